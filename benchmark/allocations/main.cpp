@@ -0,0 +1,211 @@
+/*
+ * Copyright (c) 2015 Oleg Morozenkov
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+/*
+ * Counts heap allocations per sendMessage call. Requests are sent to a local https server, so no bot token
+ * or network access is needed. Allocations of the server thread aren't counted.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <new>
+#include <string>
+#include <thread>
+
+#include <boost/asio.hpp>
+#include <boost/asio/ssl.hpp>
+#include <openssl/evp.h>
+#include <openssl/rsa.h>
+#include <openssl/x509.h>
+
+#include <tgbot/tgbot.h>
+
+using namespace std;
+using namespace TgBot;
+using namespace boost::asio;
+
+static atomic<size_t> allocationCount(0);
+static atomic<size_t> allocatedBytes(0);
+static thread_local bool isServerThread = false;
+
+void* operator new(size_t size) {
+	if (!isServerThread) {
+		allocationCount.fetch_add(1, memory_order_relaxed);
+		allocatedBytes.fetch_add(size, memory_order_relaxed);
+	}
+	void* result = malloc(size ? size : 1);
+	if (!result) {
+		throw bad_alloc();
+	}
+	return result;
+}
+
+void operator delete(void* ptr) noexcept {
+	free(ptr);
+}
+
+static const string RESPONSE_BODY = "{\"ok\":true,\"result\":{\"message_id\":1,\"date\":0,\"chat\":{\"id\":1,\"type\":\"private\"},\"text\":\"Hi\"}}";
+
+static void useSelfSignedCertificate(ssl::context& context) {
+	EVP_PKEY* key = nullptr;
+	EVP_PKEY_CTX* keyContext = EVP_PKEY_CTX_new_id(EVP_PKEY_RSA, nullptr);
+	EVP_PKEY_keygen_init(keyContext);
+	EVP_PKEY_CTX_set_rsa_keygen_bits(keyContext, 2048);
+	EVP_PKEY_keygen(keyContext, &key);
+	EVP_PKEY_CTX_free(keyContext);
+
+	X509* certificate = X509_new();
+	X509_set_version(certificate, 2);
+	ASN1_INTEGER_set(X509_get_serialNumber(certificate), 1);
+	X509_gmtime_adj(X509_get_notBefore(certificate), 0);
+	X509_gmtime_adj(X509_get_notAfter(certificate), 24 * 60 * 60);
+	X509_set_pubkey(certificate, key);
+	X509_NAME* name = X509_get_subject_name(certificate);
+	X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC, reinterpret_cast<const unsigned char*>("127.0.0.1"), -1, -1, 0);
+	X509_set_issuer_name(certificate, name);
+	X509_sign(certificate, key, EVP_sha256());
+
+	SSL_CTX_use_certificate(context.native_handle(), certificate);
+	SSL_CTX_use_PrivateKey(context.native_handle(), key);
+	X509_free(certificate);
+	EVP_PKEY_free(key);
+}
+
+static void serveConnection(ssl::stream<ip::tcp::socket>& stream) {
+	string response = "HTTP/1.1 200 OK\r\nConnection: keep-alive\r\nContent-Type: application/json\r\nContent-Length: ";
+	response += to_string(RESPONSE_BODY.size());
+	response += "\r\n\r\n";
+	response += RESPONSE_BODY;
+
+	boost::system::error_code error;
+	stream.handshake(ssl::stream_base::server, error);
+	boost::asio::streambuf buffer;
+	while (!error) {
+		size_t headSize = read_until(stream, buffer, "\r\n\r\n", error);
+		if (error) {
+			break;
+		}
+		string head(buffers_begin(buffer.data()), buffers_begin(buffer.data()) + headSize);
+		buffer.consume(headSize);
+
+		size_t bodySize = 0;
+		size_t position = head.find("Content-Length:");
+		if (position != string::npos) {
+			bodySize = strtoul(head.c_str() + position + 15, nullptr, 10);
+		}
+		if (buffer.size() < bodySize) {
+			read(stream, buffer, transfer_exactly(bodySize - buffer.size()), error);
+		}
+		buffer.consume(bodySize);
+		write(stream, boost::asio::buffer(response), error);
+	}
+}
+
+static void serve(io_service& ioService, ip::tcp::acceptor& acceptor, ssl::context& context) {
+	isServerThread = true;
+	while (true) {
+		ssl::stream<ip::tcp::socket> stream(ioService, context);
+		acceptor.accept(stream.lowest_layer());
+		serveConnection(stream);
+	}
+}
+
+static void measure(const char* name, size_t iterations, const function<void()>& call) {
+	call();
+
+	size_t countBefore = allocationCount.load();
+	size_t bytesBefore = allocatedBytes.load();
+	auto timeBefore = std::chrono::steady_clock::now();
+	for (size_t i = 0; i < iterations; ++i) {
+		call();
+	}
+	auto time = std::chrono::steady_clock::now() - timeBefore;
+	double count = static_cast<double>(allocationCount.load() - countBefore) / iterations;
+	double bytes = static_cast<double>(allocatedBytes.load() - bytesBefore) / iterations;
+	double microseconds = static_cast<double>(std::chrono::duration_cast<std::chrono::microseconds>(time).count()) / iterations;
+
+	printf("%-40s %8.1f allocations %10.0f bytes %8.1f us\n", name, count, bytes, microseconds);
+}
+
+int main(int argc, char* argv[]) {
+	size_t iterations = argc > 1 ? strtoul(argv[1], nullptr, 10) : 1000;
+
+	// The server runs until the process exits, so its objects are never destroyed
+	io_service* ioService = new io_service;
+	ssl::context* context = new ssl::context(ssl::context::sslv23);
+	useSelfSignedCertificate(*context);
+	ip::tcp::acceptor* acceptor = new ip::tcp::acceptor(*ioService, ip::tcp::endpoint(ip::address_v4::loopback(), 0));
+	thread(serve, ref(*ioService), ref(*acceptor), ref(*context)).detach();
+
+	Api api("123456:TOKEN", "https://127.0.0.1:" + to_string(acceptor->local_endpoint().port()));
+	string text = "Benchmark message text";
+
+	InlineKeyboardMarkup::Ptr keyboard(new InlineKeyboardMarkup);
+	for (int32_t i = 0; i < 2; ++i) {
+		vector<InlineKeyboardButton::Ptr> row;
+		for (int32_t j = 0; j < 3; ++j) {
+			InlineKeyboardButton::Ptr button(new InlineKeyboardButton);
+			button->text = "Button";
+			button->callbackData = "data";
+			row.push_back(button);
+		}
+		keyboard->inlineKeyboard.push_back(row);
+	}
+	// Long generated texts, which are copied or moved into the request.
+	string longText(16 * 1024, 'x');
+
+	SendOptions options;
+	SendOptions keyboardOptions;
+	keyboardOptions.replyMarkup = keyboard;
+
+	measure("sendMessage(chatId, text)", iterations, [&] {
+		api.sendMessage(1, text);
+	});
+	measure("sendMessage(chatId, text, options)", iterations, [&] {
+		api.sendMessage(1, text, options);
+	});
+	measure("sendMessage(..., replyMarkup)", iterations, [&] {
+		api.sendMessage(1, text, false, 0, keyboard);
+	});
+	measure("sendMessage(..., options with markup)", iterations, [&] {
+		api.sendMessage(1, text, keyboardOptions);
+	});
+	measure("sendMessage(chatId, long text)", iterations, [&] {
+		string generatedText(longText);
+		api.sendMessage(1, generatedText);
+	});
+	measure("sendMessage(chatId, moved long text)", iterations, [&] {
+		string generatedText(longText);
+		api.sendMessage(1, move(generatedText));
+	});
+	measure("sendMessageAndForget(chatId, text)", iterations, [&] {
+		api.sendMessageAndForget(1, text);
+	});
+	measure("sendMessageAndForget(..., markup)", iterations, [&] {
+		api.sendMessageAndForget(1, text, keyboardOptions);
+	});
+
+	return 0;
+}
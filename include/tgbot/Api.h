@@ -24,12 +24,22 @@
 #ifndef TGBOT_CPP_API_H
 #define TGBOT_CPP_API_H
 
+#include <functional>
+#include <memory>
 #include <string>
 #include <vector>
 
-#include <boost/property_tree/ptree.hpp>
+#include <boost/utility/string_ref.hpp>
 
+#include "tgbot/EditOptions.h"
+#include "tgbot/PreparedMessage.h"
+#include "tgbot/Result.h"
+#include "tgbot/SendOptions.h"
 #include "tgbot/net/HttpReqArg.h"
+#include "tgbot/net/RateLimiter.h"
+#include "tgbot/net/Url.h"
+#include "tgbot/tools/FileIdCache.h"
+#include "tgbot/tools/JsonValue.h"
 #include "tgbot/types/User.h"
 #include "tgbot/types/Message.h"
 #include "tgbot/types/GenericReply.h"
@@ -57,7 +67,47 @@ typedef std::shared_ptr<std::vector<std::string>> StringArrayPtr;
 friend class Bot;
 
 public:
-	Api(const std::string& token);
+	/**
+	 * Receives pieces of a downloaded file as they arrive.
+	 */
+	typedef std::function<void (const char* data, size_t length)> DownloadSink;
+
+	/**
+	 * Receives the number of downloaded bytes and the size of a file, which is 0 if the server didn't tell it.
+	 */
+	typedef std::function<void (uint64_t downloadedSize, uint64_t fileSize)> DownloadProgressHandler;
+
+	/**
+	 * @param url Base url of the Bot API server, e.g. a local one.
+	 */
+	Api(const std::string& token, const std::string& url = "https://api.telegram.org");
+
+	/**
+	 * Enables reuse of uploaded files. Methods which upload an InputFile look up its contents in the cache and send the stored file id instead,
+	 * and store the file id returned by Telegram after an upload. Pass nullptr to disable it.
+	 * It shouldn't be changed while other threads send requests.
+	 */
+	void setFileIdCache(const FileIdCache::Ptr& cache);
+
+	/**
+	 * @return Cache of uploaded files or nullptr if it's disabled.
+	 */
+	inline const FileIdCache::Ptr& getFileIdCache() const {
+		return _fileIdCache;
+	}
+
+	/**
+	 * Enables flood limits. Methods which send, forward or edit messages wait until RateLimiter allows a message to their chat_id.
+	 * Pass nullptr to disable it. It shouldn't be changed while other threads send requests.
+	 */
+	void setRateLimiter(const RateLimiter::Ptr& rateLimiter);
+
+	/**
+	 * @return Rate limiter, which can be tuned and queried for metrics at any time, or nullptr if it's disabled.
+	 */
+	inline const RateLimiter::Ptr& getRateLimiter() const {
+		return _rateLimiter;
+	}
 
 	/**
 	 * A simple method for testing your bot's auth token.
@@ -76,7 +126,61 @@ public:
 	 * @param disableNotification Optional. Sends the message silenty.
 	 * @return On success, the sent message is returned.
 	 */
-	Message::Ptr sendMessage(int64_t chatId, const std::string& text, bool disableWebPagePreview = false, int32_t replyToMessageId = 0, const GenericReply::Ptr replyMarkup = std::make_shared<GenericReply>(), const std::string& parseMode = "", bool disableNotification = false) const;
+	Message::Ptr sendMessage(int64_t chatId, const std::string& text, bool disableWebPagePreview = false, int32_t replyToMessageId = 0, const GenericReply::Ptr replyMarkup = nullptr, const std::string& parseMode = "", bool disableNotification = false) const;
+
+	/**
+	 * Same as sendMessage above, but the text is moved into the request instead of being copied, which helps with long generated texts.
+	 */
+	Message::Ptr sendMessage(int64_t chatId, std::string&& text, bool disableWebPagePreview = false, int32_t replyToMessageId = 0, const GenericReply::Ptr replyMarkup = nullptr, const std::string& parseMode = "", bool disableNotification = false) const;
+
+	/**
+	 * Use this method to send text messages.
+	 * The request is written straight into one buffer, so nothing else is allocated for it.
+	 * @param chatId Unique identifier for the target chat.
+	 * @param text Text of the message to be sent.
+	 * @param options Optional parameters. Caption is ignored.
+	 * @return On success, the sent message is returned.
+	 */
+	Message::Ptr sendMessage(int64_t chatId, const std::string& text, const SendOptions& options) const;
+
+	/**
+	 * Same as sendMessage with options, but the sent message isn't decoded. The response is only scanned for "ok" and "message_id",
+	 * which saves time and allocations on bulk sends.
+	 * @return Identifier of the sent message.
+	 */
+	int32_t sendMessageAndForget(int64_t chatId, const std::string& text, const SendOptions& options = SendOptions()) const;
+
+	/**
+	 * Same as sendMessageAndForget, but a failure reported by Telegram is returned instead of thrown, so checking it doesn't unwind the stack.
+	 * Network errors are still thrown.
+	 */
+	Result<int32_t> trySendMessageAndForget(int64_t chatId, const std::string& text, const SendOptions& options = SendOptions()) const;
+
+	/**
+	 * Serializes a text message once, so it can be sent to many chats by sendPreparedMessage.
+	 * @param text Text of the message to be sent.
+	 * @param options Optional parameters. Caption is ignored.
+	 */
+	static PreparedMessage prepareMessage(const std::string& text, const SendOptions& options = SendOptions());
+
+	/**
+	 * Serializes a photo message once, so it can be sent to many chats by sendPreparedMessage.
+	 * @param photoId File id of a photo which is already on the Telegram servers.
+	 * @param options Optional parameters.
+	 */
+	static PreparedMessage preparePhoto(const std::string& photoId, const SendOptions& options = SendOptions());
+
+	/**
+	 * Sends a prepared message to the chat. Only the chat id is serialized, and the sent message isn't decoded.
+	 * It's limited by the rate limiter like the method of the message.
+	 * @return Identifier of the sent message.
+	 */
+	int32_t sendPreparedMessage(int64_t chatId, const PreparedMessage& message) const;
+
+	/**
+	 * Same as sendPreparedMessage, but a failure reported by Telegram is returned instead of thrown. See trySendMessageAndForget.
+	 */
+	Result<int32_t> trySendPreparedMessage(int64_t chatId, const PreparedMessage& message) const;
 
 	/**
 	 * Use this method to forward messages of any kind.
@@ -88,6 +192,27 @@ public:
 	 */
 	Message::Ptr forwardMessage(int64_t chatId, int64_t fromChatId, int32_t messageId, bool disableNotification = false) const;
 
+	/**
+	 * Use this method to forward messages of any kind.
+	 * @param chatId Unique identifier for the target chat.
+	 * @param fromChatId Unique identifier for the chat where the original message was sent.
+	 * @param messageId Unique message identifier.
+	 * @param options Optional parameters. Only disableNotification is used.
+	 * @return On success, the sent message is returned.
+	 */
+	Message::Ptr forwardMessage(int64_t chatId, int64_t fromChatId, int32_t messageId, const SendOptions& options) const;
+
+	/**
+	 * Same as forwardMessage with options, but the sent message isn't decoded. See sendMessageAndForget.
+	 * @return Identifier of the sent message.
+	 */
+	int32_t forwardMessageAndForget(int64_t chatId, int64_t fromChatId, int32_t messageId, const SendOptions& options = SendOptions()) const;
+
+	/**
+	 * Same as forwardMessageAndForget, but a failure reported by Telegram is returned instead of thrown. See trySendMessageAndForget.
+	 */
+	Result<int32_t> tryForwardMessageAndForget(int64_t chatId, int64_t fromChatId, int32_t messageId, const SendOptions& options = SendOptions()) const;
+
 	/**
 	 * Use this method to send photos.
 	 * @param chatId Unique identifier for the target chat.
@@ -99,7 +224,7 @@ public:
 	 * @return On success, the sent message is returned.
 	 */
 	Message::Ptr sendPhoto(int64_t chatId, const InputFile::Ptr photo, const std::string& caption = "", int32_t replyToMessageId = 0,
-	                       const GenericReply::Ptr replyMarkup = std::make_shared<GenericReply>(), bool disableNotification = false) const;
+	                       const GenericReply::Ptr replyMarkup = nullptr, bool disableNotification = false) const;
 
 	/**
 	 * Use this method to send photos.
@@ -112,7 +237,27 @@ public:
 	 * @return On success, the sent message is returned.
 	 */
 	Message::Ptr sendPhoto(int64_t chatId, const std::string& photoId, const std::string& caption = "", int32_t replyToMessageId = 0,
-	                       const GenericReply::Ptr replyMarkup = std::make_shared<GenericReply>(), bool disableNotification = false) const;
+	                       const GenericReply::Ptr replyMarkup = nullptr, bool disableNotification = false) const;
+
+	/**
+	 * Use this method to send photos which are already on the Telegram servers.
+	 * @param chatId Unique identifier for the target chat.
+	 * @param photoId Id of the photo.
+	 * @param options Optional parameters. Parse mode and web page preview are ignored.
+	 * @return On success, the sent message is returned.
+	 */
+	Message::Ptr sendPhoto(int64_t chatId, const std::string& photoId, const SendOptions& options) const;
+
+	/**
+	 * Same as sendPhoto with options, but the sent message isn't decoded. See sendMessageAndForget.
+	 * @return Identifier of the sent message.
+	 */
+	int32_t sendPhotoAndForget(int64_t chatId, const std::string& photoId, const SendOptions& options = SendOptions()) const;
+
+	/**
+	 * Same as sendPhotoAndForget, but a failure reported by Telegram is returned instead of thrown. See trySendMessageAndForget.
+	 */
+	Result<int32_t> trySendPhotoAndForget(int64_t chatId, const std::string& photoId, const SendOptions& options = SendOptions()) const;
 
 	/**
 	 * Use this method to send audio files, if you want Telegram clients to display the file as a playable voice message. For this to work, your audio must be in an .ogg file encoded with OPUS (other formats may be sent as Document).
@@ -129,7 +274,7 @@ public:
 	 */
 	Message::Ptr sendAudio(int64_t chatId, const InputFile::Ptr audio, const std::string &caption = "", int32_t duration = 0,
 	                       const std::string& performer = "", const std::string& title = "", int32_t replyToMessageId = 0,
-	                       const GenericReply::Ptr replyMarkup = std::make_shared<GenericReply>(), bool disableNotification = false) const;
+	                       const GenericReply::Ptr replyMarkup = nullptr, bool disableNotification = false) const;
 
 	/**
 	 * Use this method to send audio files, if you want Telegram clients to display the file as a playable voice message. For this to work, your audio must be in an .ogg file encoded with OPUS (other formats may be sent as Document).
@@ -146,7 +291,27 @@ public:
 	 */
 	Message::Ptr sendAudio(int64_t chatId, const std::string& audioId, const std::string &caption = "", int32_t duration = 0,
 	                       const std::string& performer = "", const std::string& title = "", int32_t replyToMessageId = 0,
-	                       const GenericReply::Ptr replyMarkup = std::make_shared<GenericReply>(), bool disableNotification = false) const;
+	                       const GenericReply::Ptr replyMarkup = nullptr, bool disableNotification = false) const;
+
+	/**
+	 * Use this method to send audio files which are already on the Telegram servers.
+	 * @param chatId Unique identifier for the target chat.
+	 * @param audioId Id of the audio that is already on the Telegram servers.
+	 * @param options Optional parameters. Parse mode and web page preview are ignored.
+	 * @return On success, the sent message is returned.
+	 */
+	Message::Ptr sendAudio(int64_t chatId, const std::string& audioId, const SendOptions& options) const;
+
+	/**
+	 * Same as sendAudio with options, but the sent message isn't decoded. See sendMessageAndForget.
+	 * @return Identifier of the sent message.
+	 */
+	int32_t sendAudioAndForget(int64_t chatId, const std::string& audioId, const SendOptions& options = SendOptions()) const;
+
+	/**
+	 * Same as sendAudioAndForget, but a failure reported by Telegram is returned instead of thrown. See trySendMessageAndForget.
+	 */
+	Result<int32_t> trySendAudioAndForget(int64_t chatId, const std::string& audioId, const SendOptions& options = SendOptions()) const;
 
 	/**
 	 * Use this method to send general files.
@@ -159,7 +324,7 @@ public:
 	 * @return On success, the sent message is returned.
 	 */
 	Message::Ptr sendDocument(int64_t chatId, const InputFile::Ptr document, const std::string &caption = "", int32_t replyToMessageId = 0,
-	                          const GenericReply::Ptr replyMarkup = std::make_shared<GenericReply>(), bool disableNotification = false) const;
+	                          const GenericReply::Ptr replyMarkup = nullptr, bool disableNotification = false) const;
 
 	/**
 	 * Use this method to send general files.
@@ -172,7 +337,27 @@ public:
 	 * @return On success, the sent message is returned.
 	 */
 	Message::Ptr sendDocument(int64_t chatId, const std::string& documentId, const std::string &caption = "", int32_t replyToMessageId = 0,
-	                          const GenericReply::Ptr replyMarkup = std::make_shared<GenericReply>(), bool disableNotification = false) const;
+	                          const GenericReply::Ptr replyMarkup = nullptr, bool disableNotification = false) const;
+
+	/**
+	 * Use this method to send documents which are already on the Telegram servers.
+	 * @param chatId Unique identifier for the target chat.
+	 * @param documentId Id of the document.
+	 * @param options Optional parameters. Parse mode and web page preview are ignored.
+	 * @return On success, the sent message is returned.
+	 */
+	Message::Ptr sendDocument(int64_t chatId, const std::string& documentId, const SendOptions& options) const;
+
+	/**
+	 * Same as sendDocument with options, but the sent message isn't decoded. See sendMessageAndForget.
+	 * @return Identifier of the sent message.
+	 */
+	int32_t sendDocumentAndForget(int64_t chatId, const std::string& documentId, const SendOptions& options = SendOptions()) const;
+
+	/**
+	 * Same as sendDocumentAndForget, but a failure reported by Telegram is returned instead of thrown. See trySendMessageAndForget.
+	 */
+	Result<int32_t> trySendDocumentAndForget(int64_t chatId, const std::string& documentId, const SendOptions& options = SendOptions()) const;
 
 	/**
 	 * Use this method to send .webp stickers.
@@ -184,7 +369,7 @@ public:
 	 * @return On success, the sent message is returned.
 	 */
 	Message::Ptr sendSticker(int64_t chatId, const InputFile::Ptr sticker, int32_t replyToMessageId = 0,
-	                         const GenericReply::Ptr replyMarkup = std::make_shared<GenericReply>(), bool disableNotification = false) const;
+	                         const GenericReply::Ptr replyMarkup = nullptr, bool disableNotification = false) const;
 
 	/**
 	 * Use this method to send .webp stickers.
@@ -196,7 +381,27 @@ public:
 	 * @return On success, the sent message is returned.
 	 */
 	Message::Ptr sendSticker(int64_t chatId, const std::string& stickerId, int32_t replyToMessageId = 0,
-	                         const GenericReply::Ptr replyMarkup = std::make_shared<GenericReply>(), bool disableNotification = false) const;
+	                         const GenericReply::Ptr replyMarkup = nullptr, bool disableNotification = false) const;
+
+	/**
+	 * Use this method to send stickers which are already on the Telegram servers.
+	 * @param chatId Unique identifier for the target chat.
+	 * @param stickerId Id of the sticker.
+	 * @param options Optional parameters. Caption, parse mode and web page preview are ignored.
+	 * @return On success, the sent message is returned.
+	 */
+	Message::Ptr sendSticker(int64_t chatId, const std::string& stickerId, const SendOptions& options) const;
+
+	/**
+	 * Same as sendSticker with options, but the sent message isn't decoded. See sendMessageAndForget.
+	 * @return Identifier of the sent message.
+	 */
+	int32_t sendStickerAndForget(int64_t chatId, const std::string& stickerId, const SendOptions& options = SendOptions()) const;
+
+	/**
+	 * Same as sendStickerAndForget, but a failure reported by Telegram is returned instead of thrown. See trySendMessageAndForget.
+	 */
+	Result<int32_t> trySendStickerAndForget(int64_t chatId, const std::string& stickerId, const SendOptions& options = SendOptions()) const;
 
 	/**
 	 * Use this method to send video files, Telegram clients support mp4 videos (other formats may be sent as Document).
@@ -212,7 +417,7 @@ public:
 	 * @return On success, the sent message is returned.
 	 */
 	Message::Ptr sendVideo(int64_t chatId, const InputFile::Ptr video, int32_t duration = 0, int32_t width = 0, int32_t height = 0, const std::string &caption = "",
-						   int32_t replyToMessageId = 0, const GenericReply::Ptr replyMarkup = std::make_shared<GenericReply>(), bool disableNotification = false) const;
+						   int32_t replyToMessageId = 0, const GenericReply::Ptr replyMarkup = nullptr, bool disableNotification = false) const;
 
 	/**
 	 * Use this method to send video files, Telegram clients support mp4 videos (other formats may be sent as Document).
@@ -228,7 +433,27 @@ public:
 	 * @return On success, the sent message is returned.
 	 */
 	Message::Ptr sendVideo(int64_t chatId, const std::string& videoId, int32_t duration = 0, int32_t width = 0, int32_t height = 0, const std::string &caption = "",
-						   int32_t replyToMessageId = 0, const GenericReply::Ptr replyMarkup = std::make_shared<GenericReply>(), bool disableNotification = false) const;
+						   int32_t replyToMessageId = 0, const GenericReply::Ptr replyMarkup = nullptr, bool disableNotification = false) const;
+
+	/**
+	 * Use this method to send videos which are already on the Telegram servers.
+	 * @param chatId Unique identifier for the target chat.
+	 * @param videoId Id of the video that is already on the Telegram servers.
+	 * @param options Optional parameters. Parse mode and web page preview are ignored.
+	 * @return On success, the sent message is returned.
+	 */
+	Message::Ptr sendVideo(int64_t chatId, const std::string& videoId, const SendOptions& options) const;
+
+	/**
+	 * Same as sendVideo with options, but the sent message isn't decoded. See sendMessageAndForget.
+	 * @return Identifier of the sent message.
+	 */
+	int32_t sendVideoAndForget(int64_t chatId, const std::string& videoId, const SendOptions& options = SendOptions()) const;
+
+	/**
+	 * Same as sendVideoAndForget, but a failure reported by Telegram is returned instead of thrown. See trySendMessageAndForget.
+	 */
+	Result<int32_t> trySendVideoAndForget(int64_t chatId, const std::string& videoId, const SendOptions& options = SendOptions()) const;
 
     /**
      * Use this method to send video messages. On success, the sent Message is returned.
@@ -242,7 +467,7 @@ public:
      * @return On success, the sent Message is returned.
      */
     Message::Ptr sendVideoNote(int64_t chatId, const InputFile::Ptr videoNote, int64_t replyToMessageId = 0, bool disableNotification = false,
-                               int32_t duration = 0, int32_t length = 0, const GenericReply::Ptr replyMarkup = std::make_shared<GenericReply>());
+                               int32_t duration = 0, int32_t length = 0, const GenericReply::Ptr replyMarkup = nullptr);
 
     /**
      * Use this method to send video messages. On success, the sent Message is returned.
@@ -256,7 +481,7 @@ public:
      * @return On success, the sent Message is returned.
      */
     Message::Ptr sendVideoNote(int64_t chatId, const std::string &videoNote, int64_t replyToMessageId = 0, bool disableNotification = false,
-                               int32_t duration = 0, int32_t length = 0, const GenericReply::Ptr replyMarkup = std::make_shared<GenericReply>());
+                               int32_t duration = 0, int32_t length = 0, const GenericReply::Ptr replyMarkup = nullptr);
 
 	/**
 	 * Use this method to send audio files, if you want Telegram clients to display the file as a playable voice message.
@@ -270,7 +495,7 @@ public:
 	 * @return On success, the sent message is returned.
 	 */
 	Message::Ptr sendVoice(int64_t chatId, const InputFile::Ptr voice, const std::string &caption = "", int duration = 0, int32_t replyToMessageId = 0,
-	                      const GenericReply::Ptr replyMarkup = std::make_shared<GenericReply>(), bool disableNotification = false) const;
+	                      const GenericReply::Ptr replyMarkup = nullptr, bool disableNotification = false) const;
 
 	/**
 	 * Use this method to send audio files, if you want Telegram clients to display the file as a playable voice message.
@@ -284,7 +509,27 @@ public:
 	 * @return On success, the sent message is returned.
 	 */
 	Message::Ptr sendVoice(int64_t chatId, const std::string& voiceId, const std::string &caption = "", int duration = 0, int32_t replyToMessageId = 0,
-	                       const GenericReply::Ptr replyMarkup = std::make_shared<GenericReply>(), bool disableNotification = false) const;
+	                       const GenericReply::Ptr replyMarkup = nullptr, bool disableNotification = false) const;
+
+	/**
+	 * Use this method to send voice messages which are already on the Telegram servers.
+	 * @param chatId Unique identifier for the target chat.
+	 * @param voiceId Id of the voice message that is already on the Telegram servers.
+	 * @param options Optional parameters. Parse mode and web page preview are ignored.
+	 * @return On success, the sent message is returned.
+	 */
+	Message::Ptr sendVoice(int64_t chatId, const std::string& voiceId, const SendOptions& options) const;
+
+	/**
+	 * Same as sendVoice with options, but the sent message isn't decoded. See sendMessageAndForget.
+	 * @return Identifier of the sent message.
+	 */
+	int32_t sendVoiceAndForget(int64_t chatId, const std::string& voiceId, const SendOptions& options = SendOptions()) const;
+
+	/**
+	 * Same as sendVoiceAndForget, but a failure reported by Telegram is returned instead of thrown. See trySendMessageAndForget.
+	 */
+	Result<int32_t> trySendVoiceAndForget(int64_t chatId, const std::string& voiceId, const SendOptions& options = SendOptions()) const;
 
 	/**
 	 * Use this method to send point on the map.
@@ -297,7 +542,28 @@ public:
 	 * @return On success, the sent message is returned.
 	 */
 	Message::Ptr sendLocation(int64_t chatId, float latitude, float longitude, int32_t replyToMessageId = 0,
-	                          const GenericReply::Ptr replyMarkup = std::make_shared<GenericReply>(), bool disableNotification = false) const;
+	                          const GenericReply::Ptr replyMarkup = nullptr, bool disableNotification = false) const;
+
+	/**
+	 * Use this method to send point on the map.
+	 * @param chatId Unique identifier for the target chat.
+	 * @param latitude Latitude of location.
+	 * @param longitude Longitude of location.
+	 * @param options Optional parameters. Caption, parse mode and web page preview are ignored.
+	 * @return On success, the sent message is returned.
+	 */
+	Message::Ptr sendLocation(int64_t chatId, float latitude, float longitude, const SendOptions& options) const;
+
+	/**
+	 * Same as sendLocation with options, but the sent message isn't decoded. See sendMessageAndForget.
+	 * @return Identifier of the sent message.
+	 */
+	int32_t sendLocationAndForget(int64_t chatId, float latitude, float longitude, const SendOptions& options = SendOptions()) const;
+
+	/**
+	 * Same as sendLocationAndForget, but a failure reported by Telegram is returned instead of thrown. See trySendMessageAndForget.
+	 */
+	Result<int32_t> trySendLocationAndForget(int64_t chatId, float latitude, float longitude, const SendOptions& options = SendOptions()) const;
 
 	/**
 	 * Use this method to send information about a venue. On success, the sent Message is returned.
@@ -313,7 +579,31 @@ public:
 	 * @return On success, the sent message is returned.
 	 */
 	Message::Ptr sendVenue(int64_t chatId, float latitude, float longitude, std::string title, std::string address, std::string foursquareId = "",
-	                       bool disableNotification = false, int32_t replyToMessageId = 0, const GenericReply::Ptr replyMarkup = std::make_shared<GenericReply>()) const;
+	                       bool disableNotification = false, int32_t replyToMessageId = 0, const GenericReply::Ptr replyMarkup = nullptr) const;
+
+	/**
+	 * Use this method to send information about a venue.
+	 * @param chatId Unique identifier for the target chat.
+	 * @param latitude Latitude of the venue.
+	 * @param longitude Longitude of the venue.
+	 * @param title Name of the venue.
+	 * @param address Address of the venue.
+	 * @param foursquareId Foursquare identifier of the venue, or an empty string.
+	 * @param options Optional parameters. Caption, parse mode and web page preview are ignored.
+	 * @return On success, the sent message is returned.
+	 */
+	Message::Ptr sendVenue(int64_t chatId, float latitude, float longitude, const std::string& title, const std::string& address, const std::string& foursquareId, const SendOptions& options) const;
+
+	/**
+	 * Same as sendVenue with options, but the sent message isn't decoded. See sendMessageAndForget.
+	 * @return Identifier of the sent message.
+	 */
+	int32_t sendVenueAndForget(int64_t chatId, float latitude, float longitude, const std::string& title, const std::string& address, const std::string& foursquareId = "", const SendOptions& options = SendOptions()) const;
+
+	/**
+	 * Same as sendVenueAndForget, but a failure reported by Telegram is returned instead of thrown. See trySendMessageAndForget.
+	 */
+	Result<int32_t> trySendVenueAndForget(int64_t chatId, float latitude, float longitude, const std::string& title, const std::string& address, const std::string& foursquareId = "", const SendOptions& options = SendOptions()) const;
 
 	/**
 	 * Use this method to send phone contacts. On success, the sent Message is returned.
@@ -327,7 +617,29 @@ public:
 	 * @return On success, the sent message is returned.
 	 */
 	Message::Ptr sendContact(int64_t chatId, std::string phoneNumber, std::string firstName, std::string lastName = "", bool disableNotification = false,
-							int32_t replyToMessageId = 0, const GenericReply::Ptr replyMarkup = std::make_shared<GenericReply>()) const;
+							int32_t replyToMessageId = 0, const GenericReply::Ptr replyMarkup = nullptr) const;
+
+	/**
+	 * Use this method to send phone contacts.
+	 * @param chatId Unique identifier for the target chat.
+	 * @param phoneNumber Contact's phone number.
+	 * @param firstName Contact's first name.
+	 * @param lastName Contact's last name, or an empty string.
+	 * @param options Optional parameters. Caption, parse mode and web page preview are ignored.
+	 * @return On success, the sent message is returned.
+	 */
+	Message::Ptr sendContact(int64_t chatId, const std::string& phoneNumber, const std::string& firstName, const std::string& lastName, const SendOptions& options) const;
+
+	/**
+	 * Same as sendContact with options, but the sent message isn't decoded. See sendMessageAndForget.
+	 * @return Identifier of the sent message.
+	 */
+	int32_t sendContactAndForget(int64_t chatId, const std::string& phoneNumber, const std::string& firstName, const std::string& lastName = "", const SendOptions& options = SendOptions()) const;
+
+	/**
+	 * Same as sendContactAndForget, but a failure reported by Telegram is returned instead of thrown. See trySendMessageAndForget.
+	 */
+	Result<int32_t> trySendContactAndForget(int64_t chatId, const std::string& phoneNumber, const std::string& firstName, const std::string& lastName = "", const SendOptions& options = SendOptions()) const;
 
 	/**
 	 * Use this method when you need to tell the user that something is happening on the bot's side. The status is set for 5 seconds or less (when a message arrives from your bot, Telegram clients clear its typing status).
@@ -413,7 +725,52 @@ public:
 	 * @return Message object on success, otherwise nullptr
 	 */
 	Message::Ptr editMessageText(const std::string& text, int64_t chatId=0, int32_t messageId=0, const std::string& inlineMessageId="",
-								 const std::string& parseMode = "", bool disableWebPagePreview = false, const GenericReply::Ptr replyMarkup = std::make_shared<GenericReply>()) const;
+								 const std::string& parseMode = "", bool disableWebPagePreview = false, const GenericReply::Ptr replyMarkup = nullptr) const;
+
+	/**
+	 * Same as editMessageText above, but the text is moved into the request instead of being copied.
+	 */
+	Message::Ptr editMessageText(std::string&& text, int64_t chatId=0, int32_t messageId=0, const std::string& inlineMessageId="",
+								 const std::string& parseMode = "", bool disableWebPagePreview = false, const GenericReply::Ptr replyMarkup = nullptr) const;
+
+	/**
+	 * Use this method to edit text and game messages sent by the bot.
+	 * @param chatId Unique identifier for the target chat.
+	 * @param messageId Identifier of the sent message.
+	 * @param text New text of the message.
+	 * @param options Optional parameters.
+	 * @return Edited message on success.
+	 */
+	Message::Ptr editMessageText(int64_t chatId, int32_t messageId, const std::string& text, const EditOptions& options) const;
+
+	/**
+	 * Same as editMessageText with options, but the edited message isn't decoded. The response is only checked for "ok".
+	 */
+	void editMessageTextAndForget(int64_t chatId, int32_t messageId, const std::string& text, const EditOptions& options = EditOptions()) const;
+
+	/**
+	 * Same as editMessageTextAndForget, but a failure reported by Telegram is returned instead of thrown. See trySendMessageAndForget.
+	 */
+	Result<void> tryEditMessageTextAndForget(int64_t chatId, int32_t messageId, const std::string& text, const EditOptions& options = EditOptions()) const;
+
+	/**
+	 * Use this method to edit text and game messages sent via the bot (for inline bots).
+	 * @param inlineMessageId Identifier of the inline message.
+	 * @param text New text of the message.
+	 * @param options Optional parameters.
+	 * @return True on success.
+	 */
+	bool editMessageText(const std::string& inlineMessageId, const std::string& text, const EditOptions& options) const;
+
+	/**
+	 * Same as editMessageText of an inline message with options, but the response is only checked for "ok".
+	 */
+	void editMessageTextAndForget(const std::string& inlineMessageId, const std::string& text, const EditOptions& options = EditOptions()) const;
+
+	/**
+	 * Same as editMessageTextAndForget, but a failure reported by Telegram is returned instead of thrown. See trySendMessageAndForget.
+	 */
+	Result<void> tryEditMessageTextAndForget(const std::string& inlineMessageId, const std::string& text, const EditOptions& options = EditOptions()) const;
 
 	/**
 	* Use this method to edit captions of messages sent by the bot or via the bot (for inline bots). 
@@ -425,7 +782,52 @@ public:
 	* @return Message object on success, otherwise nullptr
 	*/
 	Message::Ptr editMessageCaption(int64_t chatId = 0, int32_t messageId = 0, const std::string& caption = "",
-									const std::string& inlineMessageId = "", const GenericReply::Ptr replyMarkup = std::make_shared<GenericReply>()) const;
+									const std::string& inlineMessageId = "", const GenericReply::Ptr replyMarkup = nullptr) const;
+
+	/**
+	 * Same as editMessageCaption above, but the caption is moved into the request instead of being copied.
+	 */
+	Message::Ptr editMessageCaption(int64_t chatId, int32_t messageId, std::string&& caption,
+									const std::string& inlineMessageId = "", const GenericReply::Ptr replyMarkup = nullptr) const;
+
+	/**
+	 * Use this method to edit captions of messages sent by the bot.
+	 * @param chatId Unique identifier for the target chat.
+	 * @param messageId Identifier of the sent message.
+	 * @param caption New caption of the message.
+	 * @param options Optional parameters. Parse mode and web page preview are ignored.
+	 * @return Edited message on success.
+	 */
+	Message::Ptr editMessageCaption(int64_t chatId, int32_t messageId, const std::string& caption, const EditOptions& options) const;
+
+	/**
+	 * Same as editMessageCaption with options, but the edited message isn't decoded. The response is only checked for "ok".
+	 */
+	void editMessageCaptionAndForget(int64_t chatId, int32_t messageId, const std::string& caption, const EditOptions& options = EditOptions()) const;
+
+	/**
+	 * Same as editMessageCaptionAndForget, but a failure reported by Telegram is returned instead of thrown. See trySendMessageAndForget.
+	 */
+	Result<void> tryEditMessageCaptionAndForget(int64_t chatId, int32_t messageId, const std::string& caption, const EditOptions& options = EditOptions()) const;
+
+	/**
+	 * Use this method to edit captions of messages sent via the bot (for inline bots).
+	 * @param inlineMessageId Identifier of the inline message.
+	 * @param caption New caption of the message.
+	 * @param options Optional parameters. Parse mode and web page preview are ignored.
+	 * @return True on success.
+	 */
+	bool editMessageCaption(const std::string& inlineMessageId, const std::string& caption, const EditOptions& options) const;
+
+	/**
+	 * Same as editMessageCaption of an inline message with options, but the response is only checked for "ok".
+	 */
+	void editMessageCaptionAndForget(const std::string& inlineMessageId, const std::string& caption, const EditOptions& options = EditOptions()) const;
+
+	/**
+	 * Same as editMessageCaptionAndForget, but a failure reported by Telegram is returned instead of thrown. See trySendMessageAndForget.
+	 */
+	Result<void> tryEditMessageCaptionAndForget(const std::string& inlineMessageId, const std::string& caption, const EditOptions& options = EditOptions()) const;
 
 	/**
 	* Use this method to edit only the reply markup of messages sent by the bot or via the bot (for inline bots).
@@ -436,7 +838,44 @@ public:
 	* @return Message object on success, otherwise nullptr
 	*/
 	Message::Ptr editMessageReplyMarkup(int64_t chatId = 0, int32_t messageId = 0, const std::string& inlineMessageId = "",
-										const GenericReply::Ptr replyMarkup = std::make_shared<GenericReply>()) const;
+										const GenericReply::Ptr replyMarkup = nullptr) const;
+
+	/**
+	 * Use this method to edit only the reply markup of messages sent by the bot.
+	 * @param chatId Unique identifier for the target chat.
+	 * @param messageId Identifier of the sent message.
+	 * @param options Optional parameters. The reply markup is the new one, an empty one removes it. Parse mode and web page preview are ignored.
+	 * @return Edited message on success.
+	 */
+	Message::Ptr editMessageReplyMarkup(int64_t chatId, int32_t messageId, const EditOptions& options) const;
+
+	/**
+	 * Same as editMessageReplyMarkup with options, but the edited message isn't decoded. The response is only checked for "ok".
+	 */
+	void editMessageReplyMarkupAndForget(int64_t chatId, int32_t messageId, const EditOptions& options = EditOptions()) const;
+
+	/**
+	 * Same as editMessageReplyMarkupAndForget, but a failure reported by Telegram is returned instead of thrown. See trySendMessageAndForget.
+	 */
+	Result<void> tryEditMessageReplyMarkupAndForget(int64_t chatId, int32_t messageId, const EditOptions& options = EditOptions()) const;
+
+	/**
+	 * Use this method to edit only the reply markup of messages sent via the bot (for inline bots).
+	 * @param inlineMessageId Identifier of the inline message.
+	 * @param options Optional parameters. The reply markup is the new one, an empty one removes it. Parse mode and web page preview are ignored.
+	 * @return True on success.
+	 */
+	bool editMessageReplyMarkup(const std::string& inlineMessageId, const EditOptions& options) const;
+
+	/**
+	 * Same as editMessageReplyMarkup of an inline message with options, but the response is only checked for "ok".
+	 */
+	void editMessageReplyMarkupAndForget(const std::string& inlineMessageId, const EditOptions& options = EditOptions()) const;
+
+	/**
+	 * Same as editMessageReplyMarkupAndForget, but a failure reported by Telegram is returned instead of thrown. See trySendMessageAndForget.
+	 */
+	Result<void> tryEditMessageReplyMarkupAndForget(const std::string& inlineMessageId, const EditOptions& options = EditOptions()) const;
 
 	/**
 	 * Use this method to delete messages sent by bot (or by other users if bot is admin).
@@ -457,6 +896,12 @@ public:
 	 */
 	std::vector<Update::Ptr> getUpdates(int32_t offset = 0, int32_t limit = 100, int32_t timeout = 0, const StringArrayPtr &allowedUpdates = nullptr) const;
 
+	/**
+	 * Does the same as getUpdates, but passes updates to the handler one by one while the response is still being received, so the first update can be handled before the whole batch arrives.
+	 * The handler is called on the calling thread. Parameters have the same meaning as in getUpdates.
+	 */
+	void streamUpdates(const std::function<void (const Update::Ptr&)>& handler, int32_t offset = 0, int32_t limit = 100, int32_t timeout = 0, const StringArrayPtr &allowedUpdates = nullptr) const;
+
 	/**
 	 * Use this method to specify a url and receive incoming updates via an outgoing webhook. Whenever there is an update for the bot, we will send an HTTPS POST request to the specified url, containing a JSON-serialized Update. In case of an unsuccessful request, we will give up after a reasonable amount of attempts.
 	 * If you'd like to make sure that the Webhook request comes from Telegram, we recommend using a secret path in the URL, e.g. www.example.com/<token>. Since nobody else knows your bot‘s token, you can be pretty sure it’s us.
@@ -519,10 +964,69 @@ public:
 	 */
 	std::string downloadFile(const std::string& filePath, const std::vector<HttpReqArg>& args = std::vector<HttpReqArg>()) const;
 
+	/**
+	 * Downloads file from Telegram and passes its contents to the sink as they arrive, so only one piece of the file is held in memory.
+	 * The sink and the progress handler are called on a worker thread. The method returns when the download is finished.
+	 * If the sink throws, the request is aborted and the exception is rethrown by this method.
+	 * @param filePath Telegram file path.
+	 * @param sink Receives pieces of the file.
+	 * @param progress Optional. Called after each piece.
+	 */
+	void downloadFile(const std::string& filePath, const DownloadSink& sink, const DownloadProgressHandler& progress = nullptr) const;
+
+	/**
+	 * Downloads file from Telegram and writes it to disk as it arrives, so only one piece of the file is held in memory.
+	 * Throws std::runtime_error naming the destination path if the file can't be written.
+	 * @param filePath Telegram file path.
+	 * @param destinationPath Path of a file which is created or overwritten.
+	 * @param progress Optional. Called on a worker thread after each piece.
+	 */
+	void downloadFileToPath(const std::string& filePath, const std::string& destinationPath, const DownloadProgressHandler& progress = nullptr) const;
+
+	/**
+	 * Downloads file from Telegram by several concurrent range requests and writes it to disk, which is faster for large files.
+	 * Falls back to a single request if the server doesn't support ranges. See ParallelDownloader.
+	 * @param filePath Telegram file path.
+	 * @param destinationPath Path of a file which is created or overwritten.
+	 * @param progress Optional. Called on a worker thread after each piece.
+	 * @param concurrency Maximum number of concurrent requests.
+	 */
+	void downloadFileParallel(const std::string& filePath, const std::string& destinationPath, const DownloadProgressHandler& progress = nullptr, size_t concurrency = 4) const;
+
 private:
-	boost::property_tree::ptree sendRequest(const std::string& method, const std::vector<HttpReqArg>& args = std::vector<HttpReqArg>()) const;
+	class JsonRequest;
+
+	JsonValue::Ptr sendRequest(const std::string& method, const std::vector<HttpReqArg>& args = std::vector<HttpReqArg>()) const;
+	JsonValue::Ptr sendRequest(JsonRequest& request) const;
+	Result<int32_t> trySendRequest(JsonRequest& request) const;
+	Result<void> trySendRequestWithoutValue(JsonRequest& request) const;
+	std::unique_ptr<JsonRequest> makeSendMessageRequest(int64_t chatId, const std::string& text, const SendOptions& options) const;
+	std::unique_ptr<JsonRequest> makeSendFileRequest(boost::string_ref method, boost::string_ref fileKey, int64_t chatId, const std::string& fileId,
+													 const SendOptions& options, bool hasCaption) const;
+	std::unique_ptr<JsonRequest> makeSendLocationRequest(int64_t chatId, float latitude, float longitude, const SendOptions& options) const;
+	std::unique_ptr<JsonRequest> makeSendVenueRequest(int64_t chatId, float latitude, float longitude, const std::string& title, const std::string& address,
+													  const std::string& foursquareId, const SendOptions& options) const;
+	std::unique_ptr<JsonRequest> makeSendContactRequest(int64_t chatId, const std::string& phoneNumber, const std::string& firstName, const std::string& lastName,
+														const SendOptions& options) const;
+	std::unique_ptr<JsonRequest> makeForwardMessageRequest(int64_t chatId, int64_t fromChatId, int32_t messageId, const SendOptions& options) const;
+	std::unique_ptr<JsonRequest> makeEditMessageRequest(boost::string_ref method, int64_t chatId, int32_t messageId, const std::string& inlineMessageId,
+														boost::string_ref key, const std::string& value, const EditOptions& options) const;
+	ApiError parseError(std::string serverResponse) const;
+	static ApiError getError(const JsonValue& response);
+	std::string makeRequest(JsonRequest& request) const;
+	JsonValue::Ptr parseResponse(std::string serverResponse) const;
+	static bool isRateLimited(boost::string_ref method);
+	std::string getMethodUrl(const std::string& method) const;
+	std::string getFileUrl(const std::string& filePath) const;
+	Message::Ptr sendCachedFile(const InputFile::Ptr& file, std::string& key, const std::function<Message::Ptr (const std::string&)>& sendById) const;
+	void cacheFileId(const std::string& key, const std::string& fileId) const;
+	JsonValue::Ptr getResult(const JsonValue::Ptr& response) const;
 
 	const std::string _token;
+	const std::string _url;
+	const Url _methodBaseUrl;
+	FileIdCache::Ptr _fileIdCache;
+	RateLimiter::Ptr _rateLimiter;
 };
 
 }
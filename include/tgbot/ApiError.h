@@ -0,0 +1,66 @@
+/*
+ * Copyright (c) 2015 Oleg Morozenkov
+ * Copyright (c) 2017 Maks Mazurov (fox.cpp)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef TGBOT_CPP_APIERROR_H
+#define TGBOT_CPP_APIERROR_H
+
+#include <cstdint>
+#include <string>
+#include <utility>
+
+#include "tgbot/types/ResponseParameters.h"
+
+namespace TgBot {
+
+/**
+ * Error of a request which Telegram refused, returned by non-throwing methods instead of TgException.
+ * @ingroup general
+ */
+class ApiError {
+
+public:
+	ApiError() = default;
+
+	ApiError(int32_t errorCode, std::string description, ResponseParameters::Ptr parameters = nullptr)
+		: errorCode(errorCode), description(std::move(description)), parameters(std::move(parameters)) {
+	}
+
+	/**
+	 * Error code given by Telegram, e.g. 400 or 429. It's 0 if the error wasn't given by Telegram, e.g. if the response couldn't be parsed.
+	 */
+	int32_t errorCode = 0;
+
+	/**
+	 * Human-readable description of the error.
+	 */
+	std::string description;
+
+	/**
+	 * Optional. Information which helps to handle the error automatically, e.g. the number of seconds to wait after a flood error.
+	 */
+	ResponseParameters::Ptr parameters;
+};
+
+}
+
+#endif //TGBOT_CPP_APIERROR_H
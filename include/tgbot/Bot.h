@@ -39,7 +39,7 @@ namespace TgBot {
 class Bot {
 
 public:
-	explicit Bot(const std::string& token) : _token(token), _api(token), _eventHandler(&_eventBroadcaster) {
+	explicit Bot(const std::string& token, const std::string& url = "https://api.telegram.org") : _token(token), _api(token, url), _eventHandler(&_eventBroadcaster) {
 	}
 
 	/**
@@ -56,6 +56,13 @@ public:
 		return _api;
 	}
 
+	/**
+	 * @return Object which can execute Telegram Bot API methods. Non-const access is needed to configure it, e.g. to enable the file id cache.
+	 */
+	inline Api& getApi() {
+		return _api;
+	}
+
 	/**
 	 * @return Object which holds all event listeners.
 	 */
@@ -70,11 +77,18 @@ public:
 		return _eventHandler;
 	}
 
+	/**
+	 * @return Object which handles new update objects. Non-const access is needed to enable parallel dispatch.
+	 */
+	inline EventHandler& getEventHandler() {
+		return _eventHandler;
+	}
+
 private:
 	const std::string _token;
-	const Api _api;
+	Api _api;
 	EventBroadcaster _eventBroadcaster;
-	const EventHandler _eventHandler;
+	EventHandler _eventHandler;
 };
 
 }
@@ -0,0 +1,230 @@
+/*
+ * Copyright (c) 2015 Oleg Morozenkov
+ * Copyright (c) 2017 Maks Mazurov (fox.cpp)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef TGBOT_CPP_BROADCASTER_H
+#define TGBOT_CPP_BROADCASTER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include "tgbot/Api.h"
+#include "tgbot/PreparedMessage.h"
+#include "tgbot/Result.h"
+#include "tgbot/net/RateLimiter.h"
+
+namespace TgBot {
+
+/**
+ * Sends one prepared message to a lot of chats. Messages are sent by several threads at the global rate limit, and calls failed
+ * by flood limits, migrations or network errors are repeated by RetryEngine.
+ * Progress can be saved to a checkpoint file, so a broadcast which was interrupted continues where it stopped when it's run again.
+ * @ingroup general
+ */
+class Broadcaster {
+
+public:
+	/**
+	 * Gives the next chat id. Returns false when there are no more chats.
+	 */
+	typedef std::function<bool (int64_t& chatId)> ChatIdSource;
+
+	/**
+	 * Sends the message to one chat, e.g. by calling Api::trySendPreparedMessage. It's called on several threads at once.
+	 * Exceptions are handled like the ones of Api calls: TgException and network errors are retried, others fail the chat.
+	 */
+	typedef std::function<Result<void> (int64_t chatId)> Sender;
+
+	enum class FailureKind {
+		Blocked, ChatNotFound, Deactivated, Other
+	};
+
+	struct Progress {
+		/**
+		 * Number of chats which are done, either sent or failed.
+		 */
+		uint64_t processedCount = 0;
+
+		/**
+		 * Number of chats which received the message, including migrated ones.
+		 */
+		uint64_t sentCount = 0;
+
+		/**
+		 * Number of groups which were migrated to supergroups and received the message there.
+		 */
+		uint64_t migratedCount = 0;
+
+		uint64_t blockedCount = 0;
+		uint64_t chatNotFoundCount = 0;
+		uint64_t deactivatedCount = 0;
+		uint64_t otherFailureCount = 0;
+
+		/**
+		 * Number of all chats, which is Options::totalCount. It's 0 if it's unknown.
+		 */
+		uint64_t totalCount = 0;
+
+		/**
+		 * Number of processed chats per second during this run.
+		 */
+		double throughput = 0;
+
+		/**
+		 * Estimated time until the broadcast is done. It's negative if the total count or the throughput is unknown.
+		 */
+		std::chrono::seconds eta = std::chrono::seconds(-1);
+	};
+
+	/**
+	 * Called periodically on the thread which runs the broadcast.
+	 */
+	typedef std::function<void (const Progress& progress)> ProgressHandler;
+
+	struct Options {
+		/**
+		 * Number of messages which are sent at the same time.
+		 */
+		size_t concurrency = 8;
+
+		/**
+		 * Maximum number of messages per second. Zero or a negative value disables the limit.
+		 */
+		double rate = 30;
+
+		/**
+		 * Maximum number of attempts of a message to one chat.
+		 */
+		size_t maxAttempts = 5;
+
+		/**
+		 * Optional. Path of a file with progress. If it exists, the broadcast skips the chats which are already processed.
+		 * It's kept when the broadcast is done, so it isn't sent twice by accident.
+		 */
+		std::string checkpointPath;
+
+		/**
+		 * Optional. Path of a file where a line "chatId kind description" is appended for every failed chat,
+		 * and "chatId migrated newChatId" for every migrated one. Lines are written in the order of chats when they are
+		 * committed to the checkpoint, so a resumed broadcast doesn't repeat them. Only if the process is killed, the lines
+		 * written after the last saved checkpoint may appear again.
+		 */
+		std::string failuresPath;
+
+		/**
+		 * Optional. Number of all chats, which is needed to estimate the remaining time.
+		 */
+		uint64_t totalCount = 0;
+
+		/**
+		 * Interval between progress reports and checkpoints.
+		 */
+		std::chrono::milliseconds progressInterval = std::chrono::milliseconds(1000);
+	};
+
+	Broadcaster(const Api& api, const PreparedMessage& message);
+	Broadcaster(const Api& api, const PreparedMessage& message, const Options& options);
+	Broadcaster(const Sender& sender, const Options& options);
+
+	/**
+	 * Creates a source which reads chat ids separated by whitespace from a file, e.g. one per line.
+	 */
+	static ChatIdSource fromFile(const std::string& filePath);
+
+	/**
+	 * Creates a source which takes chat ids from a range. The range must outlive the source.
+	 */
+	template<typename Iterator>
+	static ChatIdSource fromRange(Iterator begin, Iterator end) {
+		auto it(std::make_shared<Iterator>(begin));
+		return [it, end](int64_t& chatId) {
+			if (*it == end) {
+				return false;
+			}
+			chatId = static_cast<int64_t>(**it);
+			++*it;
+			return true;
+		};
+	}
+
+	/**
+	 * Sends the message to all chats from the source and returns when they're processed or the broadcast is stopped.
+	 * Messages which were in progress during an interruption may be sent again when it's resumed.
+	 * @param progressHandler Optional. Called every Options::progressInterval and at the end.
+	 * @return Final progress, which includes the chats processed by previous runs.
+	 */
+	Progress run(const ChatIdSource& source, const ProgressHandler& progressHandler = nullptr);
+
+	/**
+	 * Stops a running broadcast from another thread. run saves the checkpoint and returns after the messages in progress are done.
+	 */
+	void stop();
+
+	/**
+	 * Tells why a message couldn't be sent.
+	 */
+	static FailureKind classifyFailure(const ApiError& error);
+
+	static const char* getFailureKindName(FailureKind kind);
+
+private:
+	enum class Outcome : int8_t {
+		Pending, Sent, Migrated, Blocked, ChatNotFound, Deactivated, Other
+	};
+
+	struct Entry {
+		Outcome outcome = Outcome::Pending;
+		FailureKind kind = FailureKind::Other;
+		int64_t chatId = 0;
+		int64_t sentChatId = 0;
+		std::string description;
+	};
+
+	static void addOutcome(Progress& progress, Outcome outcome);
+	void complete(uint64_t position, int64_t chatId, int64_t sentChatId, const Result<void>& result);
+	void writeFailure(const Entry& entry);
+	void loadCheckpoint();
+	void saveCheckpoint();
+	Progress getProgress(std::chrono::steady_clock::time_point startTime, uint64_t startProcessedCount) const;
+
+	const Sender _sender;
+	const Options _options;
+	RateLimiter _rateLimiter;
+	mutable std::mutex _mutex;
+	std::condition_variable _condition;
+	Progress _committedProgress;
+	std::deque<Entry> _window;
+	size_t _inFlightCount = 0;
+	bool _isStopped = false;
+	std::ofstream _failuresStream;
+};
+
+}
+
+#endif //TGBOT_CPP_BROADCASTER_H
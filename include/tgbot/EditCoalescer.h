@@ -0,0 +1,184 @@
+/*
+ * Copyright (c) 2015 Oleg Morozenkov
+ * Copyright (c) 2017 Maks Mazurov (fox.cpp)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef TGBOT_CPP_EDITCOALESCER_H
+#define TGBOT_CPP_EDITCOALESCER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "tgbot/Api.h"
+#include "tgbot/EditOptions.h"
+#include "tgbot/Result.h"
+
+namespace TgBot {
+
+/**
+ * Edits texts of messages which change often, e.g. progress bars, without wasting requests.
+ * Only the latest text of a message is kept while it waits, a message isn't edited more often than Options::minInterval,
+ * and edits which wouldn't change the text or the markup are dropped. Waiting edits are sent on its own threads.
+ * Requests go through the rate limiter of the Api, if it has one.
+ * @ingroup general
+ */
+class EditCoalescer {
+
+public:
+	typedef std::chrono::steady_clock Clock;
+
+	/**
+	 * Edits the text of a message, e.g. by calling Api::tryEditMessageTextAndForget. Exceptions are treated as errors with code 0.
+	 */
+	typedef std::function<Result<void> (int64_t chatId, int32_t messageId, const std::string& text, const EditOptions& options)> Sender;
+
+	/**
+	 * Called on a thread of the coalescer when an edit fails. Exceptions thrown from it are ignored.
+	 */
+	typedef std::function<void (int64_t chatId, int32_t messageId, const ApiError& error)> ErrorHandler;
+
+	struct Options {
+		/**
+		 * Minimum interval between the starts of two edits of the same message.
+		 */
+		std::chrono::milliseconds minInterval = std::chrono::milliseconds(1000);
+
+		/**
+		 * Number of threads which send edits, i.e. the maximum number of edits in progress.
+		 */
+		size_t threadCount = 1;
+
+		/**
+		 * Optional. Called when an edit fails for another reason than a flood limit. Edits failed by flood limits are repeated
+		 * after ResponseParameters::retryAfter seconds, unless there's a newer text already.
+		 */
+		ErrorHandler errorHandler;
+	};
+
+	struct Metrics {
+		/**
+		 * Number of calls to edit.
+		 */
+		uint64_t requestedCount = 0;
+
+		/**
+		 * Number of successful edits.
+		 */
+		uint64_t sentCount = 0;
+
+		/**
+		 * Number of texts which were replaced by newer ones before they were sent.
+		 */
+		uint64_t supersededCount = 0;
+
+		/**
+		 * Number of edits which were dropped because the message already had the same content, including ones which
+		 * Telegram refused with "message is not modified".
+		 */
+		uint64_t unchangedCount = 0;
+
+		uint64_t failedCount = 0;
+
+		/**
+		 * Number of messages which have an edit waiting now.
+		 */
+		size_t pendingCount = 0;
+	};
+
+	explicit EditCoalescer(const Api& api);
+	EditCoalescer(const Api& api, const Options& options);
+	EditCoalescer(const Sender& sender, const Options& options);
+
+	/**
+	 * Waits for edits which are in progress. Edits which are waiting are dropped.
+	 */
+	~EditCoalescer();
+
+	/**
+	 * Queues a new text of a message and returns immediately. The edit is sent when the interval since the previous edit of
+	 * the message has passed, unless it's replaced by a newer text before.
+	 */
+	void edit(int64_t chatId, int32_t messageId, const std::string& text, const EditOptions& options = EditOptions());
+
+	/**
+	 * Waits until all queued edits are done.
+	 */
+	void flush();
+
+	/**
+	 * Drops the waiting edit and the last sent content of a message, e.g. when its progress is done or it's deleted.
+	 * The coalescer remembers every edited message until it's forgotten.
+	 */
+	void forget(int64_t chatId, int32_t messageId);
+
+	Metrics getMetrics() const;
+
+private:
+	typedef std::pair<int64_t, int32_t> Target;
+
+	struct Edit {
+		std::string text;
+		EditOptions options;
+
+		/**
+		 * Text together with options which change how the message looks, used to detect edits which change nothing.
+		 */
+		std::string content;
+	};
+
+	struct Entry {
+		Edit pending;
+		bool hasPending = false;
+		bool isSending = false;
+		bool isForgotten = false;
+		std::string sendingContent;
+		std::string lastSentContent;
+		Clock::time_point nextEditTime;
+	};
+
+	static std::string getContent(const std::string& text, const EditOptions& options);
+	void work();
+	void complete(const Target& target, Edit& edit, const Result<void>& result, std::unique_lock<std::mutex>& lock);
+
+	const Sender _sender;
+	const Options _options;
+	std::map<Target, Entry> _entries;
+	std::set<std::pair<Clock::time_point, Target>> _schedule;
+	std::vector<std::thread> _workers;
+	mutable std::mutex _mutex;
+	std::condition_variable _condition;
+	Metrics _metrics;
+	size_t _sendingCount = 0;
+	bool _isStopped = false;
+};
+
+}
+
+#endif //TGBOT_CPP_EDITCOALESCER_H
@@ -0,0 +1,58 @@
+/*
+ * Copyright (c) 2015 Oleg Morozenkov
+ * Copyright (c) 2017 Maks Mazurov (fox.cpp)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef TGBOT_CPP_EDITOPTIONS_H
+#define TGBOT_CPP_EDITOPTIONS_H
+
+#include <string>
+
+#include "tgbot/types/GenericReply.h"
+
+namespace TgBot {
+
+/**
+ * Optional parameters of edit methods. Members with default values aren't sent, so default options cost nothing.
+ * @ingroup general
+ */
+class EditOptions {
+
+public:
+	/**
+	 * Optional. New inline keyboard of the message.
+	 */
+	GenericReply::Ptr replyMarkup;
+
+	/**
+	 * Optional. Set it to "Markdown" or "HTML" if you want Telegram apps to show bold, italic, fixed-width text or inline URLs in the new text. Ignored when a caption is edited.
+	 */
+	std::string parseMode;
+
+	/**
+	 * Optional. Disables link previews for links in the new text. Ignored when a caption is edited.
+	 */
+	bool disableWebPagePreview = false;
+};
+
+}
+
+#endif //TGBOT_CPP_EDITOPTIONS_H
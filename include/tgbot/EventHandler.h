@@ -24,8 +24,15 @@
 #ifndef TGBOT_EVENTHANDLER_H
 #define TGBOT_EVENTHANDLER_H
 
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 #include "tgbot/EventBroadcaster.h"
 #include "tgbot/types/Update.h"
+#include "tgbot/tools/BlockingQueue.h"
 #include "tgbot/tools/StringTools.h"
 
 namespace TgBot {
@@ -36,11 +43,56 @@ public:
 	explicit EventHandler(const EventBroadcaster* broadcaster) : _broadcaster(broadcaster) {
 	}
 
+	~EventHandler();
+
+	/**
+	 * Passes update to listeners. If parallel dispatch is enabled, update is only queued to its lane and listeners are invoked later on a worker thread.
+	 * If a listener threw an exception on a worker thread, the first such exception is rethrown from here.
+	 */
 	void handleUpdate(const Update::Ptr update) const;
 
+	/**
+	 * Enables parallel dispatch. Updates are distributed between serial lanes by chat id (or by user id for inline queries, chosen inline results and callback queries), each lane is served by its own thread.
+	 * Updates from the same chat are handled in the order they came, updates from different chats may be handled concurrently, so listeners must be thread safe.
+	 * Must not be called concurrently with handleUpdate. Rethrows a pending listener exception the same way drain does.
+	 * @param laneCount Number of lanes and worker threads. If 0, number of hardware threads is used.
+	 * @param maxQueuedUpdatesPerLane Maximum number of updates which wait in a lane. When it's reached, handleUpdate waits until the lane takes one.
+	 */
+	void enableParallelDispatch(size_t laneCount = 0, size_t maxQueuedUpdatesPerLane = 256);
+
+	/**
+	 * Waits until all queued updates are handled and stops worker threads. After that updates are handled on the calling thread again.
+	 * If a listener threw an exception on a worker thread and it wasn't rethrown from handleUpdate yet, the first such exception is rethrown from here.
+	 * Must not be called concurrently with handleUpdate.
+	 */
+	void drain();
+
+	/**
+	 * @return Number of updates which wait in all lanes.
+	 */
+	size_t getQueuedUpdateCount() const;
+
+	/**
+	 * @return Key by which update is assigned to a lane: chat id for messages and channel posts, user id for queries. 0 if update has none of them.
+	 */
+	static int64_t getLaneKey(const Update::Ptr& update);
+
 private:
+	struct Lane {
+		explicit Lane(size_t capacity) : queue(capacity) {
+		}
+
+		BlockingQueue<Update::Ptr> queue;
+		std::thread thread;
+	};
+
 	const EventBroadcaster* _broadcaster;
+	std::vector<std::unique_ptr<Lane>> _lanes;
+	mutable std::mutex _dispatchErrorMutex;
+	mutable std::exception_ptr _dispatchError;
 
+	void processUpdate(const Update::Ptr& update) const;
+	void runLane(Lane* lane) const;
 	void handleMessage(const Message::Ptr message) const;
 };
 
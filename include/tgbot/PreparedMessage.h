@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2015 Oleg Morozenkov
+ * Copyright (c) 2017 Maks Mazurov (fox.cpp)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef TGBOT_CPP_PREPAREDMESSAGE_H
+#define TGBOT_CPP_PREPAREDMESSAGE_H
+
+#include <string>
+
+namespace TgBot {
+
+/**
+ * Message which is serialized once and then sent to many chats by Api::sendPreparedMessage, e.g. by Broadcaster.
+ * Usually it's created by Api::prepareMessage or Api::preparePhoto.
+ * @ingroup general
+ */
+class PreparedMessage {
+
+public:
+	/**
+	 * Name of the method which sends the message, e.g. "sendMessage".
+	 */
+	std::string method;
+
+	/**
+	 * Members of the json request body except chat_id, without enclosing braces, e.g. "text":"Hello".
+	 */
+	std::string members;
+};
+
+}
+
+#endif //TGBOT_CPP_PREPAREDMESSAGE_H
@@ -0,0 +1,130 @@
+/*
+ * Copyright (c) 2015 Oleg Morozenkov
+ * Copyright (c) 2017 Maks Mazurov (fox.cpp)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef TGBOT_CPP_RESULT_H
+#define TGBOT_CPP_RESULT_H
+
+#include <utility>
+
+#include "tgbot/ApiError.h"
+#include "tgbot/TgException.h"
+
+namespace TgBot {
+
+/**
+ * Either a value of a successful request or an ApiError, which is returned by non-throwing methods of Api.
+ * Checking it is cheaper than catching TgException when a lot of requests fail, e.g. during broadcasts.
+ * @ingroup general
+ */
+template<typename T>
+class Result {
+
+public:
+	Result(T value) : _value(std::move(value)), _isOk(true) {
+	}
+
+	Result(ApiError error) : _error(std::move(error)), _isOk(false) {
+	}
+
+	inline bool isOk() const {
+		return _isOk;
+	}
+
+	inline explicit operator bool() const {
+		return _isOk;
+	}
+
+	/**
+	 * @return Value of a successful request. It's default constructed if the request failed.
+	 */
+	inline const T& getValue() const {
+		return _value;
+	}
+
+	/**
+	 * @return Value of a successful request.
+	 * @throws TgException with the error if the request failed.
+	 */
+	inline const T& getValueOrThrow() const {
+		if (!_isOk) {
+			throw TgException(_error.description, _error.errorCode, _error.parameters);
+		}
+		return _value;
+	}
+
+	/**
+	 * @return Error of a failed request. Its error code is 0 if the request succeeded.
+	 */
+	inline const ApiError& getError() const {
+		return _error;
+	}
+
+private:
+	T _value = T();
+	ApiError _error;
+	bool _isOk;
+};
+
+/**
+ * Result of a request which gives no value.
+ * @ingroup general
+ */
+template<>
+class Result<void> {
+
+public:
+	Result() : _isOk(true) {
+	}
+
+	Result(ApiError error) : _error(std::move(error)), _isOk(false) {
+	}
+
+	inline bool isOk() const {
+		return _isOk;
+	}
+
+	inline explicit operator bool() const {
+		return _isOk;
+	}
+
+	/**
+	 * @throws TgException with the error if the request failed.
+	 */
+	inline void throwIfFailed() const {
+		if (!_isOk) {
+			throw TgException(_error.description, _error.errorCode, _error.parameters);
+		}
+	}
+
+	inline const ApiError& getError() const {
+		return _error;
+	}
+
+private:
+	ApiError _error;
+	bool _isOk;
+};
+
+}
+
+#endif //TGBOT_CPP_RESULT_H
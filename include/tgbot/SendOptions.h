@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2015 Oleg Morozenkov
+ * Copyright (c) 2017 Maks Mazurov (fox.cpp)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef TGBOT_CPP_SENDOPTIONS_H
+#define TGBOT_CPP_SENDOPTIONS_H
+
+#include <cstdint>
+#include <string>
+
+#include "tgbot/types/GenericReply.h"
+
+namespace TgBot {
+
+/**
+ * Optional parameters of send methods. Members with default values aren't sent, so default options cost nothing.
+ * Members which a method doesn't support are ignored by it.
+ * @ingroup general
+ */
+class SendOptions {
+
+public:
+	/**
+	 * Optional. If the message is a reply, ID of the original message.
+	 */
+	int32_t replyToMessageId = 0;
+
+	/**
+	 * Optional. Additional interface options. An object for a custom reply keyboard, instructions to hide keyboard or to force a reply from the user.
+	 */
+	GenericReply::Ptr replyMarkup;
+
+	/**
+	 * Optional. Sends the message silently.
+	 */
+	bool disableNotification = false;
+
+	/**
+	 * Optional. Photo or document caption, 0-200 characters.
+	 */
+	std::string caption;
+
+	/**
+	 * Optional. Set it to "Markdown" or "HTML" if you want Telegram apps to show bold, italic, fixed-width text or inline URLs in your bot's text message.
+	 */
+	std::string parseMode;
+
+	/**
+	 * Optional. Disables link previews for links in the text message.
+	 */
+	bool disableWebPagePreview = false;
+};
+
+}
+
+#endif //TGBOT_CPP_SENDOPTIONS_H
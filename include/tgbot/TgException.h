@@ -24,9 +24,12 @@
 #ifndef TGBOT_TGEXCEPTION_H
 #define TGBOT_TGEXCEPTION_H
 
+#include <cstdint>
 #include <string>
 #include <stdexcept>
 
+#include "tgbot/types/ResponseParameters.h"
+
 namespace TgBot {
 
 /**
@@ -37,6 +40,20 @@ class TgException : public std::runtime_error {
 
 public:
 	using std::runtime_error::runtime_error;
+
+	TgException(const std::string& description, int32_t errorCode, const ResponseParameters::Ptr& parameters) :
+		std::runtime_error(description), errorCode(errorCode), parameters(parameters) {
+	}
+
+	/**
+	 * Error code given by Telegram, e.g. 400 or 429. It's 0 if the error wasn't given by Telegram, e.g. if the response couldn't be parsed.
+	 */
+	int32_t errorCode = 0;
+
+	/**
+	 * Optional. Information which helps to handle the error automatically, e.g. the number of seconds to wait after a flood error.
+	 */
+	ResponseParameters::Ptr parameters;
 };
 
 }
@@ -24,12 +24,15 @@
 #ifndef TGBOT_CPP_TGTYPEPARSER_H
 #define TGBOT_CPP_TGTYPEPARSER_H
 
+#include <atomic>
+#include <functional>
 #include <string>
-
-#include <boost/property_tree/ptree.hpp>
-#include <boost/property_tree/json_parser.hpp>
+#include <vector>
 
 #include "tgbot/types.h"
+#include "tgbot/tools/JsonDocument.h"
+#include "tgbot/tools/JsonWriter.h"
+#include "tgbot/tools/Lazy.h"
 
 namespace TgBot {
 
@@ -37,259 +40,399 @@ class TgTypeParser {
 
 public:
 	template<typename T>
-	using JsonToTgTypeFunc = std::shared_ptr<T> (TgTypeParser::*)(const boost::property_tree::ptree&) const;
+	using JsonToTgTypeFunc = std::shared_ptr<T> (TgTypeParser::*)(const JsonValue&) const;
 
 	template<typename T>
 	using TgTypeToJsonFunc = std::string (TgTypeParser::*)(const std::shared_ptr<T>&) const;
 
+	template<typename T>
+	using TgTypeToJsonWriterFunc = void (TgTypeParser::*)(JsonWriter&, const std::shared_ptr<T>&) const;
+
 	static TgTypeParser& getInstance();
 
-	Chat::Ptr parseJsonAndGetChat(const boost::property_tree::ptree& data) const;
+	/**
+	 * Enables or disables lazy decoding. When it's enabled, nested objects and arrays of messages are decoded only when they are accessed for the first time.
+	 * Until then each message keeps the json document it came from in memory.
+	 * Only json parsed by parseJson or JsonDocument::parse can be decoded lazily.
+	 */
+	void setLazyDecoding(bool isLazy);
+	bool isLazyDecoding() const;
+
+	Chat::Ptr parseJsonAndGetChat(const JsonValue& data) const;
 	std::string parseChat(const Chat::Ptr& object) const;
-	User::Ptr parseJsonAndGetUser(const boost::property_tree::ptree& data) const;
+	void writeChat(JsonWriter& writer, const Chat::Ptr& object) const;
+	User::Ptr parseJsonAndGetUser(const JsonValue& data) const;
 	std::string parseUser(const User::Ptr& object) const;
-	MessageEntity::Ptr parseJsonAndGetEntity(const boost::property_tree::ptree& data) const;
-	Message::Ptr parseJsonAndGetMessage(const boost::property_tree::ptree& data) const;
+	void writeUser(JsonWriter& writer, const User::Ptr& object) const;
+	MessageEntity::Ptr parseJsonAndGetEntity(const JsonValue& data) const;
+	Message::Ptr parseJsonAndGetMessage(const JsonValue& data) const;
 	std::string parseMessage(const Message::Ptr& object) const;
-	PhotoSize::Ptr parseJsonAndGetPhotoSize(const boost::property_tree::ptree& data) const;
+	void writeMessage(JsonWriter& writer, const Message::Ptr& object) const;
+	PhotoSize::Ptr parseJsonAndGetPhotoSize(const JsonValue& data) const;
 	std::string parsePhotoSize(const PhotoSize::Ptr& object) const;
-	Audio::Ptr parseJsonAndGetAudio(const boost::property_tree::ptree& data) const;
+	void writePhotoSize(JsonWriter& writer, const PhotoSize::Ptr& object) const;
+	Audio::Ptr parseJsonAndGetAudio(const JsonValue& data) const;
 	std::string parseAudio(const Audio::Ptr& object) const;
-	Document::Ptr parseJsonAndGetDocument(const boost::property_tree::ptree& data) const;
+	void writeAudio(JsonWriter& writer, const Audio::Ptr& object) const;
+	Voice::Ptr parseJsonAndGetVoice(const JsonValue& data) const;
+	std::string parseVoice(const Voice::Ptr& object) const;
+	void writeVoice(JsonWriter& writer, const Voice::Ptr& object) const;
+	Document::Ptr parseJsonAndGetDocument(const JsonValue& data) const;
 	std::string parseDocument(const Document::Ptr& object) const;
-	Sticker::Ptr parseJsonAndGetSticker(const boost::property_tree::ptree& data) const;
+	void writeDocument(JsonWriter& writer, const Document::Ptr& object) const;
+	Sticker::Ptr parseJsonAndGetSticker(const JsonValue& data) const;
 	std::string parseSticker(const Sticker::Ptr& object) const;
-	Video::Ptr parseJsonAndGetVideo(const boost::property_tree::ptree& data) const;
+	void writeSticker(JsonWriter& writer, const Sticker::Ptr& object) const;
+	Video::Ptr parseJsonAndGetVideo(const JsonValue& data) const;
 	std::string parseVideo(const Video::Ptr& object) const;
-	VideoNote::Ptr parseJsonAndGetVideoNote(const boost::property_tree::ptree& data) const;
+	void writeVideo(JsonWriter& writer, const Video::Ptr& object) const;
+	VideoNote::Ptr parseJsonAndGetVideoNote(const JsonValue& data) const;
 	std::string parseVideoNote(const VideoNote::Ptr& object) const;
-	Contact::Ptr parseJsonAndGetContact(const boost::property_tree::ptree& data) const;
+	void writeVideoNote(JsonWriter& writer, const VideoNote::Ptr& object) const;
+	Contact::Ptr parseJsonAndGetContact(const JsonValue& data) const;
 	std::string parseContact(const Contact::Ptr& object) const;
-	Location::Ptr parseJsonAndGetLocation(const boost::property_tree::ptree& data) const;
+	void writeContact(JsonWriter& writer, const Contact::Ptr& object) const;
+	Location::Ptr parseJsonAndGetLocation(const JsonValue& data) const;
 	std::string parseLocation(const Location::Ptr& object) const;
-	Update::Ptr parseJsonAndGetUpdate(const boost::property_tree::ptree& data) const;
+	void writeLocation(JsonWriter& writer, const Location::Ptr& object) const;
+	Venue::Ptr parseJsonAndGetVenue(const JsonValue& data) const;
+	std::string parseVenue(const Venue::Ptr& object) const;
+	void writeVenue(JsonWriter& writer, const Venue::Ptr& object) const;
+	Update::Ptr parseJsonAndGetUpdate(const JsonValue& data) const;
 	std::string parseUpdate(const Update::Ptr& object) const;
-	UserProfilePhotos::Ptr parseJsonAndGetUserProfilePhotos(const boost::property_tree::ptree& data) const;
+	void writeUpdate(JsonWriter& writer, const Update::Ptr& object) const;
+	UserProfilePhotos::Ptr parseJsonAndGetUserProfilePhotos(const JsonValue& data) const;
 	std::string parseUserProfilePhotos(const UserProfilePhotos::Ptr& object) const;
+	void writeUserProfilePhotos(JsonWriter& writer, const UserProfilePhotos::Ptr& object) const;
 
-	File::Ptr parseJsonAndGetFile(const boost::property_tree::ptree& data) const;
+	File::Ptr parseJsonAndGetFile(const JsonValue& data) const;
 	std::string parseFile(const File::Ptr& object) const;
+	void writeFile(JsonWriter& writer, const File::Ptr& object) const;
 
-	ReplyKeyboardMarkup::Ptr parseJsonAndGetReplyKeyboardMarkup(const boost::property_tree::ptree& data) const;
+	ReplyKeyboardMarkup::Ptr parseJsonAndGetReplyKeyboardMarkup(const JsonValue& data) const;
 	std::string parseReplyKeyboardMarkup(const ReplyKeyboardMarkup::Ptr& object) const;
+	void writeReplyKeyboardMarkup(JsonWriter& writer, const ReplyKeyboardMarkup::Ptr& object) const;
 
-	KeyboardButton::Ptr parseJsonAndGetKeyboardButton(const boost::property_tree::ptree& data) const;
+	KeyboardButton::Ptr parseJsonAndGetKeyboardButton(const JsonValue& data) const;
 	std::string parseKeyboardButton(const KeyboardButton::Ptr& object) const;
+	void writeKeyboardButton(JsonWriter& writer, const KeyboardButton::Ptr& object) const;
 
-	ReplyKeyboardRemove::Ptr parseJsonAndGetReplyKeyboardRemove(const boost::property_tree::ptree& data) const;
+	ReplyKeyboardRemove::Ptr parseJsonAndGetReplyKeyboardRemove(const JsonValue& data) const;
 	std::string parseReplyKeyboardRemove(const ReplyKeyboardRemove::Ptr& object) const;
+	void writeReplyKeyboardRemove(JsonWriter& writer, const ReplyKeyboardRemove::Ptr& object) const;
 
-	ForceReply::Ptr parseJsonAndGetForceReply(const boost::property_tree::ptree& data) const;
+	ForceReply::Ptr parseJsonAndGetForceReply(const JsonValue& data) const;
 	std::string parseForceReply(const ForceReply::Ptr& object) const;
+	void writeForceReply(JsonWriter& writer, const ForceReply::Ptr& object) const;
 
-	ChatMember::Ptr parseJsonAndGetChatMember(const boost::property_tree::ptree& data) const;
+	ChatMember::Ptr parseJsonAndGetChatMember(const JsonValue& data) const;
 	std::string parseChatMember(const ChatMember::Ptr& object) const;
+	void writeChatMember(JsonWriter& writer, const ChatMember::Ptr& object) const;
 
-	ResponseParameters::Ptr parseJsonAndGetResponseParameters(const boost::property_tree::ptree& data) const;
+	ResponseParameters::Ptr parseJsonAndGetResponseParameters(const JsonValue& data) const;
 	std::string parseResponseParameters(const ResponseParameters::Ptr& object) const;
+	void writeResponseParameters(JsonWriter& writer, const ResponseParameters::Ptr& object) const;
 
-	GenericReply::Ptr parseJsonAndGetGenericReply(const boost::property_tree::ptree& data) const;
+	GenericReply::Ptr parseJsonAndGetGenericReply(const JsonValue& data) const;
 	std::string parseGenericReply(const GenericReply::Ptr& object) const;
+	void writeGenericReply(JsonWriter& writer, const GenericReply::Ptr& object) const;
 	
-	InlineQuery::Ptr parseJsonAndGetInlineQuery(const boost::property_tree::ptree& data) const;
+	InlineQuery::Ptr parseJsonAndGetInlineQuery(const JsonValue& data) const;
 	std::string parseInlineQuery(const InlineQuery::Ptr& object) const;
+	void writeInlineQuery(JsonWriter& writer, const InlineQuery::Ptr& object) const;
 	
-	InlineQueryResult::Ptr parseJsonAndGetInlineQueryResult(const boost::property_tree::ptree& data) const;
+	InlineQueryResult::Ptr parseJsonAndGetInlineQueryResult(const JsonValue& data) const;
 	std::string parseInlineQueryResult(const InlineQueryResult::Ptr& object) const;
+	void writeInlineQueryResult(JsonWriter& writer, const InlineQueryResult::Ptr& object) const;
 	
-	InlineQueryResultCachedAudio::Ptr parseJsonAndGetInlineQueryResultCachedAudio(const boost::property_tree::ptree& data) const;
+	InlineQueryResultCachedAudio::Ptr parseJsonAndGetInlineQueryResultCachedAudio(const JsonValue& data) const;
 	std::string parseInlineQueryResultCachedAudio(const InlineQueryResultCachedAudio::Ptr& object) const;
+	void writeInlineQueryResultCachedAudio(JsonWriter& writer, const InlineQueryResultCachedAudio::Ptr& object) const;
 
-	InlineQueryResultCachedDocument::Ptr parseJsonAndGetInlineQueryResultCachedDocument(const boost::property_tree::ptree& data) const;
+	InlineQueryResultCachedDocument::Ptr parseJsonAndGetInlineQueryResultCachedDocument(const JsonValue& data) const;
 	std::string parseInlineQueryResultCachedDocument(const InlineQueryResultCachedDocument::Ptr& object) const;
+	void writeInlineQueryResultCachedDocument(JsonWriter& writer, const InlineQueryResultCachedDocument::Ptr& object) const;
 
-	InlineQueryResultCachedGif::Ptr parseJsonAndGetInlineQueryResultCachedGif(const boost::property_tree::ptree& data) const;
+	InlineQueryResultCachedGif::Ptr parseJsonAndGetInlineQueryResultCachedGif(const JsonValue& data) const;
 	std::string parseInlineQueryResultCachedGif(const InlineQueryResultCachedGif::Ptr& object) const;
+	void writeInlineQueryResultCachedGif(JsonWriter& writer, const InlineQueryResultCachedGif::Ptr& object) const;
 
-	InlineQueryResultCachedMpeg4Gif::Ptr parseJsonAndGetInlineQueryResultCachedMpeg4Gif(const boost::property_tree::ptree& data) const;
+	InlineQueryResultCachedMpeg4Gif::Ptr parseJsonAndGetInlineQueryResultCachedMpeg4Gif(const JsonValue& data) const;
 	std::string parseInlineQueryResultCachedMpeg4Gif(const InlineQueryResultCachedMpeg4Gif::Ptr& object) const;
+	void writeInlineQueryResultCachedMpeg4Gif(JsonWriter& writer, const InlineQueryResultCachedMpeg4Gif::Ptr& object) const;
 
-	InlineQueryResultCachedPhoto::Ptr parseJsonAndGetInlineQueryResultCachedPhoto(const boost::property_tree::ptree& data) const;
+	InlineQueryResultCachedPhoto::Ptr parseJsonAndGetInlineQueryResultCachedPhoto(const JsonValue& data) const;
 	std::string parseInlineQueryResultCachedPhoto(const InlineQueryResultCachedPhoto::Ptr& object) const;
+	void writeInlineQueryResultCachedPhoto(JsonWriter& writer, const InlineQueryResultCachedPhoto::Ptr& object) const;
 
-	InlineQueryResultCachedSticker::Ptr parseJsonAndGetInlineQueryResultCachedSticker(const boost::property_tree::ptree& data) const;
+	InlineQueryResultCachedSticker::Ptr parseJsonAndGetInlineQueryResultCachedSticker(const JsonValue& data) const;
 	std::string parseInlineQueryResultCachedSticker(const InlineQueryResultCachedSticker::Ptr& object) const;
+	void writeInlineQueryResultCachedSticker(JsonWriter& writer, const InlineQueryResultCachedSticker::Ptr& object) const;
 
-	InlineQueryResultCachedVideo::Ptr parseJsonAndGetInlineQueryResultCachedVideo(const boost::property_tree::ptree& data) const;
+	InlineQueryResultCachedVideo::Ptr parseJsonAndGetInlineQueryResultCachedVideo(const JsonValue& data) const;
 	std::string parseInlineQueryResultCachedVideo(const InlineQueryResultCachedVideo::Ptr& object) const;
+	void writeInlineQueryResultCachedVideo(JsonWriter& writer, const InlineQueryResultCachedVideo::Ptr& object) const;
 
-	InlineQueryResultCachedVoice::Ptr parseJsonAndGetInlineQueryResultCachedVoice(const boost::property_tree::ptree& data) const;
+	InlineQueryResultCachedVoice::Ptr parseJsonAndGetInlineQueryResultCachedVoice(const JsonValue& data) const;
 	std::string parseInlineQueryResultCachedVoice(const InlineQueryResultCachedVoice::Ptr& object) const;
+	void writeInlineQueryResultCachedVoice(JsonWriter& writer, const InlineQueryResultCachedVoice::Ptr& object) const;
 
-	InlineQueryResultArticle::Ptr parseJsonAndGetInlineQueryResultArticle(const boost::property_tree::ptree& data) const;
+	InlineQueryResultArticle::Ptr parseJsonAndGetInlineQueryResultArticle(const JsonValue& data) const;
 	std::string parseInlineQueryResultArticle(const InlineQueryResultArticle::Ptr& object) const;
+	void writeInlineQueryResultArticle(JsonWriter& writer, const InlineQueryResultArticle::Ptr& object) const;
 
-	InlineQueryResultAudio::Ptr parseJsonAndGetInlineQueryResultAudio(const boost::property_tree::ptree& data) const;
+	InlineQueryResultAudio::Ptr parseJsonAndGetInlineQueryResultAudio(const JsonValue& data) const;
 	std::string parseInlineQueryResultAudio(const InlineQueryResultAudio::Ptr& object) const;
+	void writeInlineQueryResultAudio(JsonWriter& writer, const InlineQueryResultAudio::Ptr& object) const;
 
-	InlineQueryResultContact::Ptr parseJsonAndGetInlineQueryResultContact(const boost::property_tree::ptree& data) const;
+	InlineQueryResultContact::Ptr parseJsonAndGetInlineQueryResultContact(const JsonValue& data) const;
 	std::string parseInlineQueryResultContact(const InlineQueryResultContact::Ptr& object) const;
+	void writeInlineQueryResultContact(JsonWriter& writer, const InlineQueryResultContact::Ptr& object) const;
 
-	InlineQueryResultGame::Ptr parseJsonAndGetInlineQueryResultGame(const boost::property_tree::ptree& data) const;
+	InlineQueryResultGame::Ptr parseJsonAndGetInlineQueryResultGame(const JsonValue& data) const;
 	std::string parseInlineQueryResultGame(const InlineQueryResultGame::Ptr& object) const;
+	void writeInlineQueryResultGame(JsonWriter& writer, const InlineQueryResultGame::Ptr& object) const;
 
-	InlineQueryResultDocument::Ptr parseJsonAndGetInlineQueryResultDocument(const boost::property_tree::ptree& data) const;
+	InlineQueryResultDocument::Ptr parseJsonAndGetInlineQueryResultDocument(const JsonValue& data) const;
 	std::string parseInlineQueryResultDocument(const InlineQueryResultDocument::Ptr& object) const;
+	void writeInlineQueryResultDocument(JsonWriter& writer, const InlineQueryResultDocument::Ptr& object) const;
 
-	InlineQueryResultLocation::Ptr parseJsonAndGetInlineQueryResultLocation(const boost::property_tree::ptree& data) const;
+	InlineQueryResultLocation::Ptr parseJsonAndGetInlineQueryResultLocation(const JsonValue& data) const;
 	std::string parseInlineQueryResultLocation(const InlineQueryResultLocation::Ptr& object) const;
+	void writeInlineQueryResultLocation(JsonWriter& writer, const InlineQueryResultLocation::Ptr& object) const;
 
-	InlineQueryResultVenue::Ptr parseJsonAndGetInlineQueryResultVenue(const boost::property_tree::ptree& data) const;
+	InlineQueryResultVenue::Ptr parseJsonAndGetInlineQueryResultVenue(const JsonValue& data) const;
 	std::string parseInlineQueryResultVenue(const InlineQueryResultVenue::Ptr& object) const;
+	void writeInlineQueryResultVenue(JsonWriter& writer, const InlineQueryResultVenue::Ptr& object) const;
 
-	InlineQueryResultVoice::Ptr parseJsonAndGetInlineQueryResultVoice(const boost::property_tree::ptree& data) const;
+	InlineQueryResultVoice::Ptr parseJsonAndGetInlineQueryResultVoice(const JsonValue& data) const;
 	std::string parseInlineQueryResultVoice(const InlineQueryResultVoice::Ptr& object) const;
+	void writeInlineQueryResultVoice(JsonWriter& writer, const InlineQueryResultVoice::Ptr& object) const;
 
-	InlineQueryResultPhoto::Ptr parseJsonAndGetInlineQueryResultPhoto(const boost::property_tree::ptree& data) const;
+	InlineQueryResultPhoto::Ptr parseJsonAndGetInlineQueryResultPhoto(const JsonValue& data) const;
 	std::string parseInlineQueryResultPhoto(const InlineQueryResultPhoto::Ptr& object) const;
-	InlineQueryResultGif::Ptr parseJsonAndGetInlineQueryResultGif(const boost::property_tree::ptree& data) const;
+	void writeInlineQueryResultPhoto(JsonWriter& writer, const InlineQueryResultPhoto::Ptr& object) const;
+	InlineQueryResultGif::Ptr parseJsonAndGetInlineQueryResultGif(const JsonValue& data) const;
 	std::string parseInlineQueryResultGif(const InlineQueryResultGif::Ptr& object) const;
-	InlineQueryResultMpeg4Gif::Ptr parseJsonAndGetInlineQueryResultMpeg4Gif(const boost::property_tree::ptree& data) const;
+	void writeInlineQueryResultGif(JsonWriter& writer, const InlineQueryResultGif::Ptr& object) const;
+	InlineQueryResultMpeg4Gif::Ptr parseJsonAndGetInlineQueryResultMpeg4Gif(const JsonValue& data) const;
 	std::string parseInlineQueryResultMpeg4Gif(const InlineQueryResultMpeg4Gif::Ptr& object) const;
-	InlineQueryResultVideo::Ptr parseJsonAndGetInlineQueryResultVideo(const boost::property_tree::ptree& data) const;
+	void writeInlineQueryResultMpeg4Gif(JsonWriter& writer, const InlineQueryResultMpeg4Gif::Ptr& object) const;
+	InlineQueryResultVideo::Ptr parseJsonAndGetInlineQueryResultVideo(const JsonValue& data) const;
 	std::string parseInlineQueryResultVideo(const InlineQueryResultVideo::Ptr& object) const;
-	ChosenInlineResult::Ptr parseJsonAndGetChosenInlineResult(const boost::property_tree::ptree& data) const;
+	void writeInlineQueryResultVideo(JsonWriter& writer, const InlineQueryResultVideo::Ptr& object) const;
+	ChosenInlineResult::Ptr parseJsonAndGetChosenInlineResult(const JsonValue& data) const;
 	std::string parseChosenInlineResult(const ChosenInlineResult::Ptr& object) const;
+	void writeChosenInlineResult(JsonWriter& writer, const ChosenInlineResult::Ptr& object) const;
 
-	CallbackQuery::Ptr parseJsonAndGetCallbackQuery(const boost::property_tree::ptree& data) const;
+	CallbackQuery::Ptr parseJsonAndGetCallbackQuery(const JsonValue& data) const;
 	std::string parseCallbackQuery(const CallbackQuery::Ptr& object) const;
-	InlineKeyboardMarkup::Ptr parseJsonAndGetInlineKeyboardMarkup(const boost::property_tree::ptree& data) const;
+	void writeCallbackQuery(JsonWriter& writer, const CallbackQuery::Ptr& object) const;
+	InlineKeyboardMarkup::Ptr parseJsonAndGetInlineKeyboardMarkup(const JsonValue& data) const;
 	std::string parseInlineKeyboardMarkup(const InlineKeyboardMarkup::Ptr& object) const;
-	InlineKeyboardButton::Ptr parseJsonAndGetInlineKeyboardButton(const boost::property_tree::ptree& data) const;
+	void writeInlineKeyboardMarkup(JsonWriter& writer, const InlineKeyboardMarkup::Ptr& object) const;
+	InlineKeyboardButton::Ptr parseJsonAndGetInlineKeyboardButton(const JsonValue& data) const;
 	std::string parseInlineKeyboardButton(const InlineKeyboardButton::Ptr& object) const;
+	void writeInlineKeyboardButton(JsonWriter& writer, const InlineKeyboardButton::Ptr& object) const;
 
-	WebhookInfo::Ptr parseJsonAndGetWebhookInfo(const boost::property_tree::ptree& data) const;
+	WebhookInfo::Ptr parseJsonAndGetWebhookInfo(const JsonValue& data) const;
 	std::string parseWebhookInfo(const WebhookInfo::Ptr& object) const;
+	void writeWebhookInfo(JsonWriter& writer, const WebhookInfo::Ptr& object) const;
 
-	InputMessageContent::Ptr parseJsonAndGetInputMessageContent(const boost::property_tree::ptree& data) const;
+	InputMessageContent::Ptr parseJsonAndGetInputMessageContent(const JsonValue& data) const;
 	std::string parseInputMessageContent(const InputMessageContent::Ptr& object) const;
+	void writeInputMessageContent(JsonWriter& writer, const InputMessageContent::Ptr& object) const;
 
-	InputTextMessageContent::Ptr parseJsonAndGetInputTextMessageContent(const boost::property_tree::ptree& data) const;
+	InputTextMessageContent::Ptr parseJsonAndGetInputTextMessageContent(const JsonValue& data) const;
 	std::string parseInputTextMessageContent(const InputTextMessageContent::Ptr& object) const;
+	void writeInputTextMessageContent(JsonWriter& writer, const InputTextMessageContent::Ptr& object) const;
 
-	InputLocationMessageContent::Ptr parseJsonAndGetInputLocationMessageContent(const boost::property_tree::ptree& data) const;
+	InputLocationMessageContent::Ptr parseJsonAndGetInputLocationMessageContent(const JsonValue& data) const;
 	std::string parseInputLocationMessageContent(const InputLocationMessageContent::Ptr& object) const;
+	void writeInputLocationMessageContent(JsonWriter& writer, const InputLocationMessageContent::Ptr& object) const;
 
-	InputVenueMessageContent::Ptr parseJsonAndGetInputVenueMessageContent(const boost::property_tree::ptree& data) const;
+	InputVenueMessageContent::Ptr parseJsonAndGetInputVenueMessageContent(const JsonValue& data) const;
 	std::string parseInputVenueMessageContent(const InputVenueMessageContent::Ptr& object) const;
+	void writeInputVenueMessageContent(JsonWriter& writer, const InputVenueMessageContent::Ptr& object) const;
 
-	InputContactMessageContent::Ptr parseJsonAndGetInputContactMessageContent(const boost::property_tree::ptree& data) const;
+	InputContactMessageContent::Ptr parseJsonAndGetInputContactMessageContent(const JsonValue& data) const;
 	std::string parseInputContactMessageContent(const InputContactMessageContent::Ptr& object) const;
+	void writeInputContactMessageContent(JsonWriter& writer, const InputContactMessageContent::Ptr& object) const;
 
-	Invoice::Ptr parseJsonAndGetInvoice(const boost::property_tree::ptree& data) const;
+	Invoice::Ptr parseJsonAndGetInvoice(const JsonValue& data) const;
 	std::string parseInvoice(const Invoice::Ptr& object) const;
+	void writeInvoice(JsonWriter& writer, const Invoice::Ptr& object) const;
 
-	LabeledPrice::Ptr parseJsonAndGetLabeledPrice(const boost::property_tree::ptree& data) const;
+	LabeledPrice::Ptr parseJsonAndGetLabeledPrice(const JsonValue& data) const;
 	std::string parseLabeledPrice(const LabeledPrice::Ptr& object) const;
+	void writeLabeledPrice(JsonWriter& writer, const LabeledPrice::Ptr& object) const;
 
-	OrderInfo::Ptr parseJsonAndGetOrderInfo(const boost::property_tree::ptree& data) const;
+	OrderInfo::Ptr parseJsonAndGetOrderInfo(const JsonValue& data) const;
 	std::string parseOrderInfo(const OrderInfo::Ptr& object) const;
+	void writeOrderInfo(JsonWriter& writer, const OrderInfo::Ptr& object) const;
 
-	PreCheckoutQuery::Ptr parseJsonAndGetPreCheckoutQuery(const boost::property_tree::ptree& data) const;
+	PreCheckoutQuery::Ptr parseJsonAndGetPreCheckoutQuery(const JsonValue& data) const;
 	std::string parsePreCheckoutQuery(const PreCheckoutQuery::Ptr& object) const;
+	void writePreCheckoutQuery(JsonWriter& writer, const PreCheckoutQuery::Ptr& object) const;
 
-	ShippingAddress::Ptr parseJsonAndGetShippingAddress(const boost::property_tree::ptree& data) const;
+	ShippingAddress::Ptr parseJsonAndGetShippingAddress(const JsonValue& data) const;
 	std::string parseShippingAddress(const ShippingAddress::Ptr& object) const;
+	void writeShippingAddress(JsonWriter& writer, const ShippingAddress::Ptr& object) const;
 
-	ShippingOption::Ptr parseJsonAndGetShippingOption(const boost::property_tree::ptree& data) const;
+	ShippingOption::Ptr parseJsonAndGetShippingOption(const JsonValue& data) const;
 	std::string parseShippingOption(const ShippingOption::Ptr& object) const;
+	void writeShippingOption(JsonWriter& writer, const ShippingOption::Ptr& object) const;
 
-	ShippingQuery::Ptr parseJsonAndGetShippingQuery(const boost::property_tree::ptree& data) const;
+	ShippingQuery::Ptr parseJsonAndGetShippingQuery(const JsonValue& data) const;
 	std::string parseShippingQuery(const ShippingQuery::Ptr& object) const;
+	void writeShippingQuery(JsonWriter& writer, const ShippingQuery::Ptr& object) const;
 
-	SuccessfulPayment::Ptr parseJsonAndGetSucessfulPayment(const boost::property_tree::ptree& data) const;
+	SuccessfulPayment::Ptr parseJsonAndGetSucessfulPayment(const JsonValue& data) const;
 	std::string parseSucessfulPayment(const SuccessfulPayment::Ptr& object) const;
+	void writeSucessfulPayment(JsonWriter& writer, const SuccessfulPayment::Ptr& object) const;
 
-	inline boost::property_tree::ptree parseJson(const std::string& json) const {
-		boost::property_tree::ptree tree;
-		std::istringstream input(json);
-		boost::property_tree::read_json(input, tree);
-		return tree;
+	inline JsonValue::Ptr parseJson(std::string json) const {
+		return JsonDocument::parse(std::move(json));
 	}
 
+	/**
+	 * Checks a response of Bot API without parsing it into a document. It stops as soon as it finds "ok" and "message_id" of the result,
+	 * which are the first members in responses of Telegram.
+	 * @param messageId Set to "message_id" of the result, or 0 if the result isn't a message.
+	 * @return Value of "ok". False if it's missing.
+	 */
+	bool scanResponse(boost::string_ref json, int32_t& messageId) const;
+
 	template<typename T>
-	std::shared_ptr<T> tryParseJson(JsonToTgTypeFunc<T> parseFunc, const boost::property_tree::ptree& data, const std::string& keyName) const {
-		auto treeItem = data.find(keyName);
-		if (treeItem == data.not_found()) {
+	std::shared_ptr<T> tryParseJson(JsonToTgTypeFunc<T> parseFunc, const JsonValue& data, boost::string_ref keyName) const {
+		const JsonValue* item = data.find(keyName);
+		if (item == nullptr || item->isNull()) {
 			return std::shared_ptr<T>();
 		}
-		return (this->*parseFunc)(treeItem->second);
+		return (this->*parseFunc)(*item);
 	}
 
 	template<typename T>
-	std::vector<std::shared_ptr<T>> parseJsonAndGetArray(JsonToTgTypeFunc<T> parseFunc, const boost::property_tree::ptree& data) const {
+	std::vector<std::shared_ptr<T>> parseJsonAndGetArray(JsonToTgTypeFunc<T> parseFunc, const JsonValue& data) const {
 		std::vector<std::shared_ptr<T>> result;
-		for (const std::pair<const std::string, boost::property_tree::ptree>& innerTreeItem : data) {
-			result.push_back((this->*parseFunc)(innerTreeItem.second));
+		result.reserve(data.size());
+		for (const JsonValue& innerItem : data) {
+			result.push_back((this->*parseFunc)(innerItem));
 		}
 		return result;
 	}
 
 	template<typename T>
-	std::vector<T> parseJsonAndGetArray(std::function<T(const boost::property_tree::ptree&)> parseFunc, const boost::property_tree::ptree& data, const std::string& keyName) const {
+	std::vector<T> parseJsonAndGetArray(std::function<T(const JsonValue&)> parseFunc, const JsonValue& data, boost::string_ref keyName) const {
 		std::vector<T> result;
-		auto treeItem = data.find(keyName);
-		if (treeItem == data.not_found()) {
+		const JsonValue* item = data.find(keyName);
+		if (item == nullptr) {
 			return result;
 		}
-		for (const std::pair<const std::string, boost::property_tree::ptree>& innerTreeItem : treeItem->second) {
-			result.push_back(parseFunc(innerTreeItem.second));
+		result.reserve(item->size());
+		for (const JsonValue& innerItem : *item) {
+			result.push_back(parseFunc(innerItem));
 		}
 		return result;
 	}
 
 	template<typename T>
-	std::vector<std::shared_ptr<T>> parseJsonAndGetArray(JsonToTgTypeFunc<T> parseFunc, const boost::property_tree::ptree& data, const std::string& keyName) const {
-		std::vector<std::shared_ptr<T>> result;
-		auto treeItem = data.find(keyName);
-		if (treeItem == data.not_found()) {
-			return result;
-		}
-		for (const std::pair<const std::string, boost::property_tree::ptree>& innerTreeItem : treeItem->second) {
-			result.push_back((this->*parseFunc)(innerTreeItem.second));
+	std::vector<std::shared_ptr<T>> parseJsonAndGetArray(JsonToTgTypeFunc<T> parseFunc, const JsonValue& data, boost::string_ref keyName) const {
+		const JsonValue* item = data.find(keyName);
+		if (item == nullptr) {
+			return std::vector<std::shared_ptr<T>>();
 		}
-		return result;
+		return parseJsonAndGetArray(parseFunc, *item);
 	}
 
 	template<typename T>
-	std::vector<std::vector<std::shared_ptr<T>>> parseJsonAndGet2DArray(JsonToTgTypeFunc<T> parseFunc, const boost::property_tree::ptree& data, const std::string& keyName) const {
+	std::vector<std::vector<std::shared_ptr<T>>> parseJsonAndGet2DArray(JsonToTgTypeFunc<T> parseFunc, const JsonValue& data, boost::string_ref keyName) const {
 		std::vector<std::vector<std::shared_ptr<T>>> result;
-		auto treeItem = data.find(keyName);
-		if (treeItem == data.not_found()) {
+		const JsonValue* item = data.find(keyName);
+		if (item == nullptr) {
 			return result;
 		}
-		for (const std::pair<const std::string, boost::property_tree::ptree>& innerTreeItem : treeItem->second) {
-			std::vector<std::shared_ptr<T>> innerResult;
-			for (const std::pair<const std::string, boost::property_tree::ptree>& innerInnerTreeItem : innerTreeItem.second) {
-				innerResult.push_back((this->*parseFunc)(innerInnerTreeItem.second));
-			}
-			result.push_back(innerResult);
+		result.reserve(item->size());
+		for (const JsonValue& innerItem : *item) {
+			result.push_back(parseJsonAndGetArray(parseFunc, innerItem));
 		}
 		return result;
 	}
 
+	template<typename T, JsonToTgTypeFunc<T> parseFunc>
+	void tryParseJsonLazily(Lazy<std::shared_ptr<T>>& field, const JsonValue& data, boost::string_ref keyName, const JsonValue::Ptr& document) const {
+		const JsonValue* item = data.find(keyName);
+		if (item == nullptr || item->isNull()) {
+			field = nullptr;
+		} else if (document) {
+			field.setSource(JsonValue::Ptr(document, item), &decodeLazily<T, parseFunc>);
+		} else {
+			field = (this->*parseFunc)(*item);
+		}
+	}
+
+	template<typename T, JsonToTgTypeFunc<T> parseFunc>
+	void parseJsonAndGetArrayLazily(Lazy<std::vector<std::shared_ptr<T>>>& field, const JsonValue& data, boost::string_ref keyName, const JsonValue::Ptr& document) const {
+		const JsonValue* item = data.find(keyName);
+		if (item == nullptr) {
+			field = std::vector<std::shared_ptr<T>>();
+		} else if (document) {
+			field.setSource(JsonValue::Ptr(document, item), &decodeArrayLazily<T, parseFunc>);
+		} else {
+			field = parseJsonAndGetArray(parseFunc, *item);
+		}
+	}
+
+	/**
+	 * Serializes an object with the given write function into a new string. Empty string is returned for null objects.
+	 */
+	template<typename T>
+	std::string toJson(TgTypeToJsonWriterFunc<T> writeFunc, const std::shared_ptr<T>& object) const {
+		std::string result;
+		if (object) {
+			JsonWriter writer(result);
+			(this->*writeFunc)(writer, object);
+		}
+		return result;
+	}
+
+	template<typename T>
+	void writeArray(JsonWriter& writer, TgTypeToJsonWriterFunc<T> writeFunc, const std::vector<std::shared_ptr<T>>& objects) const {
+		writer.startArray();
+		for (const std::shared_ptr<T>& item : objects) {
+			(this->*writeFunc)(writer, item);
+		}
+		writer.endArray();
+	}
+
+	void writeArray(JsonWriter& writer, const std::vector<std::string>& objects) const {
+		writer.startArray();
+		for (const std::string& item : objects) {
+			writer.value(item);
+		}
+		writer.endArray();
+	}
+
+	template<typename T>
+	void write2DArray(JsonWriter& writer, TgTypeToJsonWriterFunc<T> writeFunc, const std::vector<std::vector<std::shared_ptr<T>>>& objects) const {
+		writer.startArray();
+		for (const std::vector<std::shared_ptr<T>>& item : objects) {
+			writeArray(writer, writeFunc, item);
+		}
+		writer.endArray();
+	}
+
 	template<typename T>
 	std::string parseArray(TgTypeToJsonFunc<T> parseFunc, const std::vector<std::shared_ptr<T>>& objects) const {
 		if (objects.empty())
 			return "";
 		std::string result;
-		result += '[';
+		JsonWriter writer(result);
+		writer.startArray();
 		for (const std::shared_ptr<T>& item : objects) {
-			result += (this->*parseFunc)(item);
-			result += ',';
+			writer.rawValue((this->*parseFunc)(item));
 		}
-		result.erase(result.length() - 1);
-		result += ']';
+		writer.endArray();
 		return result;
 	}
 
@@ -298,13 +441,12 @@ public:
 		if (objects.empty())
 			return "";
 		std::string result;
-		result += '[';
+		JsonWriter writer(result);
+		writer.startArray();
 		for (const T& item : objects) {
-			result += parseFunc(item);
-			result += ',';
+			writer.rawValue(parseFunc(item));
 		}
-		result.erase(result.length() - 1);
-		result += ']';
+		writer.endArray();
 		return result;
 	}
 
@@ -313,38 +455,74 @@ public:
 		if (objects.empty())
 			return "";
 		std::string result;
-		result += '[';
+		JsonWriter writer(result);
+		writer.startArray();
 		for (const std::vector<std::shared_ptr<T>>& item : objects) {
-			result += parseArray(parseFunc, item);
-			result += ',';
+			writer.rawValue(parseArray(parseFunc, item));
 		}
-		result.erase(result.length() - 1);
-		result += ']';
+		writer.endArray();
 		return result;
 	}
 
 private:
+	template<typename T, JsonToTgTypeFunc<T> parseFunc>
+	static std::shared_ptr<T> decodeLazily(const JsonValue& data) {
+		return (getInstance().*parseFunc)(data);
+	}
+
+	template<typename T, JsonToTgTypeFunc<T> parseFunc>
+	static std::vector<std::shared_ptr<T>> decodeArrayLazily(const JsonValue& data) {
+		return getInstance().parseJsonAndGetArray(parseFunc, data);
+	}
+
+	std::atomic<bool> _isLazyDecoding{false};
+
+	// Members with zero, empty or null values are omitted.
 	template<typename T>
-	void appendToJson(std::string& json, const std::string& varName, const T& value) const {
+	void appendToJson(JsonWriter& writer, boost::string_ref varName, const T& value) const {
 		if (value == 0) {
 			return;
 		}
-		json += '"';
-		json += varName;
-		json += "\":";
-		json += value;
-		json += ',';
+		writer.key(varName).value(value);
+	}
+
+	void appendToJson(JsonWriter& writer, boost::string_ref varName, bool value) const {
+		writer.key(varName).value(value);
+	}
+
+	void appendToJson(JsonWriter& writer, boost::string_ref varName, const std::string& value) const {
+		if (value.empty()) {
+			return;
+		}
+		writer.key(varName).value(value);
+	}
+
+	template<typename T>
+	void appendToJson(JsonWriter& writer, boost::string_ref varName, TgTypeToJsonWriterFunc<T> writeFunc, const std::shared_ptr<T>& object) const {
+		if (!object) {
+			return;
+		}
+		writer.key(varName);
+		(this->*writeFunc)(writer, object);
 	}
 
-	void appendToJson(std::string& json, const std::string& varName, const bool& value) const {
-		json += '"';
-		json += varName;
-		json += "\":";
-		json += (value ? "true" : "false");
-		json += ',';
+	template<typename T>
+	void appendToJson(JsonWriter& writer, boost::string_ref varName, TgTypeToJsonWriterFunc<T> writeFunc, const std::vector<std::shared_ptr<T>>& objects) const {
+		if (objects.empty()) {
+			return;
+		}
+		writer.key(varName);
+		writeArray(writer, writeFunc, objects);
 	}
 
-	void appendToJson(std::string& json, const std::string& varName, const std::string& value) const;
+	template<typename T>
+	void appendToJson(JsonWriter& writer, boost::string_ref varName, TgTypeToJsonWriterFunc<T> writeFunc, const std::vector<std::vector<std::shared_ptr<T>>>& objects) const {
+		if (objects.empty()) {
+			return;
+		}
+		writer.key(varName);
+		write2DArray(writer, writeFunc, objects);
+	}
 };
 
 }
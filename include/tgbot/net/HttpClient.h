@@ -25,36 +25,200 @@
 #define TGBOT_HTTPCLIENT_H
 
 #include <string>
+#include <map>
+#include <list>
+#include <deque>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <future>
+#include <chrono>
+#include <atomic>
+#include <functional>
 
 #include <boost/asio.hpp>
+#include <boost/asio/ssl.hpp>
+#include <boost/asio/steady_timer.hpp>
 
 #include "tgbot/net/Url.h"
 #include "tgbot/net/HttpReqArg.h"
 #include "tgbot/net/HttpParser.h"
+#include "tgbot/net/HttpResponseParser.h"
 
 namespace TgBot {
 
 /**
  * This class makes http requests.
+ * All network operations are asynchronous and run on a pool of worker threads, so a lot of requests can be in flight at the same time.
+ * Connections are kept alive and reused by subsequent requests to the same host.
  * @ingroup net
  */
 class HttpClient {
 
 public:
+	/**
+	 * Handler which is called when a request is completed.
+	 * It's called from one of worker threads, so it shouldn't block. Exceptions thrown from it are ignored.
+	 * @param error Error which occurred during the request. Empty if the request succeeded.
+	 * @param response Body of the response.
+	 */
+	typedef std::function<void (const boost::system::error_code& error, std::string&& response)> ResponseHandler;
+
 	/**
 	 * Returns instance which lives during all application lifetime.
 	 */
 	static HttpClient& getInstance();
 
+	HttpClient();
+	~HttpClient();
+
 	/**
-	 * Sends a request to the url.
+	 * Sends a request to the url and waits for the response.
 	 * If there's no args specified, a GET request will be sent, otherwise a POST request will be sent.
-	 * If at least 1 arg is marked as file, the content type of a request will be multipart/form-data, otherwise it will be application/x-www-form-urlencoded.
+	 * If at least 1 arg is marked as file, the content type of a request will be multipart/form-data, otherwise it's chosen by bodyEncoding.
+	 * Must not be called from a ResponseHandler.
+	 */
+	std::string makeRequest(const Url& url, const std::vector<HttpReqArg>& args, HttpParser::BodyEncoding bodyEncoding = HttpParser::BodyEncoding::WwwFormUrlencoded);
+
+	/**
+	 * Sends a request to the url and returns immediately. The handler is called when the response is received or an error occurs.
+	 * Args are handled in the same way as in makeRequest.
+	 */
+	void makeRequestAsync(const Url& url, const std::vector<HttpReqArg>& args, const ResponseHandler& handler, HttpParser::BodyEncoding bodyEncoding = HttpParser::BodyEncoding::WwwFormUrlencoded);
+
+	/**
+	 * Sends a request to the url and returns immediately. Pieces of the response body are passed to bodyHandler as soon as they are received, the response passed to handler is empty then.
+	 * Both handlers are called on a worker thread. If the bodyHandler throws, the request is aborted, its connection is closed
+	 * and handler gets boost::system::errc::operation_canceled.
+	 */
+	void makeRequestAsync(const Url& url, const std::vector<HttpReqArg>& args, const HttpResponseParser::BodyHandler& bodyHandler, const ResponseHandler& handler, HttpParser::BodyEncoding bodyEncoding = HttpParser::BodyEncoding::WwwFormUrlencoded);
+
+	/**
+	 * Same as the previous method, but headersHandler also gets the status and headers of the response before any piece of the body.
+	 * It's called on a worker thread. If it throws, the request is aborted like when the bodyHandler throws.
+	 */
+	void makeRequestAsync(const Url& url, const std::vector<HttpReqArg>& args, const HttpResponseParser::HeadersHandler& headersHandler, const HttpResponseParser::BodyHandler& bodyHandler, const ResponseHandler& handler, HttpParser::BodyEncoding bodyEncoding = HttpParser::BodyEncoding::WwwFormUrlencoded);
+
+	/**
+	 * Sends a request to the url and returns immediately.
+	 * Args are handled in the same way as in makeRequest.
+	 * @return Future which holds the body of the response or boost::system::system_error.
+	 */
+	std::future<std::string> makeRequestAsync(const Url& url, const std::vector<HttpReqArg>& args, HttpParser::BodyEncoding bodyEncoding = HttpParser::BodyEncoding::WwwFormUrlencoded);
+
+	/**
+	 * Sends a complete request text, e.g. one generated with HttpParser::generateRequestHead, and waits for the response.
+	 * Must not be called from a ResponseHandler.
+	 */
+	std::string makeRequest(const Url& url, std::string&& requestText);
+
+	/**
+	 * Sends a complete request text and returns immediately. The handler is called when the response is received or an error occurs.
+	 */
+	void makeRequestAsync(const Url& url, std::string&& requestText, const ResponseHandler& handler);
+
+	/**
+	 * Sends a prepared request text, passing the response to headersHandler and bodyHandler as it arrives. See makeRequestAsync with args.
+	 */
+	void makeRequestAsync(const Url& url, std::string&& requestText, const HttpResponseParser::HeadersHandler& headersHandler, const HttpResponseParser::BodyHandler& bodyHandler, const ResponseHandler& handler);
+
+	/**
+	 * Sets the number of worker threads which perform network operations and call handlers. Defaults to 1.
+	 * The pool can only grow, so values lower than the current number of threads are ignored.
+	 */
+	void setWorkerThreadCount(size_t count);
+
+	/**
+	 * Sets the maximum number of connections which can be opened to one host at the same time.
+	 * If all of them are busy, requests wait until one of them is released. Defaults to 8.
+	 */
+	void setMaxConnectionsPerHost(size_t count);
+
+	/**
+	 * Sets the number of seconds after which an unused connection is closed. Defaults to 60.
+	 * Idle connections are checked every second.
 	 */
-	std::string makeRequest(const Url& url, const std::vector<HttpReqArg>& args);
+	void setIdleTimeout(int32_t seconds);
+
+	/**
+	 * Sets the number of seconds which one network operation of a request may take, e.g. connecting or waiting for the next piece
+	 * of the response. When it's over, the request fails with boost::system::errc::timed_out. Defaults to 150.
+	 * It must be longer than the timeout of long polling, since the server doesn't respond until updates arrive.
+	 */
+	void setRequestTimeout(int32_t seconds);
+
+	/**
+	 * @return Number of TLS handshakes which were made without resuming a previous session.
+	 */
+	inline uint64_t getFullHandshakeCount() const {
+		return _fullHandshakeCount;
+	}
+
+	/**
+	 * @return Number of TLS handshakes which resumed a previous session with the same host.
+	 */
+	inline uint64_t getResumedHandshakeCount() const {
+		return _resumedHandshakeCount;
+	}
 
 private:
+	class Request;
+
+	class Connection {
+
+	public:
+		Connection(boost::asio::io_service& ioService, boost::asio::ssl::context& context, const std::string& sessionKey) : socket(ioService, context), sessionKey(sessionKey) {
+		}
+
+		~Connection() {
+			// OpenSSL forbids resuming a session of a connection which wasn't shut down, so mark it as such before closing the socket.
+			if (SSL_is_init_finished(socket.native_handle())) {
+				SSL_shutdown(socket.native_handle());
+				ERR_clear_error();
+			}
+		}
+
+		boost::asio::ssl::stream<boost::asio::ip::tcp::socket> socket;
+		std::chrono::steady_clock::time_point lastUsed;
+		const std::string sessionKey;
+		char readBuffer[16384];
+	};
+
+	struct HostPool {
+		std::list<std::shared_ptr<Connection>> idleConnections;
+		std::deque<std::shared_ptr<Request>> waitingRequests;
+		size_t openedCount = 0;
+	};
+
+	void acquireConnection(const std::shared_ptr<Request>& request);
+	void releaseConnection(const std::string& poolKey, std::shared_ptr<Connection> connection, bool isReusable);
+	void startWaitingRequests(HostPool& pool);
+	void scheduleIdleCheck();
+	void closeIdleConnections();
+
+	static int onNewSslSession(SSL* ssl, SSL_SESSION* session);
+	void storeSslSession(const std::string& sessionKey, SSL_SESSION* session);
+	void resumeSslSession(Connection& connection);
+
 	boost::asio::io_service _ioService;
+	std::unique_ptr<boost::asio::io_service::work> _ioServiceWork;
+	std::mutex _workersMutex;
+	std::vector<std::thread> _workers;
+
+	boost::asio::ssl::context _sslContext;
+
+	std::mutex _poolMutex;
+	std::map<std::string, HostPool> _pools;
+	size_t _maxConnectionsPerHost = 8;
+	std::chrono::steady_clock::duration _idleTimeout = std::chrono::seconds(60);
+	std::atomic<int32_t> _requestTimeout;
+	boost::asio::steady_timer _idleTimer;
+
+	std::mutex _sslSessionsMutex;
+	std::map<std::string, SSL_SESSION*> _sslSessions;
+	std::atomic<uint64_t> _fullHandshakeCount;
+	std::atomic<uint64_t> _resumedHandshakeCount;
 };
 
 }
@@ -24,10 +24,14 @@
 #ifndef TGBOT_HTTPPARSER_H
 #define TGBOT_HTTPPARSER_H
 
+#include <cstdint>
 #include <string>
 #include <map>
+#include <memory>
 #include <vector>
 
+#include <boost/utility/string_ref.hpp>
+
 #include "tgbot/net/Url.h"
 #include "tgbot/net/HttpReqArg.h"
 
@@ -36,12 +40,70 @@ namespace TgBot {
 class HttpParser {
 
 public:
+	/**
+	 * Encoding of a request body without file args. Requests with files are always sent as multipart/form-data.
+	 */
+	enum class BodyEncoding {
+		WwwFormUrlencoded, Json
+	};
+
+	/**
+	 * File contents which are sent at an offset of a request text instead of being copied into it.
+	 */
+	struct FilePart {
+		size_t offset;
+		size_t size;
+
+		/**
+		 * Contents held in memory, which are kept alive by owner. Not set for streamed files.
+		 */
+		boost::string_ref data;
+		std::shared_ptr<const void> owner;
+
+		/**
+		 * Path of a file which is read in chunks while it's sent, when data isn't set.
+		 */
+		std::string path;
+	};
+
 	static HttpParser& getInstance();
 
-	std::string generateRequest(const Url& url, const std::vector<HttpReqArg>& args, bool isKeepAlive = false);
+	std::string generateRequest(const Url& url, const std::vector<HttpReqArg>& args, bool isKeepAlive = false, BodyEncoding bodyEncoding = BodyEncoding::WwwFormUrlencoded);
+
+	/**
+	 * Generates a request without copying referenced file contents of args (see HttpReqArg::isFileReferenced).
+	 * They're added to fileParts instead, ordered by offsets in the returned text, and must be sent in between its pieces.
+	 */
+	std::string generateRequest(const Url& url, const std::vector<HttpReqArg>& args, std::vector<FilePart>& fileParts, bool isKeepAlive = false, BodyEncoding bodyEncoding = BodyEncoding::WwwFormUrlencoded);
+
+	/**
+	 * Generates the head of a POST request. The body is appended to the output by the caller afterwards, so it isn't copied.
+	 * Content-Length is filled in by completeRequest once the body is written.
+	 * @param relativePath Path which is appended to the path of the url, so a base url can be reused for many methods.
+	 * @param bodySize Expected size of the body, which is reserved in the output.
+	 * @return Offset of the body in the output.
+	 */
+	size_t generateRequestHead(std::string& output, const Url& url, boost::string_ref relativePath, const std::string& contentType, bool isKeepAlive = false, size_t bodySize = 0);
+
+	/**
+	 * Fills in Content-Length of a request generated by generateRequestHead.
+	 */
+	void completeRequest(std::string& output, size_t bodyOffset);
+
+	/**
+	 * Generates a GET request for the bytes from firstByte to lastByte inclusive.
+	 */
+	std::string generateRangeRequest(const Url& url, uint64_t firstByte, uint64_t lastByte, bool isKeepAlive = false);
+
 	std::string generateMultipartFormData(const std::vector<HttpReqArg>& args, const std::string& bondary);
+	std::string generateMultipartFormData(const std::vector<HttpReqArg>& args, const std::string& bondary, std::vector<FilePart>& fileParts);
 	std::string generateMultipartBoundary(const std::vector<HttpReqArg>& args);
 	std::string generateWwwFormUrlencoded(const std::vector<HttpReqArg>& args);
+
+	/**
+	 * Generates one json object with a member for each arg. Values of args marked as json are embedded as is, other values are written as strings.
+	 */
+	std::string generateJson(const std::vector<HttpReqArg>& args);
 	std::string generateResponse(const std::string& data, const std::string& mimeType = "text/plain", short unsigned statusCode = 200, const std::string& statusStr = "OK", bool isKeepAlive = false);
 
 	inline std::string parseRequest(const std::string& data, std::map<std::string, std::string>& headers) {
@@ -61,6 +123,10 @@ public:
 	}
 
 private:
+	static std::string insertFileParts(const std::string& text, const std::vector<FilePart>& fileParts);
+	static size_t getJsonSize(const std::vector<HttpReqArg>& args);
+	static void writeJson(std::string& output, const std::vector<HttpReqArg>& args);
+
 	std::string parseHttp(bool isRequest, const std::string& data, std::map<std::string, std::string>& headers);
 	std::string parseHttp(bool isRequest, const std::string& data);
 };
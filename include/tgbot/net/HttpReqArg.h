@@ -26,9 +26,15 @@
 
 #include <string>
 #include <vector>
+#include <memory>
 #include <functional>
+#include <type_traits>
+#include <utility>
 
 #include <boost/lexical_cast.hpp>
+#include <boost/utility/string_ref.hpp>
+
+#include "tgbot/types/InputFile.h"
 
 namespace TgBot {
 
@@ -40,9 +46,48 @@ class HttpReqArg {
 
 public:
 	template<typename T>
-	HttpReqArg(const std::string& name, const T& value, bool isFile = false, const std::string& mimeType = "text/plain", const std::string& fileName = "") :
-			name(name), value(boost::lexical_cast<std::string>(value)), isFile(isFile), mimeType(mimeType), fileName(fileName)
+	HttpReqArg(std::string name, const T& value, bool isFile = false, std::string mimeType = "text/plain", std::string fileName = "") :
+			name(std::move(name)), value(toString(value)), isFile(isFile), mimeType(std::move(mimeType)), fileName(std::move(fileName)), isJson(std::is_arithmetic<T>::value)
+	{
+	}
+
+	/**
+	 * Creates an argument with a string value, which is moved instead of being converted.
+	 * Pass long texts and generated json with std::move, so they aren't copied until the request is written.
+	 */
+	HttpReqArg(std::string name, std::string value, bool isFile = false, std::string mimeType = "text/plain", std::string fileName = "") :
+			name(std::move(name)), value(std::move(value)), isFile(isFile), mimeType(std::move(mimeType)), fileName(std::move(fileName))
+	{
+	}
+
+	/**
+	 * Creates a file argument which references the contents instead of copying them.
+	 * The buffer may be shared or borrowed (a pointer without an owner), but it must stay unchanged until the request is sent.
+	 */
+	HttpReqArg(std::string name, std::shared_ptr<const std::string> data, std::string mimeType, std::string fileName) :
+			name(std::move(name)), isFile(true), mimeType(std::move(mimeType)), fileName(std::move(fileName)), fileData(*data), fileOwner(std::move(data))
+	{
+	}
+
+	/**
+	 * Creates a file argument which references the contents of an InputFile, whether they're held in memory, mapped or streamed.
+	 * The file is kept alive by the argument.
+	 */
+	HttpReqArg(std::string name, const InputFile::Ptr& file) :
+			name(std::move(name)), isFile(true), mimeType(file->mimeType), fileName(file->fileName), fileOwner(file), filePath(file->filePath), fileSize(file->fileSize)
 	{
+		if (file->mappedRegion) {
+			fileData = boost::string_ref(static_cast<const char*>(file->mappedRegion->get_address()), file->mappedRegion->get_size());
+		} else if (filePath.empty()) {
+			fileData = file->data;
+		}
+	}
+
+	/**
+	 * Returns true if the contents of a file argument are referenced instead of being held in value.
+	 */
+	inline bool isFileReferenced() const {
+		return fileData.data() != nullptr || !filePath.empty();
 	}
 
 	/**
@@ -69,6 +114,42 @@ public:
 	 * Should be set if an argument value hold some file contents
 	 */
 	std::string fileName;
+
+	/**
+	 * Should be true if an argument value holds serialized json, which is embedded as is into json request bodies instead of being sent as a string.
+	 * Numbers and booleans are marked automatically.
+	 */
+	bool isJson = false;
+
+	/**
+	 * Referenced contents of a file, which are used instead of value when set.
+	 */
+	boost::string_ref fileData;
+
+	/**
+	 * Keeps referenced contents of a file alive. Borrowed contents don't have an owner.
+	 */
+	std::shared_ptr<const void> fileOwner;
+
+	/**
+	 * Path of a file which is read in chunks while the request is sent, instead of using value.
+	 */
+	std::string filePath;
+
+	/**
+	 * Size of a file at filePath.
+	 */
+	size_t fileSize = 0;
+
+private:
+	template<typename T>
+	static std::string toString(const T& value) {
+		return boost::lexical_cast<std::string>(value);
+	}
+
+	static std::string toString(bool value) {
+		return value ? "true" : "false";
+	}
 };
 
 }
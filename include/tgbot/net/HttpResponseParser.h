@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2015 Oleg Morozenkov
+ * Copyright (c) 2017 Maks Mazurov (fox.cpp)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef TGBOT_HTTPRESPONSEPARSER_H
+#define TGBOT_HTTPRESPONSEPARSER_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <map>
+
+namespace TgBot {
+
+/**
+ * This class incrementally parses http responses as they arrive from a socket.
+ * The body length is taken from the Content-Length header or from chunked transfer encoding, so the end of the response is known without waiting for the connection to be closed.
+ * @ingroup net
+ */
+class HttpResponseParser {
+
+public:
+	enum class State {
+		StatusLine, Headers, Body, BodyUntilClose, ChunkSize, ChunkData, ChunkDataEnd, Trailers, Complete, Error
+	};
+
+	typedef std::function<void (const char* data, size_t length)> BodyHandler;
+	typedef std::function<void (const HttpResponseParser& parser)> HeadersHandler;
+
+	/**
+	 * Sets a function which is called once the status line and headers are parsed, before any piece of the body.
+	 * The handler is kept when the parser is reset.
+	 */
+	inline void setHeadersHandler(const HeadersHandler& handler) {
+		_headersHandler = handler;
+	}
+
+	/**
+	 * Sets a function which receives pieces of the body as they arrive. If it's set, the body isn't collected and getBody returns an empty string.
+	 * The handler is kept when the parser is reset.
+	 */
+	inline void setBodyHandler(const BodyHandler& handler) {
+		_bodyHandler = handler;
+	}
+
+	/**
+	 * Prepares the parser for the next response.
+	 */
+	void reset();
+
+	/**
+	 * Parses the next portion of the response.
+	 * @param data Received data.
+	 * @param length Length of received data.
+	 * @return Number of bytes consumed. It's less than length only if the response is complete or malformed.
+	 */
+	size_t feed(const char* data, size_t length);
+
+	/**
+	 * Tells the parser that the connection is closed. Completes the response if its body lasts until the connection is closed.
+	 */
+	void finish();
+
+	/**
+	 * @return True if the whole response is received.
+	 */
+	inline bool isComplete() const {
+		return _state == State::Complete;
+	}
+
+	/**
+	 * @return True if the response is malformed.
+	 */
+	inline bool hasError() const {
+		return _state == State::Error;
+	}
+
+	/**
+	 * @return True if the connection can be used for the next request after this response.
+	 */
+	inline bool isKeepAlive() const {
+		return _isKeepAlive;
+	}
+
+	inline State getState() const {
+		return _state;
+	}
+
+	inline unsigned short getStatusCode() const {
+		return _statusCode;
+	}
+
+	/**
+	 * @return Length of the body from Content-Length, or 0 if it isn't known in advance.
+	 */
+	inline uint64_t getContentLength() const {
+		return _contentLength;
+	}
+
+	/**
+	 * @return Response headers. Names are in lower case.
+	 */
+	inline const std::map<std::string, std::string>& getHeaders() const {
+		return _headers;
+	}
+
+	inline std::string& getBody() {
+		return _body;
+	}
+
+	inline const std::string& getBody() const {
+		return _body;
+	}
+
+private:
+	bool readLine(const char* data, size_t length, size_t& position);
+	void processLine();
+	void processStatusLine();
+	void processHeaderLine();
+	void processHeadersEnd();
+	void processChunkSizeLine();
+	void appendBody(const char* data, size_t length);
+
+	State _state = State::StatusLine;
+	std::string _line;
+	size_t _remainingLength = 0;
+	uint64_t _contentLength = 0;
+	bool _isKeepAlive = false;
+	bool _isHttp11 = false;
+	unsigned short _statusCode = 0;
+	std::map<std::string, std::string> _headers;
+	std::string _body;
+	BodyHandler _bodyHandler;
+	HeadersHandler _headersHandler;
+};
+
+}
+
+#endif //TGBOT_HTTPRESPONSEPARSER_H
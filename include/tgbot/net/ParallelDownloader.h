@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2015 Oleg Morozenkov
+ * Copyright (c) 2017 Maks Mazurov (fox.cpp)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef TGBOT_PARALLELDOWNLOADER_H
+#define TGBOT_PARALLELDOWNLOADER_H
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+#include "tgbot/net/Url.h"
+
+namespace TgBot {
+
+/**
+ * Downloads a file by several concurrent range requests over pooled connections, writing the parts into a memory mapped output file.
+ * If the server doesn't support ranges, the file is downloaded by a single request.
+ * @ingroup net
+ */
+class ParallelDownloader {
+
+public:
+	/**
+	 * Receives the number of downloaded bytes and the size of a file, which is 0 if the server didn't tell it.
+	 */
+	typedef std::function<void (uint64_t downloadedSize, uint64_t fileSize)> ProgressHandler;
+
+	/**
+	 * @param concurrency Maximum number of range requests which are sent at once. It's also limited by HttpClient::setMaxConnectionsPerHost.
+	 * @param partSize Number of bytes requested by one range request.
+	 */
+	explicit ParallelDownloader(size_t concurrency = 4, uint64_t partSize = 4 * 1024 * 1024);
+
+	/**
+	 * Downloads a file and returns when it's complete. Throws if the download fails; the output file may be left incomplete then.
+	 * @param url Url of a file.
+	 * @param destinationPath Path of a file which is created or overwritten.
+	 * @param progress Optional. Called on a worker thread after each piece of the file, from one thread at a time. If it throws, the download fails with its exception.
+	 */
+	void download(const Url& url, const std::string& destinationPath, const ProgressHandler& progress = nullptr) const;
+
+private:
+	class Download;
+
+	const size_t _concurrency;
+	const uint64_t _partSize;
+};
+
+}
+
+#endif //TGBOT_PARALLELDOWNLOADER_H
@@ -0,0 +1,139 @@
+/*
+ * Copyright (c) 2015 Oleg Morozenkov
+ * Copyright (c) 2017 Maks Mazurov (fox.cpp)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef TGBOT_RATELIMITER_H
+#define TGBOT_RATELIMITER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+namespace TgBot {
+
+/**
+ * Delays outgoing messages so they don't exceed Telegram flood limits: a global limit for the bot and a limit for every chat.
+ * Each limit is a token bucket, which allows a burst of messages and then releases them at a constant rate.
+ * Messages to the same chat are released in the order they were queued. See Api::setRateLimiter.
+ * @ingroup net
+ */
+class RateLimiter {
+
+public:
+	typedef std::shared_ptr<RateLimiter> Ptr;
+	typedef std::chrono::steady_clock Clock;
+
+	/**
+	 * Rates are in messages per second, zero or a negative rate disables a limit. Bursts are numbers of messages which are released at once.
+	 */
+	struct Limits {
+		double globalRate = 30;
+		size_t globalBurst = 1;
+		double privateChatRate = 1;
+		size_t privateChatBurst = 1;
+		double groupChatRate = 20.0 / 60;
+		size_t groupChatBurst = 1;
+	};
+
+	struct Metrics {
+		/**
+		 * Number of released messages.
+		 */
+		uint64_t releasedCount = 0;
+
+		/**
+		 * Number of released messages which had to wait.
+		 */
+		uint64_t delayedCount = 0;
+
+		/**
+		 * Sum and maximum of waiting times of released messages.
+		 */
+		Clock::duration totalDelay = Clock::duration::zero();
+		Clock::duration maxDelay = Clock::duration::zero();
+
+		/**
+		 * Number of messages which are waiting now.
+		 */
+		size_t waitingCount = 0;
+
+		/**
+		 * Number of chats which are tracked now.
+		 */
+		size_t chatCount = 0;
+	};
+
+	/**
+	 * Creates a rate limiter with default limits of Telegram: 30 messages per second, 1 message per second to a private chat and 20 messages per minute to a group.
+	 */
+	RateLimiter();
+
+	explicit RateLimiter(const Limits& limits);
+
+	/**
+	 * Waits until a message to the chat can be sent and takes its tokens.
+	 * @param chatId Value of chat_id argument. Ids starting with '-' or '@' are groups and channels, others are private chats. Only the global limit applies if it's empty.
+	 */
+	void acquire(const std::string& chatId);
+
+	/**
+	 * Changes limits. Waiting messages are released according to the new ones.
+	 */
+	void setLimits(const Limits& limits);
+
+	Limits getLimits() const;
+
+	Metrics getMetrics() const;
+
+	/**
+	 * @return True if the chat id belongs to a group, a supergroup or a channel.
+	 */
+	static bool isGroupChat(const std::string& chatId);
+
+private:
+	struct Bucket {
+		Clock::time_point theoreticalArrivalTime;
+		uint64_t nextTicket = 0;
+		uint64_t servingTicket = 0;
+	};
+
+	static Clock::time_point getAllowedTime(const Bucket& bucket, double rate, size_t burst);
+	static void take(Bucket& bucket, double rate, Clock::time_point now);
+	static void limitWaitingTime(Bucket& bucket, double rate, Clock::time_point now);
+	void removeIdleChats(Clock::time_point now);
+
+	mutable std::mutex _mutex;
+	std::condition_variable _condition;
+	Limits _limits;
+	Metrics _metrics;
+	Bucket _globalBucket;
+	std::unordered_map<std::string, Bucket> _chatBuckets;
+	size_t _cleanupThreshold;
+};
+
+}
+
+#endif //TGBOT_RATELIMITER_H
@@ -0,0 +1,165 @@
+/*
+ * Copyright (c) 2015 Oleg Morozenkov
+ * Copyright (c) 2017 Maks Mazurov (fox.cpp)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef TGBOT_RETRYENGINE_H
+#define TGBOT_RETRYENGINE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <set>
+#include <thread>
+#include <vector>
+
+#include <boost/asio.hpp>
+#include <boost/asio/steady_timer.hpp>
+
+#include "tgbot/Result.h"
+
+namespace TgBot {
+
+/**
+ * Runs calls to Api on its own threads and repeats failed ones later, so the calling thread doesn't wait for them.
+ * A call which failed with TgException is repeated after ResponseParameters::retryAfter seconds, or at once with the chat id
+ * from ResponseParameters::migrateToChatId. A call which failed with a network error, a server error of Telegram or an error without
+ * a code, e.g. an html page of a failed gateway, is repeated after an exponential backoff with full jitter. Other errors aren't repeated.
+ * @ingroup net
+ */
+class RetryEngine {
+
+public:
+	typedef std::shared_ptr<RetryEngine> Ptr;
+
+	/**
+	 * Performs a request to the chat, e.g. by calling Api::sendMessage. It signals a failure by throwing.
+	 * @param chatId Chat id passed to submit, or the one the chat was migrated to.
+	 */
+	typedef std::function<void (int64_t chatId)> Call;
+
+	/**
+	 * Called when a call succeeds or finally fails.
+	 * @param error Exception thrown by the last attempt, or nullptr if it succeeded.
+	 */
+	typedef std::function<void (std::exception_ptr error)> CompletionHandler;
+
+	/**
+	 * Performs a request which returns failures reported by Telegram instead of throwing them, e.g. by calling Api::trySendMessageAndForget.
+	 * Network errors may still be thrown.
+	 */
+	typedef std::function<Result<void> (int64_t chatId)> ResultCall;
+
+	/**
+	 * Called when a result call succeeds or finally fails. Exceptions thrown by the last attempt are given as errors with code 0.
+	 */
+	typedef std::function<void (const Result<void>& result)> ResultHandler;
+
+	struct Options {
+		/**
+		 * Maximum number of attempts of a call, including the first one.
+		 */
+		size_t maxAttempts = 5;
+
+		/**
+		 * Upper bound of the first backoff, which is multiplied by backoffMultiplier after each attempt up to maxBackoff.
+		 */
+		std::chrono::milliseconds initialBackoff = std::chrono::milliseconds(500);
+		std::chrono::milliseconds maxBackoff = std::chrono::milliseconds(30000);
+		double backoffMultiplier = 2;
+
+		/**
+		 * Number of threads which perform calls, i.e. the maximum number of calls in progress.
+		 */
+		size_t threadCount = 1;
+	};
+
+	RetryEngine();
+	explicit RetryEngine(const Options& options);
+
+	/**
+	 * Waits for calls which are in progress. Calls which are waiting for their attempt are dropped without calling their handlers.
+	 */
+	~RetryEngine();
+
+	/**
+	 * Queues a call and returns immediately.
+	 * @param handler Optional. Called on a thread of the engine. Exceptions thrown from it are ignored.
+	 */
+	void submit(int64_t chatId, const Call& call, const CompletionHandler& handler = nullptr);
+
+	/**
+	 * Queues a call which returns its result, so failures are repeated or reported without throwing, and returns immediately.
+	 * @param handler Optional. Called on a thread of the engine. Exceptions thrown from it are ignored.
+	 */
+	void submitResult(int64_t chatId, const ResultCall& call, const ResultHandler& handler = nullptr);
+
+	/**
+	 * @return Number of submitted calls which haven't completed yet.
+	 */
+	inline size_t getPendingCount() const {
+		return _pendingCount;
+	}
+
+	/**
+	 * @return Number of repeated attempts of all calls.
+	 */
+	inline uint64_t getRetryCount() const {
+		return _retryCount;
+	}
+
+private:
+	struct Task {
+		int64_t chatId;
+		Call call;
+		CompletionHandler handler;
+		ResultCall resultCall;
+		ResultHandler resultHandler;
+		size_t attemptCount = 0;
+	};
+
+	void post(const std::shared_ptr<Task>& task);
+	void run(const std::shared_ptr<Task>& task);
+	bool getRetryDelay(int32_t errorCode, const ResponseParameters::Ptr& parameters, Task& task, std::chrono::steady_clock::duration& delay);
+	void schedule(const std::shared_ptr<Task>& task, std::chrono::steady_clock::duration delay);
+	void complete(const std::shared_ptr<Task>& task, std::exception_ptr error, const Result<void>& result);
+	std::chrono::steady_clock::duration getBackoff(size_t attemptCount);
+
+	const Options _options;
+	boost::asio::io_service _ioService;
+	std::unique_ptr<boost::asio::io_service::work> _ioServiceWork;
+	std::vector<std::thread> _workers;
+	std::mutex _mutex;
+	std::set<std::shared_ptr<boost::asio::steady_timer>> _timers;
+	std::mt19937 _random;
+	bool _isStopped = false;
+	std::atomic<size_t> _pendingCount;
+	std::atomic<uint64_t> _retryCount;
+};
+
+}
+
+#endif //TGBOT_RETRYENGINE_H
@@ -24,9 +24,15 @@
 #ifndef TGBOT_TGLONGPOLL_H
 #define TGBOT_TGLONGPOLL_H
 
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <exception>
+
 #include "tgbot/Bot.h"
 #include "tgbot/Api.h"
 #include "tgbot/EventHandler.h"
+#include "tgbot/tools/BlockingQueue.h"
 
 namespace TgBot {
 
@@ -39,17 +45,42 @@ class TgLongPoll {
 public:
 	TgLongPoll(const Api* api, const EventHandler* eventHandler);
 	TgLongPoll(const Bot& bot);
+	~TgLongPoll();
 
 	/**
 	 * Starts long poll. After new update will come, this method will parse it and send to EventHandler which invokes your listeners. Designed to be executed in a loop.
+	 * Updates are passed to EventHandler as soon as each of them is received, without waiting for the rest of the batch.
+	 * In pipelined mode this method returns as soon as updates are queued for dispatching, so the next poll is sent while listeners are still running.
+	 * If listeners threw exceptions in pipelined mode, the first one is rethrown from here. The other updates of the batch are still dispatched.
 	 */
 	void start();
 	void setMaxTime(int seconds);
+
+	/**
+	 * Enables or disables pipelined mode. In this mode updates are passed to EventHandler from a separate dispatch thread.
+	 * Offset of the next poll is advanced as soon as updates are received, so updates which are still in the queue are lost if the application exits.
+	 * Must be called before the first call of start.
+	 * @param maxQueuedBatches Maximum number of received batches of updates which wait for dispatching. When it's reached, start waits until the dispatch thread takes one.
+	 */
+	void setPipelined(bool pipelined, size_t maxQueuedBatches = 4);
+
+	/**
+	 * Stops pipelined mode: waits until all queued updates are dispatched and stops the dispatch thread.
+	 */
+	void stop();
+
 private:
+	void dispatchUpdates();
+
 	int32_t _lastUpdateId = 0;
 	const Api* _api;
 	const EventHandler* _eventHandler;
 	int timeout = 100;
+
+	std::unique_ptr<BlockingQueue<std::vector<Update::Ptr>>> _dispatchQueue;
+	std::thread _dispatchThread;
+	std::mutex _dispatchErrorMutex;
+	std::exception_ptr _dispatchError;
 };
 
 }
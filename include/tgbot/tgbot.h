@@ -25,7 +25,14 @@
 #define TGBOT_TGBOT_H
 
 #include "tgbot/Bot.h"
+#include "tgbot/Broadcaster.h"
 #include "tgbot/Api.h"
+#include "tgbot/ApiError.h"
+#include "tgbot/EditCoalescer.h"
+#include "tgbot/EditOptions.h"
+#include "tgbot/PreparedMessage.h"
+#include "tgbot/Result.h"
+#include "tgbot/SendOptions.h"
 #include "tgbot/TgException.h"
 #include "tgbot/TgTypeParser.h"
 #include "tgbot/EventBroadcaster.h"
@@ -34,12 +41,23 @@
 #include "tgbot/net/HttpClient.h"
 #include "tgbot/net/HttpParser.h"
 #include "tgbot/net/HttpReqArg.h"
+#include "tgbot/net/HttpResponseParser.h"
+#include "tgbot/net/ParallelDownloader.h"
+#include "tgbot/net/RateLimiter.h"
+#include "tgbot/net/RetryEngine.h"
 #include "tgbot/net/HttpServer.h"
 #include "tgbot/net/TgLongPoll.h"
 #include "tgbot/net/TgWebhookLocalServer.h"
 #include "tgbot/net/TgWebhookServer.h"
 #include "tgbot/net/TgWebhookTcpServer.h"
 #include "tgbot/net/Url.h"
+#include "tgbot/tools/BlockingQueue.h"
+#include "tgbot/tools/FileIdCache.h"
+#include "tgbot/tools/JsonArrayStreamParser.h"
+#include "tgbot/tools/JsonDocument.h"
+#include "tgbot/tools/JsonValue.h"
+#include "tgbot/tools/JsonWriter.h"
+#include "tgbot/tools/Lazy.h"
 
 /**
  * @defgroup general
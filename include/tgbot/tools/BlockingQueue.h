@@ -0,0 +1,127 @@
+/*
+ * Copyright (c) 2015 Oleg Morozenkov
+ * Copyright (c) 2017 Maks Mazurov (fox.cpp)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef TGBOT_BLOCKINGQUEUE_H
+#define TGBOT_BLOCKINGQUEUE_H
+
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+
+namespace TgBot {
+
+/**
+ * Thread safe FIFO queue with limited capacity.
+ * Producers wait while the queue is full, consumers wait while it's empty.
+ * @ingroup tools
+ */
+template<typename T>
+class BlockingQueue {
+
+public:
+	explicit BlockingQueue(size_t capacity) : _capacity(capacity ? capacity : 1) {
+	}
+
+	/**
+	 * Adds an item to the end of the queue. Waits while the queue is full.
+	 * @return False if the queue is closed and the item wasn't added.
+	 */
+	bool push(T item) {
+		std::unique_lock<std::mutex> lock(_mutex);
+		_notFullCondition.wait(lock, [this]() {
+			return _isClosed || _items.size() < _capacity;
+		});
+		if (_isClosed) {
+			return false;
+		}
+		_items.push_back(std::move(item));
+		_notEmptyCondition.notify_one();
+		return true;
+	}
+
+	/**
+	 * Adds an item to the end of the queue if it isn't full.
+	 * @return False if the queue is full or closed and the item wasn't added.
+	 */
+	bool tryPush(T item) {
+		std::lock_guard<std::mutex> lock(_mutex);
+		if (_isClosed || _items.size() >= _capacity) {
+			return false;
+		}
+		_items.push_back(std::move(item));
+		_notEmptyCondition.notify_one();
+		return true;
+	}
+
+	/**
+	 * Takes an item from the beginning of the queue. Waits while the queue is empty.
+	 * @return False if the queue is closed and has no more items.
+	 */
+	bool pop(T& item) {
+		std::unique_lock<std::mutex> lock(_mutex);
+		_notEmptyCondition.wait(lock, [this]() {
+			return _isClosed || !_items.empty();
+		});
+		if (_items.empty()) {
+			return false;
+		}
+		item = std::move(_items.front());
+		_items.pop_front();
+		_notFullCondition.notify_one();
+		return true;
+	}
+
+	/**
+	 * Closes the queue. Items which are already in the queue can still be taken, but new ones aren't accepted.
+	 */
+	void close() {
+		std::lock_guard<std::mutex> lock(_mutex);
+		_isClosed = true;
+		_notFullCondition.notify_all();
+		_notEmptyCondition.notify_all();
+	}
+
+	/**
+	 * @return Number of items in the queue.
+	 */
+	size_t size() const {
+		std::lock_guard<std::mutex> lock(_mutex);
+		return _items.size();
+	}
+
+	inline size_t getCapacity() const {
+		return _capacity;
+	}
+
+private:
+	const size_t _capacity;
+	mutable std::mutex _mutex;
+	std::condition_variable _notFullCondition;
+	std::condition_variable _notEmptyCondition;
+	std::deque<T> _items;
+	bool _isClosed = false;
+};
+
+}
+
+#endif //TGBOT_BLOCKINGQUEUE_H
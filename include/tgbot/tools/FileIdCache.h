@@ -0,0 +1,107 @@
+/*
+ * Copyright (c) 2015 Oleg Morozenkov
+ * Copyright (c) 2017 Maks Mazurov (fox.cpp)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef TGBOT_FILEIDCACHE_H
+#define TGBOT_FILEIDCACHE_H
+
+#include <fstream>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+
+#include "tgbot/types/InputFile.h"
+
+namespace TgBot {
+
+/**
+ * Thread safe cache which maps contents of uploaded files to file ids given by Telegram, so the same file isn't uploaded twice.
+ * When it's full, the least recently used entries are removed.
+ * Optionally it's persisted to a file, so the mappings survive restarts. See Api::setFileIdCache.
+ * @ingroup tools
+ */
+class FileIdCache {
+
+public:
+	typedef std::shared_ptr<FileIdCache> Ptr;
+
+	/**
+	 * @param capacity Maximum number of stored file ids.
+	 * @param persistencePath Optional. Path of a file which stores the mappings. It's loaded here if it exists and updated after every change.
+	 */
+	explicit FileIdCache(size_t capacity = 1024, const std::string& persistencePath = "");
+
+	/**
+	 * Calculates the key of a file, which is SHA-256 of its contents and mime type in hex.
+	 * Contents of streamed files are read from disk. Their keys are remembered by path and reused while the size
+	 * and the modification time of the file stay the same.
+	 */
+	static std::string getKey(const InputFile& file);
+
+	/**
+	 * @return File id stored for the key or an empty string. The entry becomes the most recently used one.
+	 */
+	std::string find(const std::string& key);
+
+	/**
+	 * Stores a file id for the key, replacing the previous one.
+	 */
+	void insert(const std::string& key, const std::string& fileId);
+
+	/**
+	 * Removes a file id stored for the key, e.g. when Telegram doesn't accept it anymore.
+	 */
+	void erase(const std::string& key);
+
+	/**
+	 * @return Number of stored file ids.
+	 */
+	size_t size() const;
+
+	inline size_t getCapacity() const {
+		return _capacity;
+	}
+
+private:
+	typedef std::list<std::pair<std::string, std::string>> EntryList;
+
+	static std::string getStreamedFileKey(const InputFile& file);
+
+	void load();
+	void persist(const std::string& key, const std::string& fileId);
+	void compact();
+
+	const size_t _capacity;
+	const std::string _persistencePath;
+	mutable std::mutex _mutex;
+	EntryList _entries;
+	std::unordered_map<std::string, EntryList::iterator> _index;
+	std::ofstream _persistenceStream;
+	size_t _persistedLineCount = 0;
+};
+
+}
+
+#endif //TGBOT_FILEIDCACHE_H
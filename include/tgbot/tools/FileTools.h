@@ -19,6 +19,13 @@ namespace FileTools {
  */
 std::string read(const std::string& filePath);
 
+/**
+* Get size of a file. Throws if it isn't a regular file, e.g. a pipe, whose size is unknown.
+* @param filePath Path to a file
+* @return Size in bytes
+*/
+size_t getSize(const std::string& filePath);
+
 /**
 * Save file to disk.
 * @param filePath Path to a file
@@ -26,6 +33,14 @@ std::string read(const std::string& filePath);
 */
 bool write(const std::string& content, const std::string& filePath);
 
+/**
+* Replaces a file with new contents at once, so readers see either the old or the new contents even if the process is killed.
+* Throws if the file can't be written.
+* @param content New contents
+* @param filePath Path to a file
+*/
+void replace(const std::string& content, const std::string& filePath);
+
 };
 
 
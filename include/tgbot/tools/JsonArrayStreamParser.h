@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2015 Oleg Morozenkov
+ * Copyright (c) 2017 Maks Mazurov (fox.cpp)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef TGBOT_JSONARRAYSTREAMPARSER_H
+#define TGBOT_JSONARRAYSTREAMPARSER_H
+
+#include <functional>
+#include <string>
+
+#include "tgbot/tools/JsonDocument.h"
+
+namespace TgBot {
+
+/**
+ * Extracts elements of an array member of a json object while the object is still arriving.
+ * Each element is parsed into its own JsonDocument as soon as its last byte is fed, so it can be used before the rest of the text is received.
+ * Only objects and arrays are supported as elements of the array.
+ * @ingroup tools
+ */
+class JsonArrayStreamParser {
+
+public:
+	typedef std::function<void (JsonValue::Ptr element)> ElementHandler;
+
+	/**
+	 * @param arrayName Name of the array member of the root object.
+	 * @param handler Function which is called for each element of the array in order.
+	 */
+	JsonArrayStreamParser(const std::string& arrayName, const ElementHandler& handler);
+
+	/**
+	 * Parses the next portion of json text.
+	 * @throws JsonException if an element is malformed.
+	 */
+	void feed(const char* data, size_t length);
+
+	/**
+	 * Completes parsing when the whole text is fed.
+	 * @return Root object without elements of the array.
+	 * @throws JsonException if the text is malformed or incomplete.
+	 */
+	JsonValue::Ptr finish();
+
+private:
+	enum class State {
+		Root, Array, Element
+	};
+
+	const char* feedRoot(const char* it, const char* end);
+	const char* feedArray(const char* it, const char* end);
+	const char* feedElement(const char* it, const char* end);
+
+	const std::string _arrayName;
+	ElementHandler _handler;
+	State _state = State::Root;
+	std::string _root;
+	std::string _element;
+	std::string _lastRootString;
+	size_t _depth = 0;
+	size_t _arrayDepth = 0;
+	bool _isInString = false;
+	bool _isEscaped = false;
+};
+
+}
+
+#endif //TGBOT_JSONARRAYSTREAMPARSER_H
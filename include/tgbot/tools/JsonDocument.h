@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2015 Oleg Morozenkov
+ * Copyright (c) 2017 Maks Mazurov (fox.cpp)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef TGBOT_JSONDOCUMENT_H
+#define TGBOT_JSONDOCUMENT_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "tgbot/tools/JsonValue.h"
+
+namespace TgBot {
+
+/**
+ * Parsed json text.
+ * The text is parsed in place: strings are unescaped inside of the document's own buffer and values only point to it, so no memory is allocated per value.
+ * All values are kept in one array in document order, an array or an object is followed by its children.
+ * @ingroup tools
+ */
+class JsonDocument {
+
+friend class JsonValue;
+
+public:
+	typedef std::shared_ptr<JsonDocument> Ptr;
+
+	/**
+	 * Parses json text.
+	 * @throws JsonException if json text is malformed.
+	 */
+	explicit JsonDocument(std::string json);
+
+	JsonDocument(const JsonDocument&) = delete;
+	JsonDocument& operator=(const JsonDocument&) = delete;
+
+	/**
+	 * Parses json text.
+	 * @return Pointer to the root value which keeps the whole document alive.
+	 * @throws JsonException if json text is malformed.
+	 */
+	static JsonValue::Ptr parse(std::string json);
+
+	inline const JsonValue& getRoot() const {
+		return _values.front();
+	}
+
+private:
+	class Parser;
+
+	std::string _buffer;
+	std::vector<JsonValue> _values;
+	std::weak_ptr<const JsonDocument> _self;
+};
+
+}
+
+#endif //TGBOT_JSONDOCUMENT_H
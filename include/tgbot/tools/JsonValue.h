@@ -0,0 +1,263 @@
+/*
+ * Copyright (c) 2015 Oleg Morozenkov
+ * Copyright (c) 2017 Maks Mazurov (fox.cpp)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef TGBOT_JSONVALUE_H
+#define TGBOT_JSONVALUE_H
+
+#include <cstdint>
+#include <cstddef>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+
+#include <boost/utility/string_ref.hpp>
+
+namespace TgBot {
+
+class JsonDocument;
+
+/**
+ * Exception type which is thrown when json can't be parsed or a value can't be read as requested.
+ * @ingroup tools
+ */
+class JsonException : public std::runtime_error {
+
+public:
+	using std::runtime_error::runtime_error;
+};
+
+/**
+ * Read only view of a value inside of a JsonDocument.
+ * Strings and numbers point to the document buffer, so values are valid only while their document is alive.
+ * @ingroup tools
+ */
+class JsonValue {
+
+friend class JsonDocument;
+
+public:
+	typedef std::shared_ptr<const JsonValue> Ptr;
+
+	enum class Type : uint8_t {
+		Null, Bool, Number, String, Array, Object
+	};
+
+	/**
+	 * Iterates over elements of an array or over members of an object.
+	 */
+	class ConstIterator {
+
+	public:
+		typedef std::forward_iterator_tag iterator_category;
+		typedef const JsonValue value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef const JsonValue* pointer;
+		typedef const JsonValue& reference;
+
+		explicit ConstIterator(const JsonValue* value) : _value(value) {
+		}
+
+		inline const JsonValue& operator*() const {
+			return *_value;
+		}
+
+		inline const JsonValue* operator->() const {
+			return _value;
+		}
+
+		inline ConstIterator& operator++() {
+			_value += _value->_subtreeSize;
+			return *this;
+		}
+
+		inline ConstIterator operator++(int) {
+			ConstIterator result(*this);
+			++*this;
+			return result;
+		}
+
+		inline bool operator==(const ConstIterator& other) const {
+			return _value == other._value;
+		}
+
+		inline bool operator!=(const ConstIterator& other) const {
+			return _value != other._value;
+		}
+
+	private:
+		const JsonValue* _value;
+	};
+
+	inline Type getType() const {
+		return _type;
+	}
+
+	inline bool isNull() const {
+		return _type == Type::Null;
+	}
+
+	inline bool isObject() const {
+		return _type == Type::Object;
+	}
+
+	inline bool isArray() const {
+		return _type == Type::Array;
+	}
+
+	/**
+	 * @return Name of this value if it's a member of an object, empty string otherwise.
+	 */
+	inline boost::string_ref getKey() const {
+		return boost::string_ref(_key, _keyLength);
+	}
+
+	/**
+	 * @return Unescaped contents of a string or source text of a number.
+	 */
+	inline boost::string_ref getStringRef() const {
+		return boost::string_ref(_data, _dataLength);
+	}
+
+	/**
+	 * @return Number of elements of an array or members of an object.
+	 */
+	inline size_t size() const {
+		return _childCount;
+	}
+
+	inline ConstIterator begin() const {
+		return ConstIterator(this + 1);
+	}
+
+	inline ConstIterator end() const {
+		return ConstIterator(this + _subtreeSize);
+	}
+
+	/**
+	 * @return Pointer to this value which keeps its document alive, or nullptr if the document isn't owned by a shared pointer.
+	 */
+	Ptr getSharedPtr() const;
+
+	/**
+	 * Searches for a member of an object.
+	 * @return Pointer to the member or nullptr if this value isn't an object or hasn't such member.
+	 */
+	const JsonValue* find(boost::string_ref key) const;
+
+	/**
+	 * @return Member of an object.
+	 * @throws JsonException if there is no such member.
+	 */
+	const JsonValue& operator[](boost::string_ref key) const;
+
+	/**
+	 * Converts this value. Numbers and strings are converted to each other, like in boost::property_tree.
+	 * @throws JsonException if this value can't be converted to T.
+	 */
+	template<typename T>
+	T as() const {
+		T result;
+		if (!convert(result)) {
+			throw JsonException("json value of type " + getTypeName() + " can't be converted to the requested type");
+		}
+		return result;
+	}
+
+	/**
+	 * Converts this value.
+	 * @return Converted value or defaultValue if this value is null or can't be converted to T.
+	 */
+	template<typename T>
+	T as(const T& defaultValue) const {
+		T result;
+		if (!convert(result)) {
+			return defaultValue;
+		}
+		return result;
+	}
+
+	/**
+	 * @return Converted member of an object.
+	 * @throws JsonException if there is no such member or it can't be converted to T.
+	 */
+	template<typename T>
+	T get(boost::string_ref key) const {
+		return (*this)[key].as<T>();
+	}
+
+	/**
+	 * @return Converted member of an object or defaultValue if there is no such member or it can't be converted to T.
+	 */
+	template<typename T>
+	T get(boost::string_ref key, const T& defaultValue) const {
+		const JsonValue* value = find(key);
+		if (value == nullptr) {
+			return defaultValue;
+		}
+		return value->as<T>(defaultValue);
+	}
+
+	std::string get(boost::string_ref key, const char* defaultValue) const {
+		return get<std::string>(key, defaultValue);
+	}
+
+private:
+	std::string getTypeName() const;
+
+	bool convert(bool& result) const;
+	bool convert(std::string& result) const;
+	bool convert(double& result) const;
+	bool convert(float& result) const;
+	bool convertToInteger(int64_t& result) const;
+
+	template<typename T>
+	typename std::enable_if<std::is_integral<T>::value, bool>::type convert(T& result) const {
+		int64_t value;
+		if (!convertToInteger(value)) {
+			return false;
+		}
+		if (std::is_unsigned<T>::value ? value < 0 || static_cast<uint64_t>(value) > static_cast<uint64_t>(std::numeric_limits<T>::max())
+				: value < static_cast<int64_t>(std::numeric_limits<T>::min()) || value > static_cast<int64_t>(std::numeric_limits<T>::max())) {
+			return false;
+		}
+		result = static_cast<T>(value);
+		return true;
+	}
+
+	const JsonDocument* _document = nullptr;
+	const char* _key = nullptr;
+	const char* _data = nullptr;
+	uint32_t _keyLength = 0;
+	uint32_t _dataLength = 0;
+	uint32_t _childCount = 0;
+	uint32_t _subtreeSize = 1;
+	Type _type = Type::Null;
+	bool _boolValue = false;
+};
+
+}
+
+#endif //TGBOT_JSONVALUE_H
@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2015 Oleg Morozenkov
+ * Copyright (c) 2017 Maks Mazurov (fox.cpp)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef TGBOT_JSONWRITER_H
+#define TGBOT_JSONWRITER_H
+
+#include <cstdint>
+#include <string>
+
+#include <boost/utility/string_ref.hpp>
+
+namespace TgBot {
+
+/**
+ * Writes json text straight into a string, e.g. the value of an outgoing request argument.
+ * Commas between members and elements are inserted automatically, strings are escaped.
+ * The writer doesn't validate the structure: each key must be followed by exactly one value.
+ * @ingroup tools
+ */
+class JsonWriter {
+
+public:
+	static const size_t DEFAULT_RESERVED_SIZE = 256;
+
+	/**
+	 * @param output String the json text is appended to. It must outlive the writer.
+	 * @param reservedSize Number of bytes reserved in the output in advance.
+	 */
+	explicit JsonWriter(std::string& output, size_t reservedSize = DEFAULT_RESERVED_SIZE);
+
+	JsonWriter& startObject();
+	JsonWriter& endObject();
+	JsonWriter& startArray();
+	JsonWriter& endArray();
+
+	/**
+	 * Writes a name of an object member. The name is expected to need no escaping.
+	 */
+	JsonWriter& key(boost::string_ref name);
+
+	JsonWriter& value(boost::string_ref value);
+	JsonWriter& value(const char* value);
+	JsonWriter& value(const std::string& value);
+	JsonWriter& value(bool value);
+	JsonWriter& value(int32_t value);
+	JsonWriter& value(int64_t value);
+	JsonWriter& value(uint32_t value);
+	JsonWriter& value(uint64_t value);
+	JsonWriter& value(float value);
+	JsonWriter& value(double value);
+	JsonWriter& nullValue();
+
+	/**
+	 * Writes an already serialized json value as is.
+	 */
+	JsonWriter& rawValue(boost::string_ref json);
+
+	/**
+	 * Writes already serialized members of an object, without enclosing braces, as is. Nothing is written if they're empty.
+	 */
+	JsonWriter& rawMembers(boost::string_ref json);
+
+	inline std::string& getOutput() const {
+		return _output;
+	}
+
+	/**
+	 * Appends the value as a quoted and escaped json string.
+	 */
+	static void appendString(std::string& output, boost::string_ref value);
+
+	static void appendInteger(std::string& output, int64_t value);
+	static void appendInteger(std::string& output, uint64_t value);
+
+private:
+	inline void beforeValue() {
+		if (_needsComma) {
+			_output += ',';
+		}
+		_needsComma = true;
+	}
+
+	std::string& _output;
+	bool _needsComma = false;
+};
+
+}
+
+#endif //TGBOT_JSONWRITER_H
@@ -0,0 +1,369 @@
+/*
+ * Copyright (c) 2015 Oleg Morozenkov
+ * Copyright (c) 2017 Maks Mazurov (fox.cpp)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#ifndef TGBOT_LAZY_H
+#define TGBOT_LAZY_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+#include "tgbot/tools/JsonValue.h"
+
+namespace TgBot {
+
+/**
+ * Value which can be decoded from json only when it's accessed for the first time.
+ * Until then it keeps a pointer to its json, which keeps the whole json document alive.
+ * Decoding is thread safe, but assigning a new value while other threads read it isn't, like with any other field.
+ * @ingroup tools
+ */
+template<typename T>
+class LazyValue {
+
+public:
+	typedef T (*Decoder)(const JsonValue& data);
+
+	LazyValue() : _isDecoded(true) {
+	}
+
+	LazyValue(T value) : _value(std::move(value)), _isDecoded(true) {
+	}
+
+	LazyValue(const LazyValue& other) : _isDecoded(true) {
+		assign(other);
+	}
+
+	LazyValue& operator=(const LazyValue& other) {
+		if (this != &other) {
+			assign(other);
+		}
+		return *this;
+	}
+
+	LazyValue& operator=(T value) {
+		_value = std::move(value);
+		_source.reset();
+		_decoder = nullptr;
+		_isDecoded.store(true, std::memory_order_release);
+		return *this;
+	}
+
+	/**
+	 * Makes the value decoded by the decoder from the source on the first access.
+	 */
+	void setSource(JsonValue::Ptr source, Decoder decoder) {
+		_value = T();
+		_source = std::move(source);
+		_decoder = decoder;
+		_isDecoded.store(false, std::memory_order_release);
+	}
+
+	/**
+	 * @return True if the value isn't waiting for decoding anymore.
+	 */
+	inline bool isDecoded() const {
+		return _isDecoded.load(std::memory_order_acquire);
+	}
+
+	/**
+	 * @return The wrapped value itself, decoded if needed.
+	 */
+	inline const T& value() const {
+		if (!isDecoded()) {
+			decode();
+		}
+		return _value;
+	}
+
+	inline T& value() {
+		if (!isDecoded()) {
+			decode();
+		}
+		return _value;
+	}
+
+	inline operator const T&() const {
+		return value();
+	}
+
+	inline operator T&() {
+		return value();
+	}
+
+private:
+	static std::mutex& getMutex(const void* object) {
+		static std::mutex mutexes[16];
+		return mutexes[(reinterpret_cast<uintptr_t>(object) / sizeof(void*)) % 16];
+	}
+
+	void decode() const {
+		std::lock_guard<std::mutex> lock(getMutex(this));
+		if (_isDecoded.load(std::memory_order_relaxed)) {
+			return;
+		}
+		_value = _decoder(*_source);
+		_source.reset();
+		_isDecoded.store(true, std::memory_order_release);
+	}
+
+	void assign(const LazyValue& other) {
+		if (!other.isDecoded()) {
+			std::lock_guard<std::mutex> lock(getMutex(&other));
+			if (!other._isDecoded.load(std::memory_order_relaxed)) {
+				setSource(other._source, other._decoder);
+				return;
+			}
+		}
+		*this = other._value;
+	}
+
+	mutable T _value;
+	mutable JsonValue::Ptr _source;
+	Decoder _decoder = nullptr;
+	mutable std::atomic<bool> _isDecoded;
+};
+
+template<typename T>
+class Lazy;
+
+/**
+ * Lazily decoded pointer. It's used like the pointer itself.
+ * @ingroup tools
+ */
+template<typename T>
+class Lazy<std::shared_ptr<T>> : public LazyValue<std::shared_ptr<T>> {
+
+public:
+	typedef T element_type;
+
+	using LazyValue<std::shared_ptr<T>>::LazyValue;
+	using LazyValue<std::shared_ptr<T>>::operator=;
+
+	Lazy() = default;
+
+	inline T* get() const {
+		return this->value().get();
+	}
+
+	inline T* operator->() const {
+		return get();
+	}
+
+	inline T& operator*() const {
+		return *this->value();
+	}
+
+	inline void reset() {
+		*this = nullptr;
+	}
+
+	/**
+	 * Checks if the pointer isn't null. A json object always decodes to a non-null pointer, so this doesn't decode the value.
+	 */
+	inline explicit operator bool() const {
+		return !this->isDecoded() || this->value() != nullptr;
+	}
+
+	friend inline bool operator==(const Lazy& object, std::nullptr_t) {
+		return !object;
+	}
+
+	friend inline bool operator==(std::nullptr_t, const Lazy& object) {
+		return !object;
+	}
+
+	friend inline bool operator!=(const Lazy& object, std::nullptr_t) {
+		return static_cast<bool>(object);
+	}
+
+	friend inline bool operator!=(std::nullptr_t, const Lazy& object) {
+		return static_cast<bool>(object);
+	}
+
+	friend inline bool operator==(const Lazy& object, const std::shared_ptr<T>& other) {
+		return object.value() == other;
+	}
+
+	friend inline bool operator==(const std::shared_ptr<T>& other, const Lazy& object) {
+		return object.value() == other;
+	}
+
+	friend inline bool operator==(const Lazy& object, const Lazy& other) {
+		return object.value() == other.value();
+	}
+
+	friend inline bool operator!=(const Lazy& object, const std::shared_ptr<T>& other) {
+		return object.value() != other;
+	}
+
+	friend inline bool operator!=(const std::shared_ptr<T>& other, const Lazy& object) {
+		return object.value() != other;
+	}
+
+	friend inline bool operator!=(const Lazy& object, const Lazy& other) {
+		return object.value() != other.value();
+	}
+};
+
+/**
+ * Lazily decoded array. It's used like the vector itself, value() gives the vector for code which needs its exact type.
+ * @ingroup tools
+ */
+template<typename T>
+class Lazy<std::vector<T>> : public LazyValue<std::vector<T>> {
+
+public:
+	typedef typename std::vector<T>::iterator iterator;
+	typedef typename std::vector<T>::const_iterator const_iterator;
+	typedef typename std::vector<T>::value_type value_type;
+	typedef typename std::vector<T>::size_type size_type;
+	typedef typename std::vector<T>::reference reference;
+	typedef typename std::vector<T>::const_reference const_reference;
+
+	using LazyValue<std::vector<T>>::LazyValue;
+	using LazyValue<std::vector<T>>::operator=;
+
+	Lazy() = default;
+
+	inline size_type size() const {
+		return this->value().size();
+	}
+
+	inline bool empty() const {
+		return this->value().empty();
+	}
+
+	inline iterator begin() {
+		return this->value().begin();
+	}
+
+	inline const_iterator begin() const {
+		return this->value().begin();
+	}
+
+	inline iterator end() {
+		return this->value().end();
+	}
+
+	inline const_iterator end() const {
+		return this->value().end();
+	}
+
+	inline reference operator[](size_type index) {
+		return this->value()[index];
+	}
+
+	inline const_reference operator[](size_type index) const {
+		return this->value()[index];
+	}
+
+	inline reference at(size_type index) {
+		return this->value().at(index);
+	}
+
+	inline const_reference at(size_type index) const {
+		return this->value().at(index);
+	}
+
+	inline reference front() {
+		return this->value().front();
+	}
+
+	inline const_reference front() const {
+		return this->value().front();
+	}
+
+	inline reference back() {
+		return this->value().back();
+	}
+
+	inline const_reference back() const {
+		return this->value().back();
+	}
+
+	inline void push_back(const T& item) {
+		this->value().push_back(item);
+	}
+
+	inline void push_back(T&& item) {
+		this->value().push_back(std::move(item));
+	}
+
+	template<typename... Args>
+	inline void emplace_back(Args&&... args) {
+		this->value().emplace_back(std::forward<Args>(args)...);
+	}
+
+	inline iterator insert(const_iterator position, const T& item) {
+		return this->value().insert(position, item);
+	}
+
+	inline iterator erase(const_iterator position) {
+		return this->value().erase(position);
+	}
+
+	inline iterator erase(const_iterator first, const_iterator last) {
+		return this->value().erase(first, last);
+	}
+
+	inline void pop_back() {
+		this->value().pop_back();
+	}
+
+	inline void clear() {
+		*this = std::vector<T>();
+	}
+
+	inline void resize(size_type size) {
+		this->value().resize(size);
+	}
+
+	inline void reserve(size_type size) {
+		this->value().reserve(size);
+	}
+
+	friend inline bool operator==(const Lazy& object, const std::vector<T>& other) {
+		return object.value() == other;
+	}
+
+	friend inline bool operator==(const std::vector<T>& other, const Lazy& object) {
+		return object.value() == other;
+	}
+
+	friend inline bool operator!=(const Lazy& object, const std::vector<T>& other) {
+		return object.value() != other;
+	}
+
+	friend inline bool operator!=(const std::vector<T>& other, const Lazy& object) {
+		return object.value() != other;
+	}
+};
+
+}
+
+#endif //TGBOT_LAZY_H
@@ -27,6 +27,8 @@
 #include <memory>
 #include <utility>
 
+#include <boost/interprocess/mapped_region.hpp>
+
 namespace TgBot {
 
 /**
@@ -43,6 +45,21 @@ public:
 	 */
 	std::string data;
 
+	/**
+	 * Optional. Memory mapped contents of a file, which are used instead of data when set.
+	 */
+	std::shared_ptr<const boost::interprocess::mapped_region> mappedRegion;
+
+	/**
+	 * Optional. Path of a file which is read in chunks while it's uploaded, instead of holding its contents in data.
+	 */
+	std::string filePath;
+
+	/**
+	 * Size of a file at filePath.
+	 */
+	size_t fileSize = 0;
+
 	/**
 	 * Mime type of a file.
 	 */
@@ -57,6 +74,18 @@ public:
 	 * Creates new InputFile::Ptr from an existing file.
 	 */
 	static InputFile::Ptr fromFile(const std::string& filePath, const std::string& mimeType);
+
+	/**
+	 * Creates new InputFile::Ptr which maps an existing file to memory, so its pages are loaded by the OS only while it's uploaded.
+	 * The file shouldn't be changed while it's mapped.
+	 */
+	static InputFile::Ptr fromMappedFile(const std::string& filePath, const std::string& mimeType);
+
+	/**
+	 * Creates new InputFile::Ptr which reads an existing file in chunks during the upload, so memory usage doesn't depend on its size.
+	 * The file shouldn't be changed until it's uploaded.
+	 */
+	static InputFile::Ptr fromStreamedFile(const std::string& filePath, const std::string& mimeType);
 };
 
 }
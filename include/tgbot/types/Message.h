@@ -40,11 +40,15 @@
 #include "tgbot/types/MessageEntity.h"
 #include "tgbot/types/Venue.h"
 #include "tgbot/types/Voice.h"
+#include "tgbot/tools/Lazy.h"
 
 namespace TgBot {
 
 /**
  * This object represents a message.
+ * Nested objects and arrays are Lazy fields. If lazy decoding is enabled in TgTypeParser, they are decoded when they are accessed for the first time.
+ * Lazy fields are used like the pointers and vectors they wrap and convert to them implicitly. Unlike before, auto deduces the Lazy type itself
+ * and templates don't see through it, so call value() where the exact std::shared_ptr or std::vector type is needed.
  * @ingroup types
  */
 class Message {
@@ -83,12 +87,12 @@ public:
 	/**
 	 * Optional. For forwarded messages, sender of the original message.
 	 */
-	User::Ptr forwardFrom;
+	Lazy<User::Ptr> forwardFrom;
 
 	/**
 	 * Optional. For messages forwarded from a channel, information about the original channel
 	 */
-	Chat::Ptr forwardFromChat;
+	Lazy<Chat::Ptr> forwardFromChat;
 
 	/**
 	 * Optional. For forwarded channel posts, identifier of the original message in the channel
@@ -103,7 +107,7 @@ public:
 	/**
 	 * Optional. For replies, the original message. Note that the Message object in this field will not contain further reply_to_message fields even if it itself is a reply.
 	 */
-	Message::Ptr replyToMessage;
+	Lazy<Message::Ptr> replyToMessage;
 
 	/**
 	 * Optional. Date the message was last edited in Unix time
@@ -118,37 +122,37 @@ public:
 	/**
 	 * Optional. For text messages, special entities like usernames, URLs, bot commands, etc. that appear in the text.
 	 */
-	std::vector<MessageEntity::Ptr> entities;
+	Lazy<std::vector<MessageEntity::Ptr>> entities;
 
 	/**
 	 * Optional. Message is an audio file, information about the file.
 	 */
-	Audio::Ptr audio;
+	Lazy<Audio::Ptr> audio;
 
 	/**
 	 * Optional. Message is a general file, information about the file.
 	 */
-	Document::Ptr document;
+	Lazy<Document::Ptr> document;
 
 	/**
 	 * Optional. Message is a photo, available sizes of the photo.
 	 */
-	std::vector<PhotoSize::Ptr> photo;
+	Lazy<std::vector<PhotoSize::Ptr>> photo;
 
 	/**
 	 * Optional. Message is a sticker, information about the sticker.
 	 */
-	Sticker::Ptr sticker;
+	Lazy<Sticker::Ptr> sticker;
 
 	/**
 	 * Optional. Message is a video, information about the video.
 	 */
-	Video::Ptr video;
+	Lazy<Video::Ptr> video;
 
 	/**
 	 * Optional. Message is a voice message, information about the file.
 	 */
-	Voice::Ptr voice;
+	Lazy<Voice::Ptr> voice;
 
 	/**
 	 * Optional. Caption for the document, photo or video, 0-200 characters.
@@ -158,28 +162,28 @@ public:
 	/**
 	 * Optional. Message is a shared contact, information about the contact.
 	 */
-	Contact::Ptr contact;
+	Lazy<Contact::Ptr> contact;
 
 	/**
 	 * Optional. Message is a shared location, information about the location.
 	 */
-	Location::Ptr location;
+	Lazy<Location::Ptr> location;
 
 	/**
 	 * Optional. Message is a venue, information about the venue.
 	 */
-	Venue::Ptr venue;
+	Lazy<Venue::Ptr> venue;
 
 	/**
 	 * Optional. New members that were added to the group or supergroup and information about them (the bot itself may be one of these members)
 	 */
-	User::Ptr newChatMember;
-	std::vector<User::Ptr> newChatMembers;
+	Lazy<User::Ptr> newChatMember;
+	Lazy<std::vector<User::Ptr>> newChatMembers;
 
 	/**
 	 * Optional. A member was removed from the group, information about them (this member may be bot itself).
 	 */
-	User::Ptr leftChatMember;
+	Lazy<User::Ptr> leftChatMember;
 
 	/**
 	 * Optional. A group title was changed to this value.
@@ -189,7 +193,7 @@ public:
 	/**
 	 * Optional. A group photo was change to this value.
 	 */
-	std::vector<PhotoSize::Ptr> newChatPhoto;
+	Lazy<std::vector<PhotoSize::Ptr>> newChatPhoto;
 
 	/**
 	 * Optional. Informs that the group photo was deleted.
@@ -224,7 +228,7 @@ public:
 	/**
 	 * Optional. Specified message was pinned. Note that the Message object in this field will not contain further reply_to_message fields even if it is itself a reply.
 	 */
-	Message::Ptr pinnedMessage;
+	Lazy<Message::Ptr> pinnedMessage;
 
 };
 
@@ -5,6 +5,7 @@
 #ifndef TGBOT_RESPONSEPARAMETERS_H
 #define TGBOT_RESPONSEPARAMETERS_H
 
+#include <cstdint>
 #include <memory>
 
 namespace TgBot {
@@ -23,12 +24,12 @@ public:
 	 * difficulty/silent defects in interpreting it. But it is smaller than 52 bits, so a 
 	 * signed 64 bit integer or double-precision float type are safe for storing this identifier.
 	 */
-	int32_t migrateToChatId;
+	int64_t migrateToChatId = 0;
 
 	/**
 	 * Optional. In case of exceeding flood control, the number of seconds left to wait before the request can be repeated
 	 */
-	int32_t retryAfter;
+	int32_t retryAfter = 0;
 };
 }
 
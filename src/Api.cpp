@@ -26,22 +26,144 @@
 #include "tgbot/TgTypeParser.h"
 #include "tgbot/TgException.h"
 #include "tgbot/net/HttpClient.h"
+#include "tgbot/net/HttpParser.h"
+#include "tgbot/net/ParallelDownloader.h"
+#include "tgbot/tools/BlockingQueue.h"
+#include "tgbot/tools/JsonArrayStreamParser.h"
+#include "tgbot/tools/JsonWriter.h"
 
-using namespace boost::property_tree;
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <future>
+#include <limits>
+#include <stdexcept>
 
 namespace TgBot {
 
-Api::Api(const std::string& token) : _token(token) {
+/**
+ * Serializes the object straight into the value of a new request argument, which is embedded as is into the json request body.
+ */
+template<typename T>
+static void appendJsonArg(std::vector<HttpReqArg>& args, const std::string& name, TgTypeParser::TgTypeToJsonWriterFunc<T> writeFunc, const std::shared_ptr<T>& object) {
+	args.push_back(HttpReqArg(name, ""));
+	args.back().isJson = true;
+	JsonWriter writer(args.back().value);
+	(TgTypeParser::getInstance().*writeFunc)(writer, object);
+}
+
+template<typename T>
+static void appendJsonArg(std::vector<HttpReqArg>& args, const std::string& name, TgTypeParser::TgTypeToJsonWriterFunc<T> writeFunc, const std::vector<std::shared_ptr<T>>& objects) {
+	args.push_back(HttpReqArg(name, ""));
+	args.back().isJson = true;
+	// The buffer is sized by the number of objects, so long arrays like inline query results are written without reallocations.
+	JsonWriter writer(args.back().value, objects.size() * JsonWriter::DEFAULT_RESERVED_SIZE);
+	TgTypeParser::getInstance().writeArray(writer, writeFunc, objects);
+}
+
+static void appendJsonArg(std::vector<HttpReqArg>& args, const std::string& name, const std::vector<std::string>& values) {
+	args.push_back(HttpReqArg(name, ""));
+	args.back().isJson = true;
+	JsonWriter writer(args.back().value);
+	TgTypeParser::getInstance().writeArray(writer, values);
+}
+
+static const std::string JSON_CONTENT_TYPE = "application/json";
+// Error responses of file downloads are short json objects, anything longer isn't kept.
+static const size_t MAX_ERROR_RESPONSE_SIZE = 64 * 1024;
+// Reserved in addition to the sizes of strings, enough for the other arguments and a small keyboard, so the request buffer isn't reallocated.
+static const size_t JSON_BODY_RESERVE = 512;
+
+/**
+ * Request with a json body, which is written straight into the request text after the head.
+ */
+class Api::JsonRequest {
+
+public:
+	JsonRequest(const Api& api, boost::string_ref method, size_t bodySize) :
+		url(api._methodBaseUrl), method(method), bodyOffset(HttpParser::getInstance().generateRequestHead(text, url, method, JSON_CONTENT_TYPE, true, bodySize + JSON_BODY_RESERVE)), writer(text, 0)
+	{
+		writer.startObject();
+	}
+
+	void writeChatId(int64_t id) {
+		chatId = std::to_string(id);
+		writer.key("chat_id").value(id);
+	}
+
+	std::string&& finish() {
+		writer.endObject();
+		HttpParser::getInstance().completeRequest(text, bodyOffset);
+		return std::move(text);
+	}
+
+	const Url& url;
+	const boost::string_ref method;
+	std::string chatId;
+	std::string text;
+	const size_t bodyOffset;
+	JsonWriter writer;
+};
+
+static void writeSendOptions(JsonWriter& writer, const SendOptions& options, bool isText, bool hasCaption) {
+	if (options.replyToMessageId) {
+		writer.key("reply_to_message_id").value(options.replyToMessageId);
+	}
+	if (options.replyMarkup) {
+		writer.key("reply_markup");
+		TgTypeParser::getInstance().writeGenericReply(writer, options.replyMarkup);
+	}
+	if (options.disableNotification) {
+		writer.key("disable_notification").value(true);
+	}
+	if (hasCaption && !options.caption.empty()) {
+		writer.key("caption").value(options.caption);
+	}
+	if (isText && !options.parseMode.empty()) {
+		writer.key("parse_mode").value(options.parseMode);
+	}
+	if (isText && options.disableWebPagePreview) {
+		writer.key("disable_web_page_preview").value(true);
+	}
+}
+
+static void writeEditOptions(JsonWriter& writer, const EditOptions& options, bool isText) {
+	if (options.replyMarkup) {
+		writer.key("reply_markup");
+		TgTypeParser::getInstance().writeGenericReply(writer, options.replyMarkup);
+	}
+	if (isText && !options.parseMode.empty()) {
+		writer.key("parse_mode").value(options.parseMode);
+	}
+	if (isText && options.disableWebPagePreview) {
+		writer.key("disable_web_page_preview").value(true);
+	}
+}
+
+Api::Api(const std::string& token, const std::string& url) : _token(token), _url(url), _methodBaseUrl(url + "/bot" + token + "/") {
+}
+
+void Api::setFileIdCache(const FileIdCache::Ptr& cache) {
+	_fileIdCache = cache;
+}
+
+void Api::setRateLimiter(const RateLimiter::Ptr& rateLimiter) {
+	_rateLimiter = rateLimiter;
 }
 
 User::Ptr Api::getMe() const {
-	return TgTypeParser::getInstance().parseJsonAndGetUser(sendRequest("getMe"));
+	return TgTypeParser::getInstance().parseJsonAndGetUser(*sendRequest("getMe"));
 }
 
 Message::Ptr Api::sendMessage(int64_t chatId, const std::string& text, bool disableWebPagePreview, int32_t replyToMessageId, const GenericReply::Ptr replyMarkup, const std::string& parseMode, bool disableNotification) const {
+	return sendMessage(chatId, std::string(text), disableWebPagePreview, replyToMessageId, replyMarkup, parseMode, disableNotification);
+}
+
+Message::Ptr Api::sendMessage(int64_t chatId, std::string&& text, bool disableWebPagePreview, int32_t replyToMessageId, const GenericReply::Ptr replyMarkup, const std::string& parseMode, bool disableNotification) const {
 	std::vector<HttpReqArg> args;
 	args.push_back(HttpReqArg("chat_id", chatId));
-	args.push_back(HttpReqArg("text", text));
+	args.push_back(HttpReqArg("text", std::move(text)));
 	if (disableWebPagePreview) {
 		args.push_back(HttpReqArg("disable_web_page_preview", disableWebPagePreview));
 	}
@@ -52,12 +174,53 @@ Message::Ptr Api::sendMessage(int64_t chatId, const std::string& text, bool disa
 		args.push_back(HttpReqArg("reply_to_message_id", replyToMessageId));
 	}
 	if (replyMarkup) {
-		args.push_back(HttpReqArg("reply_markup", TgTypeParser::getInstance().parseGenericReply(replyMarkup)));
+		appendJsonArg(args, "reply_markup", &TgTypeParser::writeGenericReply, replyMarkup);
 	}
 	if (!parseMode.empty()) {
 		args.push_back(HttpReqArg("parse_mode", parseMode));
 	}
-	return TgTypeParser::getInstance().parseJsonAndGetMessage(sendRequest("sendMessage", args));
+	return TgTypeParser::getInstance().parseJsonAndGetMessage(*sendRequest("sendMessage", args));
+}
+
+Message::Ptr Api::sendMessage(int64_t chatId, const std::string& text, const SendOptions& options) const {
+	return TgTypeParser::getInstance().parseJsonAndGetMessage(*sendRequest(*makeSendMessageRequest(chatId, text, options)));
+}
+
+int32_t Api::sendMessageAndForget(int64_t chatId, const std::string& text, const SendOptions& options) const {
+	return trySendMessageAndForget(chatId, text, options).getValueOrThrow();
+}
+
+Result<int32_t> Api::trySendMessageAndForget(int64_t chatId, const std::string& text, const SendOptions& options) const {
+	return trySendRequest(*makeSendMessageRequest(chatId, text, options));
+}
+
+PreparedMessage Api::prepareMessage(const std::string& text, const SendOptions& options) {
+	PreparedMessage result;
+	result.method = "sendMessage";
+	JsonWriter writer(result.members, text.size() + JSON_BODY_RESERVE);
+	writer.key("text").value(text);
+	writeSendOptions(writer, options, true, false);
+	return result;
+}
+
+PreparedMessage Api::preparePhoto(const std::string& photoId, const SendOptions& options) {
+	PreparedMessage result;
+	result.method = "sendPhoto";
+	JsonWriter writer(result.members, photoId.size() + options.caption.size() + JSON_BODY_RESERVE);
+	writer.key("photo").value(photoId);
+	writeSendOptions(writer, options, false, true);
+	return result;
+}
+
+int32_t Api::sendPreparedMessage(int64_t chatId, const PreparedMessage& message) const {
+	return trySendPreparedMessage(chatId, message).getValueOrThrow();
+}
+
+Result<int32_t> Api::trySendPreparedMessage(int64_t chatId, const PreparedMessage& message) const {
+	JsonRequest request(*this, message.method, message.members.size());
+	request.writeChatId(chatId);
+	request.writer.rawMembers(message.members);
+	return trySendRequest(request);
 }
 
 Message::Ptr Api::forwardMessage(int64_t chatId, int64_t fromChatId, int32_t messageId, bool disableNotification) const {
@@ -68,13 +231,31 @@ Message::Ptr Api::forwardMessage(int64_t chatId, int64_t fromChatId, int32_t mes
 	if (disableNotification){
 		args.push_back(HttpReqArg("disable_notification", disableNotification));
 	}
-	return TgTypeParser::getInstance().parseJsonAndGetMessage(sendRequest("forwardMessage", args));
+	return TgTypeParser::getInstance().parseJsonAndGetMessage(*sendRequest("forwardMessage", args));
+}
+
+Message::Ptr Api::forwardMessage(int64_t chatId, int64_t fromChatId, int32_t messageId, const SendOptions& options) const {
+	return TgTypeParser::getInstance().parseJsonAndGetMessage(*sendRequest(*makeForwardMessageRequest(chatId, fromChatId, messageId, options)));
+}
+
+int32_t Api::forwardMessageAndForget(int64_t chatId, int64_t fromChatId, int32_t messageId, const SendOptions& options) const {
+	return tryForwardMessageAndForget(chatId, fromChatId, messageId, options).getValueOrThrow();
+}
+
+Result<int32_t> Api::tryForwardMessageAndForget(int64_t chatId, int64_t fromChatId, int32_t messageId, const SendOptions& options) const {
+	return trySendRequest(*makeForwardMessageRequest(chatId, fromChatId, messageId, options));
 }
 
 Message::Ptr Api::sendPhoto(int64_t chatId, const InputFile::Ptr photo, const std::string& caption, int32_t replyToMessageId, const GenericReply::Ptr replyMarkup, bool disableNotification) const {
+	std::string fileKey;
+	if (Message::Ptr message = sendCachedFile(photo, fileKey, [&](const std::string& photoId) {
+		return sendPhoto(chatId, photoId, caption, replyToMessageId, replyMarkup, disableNotification);
+	})) {
+		return message;
+	}
 	std::vector<HttpReqArg> args;
 	args.push_back(HttpReqArg("chat_id", chatId));
-	args.push_back(HttpReqArg("photo", photo->data, true, photo->mimeType, photo->fileName));
+	args.push_back(HttpReqArg("photo", photo));
 	if (!caption.empty()) {
 		args.push_back(HttpReqArg("caption", caption));
 	}
@@ -82,12 +263,16 @@ Message::Ptr Api::sendPhoto(int64_t chatId, const InputFile::Ptr photo, const st
 		args.push_back(HttpReqArg("reply_to_message_id", replyToMessageId));
 	}
 	if (replyMarkup) {
-		args.push_back(HttpReqArg("reply_markup", TgTypeParser::getInstance().parseGenericReply(replyMarkup)));
+		appendJsonArg(args, "reply_markup", &TgTypeParser::writeGenericReply, replyMarkup);
 	}
 	if (disableNotification){
 		args.push_back(HttpReqArg("disable_notification", disableNotification));
 	}
-	return TgTypeParser::getInstance().parseJsonAndGetMessage(sendRequest("sendPhoto", args));
+	Message::Ptr message = TgTypeParser::getInstance().parseJsonAndGetMessage(*sendRequest("sendPhoto", args));
+	if (!fileKey.empty() && !message->photo.empty()) {
+		cacheFileId(fileKey, message->photo.back()->fileId);
+	}
+	return message;
 }
 
 Message::Ptr Api::sendPhoto(int64_t chatId, const std::string& photoId, const std::string& caption, int32_t replyToMessageId, const GenericReply::Ptr replyMarkup, bool disableNotification) const {
@@ -101,18 +286,36 @@ Message::Ptr Api::sendPhoto(int64_t chatId, const std::string& photoId, const st
 		args.push_back(HttpReqArg("reply_to_message_id", replyToMessageId));
 	}
 	if (replyMarkup) {
-		args.push_back(HttpReqArg("reply_markup", TgTypeParser::getInstance().parseGenericReply(replyMarkup)));
+		appendJsonArg(args, "reply_markup", &TgTypeParser::writeGenericReply, replyMarkup);
 	}
 	if (disableNotification){
 		args.push_back(HttpReqArg("disable_notification", disableNotification));
 	}
-	return TgTypeParser::getInstance().parseJsonAndGetMessage(sendRequest("sendPhoto", args));
+	return TgTypeParser::getInstance().parseJsonAndGetMessage(*sendRequest("sendPhoto", args));
+}
+
+Message::Ptr Api::sendPhoto(int64_t chatId, const std::string& photoId, const SendOptions& options) const {
+	return TgTypeParser::getInstance().parseJsonAndGetMessage(*sendRequest(*makeSendFileRequest("sendPhoto", "photo", chatId, photoId, options, true)));
+}
+
+int32_t Api::sendPhotoAndForget(int64_t chatId, const std::string& photoId, const SendOptions& options) const {
+	return trySendPhotoAndForget(chatId, photoId, options).getValueOrThrow();
+}
+
+Result<int32_t> Api::trySendPhotoAndForget(int64_t chatId, const std::string& photoId, const SendOptions& options) const {
+	return trySendRequest(*makeSendFileRequest("sendPhoto", "photo", chatId, photoId, options, true));
 }
 
 Message::Ptr Api::sendAudio(int64_t chatId, const InputFile::Ptr audio, const std::string &caption, int32_t duration, const std::string& performer, const std::string& title, int32_t replyToMessageId, const GenericReply::Ptr replyMarkup, bool disableNotification) const {
+	std::string fileKey;
+	if (Message::Ptr message = sendCachedFile(audio, fileKey, [&](const std::string& audioId) {
+		return sendAudio(chatId, audioId, caption, duration, performer, title, replyToMessageId, replyMarkup, disableNotification);
+	})) {
+		return message;
+	}
 	std::vector<HttpReqArg> args;
 	args.push_back(HttpReqArg("chat_id", chatId));
-	args.push_back(HttpReqArg("audio", audio->data, true, audio->mimeType, audio->fileName));
+	args.push_back(HttpReqArg("audio", audio));
 	if (!caption.empty()) {
 		args.push_back(HttpReqArg("caption", caption));
 	}
@@ -129,12 +332,16 @@ Message::Ptr Api::sendAudio(int64_t chatId, const InputFile::Ptr audio, const st
 		args.push_back(HttpReqArg("reply_to_message_id", replyToMessageId));
 	}
 	if (replyMarkup) {
-		args.push_back(HttpReqArg("reply_markup", TgTypeParser::getInstance().parseGenericReply(replyMarkup)));
+		appendJsonArg(args, "reply_markup", &TgTypeParser::writeGenericReply, replyMarkup);
 	}
 	if (disableNotification){
 		args.push_back(HttpReqArg("disable_notification", disableNotification));
 	}
-	return TgTypeParser::getInstance().parseJsonAndGetMessage(sendRequest("sendAudio", args));
+	Message::Ptr message = TgTypeParser::getInstance().parseJsonAndGetMessage(*sendRequest("sendAudio", args));
+	if (!fileKey.empty() && message->audio) {
+		cacheFileId(fileKey, message->audio->fileId);
+	}
+	return message;
 }
 
 Message::Ptr Api::sendAudio(int64_t chatId, const std::string& audioId, const std::string &caption, int32_t duration, const std::string& performer, const std::string& title, int32_t replyToMessageId, const GenericReply::Ptr replyMarkup, bool disableNotification) const {
@@ -157,18 +364,36 @@ Message::Ptr Api::sendAudio(int64_t chatId, const std::string& audioId, const st
 		args.push_back(HttpReqArg("reply_to_message_id", replyToMessageId));
 	}
 	if (replyMarkup) {
-		args.push_back(HttpReqArg("reply_markup", TgTypeParser::getInstance().parseGenericReply(replyMarkup)));
+		appendJsonArg(args, "reply_markup", &TgTypeParser::writeGenericReply, replyMarkup);
 	}
 	if (disableNotification){
 		args.push_back(HttpReqArg("disable_notification", disableNotification));
 	}
-	return TgTypeParser::getInstance().parseJsonAndGetMessage(sendRequest("sendAudio", args));
+	return TgTypeParser::getInstance().parseJsonAndGetMessage(*sendRequest("sendAudio", args));
+}
+
+Message::Ptr Api::sendAudio(int64_t chatId, const std::string& audioId, const SendOptions& options) const {
+	return TgTypeParser::getInstance().parseJsonAndGetMessage(*sendRequest(*makeSendFileRequest("sendAudio", "audio", chatId, audioId, options, true)));
+}
+
+int32_t Api::sendAudioAndForget(int64_t chatId, const std::string& audioId, const SendOptions& options) const {
+	return trySendAudioAndForget(chatId, audioId, options).getValueOrThrow();
+}
+
+Result<int32_t> Api::trySendAudioAndForget(int64_t chatId, const std::string& audioId, const SendOptions& options) const {
+	return trySendRequest(*makeSendFileRequest("sendAudio", "audio", chatId, audioId, options, true));
 }
 
 Message::Ptr Api::sendDocument(int64_t chatId, const InputFile::Ptr document, const std::string &caption, int32_t replyToMessageId, const GenericReply::Ptr replyMarkup, bool disableNotification) const {
+	std::string fileKey;
+	if (Message::Ptr message = sendCachedFile(document, fileKey, [&](const std::string& documentId) {
+		return sendDocument(chatId, documentId, caption, replyToMessageId, replyMarkup, disableNotification);
+	})) {
+		return message;
+	}
 	std::vector<HttpReqArg> args;
 	args.push_back(HttpReqArg("chat_id", chatId));
-	args.push_back(HttpReqArg("document", document->data, true, document->mimeType, document->fileName));
+	args.push_back(HttpReqArg("document", document));
 	if (!caption.empty()) {
 		args.push_back(HttpReqArg("caption", caption));
 	}
@@ -176,12 +401,16 @@ Message::Ptr Api::sendDocument(int64_t chatId, const InputFile::Ptr document, co
 		args.push_back(HttpReqArg("reply_to_message_id", replyToMessageId));
 	}
 	if (replyMarkup) {
-		args.push_back(HttpReqArg("reply_markup", TgTypeParser::getInstance().parseGenericReply(replyMarkup)));
+		appendJsonArg(args, "reply_markup", &TgTypeParser::writeGenericReply, replyMarkup);
 	}
 	if (disableNotification){
 		args.push_back(HttpReqArg("disable_notification", disableNotification));
 	}
-	return TgTypeParser::getInstance().parseJsonAndGetMessage(sendRequest("sendDocument", args));
+	Message::Ptr message = TgTypeParser::getInstance().parseJsonAndGetMessage(*sendRequest("sendDocument", args));
+	if (!fileKey.empty() && message->document) {
+		cacheFileId(fileKey, message->document->fileId);
+	}
+	return message;
 }
 
 Message::Ptr Api::sendDocument(int64_t chatId, const std::string& document, const std::string &caption, int32_t replyToMessageId, const GenericReply::Ptr replyMarkup, bool disableNotification) const {
@@ -195,28 +424,50 @@ Message::Ptr Api::sendDocument(int64_t chatId, const std::string& document, cons
 		args.push_back(HttpReqArg("reply_to_message_id", replyToMessageId));
 	}
 	if (replyMarkup) {
-		args.push_back(HttpReqArg("reply_markup", TgTypeParser::getInstance().parseGenericReply(replyMarkup)));
+		appendJsonArg(args, "reply_markup", &TgTypeParser::writeGenericReply, replyMarkup);
 	}
 	if (disableNotification){
 		args.push_back(HttpReqArg("disable_notification", disableNotification));
 	}
-	return TgTypeParser::getInstance().parseJsonAndGetMessage(sendRequest("sendDocument", args));
+	return TgTypeParser::getInstance().parseJsonAndGetMessage(*sendRequest("sendDocument", args));
+}
+
+Message::Ptr Api::sendDocument(int64_t chatId, const std::string& documentId, const SendOptions& options) const {
+	return TgTypeParser::getInstance().parseJsonAndGetMessage(*sendRequest(*makeSendFileRequest("sendDocument", "document", chatId, documentId, options, true)));
+}
+
+int32_t Api::sendDocumentAndForget(int64_t chatId, const std::string& documentId, const SendOptions& options) const {
+	return trySendDocumentAndForget(chatId, documentId, options).getValueOrThrow();
+}
+
+Result<int32_t> Api::trySendDocumentAndForget(int64_t chatId, const std::string& documentId, const SendOptions& options) const {
+	return trySendRequest(*makeSendFileRequest("sendDocument", "document", chatId, documentId, options, true));
 }
 
 Message::Ptr Api::sendSticker(int64_t chatId, const InputFile::Ptr sticker, int32_t replyToMessageId, const GenericReply::Ptr replyMarkup, bool disableNotification) const {
+	std::string fileKey;
+	if (Message::Ptr message = sendCachedFile(sticker, fileKey, [&](const std::string& stickerId) {
+		return sendSticker(chatId, stickerId, replyToMessageId, replyMarkup, disableNotification);
+	})) {
+		return message;
+	}
 	std::vector<HttpReqArg> args;
 	args.push_back(HttpReqArg("chat_id", chatId));
-	args.push_back(HttpReqArg("sticker", sticker->data, true, sticker->mimeType, sticker->fileName));
+	args.push_back(HttpReqArg("sticker", sticker));
 	if (replyToMessageId) {
 		args.push_back(HttpReqArg("reply_to_message_id", replyToMessageId));
 	}
 	if (replyMarkup) {
-		args.push_back(HttpReqArg("reply_markup", TgTypeParser::getInstance().parseGenericReply(replyMarkup)));
+		appendJsonArg(args, "reply_markup", &TgTypeParser::writeGenericReply, replyMarkup);
 	}
 	if (disableNotification){
 		args.push_back(HttpReqArg("disable_notification", disableNotification));
 	}
-	return TgTypeParser::getInstance().parseJsonAndGetMessage(sendRequest("sendSticker", args));
+	Message::Ptr message = TgTypeParser::getInstance().parseJsonAndGetMessage(*sendRequest("sendSticker", args));
+	if (!fileKey.empty() && message->sticker) {
+		cacheFileId(fileKey, message->sticker->fileId);
+	}
+	return message;
 }
 
 Message::Ptr Api::sendSticker(int64_t chatId, const std::string& stickerId, int32_t replyToMessageId, const GenericReply::Ptr replyMarkup, bool disableNotification) const {
@@ -227,18 +478,36 @@ Message::Ptr Api::sendSticker(int64_t chatId, const std::string& stickerId, int3
 		args.push_back(HttpReqArg("reply_to_message_id", replyToMessageId));
 	}
 	if (replyMarkup) {
-		args.push_back(HttpReqArg("reply_markup", TgTypeParser::getInstance().parseGenericReply(replyMarkup)));
+		appendJsonArg(args, "reply_markup", &TgTypeParser::writeGenericReply, replyMarkup);
 	}
 	if (disableNotification){
 		args.push_back(HttpReqArg("disable_notification", disableNotification));
 	}
-	return TgTypeParser::getInstance().parseJsonAndGetMessage(sendRequest("sendSticker", args));
+	return TgTypeParser::getInstance().parseJsonAndGetMessage(*sendRequest("sendSticker", args));
+}
+
+Message::Ptr Api::sendSticker(int64_t chatId, const std::string& stickerId, const SendOptions& options) const {
+	return TgTypeParser::getInstance().parseJsonAndGetMessage(*sendRequest(*makeSendFileRequest("sendSticker", "sticker", chatId, stickerId, options, false)));
+}
+
+int32_t Api::sendStickerAndForget(int64_t chatId, const std::string& stickerId, const SendOptions& options) const {
+	return trySendStickerAndForget(chatId, stickerId, options).getValueOrThrow();
+}
+
+Result<int32_t> Api::trySendStickerAndForget(int64_t chatId, const std::string& stickerId, const SendOptions& options) const {
+	return trySendRequest(*makeSendFileRequest("sendSticker", "sticker", chatId, stickerId, options, false));
 }
 
 Message::Ptr Api::sendVideo(int64_t chatId, const InputFile::Ptr video, int32_t duration, int32_t width, int32_t height, const std::string &caption, int32_t replyToMessageId, const GenericReply::Ptr replyMarkup, bool disableNotification) const {
+	std::string fileKey;
+	if (Message::Ptr message = sendCachedFile(video, fileKey, [&](const std::string& videoId) {
+		return sendVideo(chatId, videoId, duration, width, height, caption, replyToMessageId, replyMarkup, disableNotification);
+	})) {
+		return message;
+	}
 	std::vector<HttpReqArg> args;
 	args.push_back(HttpReqArg("chat_id", chatId));
-	args.push_back(HttpReqArg("video", video->data, true, video->mimeType, video->fileName));
+	args.push_back(HttpReqArg("video", video));
 	if (duration) {
 		args.push_back(HttpReqArg("duration", duration));
 	}
@@ -255,12 +524,16 @@ Message::Ptr Api::sendVideo(int64_t chatId, const InputFile::Ptr video, int32_t
 		args.push_back(HttpReqArg("reply_to_message_id", replyToMessageId));
 	}
 	if (replyMarkup) {
-		args.push_back(HttpReqArg("reply_markup", TgTypeParser::getInstance().parseGenericReply(replyMarkup)));
+		appendJsonArg(args, "reply_markup", &TgTypeParser::writeGenericReply, replyMarkup);
 	}
 	if (disableNotification){
 		args.push_back(HttpReqArg("disable_notification", disableNotification));
 	}
-	return TgTypeParser::getInstance().parseJsonAndGetMessage(sendRequest("sendVideo", args));
+	Message::Ptr message = TgTypeParser::getInstance().parseJsonAndGetMessage(*sendRequest("sendVideo", args));
+	if (!fileKey.empty() && message->video) {
+		cacheFileId(fileKey, message->video->fileId);
+	}
+	return message;
 }
 
 Message::Ptr Api::sendVideo(int64_t chatId, const std::string& videoId, int32_t duration, int32_t width, int32_t height, const std::string &caption, int32_t replyToMessageId, const GenericReply::Ptr replyMarkup, bool disableNotification) const {
@@ -283,12 +556,24 @@ Message::Ptr Api::sendVideo(int64_t chatId, const std::string& videoId, int32_t
 		args.push_back(HttpReqArg("reply_to_message_id", replyToMessageId));
 	}
 	if (replyMarkup) {
-		args.push_back(HttpReqArg("reply_markup", TgTypeParser::getInstance().parseGenericReply(replyMarkup)));
+		appendJsonArg(args, "reply_markup", &TgTypeParser::writeGenericReply, replyMarkup);
 	}
 	if (disableNotification){
 		args.push_back(HttpReqArg("disable_notification", disableNotification));
 	}
-	return TgTypeParser::getInstance().parseJsonAndGetMessage(sendRequest("sendVideo", args));
+	return TgTypeParser::getInstance().parseJsonAndGetMessage(*sendRequest("sendVideo", args));
+}
+
+Message::Ptr Api::sendVideo(int64_t chatId, const std::string& videoId, const SendOptions& options) const {
+	return TgTypeParser::getInstance().parseJsonAndGetMessage(*sendRequest(*makeSendFileRequest("sendVideo", "video", chatId, videoId, options, true)));
+}
+
+int32_t Api::sendVideoAndForget(int64_t chatId, const std::string& videoId, const SendOptions& options) const {
+	return trySendVideoAndForget(chatId, videoId, options).getValueOrThrow();
+}
+
+Result<int32_t> Api::trySendVideoAndForget(int64_t chatId, const std::string& videoId, const SendOptions& options) const {
+	return trySendRequest(*makeSendFileRequest("sendVideo", "video", chatId, videoId, options, true));
 }
 
 Message::Ptr Api::sendVideoNote(int64_t chatId, const InputFile::Ptr videoNote, int64_t replyToMessageId, bool disableNotification, int32_t duration, int32_t length, const GenericReply::Ptr replyMarkup) {
@@ -308,9 +593,9 @@ Message::Ptr Api::sendVideoNote(int64_t chatId, const InputFile::Ptr videoNote,
         args.push_back(HttpReqArg("length", length));
     }
     if (replyMarkup) {
-        args.push_back(HttpReqArg("reply_markup", TgTypeParser::getInstance().parseGenericReply(replyMarkup)));
+        appendJsonArg(args, "reply_markup", &TgTypeParser::writeGenericReply, replyMarkup);
     }
-    return TgTypeParser::getInstance().parseJsonAndGetMessage(sendRequest("sendVoiceNote", args));
+    return TgTypeParser::getInstance().parseJsonAndGetMessage(*sendRequest("sendVoiceNote", args));
 }
 
 Message::Ptr Api::sendVideoNote(int64_t chatId, const std::string &videoNote, int64_t replyToMessageId, bool disableNotification, int32_t duration, int32_t length, const GenericReply::Ptr replyMarkup) {
@@ -330,15 +615,21 @@ Message::Ptr Api::sendVideoNote(int64_t chatId, const std::string &videoNote, in
         args.push_back(HttpReqArg("length", length));
     }
     if (replyMarkup) {
-        args.push_back(HttpReqArg("reply_markup", TgTypeParser::getInstance().parseGenericReply(replyMarkup)));
+        appendJsonArg(args, "reply_markup", &TgTypeParser::writeGenericReply, replyMarkup);
     }
-    return TgTypeParser::getInstance().parseJsonAndGetMessage(sendRequest("sendVoiceNote", args));
+    return TgTypeParser::getInstance().parseJsonAndGetMessage(*sendRequest("sendVoiceNote", args));
 }
 
 Message::Ptr Api::sendVoice(int64_t chatId, const InputFile::Ptr voice, const std::string &caption, int duration, int32_t replyToMessageId, const GenericReply::Ptr replyMarkup, bool disableNotification) const {
+	std::string fileKey;
+	if (Message::Ptr message = sendCachedFile(voice, fileKey, [&](const std::string& voiceId) {
+		return sendVoice(chatId, voiceId, caption, duration, replyToMessageId, replyMarkup, disableNotification);
+	})) {
+		return message;
+	}
 	std::vector<HttpReqArg> args;
 	args.push_back(HttpReqArg("chat_id", chatId));
-	args.push_back(HttpReqArg("voice", voice->data, true, voice->mimeType, voice->fileName));
+	args.push_back(HttpReqArg("voice", voice));
 	if (!caption.empty()) {
 		args.push_back(HttpReqArg("caption", caption));
 	}
@@ -349,12 +640,16 @@ Message::Ptr Api::sendVoice(int64_t chatId, const InputFile::Ptr voice, const st
 		args.push_back(HttpReqArg("reply_to_message_id", replyToMessageId));
 	}
 	if (replyMarkup) {
-		args.push_back(HttpReqArg("reply_markup", TgTypeParser::getInstance().parseGenericReply(replyMarkup)));
+		appendJsonArg(args, "reply_markup", &TgTypeParser::writeGenericReply, replyMarkup);
 	}
 	if (disableNotification){
 		args.push_back(HttpReqArg("disable_notification", disableNotification));
 	}
-	return TgTypeParser::getInstance().parseJsonAndGetMessage(sendRequest("sendVoice", args));
+	Message::Ptr message = TgTypeParser::getInstance().parseJsonAndGetMessage(*sendRequest("sendVoice", args));
+	if (!fileKey.empty() && message->voice) {
+		cacheFileId(fileKey, message->voice->file_id);
+	}
+	return message;
 }
 
 Message::Ptr Api::sendVoice(int64_t chatId, const std::string& voiceId, const std::string &caption, int duration, int32_t replyToMessageId, const GenericReply::Ptr replyMarkup, bool disableNotification) const {
@@ -371,12 +666,24 @@ Message::Ptr Api::sendVoice(int64_t chatId, const std::string& voiceId, const st
 		args.push_back(HttpReqArg("reply_to_message_id", replyToMessageId));
 	}
 	if (replyMarkup) {
-		args.push_back(HttpReqArg("reply_markup", TgTypeParser::getInstance().parseGenericReply(replyMarkup)));
+		appendJsonArg(args, "reply_markup", &TgTypeParser::writeGenericReply, replyMarkup);
 	}
 	if (disableNotification){
 		args.push_back(HttpReqArg("disable_notification", disableNotification));
 	}
-	return TgTypeParser::getInstance().parseJsonAndGetMessage(sendRequest("sendVoice", args));
+	return TgTypeParser::getInstance().parseJsonAndGetMessage(*sendRequest("sendVoice", args));
+}
+
+Message::Ptr Api::sendVoice(int64_t chatId, const std::string& voiceId, const SendOptions& options) const {
+	return TgTypeParser::getInstance().parseJsonAndGetMessage(*sendRequest(*makeSendFileRequest("sendVoice", "voice", chatId, voiceId, options, true)));
+}
+
+int32_t Api::sendVoiceAndForget(int64_t chatId, const std::string& voiceId, const SendOptions& options) const {
+	return trySendVoiceAndForget(chatId, voiceId, options).getValueOrThrow();
+}
+
+Result<int32_t> Api::trySendVoiceAndForget(int64_t chatId, const std::string& voiceId, const SendOptions& options) const {
+	return trySendRequest(*makeSendFileRequest("sendVoice", "voice", chatId, voiceId, options, true));
 }
 
 Message::Ptr Api::sendLocation(int64_t chatId, float latitude, float longitude, int32_t replyToMessageId, const GenericReply::Ptr replyMarkup, bool disableNotification) const {
@@ -388,12 +695,24 @@ Message::Ptr Api::sendLocation(int64_t chatId, float latitude, float longitude,
 		args.push_back(HttpReqArg("reply_to_message_id", replyToMessageId));
 	}
 	if (replyMarkup) {
-		args.push_back(HttpReqArg("reply_markup", TgTypeParser::getInstance().parseGenericReply(replyMarkup)));
+		appendJsonArg(args, "reply_markup", &TgTypeParser::writeGenericReply, replyMarkup);
 	}
 	if (disableNotification){
 		args.push_back(HttpReqArg("disable_notification", disableNotification));
 	}
-	return TgTypeParser::getInstance().parseJsonAndGetMessage(sendRequest("sendLocation", args));
+	return TgTypeParser::getInstance().parseJsonAndGetMessage(*sendRequest("sendLocation", args));
+}
+
+Message::Ptr Api::sendLocation(int64_t chatId, float latitude, float longitude, const SendOptions& options) const {
+	return TgTypeParser::getInstance().parseJsonAndGetMessage(*sendRequest(*makeSendLocationRequest(chatId, latitude, longitude, options)));
+}
+
+int32_t Api::sendLocationAndForget(int64_t chatId, float latitude, float longitude, const SendOptions& options) const {
+	return trySendLocationAndForget(chatId, latitude, longitude, options).getValueOrThrow();
+}
+
+Result<int32_t> Api::trySendLocationAndForget(int64_t chatId, float latitude, float longitude, const SendOptions& options) const {
+	return trySendRequest(*makeSendLocationRequest(chatId, latitude, longitude, options));
 }
 
 Message::Ptr Api::sendVenue(int64_t chatId, float latitude, float longitude, std::string title, std::string address, std::string foursquareId, bool disableNotification, int32_t replyToMessageId, const GenericReply::Ptr replyMarkup) const {
@@ -410,12 +729,24 @@ Message::Ptr Api::sendVenue(int64_t chatId, float latitude, float longitude, std
 		args.push_back(HttpReqArg("reply_to_message_id", replyToMessageId));
 	}
 	if (replyMarkup) {
-		args.push_back(HttpReqArg("reply_markup", TgTypeParser::getInstance().parseGenericReply(replyMarkup)));
+		appendJsonArg(args, "reply_markup", &TgTypeParser::writeGenericReply, replyMarkup);
 	}
 	if (disableNotification){
 		args.push_back(HttpReqArg("disable_notification", disableNotification));
 	}
-	return TgTypeParser::getInstance().parseJsonAndGetMessage(sendRequest("sendVenue", args));
+	return TgTypeParser::getInstance().parseJsonAndGetMessage(*sendRequest("sendVenue", args));
+}
+
+Message::Ptr Api::sendVenue(int64_t chatId, float latitude, float longitude, const std::string& title, const std::string& address, const std::string& foursquareId, const SendOptions& options) const {
+	return TgTypeParser::getInstance().parseJsonAndGetMessage(*sendRequest(*makeSendVenueRequest(chatId, latitude, longitude, title, address, foursquareId, options)));
+}
+
+int32_t Api::sendVenueAndForget(int64_t chatId, float latitude, float longitude, const std::string& title, const std::string& address, const std::string& foursquareId, const SendOptions& options) const {
+	return trySendVenueAndForget(chatId, latitude, longitude, title, address, foursquareId, options).getValueOrThrow();
+}
+
+Result<int32_t> Api::trySendVenueAndForget(int64_t chatId, float latitude, float longitude, const std::string& title, const std::string& address, const std::string& foursquareId, const SendOptions& options) const {
+	return trySendRequest(*makeSendVenueRequest(chatId, latitude, longitude, title, address, foursquareId, options));
 }
 
 Message::Ptr Api::sendContact(int64_t chatId, std::string phoneNumber, std::string firstName, std::string lastName, bool disableNotification, int32_t replyToMessageId, const GenericReply::Ptr replyMarkup) const {
@@ -428,12 +759,24 @@ Message::Ptr Api::sendContact(int64_t chatId, std::string phoneNumber, std::stri
 		args.push_back(HttpReqArg("reply_to_message_id", replyToMessageId));
 	}
 	if (replyMarkup) {
-		args.push_back(HttpReqArg("reply_markup", TgTypeParser::getInstance().parseGenericReply(replyMarkup)));
+		appendJsonArg(args, "reply_markup", &TgTypeParser::writeGenericReply, replyMarkup);
 	}
 	if (disableNotification){
 		args.push_back(HttpReqArg("disable_notification", disableNotification));
 	}
-	return TgTypeParser::getInstance().parseJsonAndGetMessage(sendRequest("sendContact", args));
+	return TgTypeParser::getInstance().parseJsonAndGetMessage(*sendRequest("sendContact", args));
+}
+
+Message::Ptr Api::sendContact(int64_t chatId, const std::string& phoneNumber, const std::string& firstName, const std::string& lastName, const SendOptions& options) const {
+	return TgTypeParser::getInstance().parseJsonAndGetMessage(*sendRequest(*makeSendContactRequest(chatId, phoneNumber, firstName, lastName, options)));
+}
+
+int32_t Api::sendContactAndForget(int64_t chatId, const std::string& phoneNumber, const std::string& firstName, const std::string& lastName, const SendOptions& options) const {
+	return trySendContactAndForget(chatId, phoneNumber, firstName, lastName, options).getValueOrThrow();
+}
+
+Result<int32_t> Api::trySendContactAndForget(int64_t chatId, const std::string& phoneNumber, const std::string& firstName, const std::string& lastName, const SendOptions& options) const {
+	return trySendRequest(*makeSendContactRequest(chatId, phoneNumber, firstName, lastName, options));
 }
 
 void Api::sendChatAction(int64_t chatId, const std::string& action) const {
@@ -451,42 +794,42 @@ UserProfilePhotos::Ptr Api::getUserProfilePhotos(int32_t userId, int32_t offset,
 	}
 	limit = std::max(1, std::min(100, limit));
 	args.push_back(HttpReqArg("limit", limit));
-	return TgTypeParser::getInstance().parseJsonAndGetUserProfilePhotos(sendRequest("getUserProfilePhotos", args));
+	return TgTypeParser::getInstance().parseJsonAndGetUserProfilePhotos(*sendRequest("getUserProfilePhotos", args));
 }
 
 File::Ptr Api::getFile(const std::string &fileId) const
 {
 	std::vector<HttpReqArg> args;
 	args.push_back(HttpReqArg("file_id", fileId));
-	return TgTypeParser::getInstance().parseJsonAndGetFile(sendRequest("getFile", args));
+	return TgTypeParser::getInstance().parseJsonAndGetFile(*sendRequest("getFile", args));
 }
 
 bool Api::leaveChat(int64_t chatId) const
 {
 	std::vector<HttpReqArg> args;
 	args.push_back(HttpReqArg("chat_id", chatId));
-	return sendRequest("leaveChat", args).get<bool>("", false);
+	return sendRequest("leaveChat", args)->as<bool>(false);
 }
 
 Chat::Ptr Api::getChat(int64_t chatId) const
 {
 	std::vector<HttpReqArg> args;
 	args.push_back(HttpReqArg("chat_id", chatId));
-	return TgTypeParser::getInstance().parseJsonAndGetChat(sendRequest("getChat", args));
+	return TgTypeParser::getInstance().parseJsonAndGetChat(*sendRequest("getChat", args));
 }
 
 std::vector<ChatMember::Ptr> Api::getChatAdministrators(int64_t chatId) const
 {
 	std::vector<HttpReqArg> args;
 	args.push_back(HttpReqArg("chat_id", chatId));
-	return TgTypeParser::getInstance().parseJsonAndGetArray<ChatMember>(&TgTypeParser::parseJsonAndGetChatMember, sendRequest("getChatAdministrators", args));
+	return TgTypeParser::getInstance().parseJsonAndGetArray<ChatMember>(&TgTypeParser::parseJsonAndGetChatMember, *sendRequest("getChatAdministrators", args));
 }
 
 int32_t Api::getChatMembersCount(int64_t chatId) const
 {
 	std::vector<HttpReqArg> args;
 	args.push_back(HttpReqArg("chat_id", chatId));
-	return sendRequest("getChatMembersCount", args).get<int32_t>("", 0);
+	return sendRequest("getChatMembersCount", args)->as<int32_t>(0);
 }
 
 bool Api::answerCallbackQuery(const std::string & callbackQueryId, const std::string & text, bool showAlert, const std::string &url, int32_t cacheTime) const
@@ -505,14 +848,20 @@ bool Api::answerCallbackQuery(const std::string & callbackQueryId, const std::st
 	if (cacheTime) {
 		args.push_back(HttpReqArg("cache_time", cacheTime));
 	}
-	return sendRequest("answerCallbackQuery", args).get<bool>("", false);
+	return sendRequest("answerCallbackQuery", args)->as<bool>(false);
 }
 
 Message::Ptr Api::editMessageText(const std::string& text, int64_t chatId, int32_t messageId, const std::string& inlineMessageId,
 	const std::string& parseMode, bool disableWebPagePreview, const GenericReply::Ptr replyMarkup) const {
 
+	return editMessageText(std::string(text), chatId, messageId, inlineMessageId, parseMode, disableWebPagePreview, replyMarkup);
+}
+
+Message::Ptr Api::editMessageText(std::string&& text, int64_t chatId, int32_t messageId, const std::string& inlineMessageId,
+	const std::string& parseMode, bool disableWebPagePreview, const GenericReply::Ptr replyMarkup) const {
+
 	std::vector<HttpReqArg> args;
-	args.push_back(HttpReqArg("text", text));
+	args.push_back(HttpReqArg("text", std::move(text)));
 	if (chatId) {
 		args.push_back(HttpReqArg("chat_id", chatId));
 	}
@@ -529,19 +878,49 @@ Message::Ptr Api::editMessageText(const std::string& text, int64_t chatId, int32
 		args.push_back(HttpReqArg("disable_web_page_preview", disableWebPagePreview));
 	}
 	if (replyMarkup) {
-		args.push_back(HttpReqArg("reply_markup", TgTypeParser::getInstance().parseGenericReply(replyMarkup)));
+		appendJsonArg(args, "reply_markup", &TgTypeParser::writeGenericReply, replyMarkup);
 	}
-	ptree p = sendRequest("editMessageText", args);
-	if (p.get_child_optional("message_id")) {
-		return TgTypeParser::getInstance().parseJsonAndGetMessage(p);
+	JsonValue::Ptr p = sendRequest("editMessageText", args);
+	if (p->find("message_id")) {
+		return TgTypeParser::getInstance().parseJsonAndGetMessage(*p);
 	} else {
 		return nullptr;
 	}	
 }
 
+Message::Ptr Api::editMessageText(int64_t chatId, int32_t messageId, const std::string& text, const EditOptions& options) const {
+	return TgTypeParser::getInstance().parseJsonAndGetMessage(*sendRequest(*makeEditMessageRequest("editMessageText", chatId, messageId, "", "text", text, options)));
+}
+
+void Api::editMessageTextAndForget(int64_t chatId, int32_t messageId, const std::string& text, const EditOptions& options) const {
+	tryEditMessageTextAndForget(chatId, messageId, text, options).throwIfFailed();
+}
+
+Result<void> Api::tryEditMessageTextAndForget(int64_t chatId, int32_t messageId, const std::string& text, const EditOptions& options) const {
+	return trySendRequestWithoutValue(*makeEditMessageRequest("editMessageText", chatId, messageId, "", "text", text, options));
+}
+
+bool Api::editMessageText(const std::string& inlineMessageId, const std::string& text, const EditOptions& options) const {
+	return sendRequest(*makeEditMessageRequest("editMessageText", 0, 0, inlineMessageId, "text", text, options))->as<bool>(false);
+}
+
+void Api::editMessageTextAndForget(const std::string& inlineMessageId, const std::string& text, const EditOptions& options) const {
+	tryEditMessageTextAndForget(inlineMessageId, text, options).throwIfFailed();
+}
+
+Result<void> Api::tryEditMessageTextAndForget(const std::string& inlineMessageId, const std::string& text, const EditOptions& options) const {
+	return trySendRequestWithoutValue(*makeEditMessageRequest("editMessageText", 0, 0, inlineMessageId, "text", text, options));
+}
+
 Message::Ptr Api::editMessageCaption(int64_t chatId, int32_t messageId, const std::string& caption,
 									 const std::string& inlineMessageId, const GenericReply::Ptr replyMarkup) const {
 
+	return editMessageCaption(chatId, messageId, std::string(caption), inlineMessageId, replyMarkup);
+}
+
+Message::Ptr Api::editMessageCaption(int64_t chatId, int32_t messageId, std::string&& caption,
+									 const std::string& inlineMessageId, const GenericReply::Ptr replyMarkup) const {
+
 	std::vector<HttpReqArg> args;
 	if (chatId) {
 		args.push_back(HttpReqArg("chat_id", chatId));
@@ -550,23 +929,47 @@ Message::Ptr Api::editMessageCaption(int64_t chatId, int32_t messageId, const st
 		args.push_back(HttpReqArg("message_id", messageId));
 	}
 	if (!caption.empty()) {
-		args.push_back(HttpReqArg("caption", caption));
+		args.push_back(HttpReqArg("caption", std::move(caption)));
 	}
 	if (!inlineMessageId.empty()) {
 		args.push_back(HttpReqArg("inline_message_id", inlineMessageId));
 	}
 	if (replyMarkup) {
-		args.push_back(HttpReqArg("reply_markup", TgTypeParser::getInstance().parseGenericReply(replyMarkup)));
+		appendJsonArg(args, "reply_markup", &TgTypeParser::writeGenericReply, replyMarkup);
 	}
-	ptree p = sendRequest("editMessageCaption", args);
-	if (p.get_child_optional("message_id")) {
-		return TgTypeParser::getInstance().parseJsonAndGetMessage(p);
+	JsonValue::Ptr p = sendRequest("editMessageCaption", args);
+	if (p->find("message_id")) {
+		return TgTypeParser::getInstance().parseJsonAndGetMessage(*p);
 	} else {
 		return nullptr;
 	}
 
 }
 
+Message::Ptr Api::editMessageCaption(int64_t chatId, int32_t messageId, const std::string& caption, const EditOptions& options) const {
+	return TgTypeParser::getInstance().parseJsonAndGetMessage(*sendRequest(*makeEditMessageRequest("editMessageCaption", chatId, messageId, "", "caption", caption, options)));
+}
+
+void Api::editMessageCaptionAndForget(int64_t chatId, int32_t messageId, const std::string& caption, const EditOptions& options) const {
+	tryEditMessageCaptionAndForget(chatId, messageId, caption, options).throwIfFailed();
+}
+
+Result<void> Api::tryEditMessageCaptionAndForget(int64_t chatId, int32_t messageId, const std::string& caption, const EditOptions& options) const {
+	return trySendRequestWithoutValue(*makeEditMessageRequest("editMessageCaption", chatId, messageId, "", "caption", caption, options));
+}
+
+bool Api::editMessageCaption(const std::string& inlineMessageId, const std::string& caption, const EditOptions& options) const {
+	return sendRequest(*makeEditMessageRequest("editMessageCaption", 0, 0, inlineMessageId, "caption", caption, options))->as<bool>(false);
+}
+
+void Api::editMessageCaptionAndForget(const std::string& inlineMessageId, const std::string& caption, const EditOptions& options) const {
+	tryEditMessageCaptionAndForget(inlineMessageId, caption, options).throwIfFailed();
+}
+
+Result<void> Api::tryEditMessageCaptionAndForget(const std::string& inlineMessageId, const std::string& caption, const EditOptions& options) const {
+	return trySendRequestWithoutValue(*makeEditMessageRequest("editMessageCaption", 0, 0, inlineMessageId, "caption", caption, options));
+}
+
 Message::Ptr Api::editMessageReplyMarkup(int64_t chatId, int32_t messageId, const std::string& inlineMessageId,
 										 const GenericReply::Ptr replyMarkup) const {
 
@@ -581,25 +984,49 @@ Message::Ptr Api::editMessageReplyMarkup(int64_t chatId, int32_t messageId, cons
 		args.push_back(HttpReqArg("inline_message_id", inlineMessageId));
 	}
 	if (replyMarkup) {
-		args.push_back(HttpReqArg("reply_markup", TgTypeParser::getInstance().parseGenericReply(replyMarkup)));
+		appendJsonArg(args, "reply_markup", &TgTypeParser::writeGenericReply, replyMarkup);
 	}
-	ptree p = sendRequest("editMessageReplyMarkup", args);
-	if (p.get_child_optional("message_id")) {
-		return TgTypeParser::getInstance().parseJsonAndGetMessage(p);
+	JsonValue::Ptr p = sendRequest("editMessageReplyMarkup", args);
+	if (p->find("message_id")) {
+		return TgTypeParser::getInstance().parseJsonAndGetMessage(*p);
 	} else {
 		return nullptr;
 	}
 }
 
+Message::Ptr Api::editMessageReplyMarkup(int64_t chatId, int32_t messageId, const EditOptions& options) const {
+	return TgTypeParser::getInstance().parseJsonAndGetMessage(*sendRequest(*makeEditMessageRequest("editMessageReplyMarkup", chatId, messageId, "", "", "", options)));
+}
+
+void Api::editMessageReplyMarkupAndForget(int64_t chatId, int32_t messageId, const EditOptions& options) const {
+	tryEditMessageReplyMarkupAndForget(chatId, messageId, options).throwIfFailed();
+}
+
+Result<void> Api::tryEditMessageReplyMarkupAndForget(int64_t chatId, int32_t messageId, const EditOptions& options) const {
+	return trySendRequestWithoutValue(*makeEditMessageRequest("editMessageReplyMarkup", chatId, messageId, "", "", "", options));
+}
+
+bool Api::editMessageReplyMarkup(const std::string& inlineMessageId, const EditOptions& options) const {
+	return sendRequest(*makeEditMessageRequest("editMessageReplyMarkup", 0, 0, inlineMessageId, "", "", options))->as<bool>(false);
+}
+
+void Api::editMessageReplyMarkupAndForget(const std::string& inlineMessageId, const EditOptions& options) const {
+	tryEditMessageReplyMarkupAndForget(inlineMessageId, options).throwIfFailed();
+}
+
+Result<void> Api::tryEditMessageReplyMarkupAndForget(const std::string& inlineMessageId, const EditOptions& options) const {
+	return trySendRequestWithoutValue(*makeEditMessageRequest("editMessageReplyMarkup", 0, 0, inlineMessageId, "", "", options));
+}
+
 ChatMember::Ptr Api::getChatMember(int64_t chatId, int32_t userId) const
 {
 	std::vector<HttpReqArg> args;
 	args.push_back(HttpReqArg("chat_id", chatId));
 	args.push_back(HttpReqArg("user_id", userId));
-	return TgTypeParser::getInstance().parseJsonAndGetChatMember(sendRequest("getChatMember", args));
+	return TgTypeParser::getInstance().parseJsonAndGetChatMember(*sendRequest("getChatMember", args));
 }
 
-std::vector<Update::Ptr> Api::getUpdates(int32_t offset, int32_t limit, int32_t timeout, const StringArrayPtr &allowedUpdates) const {
+static std::vector<HttpReqArg> getUpdatesArgs(int32_t offset, int32_t limit, int32_t timeout, const std::shared_ptr<std::vector<std::string>>& allowedUpdates) {
 	std::vector<HttpReqArg> args;
 	if (offset) {
 		args.push_back(HttpReqArg("offset", offset));
@@ -610,13 +1037,68 @@ std::vector<Update::Ptr> Api::getUpdates(int32_t offset, int32_t limit, int32_t
 		args.push_back(HttpReqArg("timeout", timeout));
 	}
 	if (allowedUpdates!=nullptr) {
-		std::string allowedUpdatesJson = TgTypeParser::getInstance().parseArray<std::string>(
-			[](const std::string &s)->std::string {
-			return s;
-		}, *allowedUpdates);
-		args.push_back(HttpReqArg("allowed_updates", allowedUpdatesJson));
+		appendJsonArg(args, "allowed_updates", *allowedUpdates);
 	}
-	return TgTypeParser::getInstance().parseJsonAndGetArray<Update>(&TgTypeParser::parseJsonAndGetUpdate, sendRequest("getUpdates", args));
+	return args;
+}
+
+std::vector<Update::Ptr> Api::getUpdates(int32_t offset, int32_t limit, int32_t timeout, const StringArrayPtr &allowedUpdates) const {
+	std::vector<HttpReqArg> args = getUpdatesArgs(offset, limit, timeout, allowedUpdates);
+	return TgTypeParser::getInstance().parseJsonAndGetArray<Update>(&TgTypeParser::parseJsonAndGetUpdate, *sendRequest("getUpdates", args));
+}
+
+void Api::streamUpdates(const std::function<void (const Update::Ptr&)>& handler, int32_t offset, int32_t limit, int32_t timeout, const StringArrayPtr &allowedUpdates) const {
+	// Elements of "result" are cut out and parsed on a worker thread as they arrive, updates are built from them on this thread.
+	struct StreamState {
+		StreamState() : elements(std::numeric_limits<size_t>::max()), parser("result", [this](JsonValue::Ptr element) {
+			elements.push(std::move(element));
+		}) {
+		}
+
+		BlockingQueue<JsonValue::Ptr> elements;
+		JsonArrayStreamParser parser;
+		bool isStarted = false;
+		std::exception_ptr error;
+		JsonValue::Ptr response;
+	};
+	auto state(std::make_shared<StreamState>());
+
+	std::vector<HttpReqArg> args = getUpdatesArgs(offset, limit, timeout, allowedUpdates);
+	HttpClient::getInstance().makeRequestAsync(getMethodUrl("getUpdates"), args, [state](const char* data, size_t length) {
+		if (state->error) {
+			return;
+		}
+		if (!state->isStarted && length >= 6 && !memcmp(data, "<html>", 6)) {
+			state->error = std::make_exception_ptr(TgException("tgbot-cpp library have got html page instead of json response. Maybe you entered wrong bot token."));
+			return;
+		}
+		state->isStarted = true;
+		try {
+			state->parser.feed(data, length);
+		} catch (JsonException& e) {
+			state->error = std::make_exception_ptr(TgException("tgbot-cpp library can't parse json response. " + std::string(e.what())));
+		}
+	}, [state](const boost::system::error_code& error, std::string&&) {
+		if (error) {
+			state->error = std::make_exception_ptr(boost::system::system_error(error));
+		} else if (!state->error) {
+			try {
+				state->response = state->parser.finish();
+			} catch (JsonException& e) {
+				state->error = std::make_exception_ptr(TgException("tgbot-cpp library can't parse json response. " + std::string(e.what())));
+			}
+		}
+		state->elements.close();
+	}, HttpParser::BodyEncoding::Json);
+
+	JsonValue::Ptr element;
+	while (state->elements.pop(element)) {
+		handler(TgTypeParser::getInstance().parseJsonAndGetUpdate(*element));
+	}
+	if (state->error) {
+		std::rethrow_exception(state->error);
+	}
+	getResult(state->response);
 }
 
 void Api::setWebhook(const std::string& url, const InputFile::Ptr certificate, int32_t maxConnection, const StringArrayPtr &allowedUpdates) const {
@@ -624,17 +1106,13 @@ void Api::setWebhook(const std::string& url, const InputFile::Ptr certificate, i
 	if (!url.empty())
 		args.push_back(HttpReqArg("url", url));
 	if (certificate != nullptr)
-		args.push_back(HttpReqArg("certificate", certificate->data, true, certificate->mimeType, certificate->fileName));
+		args.push_back(HttpReqArg("certificate", certificate));
 	if (maxConnection!=40)
 		args.push_back(HttpReqArg("max_connections", maxConnection));
 	
 	if (allowedUpdates!=nullptr)
 	{
-		std::string allowedUpdatesJson = TgTypeParser::getInstance().parseArray<std::string>(
-			[](const std::string &s)->std::string {
-				return s;
-			}, *allowedUpdates);
-		args.push_back(HttpReqArg("allowed_updates", allowedUpdatesJson));
+		appendJsonArg(args, "allowed_updates", *allowedUpdates);
 	}
 
 	sendRequest("setWebhook", args);
@@ -642,20 +1120,19 @@ void Api::setWebhook(const std::string& url, const InputFile::Ptr certificate, i
 
 bool Api::deleteWebhook() const
 {
-	ptree p = sendRequest("deleteWebhook");
-	return p.get<bool>("", false);
+	return sendRequest("deleteWebhook")->as<bool>(false);
 }
 
 WebhookInfo::Ptr Api::getWebhookInfo() const
 {
-	ptree p = sendRequest("getWebhookInfo");
+	JsonValue::Ptr p = sendRequest("getWebhookInfo");
 
-	if (!p.get_child_optional("url"))
+	if (!p->find("url"))
 		return nullptr;
 
-	if (p.get<std::string>("url","")!=std::string(""))
+	if (p->get<std::string>("url","")!=std::string(""))
 	{
-		return TgTypeParser::getInstance().parseJsonAndGetWebhookInfo(p);
+		return TgTypeParser::getInstance().parseJsonAndGetWebhookInfo(*p);
 	} 
 	else 
 	{
@@ -667,8 +1144,7 @@ bool Api::answerInlineQuery(const std::string& inlineQueryId, const std::vector<
 	int32_t cacheTime, bool isPersonal, const std::string& nextOffset, const std::string& switchPmText, const std::string& switchPmParameter) const {
 	std::vector<HttpReqArg> args;
 	args.push_back(HttpReqArg("inline_query_id", inlineQueryId));
-	std::string resultsJson = TgTypeParser::getInstance().parseArray<InlineQueryResult>(&TgTypeParser::parseInlineQueryResult, results);
-	args.push_back(HttpReqArg("results", resultsJson));
+	appendJsonArg(args, "results", &TgTypeParser::writeInlineQueryResult, results);
 	if (cacheTime) {
 		args.push_back(HttpReqArg("cache_time", cacheTime));
 	}
@@ -684,59 +1160,344 @@ bool Api::answerInlineQuery(const std::string& inlineQueryId, const std::vector<
 	if (!switchPmParameter.empty()) {
 		args.push_back(HttpReqArg("switch_pm_parameter", switchPmParameter));
 	}
-	return sendRequest("answerInlineQuery", args).get<bool>("", false);
+	return sendRequest("answerInlineQuery", args)->as<bool>(false);
 }
 
 bool Api::kickChatMember(int64_t chatId, int32_t userId) const {
 	std::vector<HttpReqArg> args;
 	args.push_back(HttpReqArg("chat_id", chatId));
 	args.push_back(HttpReqArg("user_id", userId));
-	return sendRequest("kickChatMember", args).get<bool>("", false);
+	return sendRequest("kickChatMember", args)->as<bool>(false);
 }
 
 bool Api::unbanChatMember(int64_t chatId, int32_t userId) const {
 	std::vector<HttpReqArg> args;
 	args.push_back(HttpReqArg("chat_id", chatId));
 	args.push_back(HttpReqArg("user_id", userId));
-	return sendRequest("unbanChatMember", args).get<bool>("", false);
+	return sendRequest("unbanChatMember", args)->as<bool>(false);
 }
 
 void Api::deleteMessage(int64_t chatId, int32_t messageId) const {
 	sendRequest("deleteMessage", { HttpReqArg("chat_id", chatId), HttpReqArg("message_id", messageId) });
 }
 
-ptree Api::sendRequest(const std::string& method, const std::vector<HttpReqArg>& args) const {
-	std::string url = "https://api.telegram.org/bot";
-	url += _token;
-	url += "/";
-	url += method;
+std::unique_ptr<Api::JsonRequest> Api::makeSendMessageRequest(int64_t chatId, const std::string& text, const SendOptions& options) const {
+	std::unique_ptr<JsonRequest> request(new JsonRequest(*this, "sendMessage", text.size()));
+	request->writeChatId(chatId);
+	request->writer.key("text").value(text);
+	writeSendOptions(request->writer, options, true, false);
+	return request;
+}
+
+std::unique_ptr<Api::JsonRequest> Api::makeSendFileRequest(boost::string_ref method, boost::string_ref fileKey, int64_t chatId, const std::string& fileId,
+														   const SendOptions& options, bool hasCaption) const {
+	std::unique_ptr<JsonRequest> request(new JsonRequest(*this, method, fileId.size() + options.caption.size()));
+	request->writeChatId(chatId);
+	request->writer.key(fileKey).value(fileId);
+	writeSendOptions(request->writer, options, false, hasCaption);
+	return request;
+}
+
+std::unique_ptr<Api::JsonRequest> Api::makeSendLocationRequest(int64_t chatId, float latitude, float longitude, const SendOptions& options) const {
+	std::unique_ptr<JsonRequest> request(new JsonRequest(*this, "sendLocation", 0));
+	request->writeChatId(chatId);
+	request->writer.key("latitude").value(latitude);
+	request->writer.key("longitude").value(longitude);
+	writeSendOptions(request->writer, options, false, false);
+	return request;
+}
+
+std::unique_ptr<Api::JsonRequest> Api::makeSendVenueRequest(int64_t chatId, float latitude, float longitude, const std::string& title, const std::string& address,
+															const std::string& foursquareId, const SendOptions& options) const {
+	std::unique_ptr<JsonRequest> request(new JsonRequest(*this, "sendVenue", title.size() + address.size() + foursquareId.size()));
+	request->writeChatId(chatId);
+	request->writer.key("latitude").value(latitude);
+	request->writer.key("longitude").value(longitude);
+	request->writer.key("title").value(title);
+	request->writer.key("address").value(address);
+	if (!foursquareId.empty()) {
+		request->writer.key("foursquare_id").value(foursquareId);
+	}
+	writeSendOptions(request->writer, options, false, false);
+	return request;
+}
+
+std::unique_ptr<Api::JsonRequest> Api::makeSendContactRequest(int64_t chatId, const std::string& phoneNumber, const std::string& firstName, const std::string& lastName,
+															  const SendOptions& options) const {
+	std::unique_ptr<JsonRequest> request(new JsonRequest(*this, "sendContact", phoneNumber.size() + firstName.size() + lastName.size()));
+	request->writeChatId(chatId);
+	request->writer.key("phone_number").value(phoneNumber);
+	request->writer.key("first_name").value(firstName);
+	if (!lastName.empty()) {
+		request->writer.key("last_name").value(lastName);
+	}
+	writeSendOptions(request->writer, options, false, false);
+	return request;
+}
+
+std::unique_ptr<Api::JsonRequest> Api::makeForwardMessageRequest(int64_t chatId, int64_t fromChatId, int32_t messageId, const SendOptions& options) const {
+	std::unique_ptr<JsonRequest> request(new JsonRequest(*this, "forwardMessage", 0));
+	request->writeChatId(chatId);
+	request->writer.key("from_chat_id").value(fromChatId);
+	request->writer.key("message_id").value(messageId);
+	// Forwarded messages can't be replies and have no keyboard, so only the notification option applies.
+	if (options.disableNotification) {
+		request->writer.key("disable_notification").value(true);
+	}
+	return request;
+}
+
+std::unique_ptr<Api::JsonRequest> Api::makeEditMessageRequest(boost::string_ref method, int64_t chatId, int32_t messageId, const std::string& inlineMessageId,
+															  boost::string_ref key, const std::string& value, const EditOptions& options) const {
+	std::unique_ptr<JsonRequest> request(new JsonRequest(*this, method, inlineMessageId.size() + value.size()));
+	if (inlineMessageId.empty()) {
+		request->writeChatId(chatId);
+		request->writer.key("message_id").value(messageId);
+	} else {
+		request->writer.key("inline_message_id").value(inlineMessageId);
+	}
+	// The key is empty when only the reply markup is edited. Parse mode and link previews apply only to a new text.
+	if (!key.empty()) {
+		request->writer.key(key).value(value);
+	}
+	writeEditOptions(request->writer, options, key == "text");
+	return request;
+}
+
+JsonValue::Ptr Api::sendRequest(const std::string& method, const std::vector<HttpReqArg>& args) const {
+	if (_rateLimiter && isRateLimited(method)) {
+		auto chatId = std::find_if(args.begin(), args.end(), [](const HttpReqArg& arg) {
+			return arg.name == "chat_id";
+		});
+		_rateLimiter->acquire(chatId != args.end() ? chatId->value : "");
+	}
+	return parseResponse(HttpClient::getInstance().makeRequest(getMethodUrl(method), args, HttpParser::BodyEncoding::Json));
+}
 
-	std::string serverResponse = HttpClient::getInstance().makeRequest(url, args);
+JsonValue::Ptr Api::sendRequest(JsonRequest& request) const {
+	return parseResponse(makeRequest(request));
+}
+
+Result<int32_t> Api::trySendRequest(JsonRequest& request) const {
+	std::string response = makeRequest(request);
+	int32_t messageId = 0;
+	if (!TgTypeParser::getInstance().scanResponse(response, messageId)) {
+		// Errors are rare, so they're parsed completely to get their description and parameters.
+		return parseError(std::move(response));
+	}
+	return messageId;
+}
+
+Result<void> Api::trySendRequestWithoutValue(JsonRequest& request) const {
+	Result<int32_t> result = trySendRequest(request);
+	if (!result) {
+		return result.getError();
+	}
+	return Result<void>();
+}
+
+std::string Api::makeRequest(JsonRequest& request) const {
+	if (_rateLimiter && isRateLimited(request.method)) {
+		_rateLimiter->acquire(request.chatId);
+	}
+	return HttpClient::getInstance().makeRequest(request.url, request.finish());
+}
+
+JsonValue::Ptr Api::parseResponse(std::string serverResponse) const {
 	if (!serverResponse.compare(0, 6, "<html>")) {
 		throw TgException("tgbot-cpp library have got html page instead of json response. Maybe you entered wrong bot token.");
 	}
 
-	ptree result = TgTypeParser::getInstance().parseJson(serverResponse);
 	try {
-		if (result.get<bool>("ok", false)) {
-			return result.get_child("result");
-		} else {
-			throw TgException(result.get("description", ""));
-		}
-	} catch (boost::property_tree::ptree_error& e) {
+		return getResult(TgTypeParser::getInstance().parseJson(std::move(serverResponse)));
+	} catch (JsonException& e) {
 		throw TgException("tgbot-cpp library can't parse json response. " + std::string(e.what()));
 	}
 }
 
-std::string Api::downloadFile(const std::string& filePath, const std::vector<HttpReqArg>& args) const {
-	std::string url = "https://api.telegram.org/file/bot";
+bool Api::isRateLimited(boost::string_ref method) {
+	// Flood limits apply to messages, which are sent, forwarded or edited. Chat actions and queries aren't counted.
+	return (method.starts_with("send") && method != "sendChatAction") || method.starts_with("forward") || method.starts_with("edit");
+}
+
+std::string Api::getMethodUrl(const std::string& method) const {
+	std::string url = _url;
+	url += "/bot";
 	url += _token;
 	url += "/";
-	url += filePath;
+	url += method;
+	return url;
+}
 
-	std::string serverResponse = HttpClient::getInstance().makeRequest(url, args);
+JsonValue::Ptr Api::getResult(const JsonValue::Ptr& response) const {
+	if (response->get<bool>("ok", false)) {
+		return JsonValue::Ptr(response, &(*response)["result"]);
+	} else {
+		ApiError error = getError(*response);
+		throw TgException(error.description, error.errorCode, error.parameters);
+	}
+}
+
+ApiError Api::getError(const JsonValue& response) {
+	ApiError error;
+	error.errorCode = response.get<int32_t>("error_code", 0);
+	error.description = response.get("description", "");
+	const JsonValue* parameters = response.find("parameters");
+	if (parameters && parameters->isObject()) {
+		error.parameters = TgTypeParser::getInstance().parseJsonAndGetResponseParameters(*parameters);
+	}
+	return error;
+}
+
+ApiError Api::parseError(std::string serverResponse) const {
+	ApiError error;
+	if (!serverResponse.compare(0, 6, "<html>")) {
+		error.description = "tgbot-cpp library have got html page instead of json response. Maybe you entered wrong bot token.";
+		return error;
+	}
+	JsonValue::Ptr response;
+	try {
+		response = TgTypeParser::getInstance().parseJson(std::move(serverResponse));
+	} catch (JsonException& e) {
+		error.description = "tgbot-cpp library can't parse json response. " + std::string(e.what());
+		return error;
+	}
+	if (response->get<bool>("ok", false)) {
+		error.description = "tgbot-cpp library can't find ok in json response.";
+		return error;
+	}
+	return getError(*response);
+}
+
+std::string Api::downloadFile(const std::string& filePath, const std::vector<HttpReqArg>& args) const {
+	std::string serverResponse = HttpClient::getInstance().makeRequest(getFileUrl(filePath), args);
 
 	return serverResponse;
 }
 
+void Api::downloadFile(const std::string& filePath, const DownloadSink& sink, const DownloadProgressHandler& progress) const {
+	// The body goes to the sink only if the file is found, otherwise it's an error response which is collected to be parsed.
+	struct DownloadState {
+		DownloadSink sink;
+		DownloadProgressHandler progress;
+		unsigned short statusCode = 0;
+		uint64_t fileSize = 0;
+		uint64_t downloadedSize = 0;
+		std::string errorResponse;
+		std::exception_ptr error;
+		std::promise<void> completion;
+	};
+	auto state(std::make_shared<DownloadState>());
+	state->sink = sink;
+	state->progress = progress;
+
+	HttpClient::getInstance().makeRequestAsync(getFileUrl(filePath), std::vector<HttpReqArg>(), [state](const HttpResponseParser& parser) {
+		state->statusCode = parser.getStatusCode();
+		state->fileSize = parser.getContentLength();
+	}, [state](const char* data, size_t length) {
+		if (state->error) {
+			return;
+		}
+		if (state->statusCode != 200) {
+			if (state->errorResponse.size() < MAX_ERROR_RESPONSE_SIZE) {
+				state->errorResponse.append(data, length);
+			}
+			return;
+		}
+		try {
+			state->sink(data, length);
+			state->downloadedSize += length;
+			if (state->progress) {
+				state->progress(state->downloadedSize, state->fileSize);
+			}
+		} catch (...) {
+			state->error = std::current_exception();
+			// Rethrowing makes the client abort the request, so the rest of the file isn't downloaded for nothing.
+			throw;
+		}
+	}, [state](const boost::system::error_code& error, std::string&&) {
+		if (error && !state->error) {
+			state->error = std::make_exception_ptr(boost::system::system_error(error));
+		}
+		state->completion.set_value();
+	});
+
+	state->completion.get_future().wait();
+	if (state->error) {
+		std::rethrow_exception(state->error);
+	}
+	if (state->statusCode != 200) {
+		parseResponse(std::move(state->errorResponse));
+		throw TgException("tgbot-cpp library can't download file, server responded with status " + std::to_string(state->statusCode) + ".");
+	}
+}
+
+void Api::downloadFileToPath(const std::string& filePath, const std::string& destinationPath, const DownloadProgressHandler& progress) const {
+	std::ofstream out(destinationPath, std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!out) {
+		throw std::runtime_error("tgbot-cpp library can't open file " + destinationPath);
+	}
+	downloadFile(filePath, [&out, &destinationPath](const char* data, size_t length) {
+		if (!out.write(data, length)) {
+			throw std::runtime_error("tgbot-cpp library can't write file " + destinationPath);
+		}
+	}, progress);
+	out.close();
+	if (!out) {
+		throw std::runtime_error("tgbot-cpp library can't write file " + destinationPath);
+	}
+}
+
+void Api::downloadFileParallel(const std::string& filePath, const std::string& destinationPath, const DownloadProgressHandler& progress, size_t concurrency) const {
+	ParallelDownloader(concurrency).download(getFileUrl(filePath), destinationPath, progress);
+}
+
+/**
+ * Checks if Telegram didn't accept a file id, e.g. "Bad Request: wrong file identifier/HTTP URL specified".
+ */
+static bool isFileIdRejected(const TgException& e) {
+	if (e.errorCode != 400) {
+		return false;
+	}
+	std::string description = e.what();
+	std::transform(description.begin(), description.end(), description.begin(), ::tolower);
+	return description.find("file identifier") != std::string::npos || description.find("file_id") != std::string::npos;
+}
+
+Message::Ptr Api::sendCachedFile(const InputFile::Ptr& file, std::string& key, const std::function<Message::Ptr (const std::string&)>& sendById) const {
+	if (!_fileIdCache || !file) {
+		return nullptr;
+	}
+	key = FileIdCache::getKey(*file);
+	std::string fileId = _fileIdCache->find(key);
+	if (fileId.empty()) {
+		return nullptr;
+	}
+	try {
+		return sendById(fileId);
+	} catch (TgException& e) {
+		// Only a rejected file id is fixed by uploading the file again. Other errors, even ones mentioning the file, are thrown as is.
+		if (!isFileIdRejected(e)) {
+			throw;
+		}
+		_fileIdCache->erase(key);
+		return nullptr;
+	}
+}
+
+void Api::cacheFileId(const std::string& key, const std::string& fileId) const {
+	if (_fileIdCache) {
+		_fileIdCache->insert(key, fileId);
+	}
+}
+
+std::string Api::getFileUrl(const std::string& filePath) const {
+	std::string url = _url;
+	url += "/file/bot";
+	url += _token;
+	url += "/";
+	url += filePath;
+	return url;
+}
+
 }
@@ -0,0 +1,305 @@
+/*
+ * Copyright (c) 2015 Oleg Morozenkov
+ * Copyright (c) 2017 Maks Mazurov (fox.cpp)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "tgbot/Broadcaster.h"
+
+#include <algorithm>
+#include <sstream>
+
+#include "tgbot/net/RetryEngine.h"
+#include "tgbot/tools/FileTools.h"
+
+using namespace std;
+
+namespace TgBot {
+
+static RateLimiter::Limits makeGlobalLimits(double rate) {
+	RateLimiter::Limits limits;
+	// Every chat gets one message, so only the global limit matters.
+	limits.globalRate = rate;
+	limits.privateChatRate = 0;
+	limits.groupChatRate = 0;
+	return limits;
+}
+
+Broadcaster::Broadcaster(const Api& api, const PreparedMessage& message) : Broadcaster(api, message, Options()) {
+}
+
+Broadcaster::Broadcaster(const Api& api, const PreparedMessage& message, const Options& options)
+	: Broadcaster([&api, message](int64_t chatId) -> Result<void> {
+		Result<int32_t> result = api.trySendPreparedMessage(chatId, message);
+		return result ? Result<void>() : Result<void>(result.getError());
+	}, options)
+{
+}
+
+Broadcaster::Broadcaster(const Sender& sender, const Options& options) :
+	_sender(sender), _options(options), _rateLimiter(makeGlobalLimits(options.rate))
+{
+}
+
+Broadcaster::ChatIdSource Broadcaster::fromFile(const string& filePath) {
+	auto in(make_shared<ifstream>(filePath));
+	if (!*in) {
+		throw runtime_error("tgbot-cpp library can't open file " + filePath);
+	}
+	return [in](int64_t& chatId) {
+		return static_cast<bool>(*in >> chatId);
+	};
+}
+
+Broadcaster::Progress Broadcaster::run(const ChatIdSource& source, const ProgressHandler& progressHandler) {
+	{
+		lock_guard<mutex> lock(_mutex);
+		_committedProgress = Progress();
+		_window.clear();
+		_isStopped = false;
+	}
+	loadCheckpoint();
+	for (uint64_t i = 0; i < _committedProgress.processedCount; ++i) {
+		int64_t chatId;
+		if (!source(chatId)) {
+			break;
+		}
+	}
+	if (!_options.failuresPath.empty()) {
+		_failuresStream.open(_options.failuresPath, ios::out | ios::app);
+	}
+
+	RetryEngine::Options retryOptions;
+	retryOptions.maxAttempts = _options.maxAttempts;
+	retryOptions.threadCount = max<size_t>(_options.concurrency, 1);
+	RetryEngine retryEngine(retryOptions);
+
+	// A few more messages than the number of threads are queued, so the threads don't wait for the source.
+	const size_t maxInFlightCount = retryOptions.threadCount * 2;
+	const chrono::steady_clock::time_point startTime = chrono::steady_clock::now();
+	const uint64_t startProcessedCount = _committedProgress.processedCount;
+	chrono::steady_clock::time_point nextReportTime = startTime + _options.progressInterval;
+	uint64_t position = startProcessedCount;
+	bool hasMoreChats = true;
+
+	unique_lock<mutex> lock(_mutex);
+	while (true) {
+		while (hasMoreChats && !_isStopped && _inFlightCount < maxInFlightCount) {
+			int64_t chatId;
+			lock.unlock();
+			hasMoreChats = source(chatId);
+			lock.lock();
+			if (!hasMoreChats) {
+				break;
+			}
+			_window.emplace_back();
+			++_inFlightCount;
+			uint64_t chatPosition = position++;
+			auto sentChatId(make_shared<int64_t>(chatId));
+			retryEngine.submitResult(chatId, [this, sentChatId](int64_t targetChatId) -> Result<void> {
+				*sentChatId = targetChatId;
+				_rateLimiter.acquire("");
+				return _sender(targetChatId);
+			}, [this, chatPosition, chatId, sentChatId](const Result<void>& result) {
+				complete(chatPosition, chatId, *sentChatId, result);
+			});
+		}
+		if (_inFlightCount == 0 && (!hasMoreChats || _isStopped)) {
+			break;
+		}
+		_condition.wait_until(lock, nextReportTime);
+		if (chrono::steady_clock::now() >= nextReportTime) {
+			Progress progress = getProgress(startTime, startProcessedCount);
+			lock.unlock();
+			saveCheckpoint();
+			if (progressHandler) {
+				progressHandler(progress);
+			}
+			lock.lock();
+			nextReportTime += _options.progressInterval;
+		}
+	}
+	Progress progress = getProgress(startTime, startProcessedCount);
+	lock.unlock();
+
+	saveCheckpoint();
+	_failuresStream.close();
+	if (progressHandler) {
+		progressHandler(progress);
+	}
+	return progress;
+}
+
+void Broadcaster::stop() {
+	lock_guard<mutex> lock(_mutex);
+	_isStopped = true;
+	_condition.notify_all();
+}
+
+Broadcaster::FailureKind Broadcaster::classifyFailure(const ApiError& error) {
+	if (error.description.find("deactivated") != string::npos) {
+		return FailureKind::Deactivated;
+	}
+	// Telegram forbids sending to users who blocked the bot and to chats the bot was kicked from.
+	if (error.errorCode == 403) {
+		return FailureKind::Blocked;
+	}
+	if (error.description.find("chat not found") != string::npos) {
+		return FailureKind::ChatNotFound;
+	}
+	return FailureKind::Other;
+}
+
+const char* Broadcaster::getFailureKindName(FailureKind kind) {
+	switch (kind) {
+		case FailureKind::Blocked:
+			return "blocked";
+		case FailureKind::ChatNotFound:
+			return "chat_not_found";
+		case FailureKind::Deactivated:
+			return "deactivated";
+		default:
+			return "other";
+	}
+}
+
+void Broadcaster::addOutcome(Progress& progress, Outcome outcome) {
+	++progress.processedCount;
+	switch (outcome) {
+		case Outcome::Migrated:
+			++progress.migratedCount;
+			++progress.sentCount;
+			break;
+		case Outcome::Sent:
+			++progress.sentCount;
+			break;
+		case Outcome::Blocked:
+			++progress.blockedCount;
+			break;
+		case Outcome::ChatNotFound:
+			++progress.chatNotFoundCount;
+			break;
+		case Outcome::Deactivated:
+			++progress.deactivatedCount;
+			break;
+		default:
+			++progress.otherFailureCount;
+			break;
+	}
+}
+
+void Broadcaster::complete(uint64_t position, int64_t chatId, int64_t sentChatId, const Result<void>& result) {
+	Entry entry;
+	entry.outcome = sentChatId == chatId ? Outcome::Sent : Outcome::Migrated;
+	entry.chatId = chatId;
+	entry.sentChatId = sentChatId;
+	if (!result) {
+		entry.kind = classifyFailure(result.getError());
+		entry.description = result.getError().description;
+		entry.outcome = entry.kind == FailureKind::Blocked ? Outcome::Blocked
+			: entry.kind == FailureKind::ChatNotFound ? Outcome::ChatNotFound
+			: entry.kind == FailureKind::Deactivated ? Outcome::Deactivated
+			: Outcome::Other;
+	}
+
+	lock_guard<mutex> lock(_mutex);
+	// Outcomes are committed in the order of chats, so the checkpoint only counts chats which are all done before it.
+	// Failures are written at the same time, so chats which are sent again after a resume aren't written twice.
+	_window[position - _committedProgress.processedCount] = std::move(entry);
+	while (!_window.empty() && _window.front().outcome != Outcome::Pending) {
+		addOutcome(_committedProgress, _window.front().outcome);
+		writeFailure(_window.front());
+		_window.pop_front();
+	}
+	--_inFlightCount;
+	_condition.notify_all();
+}
+
+void Broadcaster::writeFailure(const Entry& entry) {
+	if (!_failuresStream.is_open()) {
+		return;
+	}
+	switch (entry.outcome) {
+		case Outcome::Sent:
+			break;
+		case Outcome::Migrated:
+			_failuresStream << entry.chatId << " migrated " << entry.sentChatId << '\n';
+			break;
+		default: {
+			string description = entry.description;
+			replace(description.begin(), description.end(), '\n', ' ');
+			_failuresStream << entry.chatId << ' ' << getFailureKindName(entry.kind) << ' ' << description << '\n';
+			break;
+		}
+	}
+}
+
+void Broadcaster::loadCheckpoint() {
+	if (_options.checkpointPath.empty()) {
+		return;
+	}
+	ifstream in(_options.checkpointPath);
+	Progress progress;
+	if (in >> progress.processedCount >> progress.sentCount >> progress.migratedCount >> progress.blockedCount
+		>> progress.chatNotFoundCount >> progress.deactivatedCount >> progress.otherFailureCount)
+	{
+		lock_guard<mutex> lock(_mutex);
+		_committedProgress = progress;
+	}
+}
+
+void Broadcaster::saveCheckpoint() {
+	if (_options.checkpointPath.empty()) {
+		return;
+	}
+	ostringstream content;
+	{
+		lock_guard<mutex> lock(_mutex);
+		// Failures are flushed first, so the ones before the checkpoint are never lost.
+		if (_failuresStream.is_open()) {
+			_failuresStream.flush();
+		}
+		const Progress& progress = _committedProgress;
+		content << progress.processedCount << ' ' << progress.sentCount << ' ' << progress.migratedCount << ' ' << progress.blockedCount
+			<< ' ' << progress.chatNotFoundCount << ' ' << progress.deactivatedCount << ' ' << progress.otherFailureCount << '\n';
+	}
+	FileTools::replace(content.str(), _options.checkpointPath);
+}
+
+Broadcaster::Progress Broadcaster::getProgress(chrono::steady_clock::time_point startTime, uint64_t startProcessedCount) const {
+	Progress progress = _committedProgress;
+	for (const Entry& entry : _window) {
+		if (entry.outcome != Outcome::Pending) {
+			addOutcome(progress, entry.outcome);
+		}
+	}
+	progress.totalCount = _options.totalCount;
+	double seconds = chrono::duration<double>(chrono::steady_clock::now() - startTime).count();
+	if (seconds > 0) {
+		progress.throughput = (progress.processedCount - startProcessedCount) / seconds;
+	}
+	if (progress.totalCount && progress.throughput > 0) {
+		uint64_t remainingCount = progress.totalCount > progress.processedCount ? progress.totalCount - progress.processedCount : 0;
+		progress.eta = chrono::seconds(static_cast<int64_t>(remainingCount / progress.throughput));
+	}
+	return progress;
+}
+
+}
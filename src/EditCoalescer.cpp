@@ -0,0 +1,227 @@
+/*
+ * Copyright (c) 2015 Oleg Morozenkov
+ * Copyright (c) 2017 Maks Mazurov (fox.cpp)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "tgbot/EditCoalescer.h"
+
+#include <algorithm>
+#include <exception>
+
+#include "tgbot/TgTypeParser.h"
+
+using namespace std;
+
+namespace TgBot {
+
+EditCoalescer::EditCoalescer(const Api& api) : EditCoalescer(api, Options()) {
+}
+
+EditCoalescer::EditCoalescer(const Api& api, const Options& options)
+	: EditCoalescer([&api](int64_t chatId, int32_t messageId, const string& text, const EditOptions& editOptions) {
+		return api.tryEditMessageTextAndForget(chatId, messageId, text, editOptions);
+	}, options)
+{
+}
+
+EditCoalescer::EditCoalescer(const Sender& sender, const Options& options) : _sender(sender), _options(options) {
+	for (size_t i = 0; i < max<size_t>(_options.threadCount, 1); ++i) {
+		_workers.emplace_back(&EditCoalescer::work, this);
+	}
+}
+
+EditCoalescer::~EditCoalescer() {
+	{
+		lock_guard<mutex> lock(_mutex);
+		_isStopped = true;
+	}
+	_condition.notify_all();
+	for (thread& worker : _workers) {
+		worker.join();
+	}
+}
+
+void EditCoalescer::edit(int64_t chatId, int32_t messageId, const string& text, const EditOptions& options) {
+	string content = getContent(text, options);
+	Target target(chatId, messageId);
+
+	lock_guard<mutex> lock(_mutex);
+	++_metrics.requestedCount;
+	Entry& entry = _entries[target];
+	entry.isForgotten = false;
+	// The message will show the text which is being sent, unless sending it fails.
+	const string& shownContent = entry.isSending ? entry.sendingContent : entry.lastSentContent;
+	if (content == shownContent) {
+		if (entry.hasPending) {
+			entry.hasPending = false;
+			++_metrics.supersededCount;
+			_schedule.erase(make_pair(entry.nextEditTime, target));
+		}
+		++_metrics.unchangedCount;
+		return;
+	}
+	if (entry.hasPending && entry.pending.content == content) {
+		++_metrics.unchangedCount;
+		return;
+	}
+	if (entry.hasPending) {
+		++_metrics.supersededCount;
+	} else if (!entry.isSending) {
+		_schedule.emplace(entry.nextEditTime, target);
+		_condition.notify_one();
+	}
+	entry.pending.text = text;
+	entry.pending.options = options;
+	entry.pending.content = move(content);
+	entry.hasPending = true;
+}
+
+void EditCoalescer::flush() {
+	unique_lock<mutex> lock(_mutex);
+	_condition.wait(lock, [this]() {
+		return _isStopped || (_schedule.empty() && _sendingCount == 0);
+	});
+}
+
+void EditCoalescer::forget(int64_t chatId, int32_t messageId) {
+	Target target(chatId, messageId);
+	lock_guard<mutex> lock(_mutex);
+	auto it = _entries.find(target);
+	if (it == _entries.end()) {
+		return;
+	}
+	if (it->second.hasPending) {
+		_schedule.erase(make_pair(it->second.nextEditTime, target));
+	}
+	if (it->second.isSending) {
+		// The entry is erased when sending is done.
+		it->second.hasPending = false;
+		it->second.isForgotten = true;
+	} else {
+		_entries.erase(it);
+	}
+	_condition.notify_all();
+}
+
+EditCoalescer::Metrics EditCoalescer::getMetrics() const {
+	lock_guard<mutex> lock(_mutex);
+	Metrics metrics = _metrics;
+	metrics.pendingCount = _schedule.size();
+	for (const auto& item : _entries) {
+		if (item.second.isSending && item.second.hasPending) {
+			++metrics.pendingCount;
+		}
+	}
+	return metrics;
+}
+
+string EditCoalescer::getContent(const string& text, const EditOptions& options) {
+	string result;
+	string markup = options.replyMarkup ? TgTypeParser::getInstance().parseGenericReply(options.replyMarkup) : string();
+	result.reserve(text.size() + options.parseMode.size() + markup.size() + 4);
+	result.append(text).push_back('\0');
+	result.append(options.parseMode).push_back('\0');
+	result.push_back(options.disableWebPagePreview ? '1' : '0');
+	result.append(markup);
+	return result;
+}
+
+void EditCoalescer::work() {
+	unique_lock<mutex> lock(_mutex);
+	while (!_isStopped) {
+		if (_schedule.empty()) {
+			_condition.wait(lock);
+			continue;
+		}
+		auto first = _schedule.begin();
+		if (first->first > Clock::now()) {
+			_condition.wait_until(lock, first->first);
+			continue;
+		}
+		Target target = first->second;
+		_schedule.erase(first);
+
+		Entry& entry = _entries[target];
+		Edit edit(move(entry.pending));
+		entry.hasPending = false;
+		entry.isSending = true;
+		entry.sendingContent = edit.content;
+		entry.nextEditTime = Clock::now() + _options.minInterval;
+		++_sendingCount;
+		lock.unlock();
+
+		Result<void> result;
+		try {
+			result = _sender(target.first, target.second, edit.text, edit.options);
+		} catch (exception& e) {
+			result = ApiError(0, e.what());
+		} catch (...) {
+			result = ApiError();
+		}
+
+		lock.lock();
+		complete(target, edit, result, lock);
+	}
+}
+
+void EditCoalescer::complete(const Target& target, Edit& edit, const Result<void>& result, unique_lock<mutex>& lock) {
+	Entry& entry = _entries[target];
+	entry.isSending = false;
+	--_sendingCount;
+	bool isFailed = false;
+	const ApiError& error = result.getError();
+	if (result) {
+		++_metrics.sentCount;
+		entry.lastSentContent = move(edit.content);
+	} else if (error.description.find("message is not modified") != string::npos) {
+		++_metrics.unchangedCount;
+		entry.lastSentContent = move(edit.content);
+	} else if (error.parameters && error.parameters->retryAfter > 0) {
+		entry.nextEditTime = max(entry.nextEditTime, Clock::now() + chrono::seconds(error.parameters->retryAfter));
+		if (entry.hasPending) {
+			++_metrics.supersededCount;
+		} else if (!entry.isForgotten) {
+			entry.pending = move(edit);
+			entry.hasPending = true;
+		}
+	} else {
+		++_metrics.failedCount;
+		isFailed = true;
+	}
+
+	if (entry.isForgotten) {
+		_entries.erase(target);
+	} else if (entry.hasPending) {
+		_schedule.emplace(entry.nextEditTime, target);
+	}
+	_condition.notify_all();
+
+	if (isFailed && _options.errorHandler) {
+		lock.unlock();
+		try {
+			_options.errorHandler(target.first, target.second, error);
+		} catch (...) {
+		}
+		lock.lock();
+	}
+}
+
+}
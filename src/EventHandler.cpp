@@ -24,9 +24,109 @@
 #include "tgbot/EventHandler.h"
 #include <algorithm>
 
+using namespace std;
+
 namespace TgBot {
 
+EventHandler::~EventHandler() {
+    try {
+        drain();
+    } catch (...) {
+    }
+}
+
 void EventHandler::handleUpdate(const Update::Ptr update) const {
+    if (_lanes.empty()) {
+        processUpdate(update);
+        return;
+    }
+
+    {
+        lock_guard<mutex> lock(_dispatchErrorMutex);
+        if (_dispatchError) {
+            exception_ptr error = _dispatchError;
+            _dispatchError = nullptr;
+            rethrow_exception(error);
+        }
+    }
+    uint64_t key = static_cast<uint64_t>(getLaneKey(update));
+    _lanes[key % _lanes.size()]->queue.push(update);
+}
+
+void EventHandler::enableParallelDispatch(size_t laneCount, size_t maxQueuedUpdatesPerLane) {
+    drain();
+    if (laneCount == 0) {
+        laneCount = max(thread::hardware_concurrency(), 1u);
+    }
+    for (size_t i = 0; i < laneCount; ++i) {
+        _lanes.emplace_back(new Lane(maxQueuedUpdatesPerLane));
+        Lane* lane = _lanes.back().get();
+        lane->thread = thread(&EventHandler::runLane, this, lane);
+    }
+}
+
+void EventHandler::drain() {
+    for (unique_ptr<Lane>& lane : _lanes) {
+        lane->queue.close();
+    }
+    for (unique_ptr<Lane>& lane : _lanes) {
+        lane->thread.join();
+    }
+    _lanes.clear();
+
+    exception_ptr error;
+    {
+        lock_guard<mutex> lock(_dispatchErrorMutex);
+        error = _dispatchError;
+        _dispatchError = nullptr;
+    }
+    if (error) {
+        rethrow_exception(error);
+    }
+}
+
+size_t EventHandler::getQueuedUpdateCount() const {
+    size_t result = 0;
+    for (const unique_ptr<Lane>& lane : _lanes) {
+        result += lane->queue.size();
+    }
+    return result;
+}
+
+int64_t EventHandler::getLaneKey(const Update::Ptr& update) {
+    for (const Message::Ptr& message : { update->message, update->editedMessage, update->channelPost, update->editedChannelPost }) {
+        if (message != nullptr && message->chat != nullptr) {
+            return message->chat->id;
+        }
+    }
+    if (update->inlineQuery != nullptr && update->inlineQuery->from != nullptr) {
+        return update->inlineQuery->from->id;
+    }
+    if (update->chosenInlineResult != nullptr && update->chosenInlineResult->from != nullptr) {
+        return update->chosenInlineResult->from->id;
+    }
+    if (update->callbackQuery != nullptr && update->callbackQuery->from != nullptr) {
+        return update->callbackQuery->from->id;
+    }
+    return 0;
+}
+
+void EventHandler::runLane(Lane* lane) const {
+    Update::Ptr update;
+    while (lane->queue.pop(update)) {
+        try {
+            processUpdate(update);
+        } catch (...) {
+            lock_guard<mutex> lock(_dispatchErrorMutex);
+            if (!_dispatchError) {
+                _dispatchError = current_exception();
+            }
+        }
+        update.reset();
+    }
+}
+
+void EventHandler::processUpdate(const Update::Ptr& update) const {
     if (update->inlineQuery != nullptr) {
         _broadcaster->broadcastInlineQuery(update->inlineQuery);
     }
@@ -23,7 +23,7 @@
 
 #include "tgbot/TgTypeParser.h"
 
-using namespace boost::property_tree;
+#include <cctype>
 
 namespace TgBot {
 
@@ -32,7 +32,15 @@ TgTypeParser& TgTypeParser::getInstance() {
 	return result;
 }
 
-Chat::Ptr TgTypeParser::parseJsonAndGetChat(const ptree& data) const {
+void TgTypeParser::setLazyDecoding(bool isLazy) {
+	_isLazyDecoding = isLazy;
+}
+
+bool TgTypeParser::isLazyDecoding() const {
+	return _isLazyDecoding;
+}
+
+Chat::Ptr TgTypeParser::parseJsonAndGetChat(const JsonValue& data) const {
 	auto result(std::make_shared<Chat>());
 	result->id = data.get<int64_t>("id");
 	std::string type = data.get<std::string>("type");
@@ -54,32 +62,34 @@ Chat::Ptr TgTypeParser::parseJsonAndGetChat(const ptree& data) const {
 	return result;
 }
 
-std::string TgTypeParser::parseChat(const Chat::Ptr& object) const {
+void TgTypeParser::writeChat(JsonWriter& writer, const Chat::Ptr& object) const {
 	if (!object) {
-		return "";
+		writer.nullValue();
+		return;
 	}
-	std::string result;
-	result += '{';
-	appendToJson(result, "id", object->id);
+	writer.startObject();
+	appendToJson(writer, "id", object->id);
 	if (object->type == Chat::Type::Private) {
-		appendToJson(result, "type", "private");
+		writer.key("type").value("private");
 	} else if (object->type == Chat::Type::Group) {
-		appendToJson(result, "type", "group");
+		writer.key("type").value("group");
 	} else if (object->type == Chat::Type::Supergroup) {
-		appendToJson(result, "type", "supergroup");
+		writer.key("type").value("supergroup");
 	} else if (object->type == Chat::Type::Channel) {
-		appendToJson(result, "type", "channel");
+		writer.key("type").value("channel");
 	}
-	appendToJson(result, "title", object->title);
-	appendToJson(result, "username", object->username);
-	appendToJson(result, "first_name", object->firstName);
-	appendToJson(result, "last_name", object->lastName);
-	result.erase(result.length() - 1);
-	result += '}';
-	return result;
+	appendToJson(writer, "title", object->title);
+	appendToJson(writer, "username", object->username);
+	appendToJson(writer, "first_name", object->firstName);
+	appendToJson(writer, "last_name", object->lastName);
+	writer.endObject();
 }
 
-User::Ptr TgTypeParser::parseJsonAndGetUser(const ptree& data) const {
+std::string TgTypeParser::parseChat(const Chat::Ptr& object) const {
+	return toJson(&TgTypeParser::writeChat, object);
+}
+
+User::Ptr TgTypeParser::parseJsonAndGetUser(const JsonValue& data) const {
 	auto result(std::make_shared<User>());
 	result->id = data.get<int32_t>("id");
 	result->firstName = data.get<std::string>("first_name");
@@ -89,23 +99,25 @@ User::Ptr TgTypeParser::parseJsonAndGetUser(const ptree& data) const {
 	return result;
 }
 
-std::string TgTypeParser::parseUser(const User::Ptr& object) const {
+void TgTypeParser::writeUser(JsonWriter& writer, const User::Ptr& object) const {
 	if (!object) {
-		return "";
+		writer.nullValue();
+		return;
 	}
-	std::string result;
-	result += '{';
-	appendToJson(result, "id", object->id);
-	appendToJson(result, "first_name", object->firstName);
-	appendToJson(result, "last_name", object->lastName);
-	appendToJson(result, "username", object->username);
-	appendToJson(result, "language_code", object->languageCode);
-	result.erase(result.length() - 1);
-	result += '}';
-	return result;
+	writer.startObject();
+	appendToJson(writer, "id", object->id);
+	appendToJson(writer, "first_name", object->firstName);
+	appendToJson(writer, "last_name", object->lastName);
+	appendToJson(writer, "username", object->username);
+	appendToJson(writer, "language_code", object->languageCode);
+	writer.endObject();
+}
+
+std::string TgTypeParser::parseUser(const User::Ptr& object) const {
+	return toJson(&TgTypeParser::writeUser, object);
 }
 
-MessageEntity::Ptr TgTypeParser::parseJsonAndGetEntity(const ptree& data) const{
+MessageEntity::Ptr TgTypeParser::parseJsonAndGetEntity(const JsonValue& data) const{
 	auto result(std::make_shared<MessageEntity>());
 	result->type=data.get<std::string>("type");
 	result->offset=data.get<int32_t>("offset");
@@ -115,83 +127,92 @@ MessageEntity::Ptr TgTypeParser::parseJsonAndGetEntity(const ptree& data) const{
 	return result;
 }	
 
-Message::Ptr TgTypeParser::parseJsonAndGetMessage(const ptree& data) const {
+Message::Ptr TgTypeParser::parseJsonAndGetMessage(const JsonValue& data) const {
 	auto result(std::make_shared<Message>());
+	// Nested objects point to the document only if it's owned by a shared pointer, otherwise they are decoded right away.
+	JsonValue::Ptr document = _isLazyDecoding ? data.getSharedPtr() : nullptr;
 	result->messageId = data.get<int32_t>("message_id");
 	result->from = tryParseJson<User>(&TgTypeParser::parseJsonAndGetUser, data, "from");
 	result->date = data.get<int32_t>("date");
-	result->chat = parseJsonAndGetChat(data.find("chat")->second);
-	result->forwardFrom = tryParseJson<User>(&TgTypeParser::parseJsonAndGetUser, data, "forward_from");
-	result->forwardFromChat = tryParseJson<Chat>(&TgTypeParser::parseJsonAndGetChat, data, "forward_from_chat");
+	result->chat = parseJsonAndGetChat(data["chat"]);
+	tryParseJsonLazily<User, &TgTypeParser::parseJsonAndGetUser>(result->forwardFrom, data, "forward_from", document);
+	tryParseJsonLazily<Chat, &TgTypeParser::parseJsonAndGetChat>(result->forwardFromChat, data, "forward_from_chat", document);
 	result->forwardFromMessageId = data.get<int32_t>("forward_from_message_id", 0);
 	result->forwardDate = data.get("forward_date", 0);
-	result->replyToMessage = tryParseJson<Message>(&TgTypeParser::parseJsonAndGetMessage, data, "reply_to_message");
+	tryParseJsonLazily<Message, &TgTypeParser::parseJsonAndGetMessage>(result->replyToMessage, data, "reply_to_message", document);
 	result->editDate = data.get<int32_t>("edit_date", 0);
 	result->text = data.get("text", "");
-	result->entities = parseJsonAndGetArray<MessageEntity>(&TgTypeParser::parseJsonAndGetEntity, data, "entities");
-	result->audio = tryParseJson<Audio>(&TgTypeParser::parseJsonAndGetAudio, data, "audio");
-	result->document = tryParseJson<Document>(&TgTypeParser::parseJsonAndGetDocument, data, "document");
-	result->photo = parseJsonAndGetArray<PhotoSize>(&TgTypeParser::parseJsonAndGetPhotoSize, data, "photo");
-	result->sticker = tryParseJson<Sticker>(&TgTypeParser::parseJsonAndGetSticker, data, "sticker");
-	result->video = tryParseJson<Video>(&TgTypeParser::parseJsonAndGetVideo, data, "video");
-	result->contact = tryParseJson<Contact>(&TgTypeParser::parseJsonAndGetContact, data, "contact");
-	result->location = tryParseJson<Location>(&TgTypeParser::parseJsonAndGetLocation, data, "location");
-	result->newChatMember = tryParseJson<User>(&TgTypeParser::parseJsonAndGetUser, data, "new_chat_participant");
-	result->newChatMembers = parseJsonAndGetArray<User>(&TgTypeParser::parseJsonAndGetUser, data, "new_chat_members");
-	result->leftChatMember = tryParseJson<User>(&TgTypeParser::parseJsonAndGetUser, data, "left_chat_member");
+	parseJsonAndGetArrayLazily<MessageEntity, &TgTypeParser::parseJsonAndGetEntity>(result->entities, data, "entities", document);
+	tryParseJsonLazily<Audio, &TgTypeParser::parseJsonAndGetAudio>(result->audio, data, "audio", document);
+	tryParseJsonLazily<Document, &TgTypeParser::parseJsonAndGetDocument>(result->document, data, "document", document);
+	parseJsonAndGetArrayLazily<PhotoSize, &TgTypeParser::parseJsonAndGetPhotoSize>(result->photo, data, "photo", document);
+	tryParseJsonLazily<Sticker, &TgTypeParser::parseJsonAndGetSticker>(result->sticker, data, "sticker", document);
+	tryParseJsonLazily<Video, &TgTypeParser::parseJsonAndGetVideo>(result->video, data, "video", document);
+	tryParseJsonLazily<Voice, &TgTypeParser::parseJsonAndGetVoice>(result->voice, data, "voice", document);
+	tryParseJsonLazily<Contact, &TgTypeParser::parseJsonAndGetContact>(result->contact, data, "contact", document);
+	tryParseJsonLazily<Location, &TgTypeParser::parseJsonAndGetLocation>(result->location, data, "location", document);
+	tryParseJsonLazily<Venue, &TgTypeParser::parseJsonAndGetVenue>(result->venue, data, "venue", document);
+	tryParseJsonLazily<User, &TgTypeParser::parseJsonAndGetUser>(result->newChatMember, data, "new_chat_participant", document);
+	parseJsonAndGetArrayLazily<User, &TgTypeParser::parseJsonAndGetUser>(result->newChatMembers, data, "new_chat_members", document);
+	tryParseJsonLazily<User, &TgTypeParser::parseJsonAndGetUser>(result->leftChatMember, data, "left_chat_member", document);
 	result->newChatTitle = data.get("new_chat_title", "");
-	result->newChatPhoto = parseJsonAndGetArray<PhotoSize>(&TgTypeParser::parseJsonAndGetPhotoSize, data, "new_chat_photo");
+	parseJsonAndGetArrayLazily<PhotoSize, &TgTypeParser::parseJsonAndGetPhotoSize>(result->newChatPhoto, data, "new_chat_photo", document);
 	result->deleteChatPhoto = data.get("delete_chat_photo", false);
 	result->groupChatCreated = data.get("group_chat_created", false);
-	result->caption = data.get("caption", false);
+	result->caption = data.get("caption", "");
 	result->supergroupChatCreated = data.get("supergroup_chat_created", false);
 	result->channelChatCreated = data.get("channel_chat_created", false);
 	result->migrateToChatId = data.get<int64_t>("migrate_to_chat_id", 0);
 	result->migrateFromChatId = data.get<int64_t>("migrate_from_chat_id", 0);
+	tryParseJsonLazily<Message, &TgTypeParser::parseJsonAndGetMessage>(result->pinnedMessage, data, "pinned_message", document);
 	return result;
 }
 
-std::string TgTypeParser::parseMessage(const Message::Ptr& object) const {
+void TgTypeParser::writeMessage(JsonWriter& writer, const Message::Ptr& object) const {
 	if (!object) {
-		return "";
-	}
-	std::string result;
-	result += '{';
-	appendToJson(result, "message_id", object->messageId);
-	appendToJson(result, "from", parseUser(object->from));
-	appendToJson(result, "date", object->date);
-	appendToJson(result, "chat", parseChat(object->chat));
-	appendToJson(result, "forward_from", parseUser(object->forwardFrom));
-	appendToJson(result, "forward_from_chat", parseChat(object->forwardFromChat));
-	appendToJson(result, "forward_from_message_id", object->forwardFromMessageId);
-	appendToJson(result, "forward_date", object->forwardDate);
-	appendToJson(result, "reply_to_message", parseMessage(object->replyToMessage));
-	appendToJson(result, "edit_date", object->editDate);
-	appendToJson(result, "text", object->text);
-	appendToJson(result, "audio", parseAudio(object->audio));
-	appendToJson(result, "document", parseDocument(object->document));
-	appendToJson(result, "photo", parseArray(&TgTypeParser::parsePhotoSize, object->photo));
-	appendToJson(result, "sticker", parseSticker(object->sticker));
-	appendToJson(result, "video", parseVideo(object->video));
-	appendToJson(result, "contact", parseContact(object->contact));
-	appendToJson(result, "location", parseLocation(object->location));
-	appendToJson(result, "new_chat_member", parseArray(&TgTypeParser::parseUser, object->newChatMembers));
-	appendToJson(result, "left_chat_member", parseUser(object->leftChatMember));
-	appendToJson(result, "new_chat_title", object->newChatTitle);
-	appendToJson(result, "new_chat_photo", parseArray(&TgTypeParser::parsePhotoSize, object->newChatPhoto));
-	appendToJson(result, "delete_chat_photo", object->deleteChatPhoto);
-	appendToJson(result, "group_chat_created", object->groupChatCreated);
-	appendToJson(result, "caption", object->caption);
-	appendToJson(result, "supergroup_chat_created", object->supergroupChatCreated);
-	appendToJson(result, "channel_chat_created", object->channelChatCreated);
-	appendToJson(result, "migrate_to_chat_id", object->migrateToChatId);
-	appendToJson(result, "migrate_from_chat_id", object->migrateFromChatId);
-	result.erase(result.length() - 1);
-	result += '}';
-	return result;
-}
-
-PhotoSize::Ptr TgTypeParser::parseJsonAndGetPhotoSize(const ptree& data) const {
+		writer.nullValue();
+		return;
+	}
+	writer.startObject();
+	appendToJson(writer, "message_id", object->messageId);
+	appendToJson(writer, "from", &TgTypeParser::writeUser, object->from);
+	appendToJson(writer, "date", object->date);
+	appendToJson(writer, "chat", &TgTypeParser::writeChat, object->chat);
+	appendToJson(writer, "forward_from", &TgTypeParser::writeUser, object->forwardFrom.value());
+	appendToJson(writer, "forward_from_chat", &TgTypeParser::writeChat, object->forwardFromChat.value());
+	appendToJson(writer, "forward_from_message_id", object->forwardFromMessageId);
+	appendToJson(writer, "forward_date", object->forwardDate);
+	appendToJson(writer, "reply_to_message", &TgTypeParser::writeMessage, object->replyToMessage.value());
+	appendToJson(writer, "edit_date", object->editDate);
+	appendToJson(writer, "text", object->text);
+	appendToJson(writer, "audio", &TgTypeParser::writeAudio, object->audio.value());
+	appendToJson(writer, "document", &TgTypeParser::writeDocument, object->document.value());
+	appendToJson(writer, "photo", &TgTypeParser::writePhotoSize, object->photo.value());
+	appendToJson(writer, "sticker", &TgTypeParser::writeSticker, object->sticker.value());
+	appendToJson(writer, "video", &TgTypeParser::writeVideo, object->video.value());
+	appendToJson(writer, "contact", &TgTypeParser::writeContact, object->contact.value());
+	appendToJson(writer, "location", &TgTypeParser::writeLocation, object->location.value());
+	appendToJson(writer, "venue", &TgTypeParser::writeVenue, object->venue.value());
+	appendToJson(writer, "new_chat_member", &TgTypeParser::writeUser, object->newChatMembers.value());
+	appendToJson(writer, "left_chat_member", &TgTypeParser::writeUser, object->leftChatMember.value());
+	appendToJson(writer, "new_chat_title", object->newChatTitle);
+	appendToJson(writer, "new_chat_photo", &TgTypeParser::writePhotoSize, object->newChatPhoto.value());
+	appendToJson(writer, "delete_chat_photo", object->deleteChatPhoto);
+	appendToJson(writer, "group_chat_created", object->groupChatCreated);
+	appendToJson(writer, "voice", &TgTypeParser::writeVoice, object->voice.value());
+	appendToJson(writer, "caption", object->caption);
+	appendToJson(writer, "supergroup_chat_created", object->supergroupChatCreated);
+	appendToJson(writer, "channel_chat_created", object->channelChatCreated);
+	appendToJson(writer, "migrate_to_chat_id", object->migrateToChatId);
+	appendToJson(writer, "migrate_from_chat_id", object->migrateFromChatId);
+	writer.endObject();
+}
+
+std::string TgTypeParser::parseMessage(const Message::Ptr& object) const {
+	return toJson(&TgTypeParser::writeMessage, object);
+}
+
+PhotoSize::Ptr TgTypeParser::parseJsonAndGetPhotoSize(const JsonValue& data) const {
 	auto result(std::make_shared<PhotoSize>());
 	result->fileId = data.get<std::string>("file_id");
 	result->width = data.get<int32_t>("width");
@@ -200,22 +221,24 @@ PhotoSize::Ptr TgTypeParser::parseJsonAndGetPhotoSize(const ptree& data) const {
 	return result;
 }
 
-std::string TgTypeParser::parsePhotoSize(const PhotoSize::Ptr& object) const {
+void TgTypeParser::writePhotoSize(JsonWriter& writer, const PhotoSize::Ptr& object) const {
 	if (!object) {
-		return "";
+		writer.nullValue();
+		return;
 	}
-	std::string result;
-	result += '{';
-	appendToJson(result, "file_id", object->fileId);
-	appendToJson(result, "width", object->width);
-	appendToJson(result, "height", object->height);
-	appendToJson(result, "file_size", object->fileSize);
-	result.erase(result.length() - 1);
-	result += '}';
-	return result;
+	writer.startObject();
+	appendToJson(writer, "file_id", object->fileId);
+	appendToJson(writer, "width", object->width);
+	appendToJson(writer, "height", object->height);
+	appendToJson(writer, "file_size", object->fileSize);
+	writer.endObject();
 }
 
-Audio::Ptr TgTypeParser::parseJsonAndGetAudio(const ptree& data) const {
+std::string TgTypeParser::parsePhotoSize(const PhotoSize::Ptr& object) const {
+	return toJson(&TgTypeParser::writePhotoSize, object);
+}
+
+Audio::Ptr TgTypeParser::parseJsonAndGetAudio(const JsonValue& data) const {
 	auto result(std::make_shared<Audio>());
 	result->fileId = data.get<std::string>("file_id");
 	result->duration = data.get<int32_t>("duration");
@@ -226,22 +249,50 @@ Audio::Ptr TgTypeParser::parseJsonAndGetAudio(const ptree& data) const {
 	return result;
 }
 
-std::string TgTypeParser::parseAudio(const Audio::Ptr& object) const {
+void TgTypeParser::writeAudio(JsonWriter& writer, const Audio::Ptr& object) const {
 	if (!object) {
-		return "";
+		writer.nullValue();
+		return;
 	}
-	std::string result;
-	result += '{';
-	appendToJson(result, "file_id", object->fileId);
-	appendToJson(result, "duration", object->duration);
-	appendToJson(result, "mime_type", object->mimeType);
-	appendToJson(result, "file_size", object->fileSize);
-	result.erase(result.length() - 1);
-	result += '}';
+	writer.startObject();
+	appendToJson(writer, "file_id", object->fileId);
+	appendToJson(writer, "duration", object->duration);
+	appendToJson(writer, "mime_type", object->mimeType);
+	appendToJson(writer, "file_size", object->fileSize);
+	writer.endObject();
+}
+
+std::string TgTypeParser::parseAudio(const Audio::Ptr& object) const {
+	return toJson(&TgTypeParser::writeAudio, object);
+}
+
+Voice::Ptr TgTypeParser::parseJsonAndGetVoice(const JsonValue& data) const {
+	auto result(std::make_shared<Voice>());
+	result->file_id = data.get<std::string>("file_id");
+	result->duration = data.get<int32_t>("duration");
+	result->mime_type = data.get("mime_type", "");
+	result->file_size = data.get("file_size", 0);
 	return result;
 }
 
-Document::Ptr TgTypeParser::parseJsonAndGetDocument(const ptree& data) const {
+void TgTypeParser::writeVoice(JsonWriter& writer, const Voice::Ptr& object) const {
+	if (!object) {
+		writer.nullValue();
+		return;
+	}
+	writer.startObject();
+	appendToJson(writer, "file_id", object->file_id);
+	appendToJson(writer, "duration", object->duration);
+	appendToJson(writer, "mime_type", object->mime_type);
+	appendToJson(writer, "file_size", object->file_size);
+	writer.endObject();
+}
+
+std::string TgTypeParser::parseVoice(const Voice::Ptr& object) const {
+	return toJson(&TgTypeParser::writeVoice, object);
+}
+
+Document::Ptr TgTypeParser::parseJsonAndGetDocument(const JsonValue& data) const {
 	auto result(std::make_shared<Document>());
 	result->fileId = data.get<std::string>("file_id");
 	result->thumb = tryParseJson<PhotoSize>(&TgTypeParser::parseJsonAndGetPhotoSize, data, "thumb");
@@ -251,23 +302,25 @@ Document::Ptr TgTypeParser::parseJsonAndGetDocument(const ptree& data) const {
 	return result;
 }
 
-std::string TgTypeParser::parseDocument(const Document::Ptr& object) const {
+void TgTypeParser::writeDocument(JsonWriter& writer, const Document::Ptr& object) const {
 	if (!object) {
-		return "";
+		writer.nullValue();
+		return;
 	}
-	std::string result;
-	result += '{';
-	appendToJson(result, "file_id", object->fileId);
-	appendToJson(result, "thumb", parsePhotoSize(object->thumb));
-	appendToJson(result, "file_name", object->fileName);
-	appendToJson(result, "mime_type", object->mimeType);
-	appendToJson(result, "file_size", object->fileSize);
-	result.erase(result.length() - 1);
-	result += '}';
-	return result;
+	writer.startObject();
+	appendToJson(writer, "file_id", object->fileId);
+	appendToJson(writer, "thumb", &TgTypeParser::writePhotoSize, object->thumb);
+	appendToJson(writer, "file_name", object->fileName);
+	appendToJson(writer, "mime_type", object->mimeType);
+	appendToJson(writer, "file_size", object->fileSize);
+	writer.endObject();
 }
 
-Sticker::Ptr TgTypeParser::parseJsonAndGetSticker(const ptree& data) const {
+std::string TgTypeParser::parseDocument(const Document::Ptr& object) const {
+	return toJson(&TgTypeParser::writeDocument, object);
+}
+
+Sticker::Ptr TgTypeParser::parseJsonAndGetSticker(const JsonValue& data) const {
 	auto result(std::make_shared<Sticker>());
 	result->fileId = data.get<std::string>("file_id");
 	result->width = data.get<int32_t>("width");
@@ -278,24 +331,26 @@ Sticker::Ptr TgTypeParser::parseJsonAndGetSticker(const ptree& data) const {
 	return result;
 }
 
-std::string TgTypeParser::parseSticker(const Sticker::Ptr& object) const {
+void TgTypeParser::writeSticker(JsonWriter& writer, const Sticker::Ptr& object) const {
 	if (!object) {
-		return "";
+		writer.nullValue();
+		return;
 	}
-	std::string result;
-	result += '{';
-	appendToJson(result, "file_id", object->fileId);
-	appendToJson(result, "width", object->width);
-	appendToJson(result, "height", object->height);
-	appendToJson(result, "thumb", parsePhotoSize(object->thumb));
-	appendToJson(result, "emoji", object->emoji);
-	appendToJson(result, "file_size", object->fileSize);
-	result.erase(result.length() - 1);
-	result += '}';
-	return result;
+	writer.startObject();
+	appendToJson(writer, "file_id", object->fileId);
+	appendToJson(writer, "width", object->width);
+	appendToJson(writer, "height", object->height);
+	appendToJson(writer, "thumb", &TgTypeParser::writePhotoSize, object->thumb);
+	appendToJson(writer, "emoji", object->emoji);
+	appendToJson(writer, "file_size", object->fileSize);
+	writer.endObject();
 }
 
-Video::Ptr TgTypeParser::parseJsonAndGetVideo(const ptree& data) const {
+std::string TgTypeParser::parseSticker(const Sticker::Ptr& object) const {
+	return toJson(&TgTypeParser::writeSticker, object);
+}
+
+Video::Ptr TgTypeParser::parseJsonAndGetVideo(const JsonValue& data) const {
 	auto result(std::make_shared<Video>());
 	result->fileId = data.get<std::string>("file_id");
 	result->width = data.get<int32_t>("width");
@@ -307,25 +362,27 @@ Video::Ptr TgTypeParser::parseJsonAndGetVideo(const ptree& data) const {
 	return result;
 }
 
-std::string TgTypeParser::parseVideo(const Video::Ptr& object) const {
+void TgTypeParser::writeVideo(JsonWriter& writer, const Video::Ptr& object) const {
 	if (!object) {
-		return "";
+		writer.nullValue();
+		return;
 	}
-	std::string result;
-	result += '{';
-	appendToJson(result, "file_id", object->fileId);
-	appendToJson(result, "width", object->width);
-	appendToJson(result, "height", object->height);
-	appendToJson(result, "duration", object->duration);
-	appendToJson(result, "thumb", parsePhotoSize(object->thumb));
-	appendToJson(result, "mime_type", object->mimeType);
-	appendToJson(result, "file_size", object->fileSize);
-	result.erase(result.length() - 1);
-	result += '}';
-	return result;
+	writer.startObject();
+	appendToJson(writer, "file_id", object->fileId);
+	appendToJson(writer, "width", object->width);
+	appendToJson(writer, "height", object->height);
+	appendToJson(writer, "duration", object->duration);
+	appendToJson(writer, "thumb", &TgTypeParser::writePhotoSize, object->thumb);
+	appendToJson(writer, "mime_type", object->mimeType);
+	appendToJson(writer, "file_size", object->fileSize);
+	writer.endObject();
+}
+
+std::string TgTypeParser::parseVideo(const Video::Ptr& object) const {
+	return toJson(&TgTypeParser::writeVideo, object);
 }
 
-VideoNote::Ptr TgTypeParser::parseJsonAndGetVideoNote(const ptree& data) const {
+VideoNote::Ptr TgTypeParser::parseJsonAndGetVideoNote(const JsonValue& data) const {
 	auto result(std::make_shared<VideoNote>());
 	result->fileId = data.get<std::string>("file_id");
 	result->length = data.get<int32_t>("length");
@@ -335,24 +392,26 @@ VideoNote::Ptr TgTypeParser::parseJsonAndGetVideoNote(const ptree& data) const {
 	return result;
 }
 
-std::string TgTypeParser::parseVideoNote(const VideoNote::Ptr& object) const {
+void TgTypeParser::writeVideoNote(JsonWriter& writer, const VideoNote::Ptr& object) const {
 	if (!object) {
-	    return "";
+		writer.nullValue();
+		return;
 	}
-	std::string result;
-	result += '{';
-	appendToJson(result, "file_id", object->fileId);
-	appendToJson(result, "length", object->length);
-	appendToJson(result, "duration", object->duration);
-	appendToJson(result, "thumb", parsePhotoSize(object->thumb));
-	appendToJson(result, "file_size", object->fileSize);
-	result += '}';
-	result.erase();
-	return result;
+	writer.startObject();
+	appendToJson(writer, "file_id", object->fileId);
+	appendToJson(writer, "length", object->length);
+	appendToJson(writer, "duration", object->duration);
+	appendToJson(writer, "thumb", &TgTypeParser::writePhotoSize, object->thumb);
+	appendToJson(writer, "file_size", object->fileSize);
+	writer.endObject();
 }
 
+std::string TgTypeParser::parseVideoNote(const VideoNote::Ptr& object) const {
+	return toJson(&TgTypeParser::writeVideoNote, object);
+}
 
-Contact::Ptr TgTypeParser::parseJsonAndGetContact(const ptree& data) const {
+
+Contact::Ptr TgTypeParser::parseJsonAndGetContact(const JsonValue& data) const {
 	auto result(std::make_shared<Contact>());
 	result->phoneNumber = data.get<std::string>("phone_number");
 	result->firstName = data.get<std::string>("first_name");
@@ -361,42 +420,72 @@ Contact::Ptr TgTypeParser::parseJsonAndGetContact(const ptree& data) const {
 	return result;
 }
 
-std::string TgTypeParser::parseContact(const Contact::Ptr& object) const {
+void TgTypeParser::writeContact(JsonWriter& writer, const Contact::Ptr& object) const {
 	if (!object) {
-		return "";
+		writer.nullValue();
+		return;
 	}
-	std::string result;
-	result += '{';
-	appendToJson(result, "phone_number", object->phoneNumber);
-	appendToJson(result, "first_name", object->firstName);
-	appendToJson(result, "last_name", object->lastName);
-	appendToJson(result, "user_id", object->userId);
-	result.erase(result.length() - 1);
-	result += '}';
-	return result;
+	writer.startObject();
+	appendToJson(writer, "phone_number", object->phoneNumber);
+	appendToJson(writer, "first_name", object->firstName);
+	appendToJson(writer, "last_name", object->lastName);
+	appendToJson(writer, "user_id", object->userId);
+	writer.endObject();
+}
+
+std::string TgTypeParser::parseContact(const Contact::Ptr& object) const {
+	return toJson(&TgTypeParser::writeContact, object);
 }
 
-Location::Ptr TgTypeParser::parseJsonAndGetLocation(const ptree& data) const {
+Location::Ptr TgTypeParser::parseJsonAndGetLocation(const JsonValue& data) const {
 	auto result(std::make_shared<Location>());
 	result->longitude = data.get<float>("longitude", 0);
 	result->latitude = data.get<float>("latitude", 0);
 	return result;
 }
 
-std::string TgTypeParser::parseLocation(const Location::Ptr& object) const {
+void TgTypeParser::writeLocation(JsonWriter& writer, const Location::Ptr& object) const {
 	if (!object) {
-		return "";
+		writer.nullValue();
+		return;
 	}
-	std::string result;
-	result += '{';
-	appendToJson(result, "longitude", object->longitude);
-	appendToJson(result, "latitude", object->latitude);
-	result.erase(result.length() - 1);
-	result += '}';
+	writer.startObject();
+	appendToJson(writer, "longitude", object->longitude);
+	appendToJson(writer, "latitude", object->latitude);
+	writer.endObject();
+}
+
+std::string TgTypeParser::parseLocation(const Location::Ptr& object) const {
+	return toJson(&TgTypeParser::writeLocation, object);
+}
+
+Venue::Ptr TgTypeParser::parseJsonAndGetVenue(const JsonValue& data) const {
+	auto result(std::make_shared<Venue>());
+	result->location = parseJsonAndGetLocation(data["location"]);
+	result->title = data.get<std::string>("title");
+	result->address = data.get<std::string>("address");
+	result->foursquare_id = data.get("foursquare_id", "");
 	return result;
 }
 
-Update::Ptr TgTypeParser::parseJsonAndGetUpdate(const ptree& data) const {
+void TgTypeParser::writeVenue(JsonWriter& writer, const Venue::Ptr& object) const {
+	if (!object) {
+		writer.nullValue();
+		return;
+	}
+	writer.startObject();
+	appendToJson(writer, "location", &TgTypeParser::writeLocation, object->location);
+	appendToJson(writer, "title", object->title);
+	appendToJson(writer, "address", object->address);
+	appendToJson(writer, "foursquare_id", object->foursquare_id);
+	writer.endObject();
+}
+
+std::string TgTypeParser::parseVenue(const Venue::Ptr& object) const {
+	return toJson(&TgTypeParser::writeVenue, object);
+}
+
+Update::Ptr TgTypeParser::parseJsonAndGetUpdate(const JsonValue& data) const {
 	auto result(std::make_shared<Update>());
 	result->updateId = data.get<int32_t>("update_id");
 	result->message = tryParseJson<Message>(&TgTypeParser::parseJsonAndGetMessage, data, "message");
@@ -409,46 +498,50 @@ Update::Ptr TgTypeParser::parseJsonAndGetUpdate(const ptree& data) const {
 	return result;
 }
 
-std::string TgTypeParser::parseUpdate(const Update::Ptr& object) const {
+void TgTypeParser::writeUpdate(JsonWriter& writer, const Update::Ptr& object) const {
 	if (!object) {
-		return "";
+		writer.nullValue();
+		return;
 	}
-	std::string result;
-	result += '{';
-	appendToJson(result, "update_id", object->updateId);
-	appendToJson(result, "message", parseMessage(object->message));
-	appendToJson(result, "edited_message", parseMessage(object->editedMessage));
-	appendToJson(result, "channel_post", parseMessage(object->channelPost));
-	appendToJson(result, "edited_channel_post", parseMessage(object->editedChannelPost));
-	appendToJson(result, "inline_query", parseInlineQuery(object->inlineQuery));
-	appendToJson(result, "chosen_inline_result", parseChosenInlineResult(object->chosenInlineResult));
-	appendToJson(result, "callback_query", parseCallbackQuery(object->callbackQuery));
-	result.erase(result.length() - 1);
-	result += '}';
-	return result;
+	writer.startObject();
+	appendToJson(writer, "update_id", object->updateId);
+	appendToJson(writer, "message", &TgTypeParser::writeMessage, object->message);
+	appendToJson(writer, "edited_message", &TgTypeParser::writeMessage, object->editedMessage);
+	appendToJson(writer, "channel_post", &TgTypeParser::writeMessage, object->channelPost);
+	appendToJson(writer, "edited_channel_post", &TgTypeParser::writeMessage, object->editedChannelPost);
+	appendToJson(writer, "inline_query", &TgTypeParser::writeInlineQuery, object->inlineQuery);
+	appendToJson(writer, "chosen_inline_result", &TgTypeParser::writeChosenInlineResult, object->chosenInlineResult);
+	appendToJson(writer, "callback_query", &TgTypeParser::writeCallbackQuery, object->callbackQuery);
+	writer.endObject();
 }
 
-UserProfilePhotos::Ptr TgTypeParser::parseJsonAndGetUserProfilePhotos(const ptree& data) const {
+std::string TgTypeParser::parseUpdate(const Update::Ptr& object) const {
+	return toJson(&TgTypeParser::writeUpdate, object);
+}
+
+UserProfilePhotos::Ptr TgTypeParser::parseJsonAndGetUserProfilePhotos(const JsonValue& data) const {
 	auto result(std::make_shared<UserProfilePhotos>());
 	result->totalCount = data.get<int32_t>("total_count");
 	result->photos = parseJsonAndGet2DArray<PhotoSize>(&TgTypeParser::parseJsonAndGetPhotoSize, data, "photos");
 	return result;
 }
 
-std::string TgTypeParser::parseUserProfilePhotos(const UserProfilePhotos::Ptr& object) const {
+void TgTypeParser::writeUserProfilePhotos(JsonWriter& writer, const UserProfilePhotos::Ptr& object) const {
 	if (!object) {
-		return "";
+		writer.nullValue();
+		return;
 	}
-	std::string result;
-	result += '{';
-	appendToJson(result, "total_count", object->totalCount);
-	appendToJson(result, "photos", parse2DArray(&TgTypeParser::parsePhotoSize, object->photos));
-	result.erase(result.length() - 1);
-	result += '}';
-	return result;
+	writer.startObject();
+	appendToJson(writer, "total_count", object->totalCount);
+	appendToJson(writer, "photos", &TgTypeParser::writePhotoSize, object->photos);
+	writer.endObject();
 }
 
-File::Ptr TgTypeParser::parseJsonAndGetFile(const boost::property_tree::ptree& data) const {
+std::string TgTypeParser::parseUserProfilePhotos(const UserProfilePhotos::Ptr& object) const {
+	return toJson(&TgTypeParser::writeUserProfilePhotos, object);
+}
+
+File::Ptr TgTypeParser::parseJsonAndGetFile(const JsonValue& data) const {
 	auto result(std::make_shared<File>());
 	result->fileId = data.get<std::string>("file_id");
 	result->fileSize = data.get<int32_t>("file_size", 0);
@@ -456,24 +549,26 @@ File::Ptr TgTypeParser::parseJsonAndGetFile(const boost::property_tree::ptree& d
 	return result;
 }
 
-std::string TgTypeParser::parseFile(const File::Ptr& object) const {
+void TgTypeParser::writeFile(JsonWriter& writer, const File::Ptr& object) const {
 	if (!object) {
-		return "";
+		writer.nullValue();
+		return;
 	}
-	std::string result;
-	result += '{';
-	appendToJson(result, "file_id", object->fileId);
-	appendToJson(result, "file_size", object->fileSize);
-	appendToJson(result, "file_path", object->filePath);
-	result.erase(result.length() - 1);
-	result += '}';
-	return result;
+	writer.startObject();
+	appendToJson(writer, "file_id", object->fileId);
+	appendToJson(writer, "file_size", object->fileSize);
+	appendToJson(writer, "file_path", object->filePath);
+	writer.endObject();
 }
 
-ReplyKeyboardMarkup::Ptr TgTypeParser::parseJsonAndGetReplyKeyboardMarkup(const boost::property_tree::ptree& data) const {
+std::string TgTypeParser::parseFile(const File::Ptr& object) const {
+	return toJson(&TgTypeParser::writeFile, object);
+}
+
+ReplyKeyboardMarkup::Ptr TgTypeParser::parseJsonAndGetReplyKeyboardMarkup(const JsonValue& data) const {
 	auto result(std::make_shared<ReplyKeyboardMarkup>());
-	for (const boost::property_tree::ptree::value_type& item : data.find("keyboard")->second){
-		result->keyboard.push_back(parseJsonAndGetArray<KeyboardButton>(&TgTypeParser::parseJsonAndGetKeyboardButton, item.second));
+	for (const JsonValue& item : data["keyboard"]) {
+		result->keyboard.push_back(parseJsonAndGetArray<KeyboardButton>(&TgTypeParser::parseJsonAndGetKeyboardButton, item));
 	}
 	result->resizeKeyboard = data.get<bool>("resize_keyboard", false);
 	result->oneTimeKeyboard = data.get<bool>("one_time_keyboard", false);
@@ -481,34 +576,26 @@ ReplyKeyboardMarkup::Ptr TgTypeParser::parseJsonAndGetReplyKeyboardMarkup(const
 	return result;
 }
 
-std::string TgTypeParser::parseReplyKeyboardMarkup(const ReplyKeyboardMarkup::Ptr& object) const {
+void TgTypeParser::writeReplyKeyboardMarkup(JsonWriter& writer, const ReplyKeyboardMarkup::Ptr& object) const {
 	if (!object) {
-		return "";
-	}
-	std::string result;
-	result += '{';
-	result += "\"keyboard\":[";
-	for (std::vector<KeyboardButton::Ptr>& item : object->keyboard) {
-		result += '[';
-		for (KeyboardButton::Ptr& innerItem : item) {
-			result += parseKeyboardButton(innerItem);
-			result += ',';
-		}
-		result.erase(result.length() - 1);
-		result += "],";
+		writer.nullValue();
+		return;
 	}
-	if (!object->keyboard.empty())
-		result.erase(result.length() - 1);
-	result += "],";
-	appendToJson(result, "resize_keyboard", object->resizeKeyboard);
-	appendToJson(result, "one_time_keyboard", object->oneTimeKeyboard);
-	appendToJson(result, "selective", object->selective);
-	result.erase(result.length() - 1);
-	result += '}';
-	return result;
+	writer.startObject();
+	// The keyboard is required even if it's empty.
+	writer.key("keyboard");
+	write2DArray(writer, &TgTypeParser::writeKeyboardButton, object->keyboard);
+	appendToJson(writer, "resize_keyboard", object->resizeKeyboard);
+	appendToJson(writer, "one_time_keyboard", object->oneTimeKeyboard);
+	appendToJson(writer, "selective", object->selective);
+	writer.endObject();
+}
+
+std::string TgTypeParser::parseReplyKeyboardMarkup(const ReplyKeyboardMarkup::Ptr& object) const {
+	return toJson(&TgTypeParser::writeReplyKeyboardMarkup, object);
 }
 
-KeyboardButton::Ptr TgTypeParser::parseJsonAndGetKeyboardButton(const boost::property_tree::ptree& data) const {
+KeyboardButton::Ptr TgTypeParser::parseJsonAndGetKeyboardButton(const JsonValue& data) const {
 	auto result(std::make_shared<KeyboardButton>());
 	result->text = data.get<std::string>("text");
 	result->requestContact = data.get<bool>("request_contact", false);
@@ -516,128 +603,205 @@ KeyboardButton::Ptr TgTypeParser::parseJsonAndGetKeyboardButton(const boost::pro
 	return result;
 }
 
-std::string TgTypeParser::parseKeyboardButton(const KeyboardButton::Ptr& object) const {
+void TgTypeParser::writeKeyboardButton(JsonWriter& writer, const KeyboardButton::Ptr& object) const {
 	if (!object) {
-		return "";
+		writer.nullValue();
+		return;
 	}
-	std::string result;
-	result += '{';
-	appendToJson(result, "text", object->text);
-	appendToJson(result, "request_contact", object->requestContact);
-	appendToJson(result, "request_location", object->requestLocation);
-	result.erase(result.length() - 1);
-	result += '}';
-	return result;
+	writer.startObject();
+	appendToJson(writer, "text", object->text);
+	appendToJson(writer, "request_contact", object->requestContact);
+	appendToJson(writer, "request_location", object->requestLocation);
+	writer.endObject();
+}
+
+std::string TgTypeParser::parseKeyboardButton(const KeyboardButton::Ptr& object) const {
+	return toJson(&TgTypeParser::writeKeyboardButton, object);
 }
 
-ReplyKeyboardRemove::Ptr TgTypeParser::parseJsonAndGetReplyKeyboardRemove(const boost::property_tree::ptree& data) const {
+ReplyKeyboardRemove::Ptr TgTypeParser::parseJsonAndGetReplyKeyboardRemove(const JsonValue& data) const {
 	auto result(std::make_shared<ReplyKeyboardRemove>());
 	result->selective = data.get<bool>("selective", false);
 	return result;
 }
 
-std::string TgTypeParser::parseReplyKeyboardRemove(const ReplyKeyboardRemove::Ptr& object) const {
+void TgTypeParser::writeReplyKeyboardRemove(JsonWriter& writer, const ReplyKeyboardRemove::Ptr& object) const {
 	if (!object) {
-		return "";
+		writer.nullValue();
+		return;
 	}
-	std::string result;
-	result += '{';
-	appendToJson(result, "remove_keyboard", object->removeKeyboard);
-	appendToJson(result, "selective", object->selective);
-	result.erase(result.length() - 1);
-	result += '}';
-	return result;
+	writer.startObject();
+	appendToJson(writer, "remove_keyboard", object->removeKeyboard);
+	appendToJson(writer, "selective", object->selective);
+	writer.endObject();
 }
 
-ForceReply::Ptr TgTypeParser::parseJsonAndGetForceReply(const boost::property_tree::ptree& data) const {
+std::string TgTypeParser::parseReplyKeyboardRemove(const ReplyKeyboardRemove::Ptr& object) const {
+	return toJson(&TgTypeParser::writeReplyKeyboardRemove, object);
+}
+
+ForceReply::Ptr TgTypeParser::parseJsonAndGetForceReply(const JsonValue& data) const {
 	auto result(std::make_shared<ForceReply>());
 	result->selective = data.get<bool>("selective");
 	return result;
 }
 
-std::string TgTypeParser::parseForceReply(const ForceReply::Ptr& object) const {
+void TgTypeParser::writeForceReply(JsonWriter& writer, const ForceReply::Ptr& object) const {
 	if (!object) {
-		return "";
+		writer.nullValue();
+		return;
 	}
-	std::string result;
-	result += '{';
-	appendToJson(result, "force_reply", object->forceReply);
-	appendToJson(result, "selective", object->selective);
-	result.erase(result.length() - 1);
-	result += '}';
-	return result;
+	writer.startObject();
+	appendToJson(writer, "force_reply", object->forceReply);
+	appendToJson(writer, "selective", object->selective);
+	writer.endObject();
+}
+
+std::string TgTypeParser::parseForceReply(const ForceReply::Ptr& object) const {
+	return toJson(&TgTypeParser::writeForceReply, object);
 }
 
-ChatMember::Ptr TgTypeParser::parseJsonAndGetChatMember(const boost::property_tree::ptree& data) const {
+ChatMember::Ptr TgTypeParser::parseJsonAndGetChatMember(const JsonValue& data) const {
 	auto result(std::make_shared<ChatMember>());
 	result->user = tryParseJson<User>(&TgTypeParser::parseJsonAndGetUser, data, "user");
 	result->status = data.get<std::string>("status");
 	return result;
 }
 
-std::string TgTypeParser::parseChatMember(const ChatMember::Ptr& object) const {
+void TgTypeParser::writeChatMember(JsonWriter& writer, const ChatMember::Ptr& object) const {
 	if (!object) {
-		return "";
+		writer.nullValue();
+		return;
 	}
-	std::string result;
-	result += '{';
-	appendToJson(result, "user", parseUser(object->user));
-	appendToJson(result, "status", object->status);
-	result.erase(result.length() - 1);
-	result += '}';
-	return result;
+	writer.startObject();
+	appendToJson(writer, "user", &TgTypeParser::writeUser, object->user);
+	appendToJson(writer, "status", object->status);
+	writer.endObject();
+}
+
+std::string TgTypeParser::parseChatMember(const ChatMember::Ptr& object) const {
+	return toJson(&TgTypeParser::writeChatMember, object);
+}
+
+bool TgTypeParser::scanResponse(boost::string_ref json, int32_t& messageId) const {
+	messageId = 0;
+	bool hasOk = false;
+	bool isOk = false;
+	bool hasMessageId = false;
+	int32_t depth = 0;
+	int32_t resultDepth = -1;
+	size_t i = 0;
+	auto skipSpaces = [&json, &i]() {
+		while (i < json.size() && isspace(static_cast<unsigned char>(json[i]))) {
+			++i;
+		}
+	};
+	while (i < json.size() && !(hasOk && (!isOk || hasMessageId))) {
+		char c = json[i];
+		if (c == '"') {
+			size_t start = ++i;
+			while (i < json.size() && json[i] != '"') {
+				i += json[i] == '\\' ? 2 : 1;
+			}
+			if (i >= json.size()) {
+				break;
+			}
+			boost::string_ref token = json.substr(start, i - start);
+			++i;
+			skipSpaces();
+			if (i >= json.size() || json[i] != ':') {
+				continue;
+			}
+			++i;
+			skipSpaces();
+			if (depth == 1 && token == "ok") {
+				hasOk = true;
+				isOk = json.substr(i).starts_with("true");
+			} else if (depth == 1 && token == "result" && i < json.size() && json[i] == '{') {
+				resultDepth = depth + 1;
+			} else if (depth == resultDepth && token == "message_id") {
+				int32_t value = 0;
+				while (i < json.size() && json[i] >= '0' && json[i] <= '9') {
+					value = value * 10 + (json[i] - '0');
+					++i;
+				}
+				messageId = value;
+				hasMessageId = true;
+			}
+		} else if (c == '{' || c == '[') {
+			++depth;
+			++i;
+		} else if (c == '}' || c == ']') {
+			if (depth == resultDepth) {
+				resultDepth = -1;
+			}
+			--depth;
+			++i;
+		} else {
+			++i;
+		}
+	}
+	return hasOk && isOk;
 }
 
-ResponseParameters::Ptr TgTypeParser::parseJsonAndGetResponseParameters(const boost::property_tree::ptree& data) const {
+ResponseParameters::Ptr TgTypeParser::parseJsonAndGetResponseParameters(const JsonValue& data) const {
 	auto result(std::make_shared<ResponseParameters>());
-	result->migrateToChatId = data.get<int32_t>("migrate_to_chat_id", 0);
+	result->migrateToChatId = data.get<int64_t>("migrate_to_chat_id", 0);
 	result->retryAfter = data.get<int32_t>("retry_after", 0);
 	return result;
 }
 
-std::string TgTypeParser::parseResponseParameters(const ResponseParameters::Ptr& object) const {
+void TgTypeParser::writeResponseParameters(JsonWriter& writer, const ResponseParameters::Ptr& object) const {
 	if (!object) {
-		return "";
+		writer.nullValue();
+		return;
 	}
-	std::string result;
-	result += '{';
-	appendToJson(result, "migrate_to_chat_id", object->migrateToChatId);
-	appendToJson(result, "retry_after", object->retryAfter);
-	result.erase(result.length() - 1);
-	result += '}';
-	return result;
+	writer.startObject();
+	appendToJson(writer, "migrate_to_chat_id", object->migrateToChatId);
+	appendToJson(writer, "retry_after", object->retryAfter);
+	writer.endObject();
 }
 
-GenericReply::Ptr TgTypeParser::parseJsonAndGetGenericReply(const boost::property_tree::ptree& data) const {
-	if (data.find("force_reply") != data.not_found()) {
+std::string TgTypeParser::parseResponseParameters(const ResponseParameters::Ptr& object) const {
+	return toJson(&TgTypeParser::writeResponseParameters, object);
+}
+
+GenericReply::Ptr TgTypeParser::parseJsonAndGetGenericReply(const JsonValue& data) const {
+	if (data.find("force_reply") != nullptr) {
 		return std::static_pointer_cast<GenericReply>(parseJsonAndGetForceReply(data));
-	} else if (data.find("remove_keyboard") != data.not_found()) {
+	} else if (data.find("remove_keyboard") != nullptr) {
 		return std::static_pointer_cast<GenericReply>(parseJsonAndGetReplyKeyboardRemove(data));
-	} else if (data.find("keyboard") != data.not_found()) {
+	} else if (data.find("keyboard") != nullptr) {
 		return std::static_pointer_cast<GenericReply>(parseJsonAndGetReplyKeyboardMarkup(data));
-	} else if (data.find("inline_keyboard") != data.not_found()) {
+	} else if (data.find("inline_keyboard") != nullptr) {
 		return std::static_pointer_cast<GenericReply>(parseJsonAndGetInlineKeyboardMarkup(data));
 	}
 	return std::make_shared<GenericReply>();
 }
 
-std::string TgTypeParser::parseGenericReply(const GenericReply::Ptr& object) const {
+void TgTypeParser::writeGenericReply(JsonWriter& writer, const GenericReply::Ptr& object) const {
 	if (!object) {
-		return "";
+		writer.nullValue();
+		return;
 	}
 	if (std::dynamic_pointer_cast<ForceReply>(object) != nullptr) {
-		return parseForceReply(std::static_pointer_cast<ForceReply>(object));
+		writeForceReply(writer, std::static_pointer_cast<ForceReply>(object));
 	} else if (std::dynamic_pointer_cast<ReplyKeyboardRemove>(object) != nullptr) {
-		return parseReplyKeyboardRemove(std::static_pointer_cast<ReplyKeyboardRemove>(object));
+		writeReplyKeyboardRemove(writer, std::static_pointer_cast<ReplyKeyboardRemove>(object));
 	} else if (std::dynamic_pointer_cast<ReplyKeyboardMarkup>(object) != nullptr){
-		return parseReplyKeyboardMarkup(std::static_pointer_cast<ReplyKeyboardMarkup>(object));
+		writeReplyKeyboardMarkup(writer, std::static_pointer_cast<ReplyKeyboardMarkup>(object));
 	} else if (std::dynamic_pointer_cast<InlineKeyboardMarkup>(object) != nullptr){
-		return parseInlineKeyboardMarkup(std::static_pointer_cast<InlineKeyboardMarkup>(object));
+		writeInlineKeyboardMarkup(writer, std::static_pointer_cast<InlineKeyboardMarkup>(object));
+	} else {
+		writer.nullValue();
 	}
-	return "";
 }
 
-InlineQuery::Ptr TgTypeParser::parseJsonAndGetInlineQuery(const boost::property_tree::ptree& data) const {
+std::string TgTypeParser::parseGenericReply(const GenericReply::Ptr& object) const {
+	return toJson(&TgTypeParser::writeGenericReply, object);
+}
+
+InlineQuery::Ptr TgTypeParser::parseJsonAndGetInlineQuery(const JsonValue& data) const {
 	auto result(std::make_shared<InlineQuery>());
 	result->id = data.get<std::string>("id");
 	result->from = tryParseJson<User>(&TgTypeParser::parseJsonAndGetUser, data, "from");
@@ -648,23 +812,25 @@ InlineQuery::Ptr TgTypeParser::parseJsonAndGetInlineQuery(const boost::property_
 	return result;
 }
 
-std::string TgTypeParser::parseInlineQuery(const InlineQuery::Ptr& object) const{
+void TgTypeParser::writeInlineQuery(JsonWriter& writer, const InlineQuery::Ptr& object) const {
 	if (!object) {
-		return "";
+		writer.nullValue();
+		return;
 	}
-	std::string result;
-	result += '{';
-	appendToJson(result, "id", object->id);
-	appendToJson(result, "from", parseUser(object->from));
-	appendToJson(result, "location", parseLocation(object->location));
-	appendToJson(result, "query", object->query);
-	appendToJson(result, "offset", object->offset);
-	result.erase(result.length() - 1);
-	result += '}';
-	return result;
+	writer.startObject();
+	appendToJson(writer, "id", object->id);
+	appendToJson(writer, "from", &TgTypeParser::writeUser, object->from);
+	appendToJson(writer, "location", &TgTypeParser::writeLocation, object->location);
+	appendToJson(writer, "query", object->query);
+	appendToJson(writer, "offset", object->offset);
+	writer.endObject();
+}
+
+std::string TgTypeParser::parseInlineQuery(const InlineQuery::Ptr& object) const {
+	return toJson(&TgTypeParser::writeInlineQuery, object);
 }
 
-InlineQueryResult::Ptr TgTypeParser::parseJsonAndGetInlineQueryResult(const boost::property_tree::ptree& data) const {
+InlineQueryResult::Ptr TgTypeParser::parseJsonAndGetInlineQueryResult(const JsonValue& data) const {
 	std::string type = data.get<std::string>("type");
 	InlineQueryResult::Ptr result;
 
@@ -721,106 +887,105 @@ InlineQueryResult::Ptr TgTypeParser::parseJsonAndGetInlineQueryResult(const boos
 	return result;
 }
 
-std::string TgTypeParser::parseInlineQueryResult(const InlineQueryResult::Ptr& object) const {
-	if (!object){
-		return "";
+void TgTypeParser::writeInlineQueryResult(JsonWriter& writer, const InlineQueryResult::Ptr& object) const {
+	if (!object) {
+		writer.nullValue();
+		return;
 	}
-
-	std::string result;
-	result += '{';
-	appendToJson(result, "id", object->id);
-	appendToJson(result, "type", object->type);
-	appendToJson(result, "title", object->title);
-	appendToJson(result, "caption", object->caption);
-	appendToJson(result, "reply_markup", parseInlineKeyboardMarkup(object->replyMarkup));
-	appendToJson(result, "input_message_content", parseInputMessageContent(object->inputMessageContent));
-
+	writer.startObject();
+	appendToJson(writer, "id", object->id);
+	appendToJson(writer, "type", object->type);
+	appendToJson(writer, "title", object->title);
+	appendToJson(writer, "caption", object->caption);
+	appendToJson(writer, "reply_markup", &TgTypeParser::writeInlineKeyboardMarkup, object->replyMarkup);
+	appendToJson(writer, "input_message_content", &TgTypeParser::writeInputMessageContent, object->inputMessageContent);
 	if (object->type == InlineQueryResultCachedAudio::TYPE) {
-		result += parseInlineQueryResultCachedAudio(std::static_pointer_cast<InlineQueryResultCachedAudio>(object));
+		writeInlineQueryResultCachedAudio(writer, std::static_pointer_cast<InlineQueryResultCachedAudio>(object));
 	}
 	else if (object->type == InlineQueryResultCachedDocument::TYPE) {
-		result += parseInlineQueryResultCachedDocument(std::static_pointer_cast<InlineQueryResultCachedDocument>(object));
+		writeInlineQueryResultCachedDocument(writer, std::static_pointer_cast<InlineQueryResultCachedDocument>(object));
 	}
 	else if (object->type == InlineQueryResultCachedGif::TYPE) {
-		result += parseInlineQueryResultCachedGif(std::static_pointer_cast<InlineQueryResultCachedGif>(object));
+		writeInlineQueryResultCachedGif(writer, std::static_pointer_cast<InlineQueryResultCachedGif>(object));
 	}
 	else if (object->type == InlineQueryResultCachedMpeg4Gif::TYPE) {
-		result += parseInlineQueryResultCachedMpeg4Gif(std::static_pointer_cast<InlineQueryResultCachedMpeg4Gif>(object));
+		writeInlineQueryResultCachedMpeg4Gif(writer, std::static_pointer_cast<InlineQueryResultCachedMpeg4Gif>(object));
 	}
 	else if (object->type == InlineQueryResultCachedPhoto::TYPE) {
-		result += parseInlineQueryResultCachedPhoto(std::static_pointer_cast<InlineQueryResultCachedPhoto>(object));
+		writeInlineQueryResultCachedPhoto(writer, std::static_pointer_cast<InlineQueryResultCachedPhoto>(object));
 	}
 	else if (object->type == InlineQueryResultCachedSticker::TYPE) {
-		result += parseInlineQueryResultCachedSticker(std::static_pointer_cast<InlineQueryResultCachedSticker>(object));
+		writeInlineQueryResultCachedSticker(writer, std::static_pointer_cast<InlineQueryResultCachedSticker>(object));
 	}
 	else if (object->type == InlineQueryResultCachedVideo::TYPE) {
-		result += parseInlineQueryResultCachedVideo(std::static_pointer_cast<InlineQueryResultCachedVideo>(object));
+		writeInlineQueryResultCachedVideo(writer, std::static_pointer_cast<InlineQueryResultCachedVideo>(object));
 	}
 	else if (object->type == InlineQueryResultCachedVoice::TYPE) {
-		result += parseInlineQueryResultCachedVoice(std::static_pointer_cast<InlineQueryResultCachedVoice>(object));
+		writeInlineQueryResultCachedVoice(writer, std::static_pointer_cast<InlineQueryResultCachedVoice>(object));
 	}
 	else if (object->type == InlineQueryResultArticle::TYPE) {
-		result += parseInlineQueryResultArticle(std::static_pointer_cast<InlineQueryResultArticle>(object));
+		writeInlineQueryResultArticle(writer, std::static_pointer_cast<InlineQueryResultArticle>(object));
 	}
 	else if (object->type == InlineQueryResultAudio::TYPE) {
-		result += parseInlineQueryResultAudio(std::static_pointer_cast<InlineQueryResultAudio>(object));
+		writeInlineQueryResultAudio(writer, std::static_pointer_cast<InlineQueryResultAudio>(object));
 	}
 	else if (object->type == InlineQueryResultContact::TYPE) {
-		result += parseInlineQueryResultContact(std::static_pointer_cast<InlineQueryResultContact>(object));
+		writeInlineQueryResultContact(writer, std::static_pointer_cast<InlineQueryResultContact>(object));
 	}
 	else if (object->type == InlineQueryResultGame::TYPE) {
-		result += parseInlineQueryResultGame(std::static_pointer_cast<InlineQueryResultGame>(object));
+		writeInlineQueryResultGame(writer, std::static_pointer_cast<InlineQueryResultGame>(object));
 	}
 	else if (object->type == InlineQueryResultDocument::TYPE) {
-		result += parseInlineQueryResultDocument(std::static_pointer_cast<InlineQueryResultDocument>(object));
+		writeInlineQueryResultDocument(writer, std::static_pointer_cast<InlineQueryResultDocument>(object));
 	}
 	else if (object->type == InlineQueryResultLocation::TYPE) {
-		result += parseInlineQueryResultLocation(std::static_pointer_cast<InlineQueryResultLocation>(object));
+		writeInlineQueryResultLocation(writer, std::static_pointer_cast<InlineQueryResultLocation>(object));
 	}
 	else if (object->type == InlineQueryResultVenue::TYPE) {
-		result += parseInlineQueryResultVenue(std::static_pointer_cast<InlineQueryResultVenue>(object));
+		writeInlineQueryResultVenue(writer, std::static_pointer_cast<InlineQueryResultVenue>(object));
 	}
 	else if (object->type == InlineQueryResultVoice::TYPE) {
-		result += parseInlineQueryResultVoice(std::static_pointer_cast<InlineQueryResultVoice>(object));
+		writeInlineQueryResultVoice(writer, std::static_pointer_cast<InlineQueryResultVoice>(object));
 	}
 	else if (object->type == InlineQueryResultPhoto::TYPE) {
-		result += parseInlineQueryResultPhoto(std::static_pointer_cast<InlineQueryResultPhoto>(object));
+		writeInlineQueryResultPhoto(writer, std::static_pointer_cast<InlineQueryResultPhoto>(object));
 	}
 	else if (object->type == InlineQueryResultGif::TYPE) {
-		result += parseInlineQueryResultGif(std::static_pointer_cast<InlineQueryResultGif>(object));
+		writeInlineQueryResultGif(writer, std::static_pointer_cast<InlineQueryResultGif>(object));
 	}
 	else if (object->type == InlineQueryResultMpeg4Gif::TYPE) {
-		result += parseInlineQueryResultMpeg4Gif(std::static_pointer_cast<InlineQueryResultMpeg4Gif>(object));
+		writeInlineQueryResultMpeg4Gif(writer, std::static_pointer_cast<InlineQueryResultMpeg4Gif>(object));
 	}
 	else if (object->type == InlineQueryResultVideo::TYPE) {
-		result += parseInlineQueryResultVideo(std::static_pointer_cast<InlineQueryResultVideo>(object));
+		writeInlineQueryResultVideo(writer, std::static_pointer_cast<InlineQueryResultVideo>(object));
 	}
-	
-	result.erase(result.length() - 1);
-	result += '}';
-	return result;
+	writer.endObject();
+}
+
+std::string TgTypeParser::parseInlineQueryResult(const InlineQueryResult::Ptr& object) const {
+	return toJson(&TgTypeParser::writeInlineQueryResult, object);
 }
 
-InlineQueryResultCachedAudio::Ptr TgTypeParser::parseJsonAndGetInlineQueryResultCachedAudio(const boost::property_tree::ptree& data) const {
+InlineQueryResultCachedAudio::Ptr TgTypeParser::parseJsonAndGetInlineQueryResultCachedAudio(const JsonValue& data) const {
 	// NOTE: This function will be called by parseJsonAndGgetInlineQueryResult().
 	auto result(std::make_shared<InlineQueryResultCachedAudio>());
 	result->audioFileId = data.get<std::string>("audio_file_id");
 	return result;
 }
 
-std::string TgTypeParser::parseInlineQueryResultCachedAudio(const InlineQueryResultCachedAudio::Ptr& object) const {
-	if (!object){
-		return " ";
+void TgTypeParser::writeInlineQueryResultCachedAudio(JsonWriter& writer, const InlineQueryResultCachedAudio::Ptr& object) const {
+	if (!object) {
+		return;
 	}
-	// This function will be called by parseInlineQueryResult(), so I don't add
-	// curly brackets to the result std::string.
-	std::string result;
-	appendToJson(result, "audio_file_id", object->audioFileId);
-	// The last comma will be erased by parseInlineQueryResult().
-	return result;
+	// This function is called by writeInlineQueryResult(), which opens and closes the object.
+	appendToJson(writer, "audio_file_id", object->audioFileId);
+}
+
+std::string TgTypeParser::parseInlineQueryResultCachedAudio(const InlineQueryResultCachedAudio::Ptr& object) const {
+	return parseInlineQueryResult(object);
 }
 
-InlineQueryResultCachedDocument::Ptr TgTypeParser::parseJsonAndGetInlineQueryResultCachedDocument(const boost::property_tree::ptree& data) const {
+InlineQueryResultCachedDocument::Ptr TgTypeParser::parseJsonAndGetInlineQueryResultCachedDocument(const JsonValue& data) const {
 	// NOTE: This function will be called by parseJsonAndGgetInlineQueryResult().
 	auto result(std::make_shared<InlineQueryResultCachedDocument>());
 	result->documentFileId = data.get<std::string>("document_file_id");
@@ -828,61 +993,61 @@ InlineQueryResultCachedDocument::Ptr TgTypeParser::parseJsonAndGetInlineQueryRes
 	return result;
 }
 
-std::string TgTypeParser::parseInlineQueryResultCachedDocument(const InlineQueryResultCachedDocument::Ptr& object) const {
-	if (!object){
-		return " ";
+void TgTypeParser::writeInlineQueryResultCachedDocument(JsonWriter& writer, const InlineQueryResultCachedDocument::Ptr& object) const {
+	if (!object) {
+		return;
 	}
-	// This function will be called by parseInlineQueryResult(), so I don't add
-	// curly brackets to the result std::string.
-	std::string result;
-	appendToJson(result, "document_file_id", object->documentFileId);
-	appendToJson(result, "description", object->description);
-	// The last comma will be erased by parseInlineQueryResult().
-	return result;
+	// This function is called by writeInlineQueryResult(), which opens and closes the object.
+	appendToJson(writer, "document_file_id", object->documentFileId);
+	appendToJson(writer, "description", object->description);
+}
+
+std::string TgTypeParser::parseInlineQueryResultCachedDocument(const InlineQueryResultCachedDocument::Ptr& object) const {
+	return parseInlineQueryResult(object);
 }
 
 
-InlineQueryResultCachedGif::Ptr TgTypeParser::parseJsonAndGetInlineQueryResultCachedGif(const boost::property_tree::ptree& data) const {
+InlineQueryResultCachedGif::Ptr TgTypeParser::parseJsonAndGetInlineQueryResultCachedGif(const JsonValue& data) const {
 	// NOTE: This function will be called by parseJsonAndGgetInlineQueryResult().
 	auto result(std::make_shared<InlineQueryResultCachedGif>());
 	result->gifFileId = data.get<std::string>("gif_file_id");
 	return result;
 }
 
-std::string TgTypeParser::parseInlineQueryResultCachedGif(const InlineQueryResultCachedGif::Ptr& object) const {
-	if (!object){
-		return " ";
+void TgTypeParser::writeInlineQueryResultCachedGif(JsonWriter& writer, const InlineQueryResultCachedGif::Ptr& object) const {
+	if (!object) {
+		return;
 	}
-	// This function will be called by parseInlineQueryResult(), so I don't add
-	// curly brackets to the result std::string.
-	std::string result;
-	appendToJson(result, "gif_file_id", object->gifFileId);
-	// The last comma will be erased by parseInlineQueryResult().
-	return result;
+	// This function is called by writeInlineQueryResult(), which opens and closes the object.
+	appendToJson(writer, "gif_file_id", object->gifFileId);
+}
+
+std::string TgTypeParser::parseInlineQueryResultCachedGif(const InlineQueryResultCachedGif::Ptr& object) const {
+	return parseInlineQueryResult(object);
 }
 
 
-InlineQueryResultCachedMpeg4Gif::Ptr TgTypeParser::parseJsonAndGetInlineQueryResultCachedMpeg4Gif(const boost::property_tree::ptree& data) const {
+InlineQueryResultCachedMpeg4Gif::Ptr TgTypeParser::parseJsonAndGetInlineQueryResultCachedMpeg4Gif(const JsonValue& data) const {
 	// NOTE: This function will be called by parseJsonAndGgetInlineQueryResult().
 	auto result(std::make_shared<InlineQueryResultCachedMpeg4Gif>());
 	result->mpeg4FileId = data.get<std::string>("mpeg4_file_id");
 	return result;
 }
 
-std::string TgTypeParser::parseInlineQueryResultCachedMpeg4Gif(const InlineQueryResultCachedMpeg4Gif::Ptr& object) const {
-	if (!object){
-		return " ";
+void TgTypeParser::writeInlineQueryResultCachedMpeg4Gif(JsonWriter& writer, const InlineQueryResultCachedMpeg4Gif::Ptr& object) const {
+	if (!object) {
+		return;
 	}
-	// This function will be called by parseInlineQueryResult(), so I don't add
-	// curly brackets to the result std::string.
-	std::string result;
-	appendToJson(result, "mpeg4_file_id", object->mpeg4FileId);
-	// The last comma will be erased by parseInlineQueryResult().
-	return result;
+	// This function is called by writeInlineQueryResult(), which opens and closes the object.
+	appendToJson(writer, "mpeg4_file_id", object->mpeg4FileId);
+}
+
+std::string TgTypeParser::parseInlineQueryResultCachedMpeg4Gif(const InlineQueryResultCachedMpeg4Gif::Ptr& object) const {
+	return parseInlineQueryResult(object);
 }
 
 
-InlineQueryResultCachedPhoto::Ptr TgTypeParser::parseJsonAndGetInlineQueryResultCachedPhoto(const boost::property_tree::ptree& data) const {
+InlineQueryResultCachedPhoto::Ptr TgTypeParser::parseJsonAndGetInlineQueryResultCachedPhoto(const JsonValue& data) const {
 	// NOTE: This function will be called by parseJsonAndGgetInlineQueryResult().
 	auto result(std::make_shared<InlineQueryResultCachedPhoto>());
 	result->photoFileId = data.get<std::string>("photo_file_id");
@@ -890,40 +1055,40 @@ InlineQueryResultCachedPhoto::Ptr TgTypeParser::parseJsonAndGetInlineQueryResult
 	return result;
 }
 
-std::string TgTypeParser::parseInlineQueryResultCachedPhoto(const InlineQueryResultCachedPhoto::Ptr& object) const {
-	if (!object){
-		return " ";
+void TgTypeParser::writeInlineQueryResultCachedPhoto(JsonWriter& writer, const InlineQueryResultCachedPhoto::Ptr& object) const {
+	if (!object) {
+		return;
 	}
-	// This function will be called by parseInlineQueryResult(), so I don't add
-	// curly brackets to the result std::string.
-	std::string result;
-	appendToJson(result, "photo_file_id", object->photoFileId);
-	appendToJson(result, "description", object->description);
-	// The last comma will be erased by parseInlineQueryResult().
-	return result;
+	// This function is called by writeInlineQueryResult(), which opens and closes the object.
+	appendToJson(writer, "photo_file_id", object->photoFileId);
+	appendToJson(writer, "description", object->description);
 }
 
+std::string TgTypeParser::parseInlineQueryResultCachedPhoto(const InlineQueryResultCachedPhoto::Ptr& object) const {
+	return parseInlineQueryResult(object);
+}
 
-InlineQueryResultCachedSticker::Ptr TgTypeParser::parseJsonAndGetInlineQueryResultCachedSticker(const boost::property_tree::ptree& data) const {
+
+InlineQueryResultCachedSticker::Ptr TgTypeParser::parseJsonAndGetInlineQueryResultCachedSticker(const JsonValue& data) const {
 	// NOTE: This function will be called by parseJsonAndGgetInlineQueryResult().
 	auto result(std::make_shared<InlineQueryResultCachedSticker>());
 	result->stickerFileId = data.get<std::string>("sticker_file_id");
 	return result;
 }
 
-std::string TgTypeParser::parseInlineQueryResultCachedSticker(const InlineQueryResultCachedSticker::Ptr& object) const {
-	if (!object){
-		return " ";
+void TgTypeParser::writeInlineQueryResultCachedSticker(JsonWriter& writer, const InlineQueryResultCachedSticker::Ptr& object) const {
+	if (!object) {
+		return;
 	}
-	// This function will be called by parseInlineQueryResult(), so I don't add
-	// curly brackets to the result std::string.
-	std::string result;
-	appendToJson(result, "sticker_file_id", object->stickerFileId);
-	// The last comma will be erased by parseInlineQueryResult().
-	return result;
+	// This function is called by writeInlineQueryResult(), which opens and closes the object.
+	appendToJson(writer, "sticker_file_id", object->stickerFileId);
 }
 
-InlineQueryResultCachedVideo::Ptr TgTypeParser::parseJsonAndGetInlineQueryResultCachedVideo(const boost::property_tree::ptree& data) const {
+std::string TgTypeParser::parseInlineQueryResultCachedSticker(const InlineQueryResultCachedSticker::Ptr& object) const {
+	return parseInlineQueryResult(object);
+}
+
+InlineQueryResultCachedVideo::Ptr TgTypeParser::parseJsonAndGetInlineQueryResultCachedVideo(const JsonValue& data) const {
 	// NOTE: This function will be called by parseJsonAndGgetInlineQueryResult().
 	auto result(std::make_shared<InlineQueryResultCachedVideo>());
 	result->videoFileId = data.get<std::string>("video_file_id");
@@ -931,40 +1096,40 @@ InlineQueryResultCachedVideo::Ptr TgTypeParser::parseJsonAndGetInlineQueryResult
 	return result;
 }
 
-std::string TgTypeParser::parseInlineQueryResultCachedVideo(const InlineQueryResultCachedVideo::Ptr& object) const {
-	if (!object){
-		return " ";
+void TgTypeParser::writeInlineQueryResultCachedVideo(JsonWriter& writer, const InlineQueryResultCachedVideo::Ptr& object) const {
+	if (!object) {
+		return;
 	}
-	// This function will be called by parseInlineQueryResult(), so I don't add
-	// curly brackets to the result std::string.
-	std::string result;
-	appendToJson(result, "video_file_id", object->videoFileId);
-	appendToJson(result, "description", object->description);
-	// The last comma will be erased by parseInlineQueryResult().
-	return result;
+	// This function is called by writeInlineQueryResult(), which opens and closes the object.
+	appendToJson(writer, "video_file_id", object->videoFileId);
+	appendToJson(writer, "description", object->description);
+}
+
+std::string TgTypeParser::parseInlineQueryResultCachedVideo(const InlineQueryResultCachedVideo::Ptr& object) const {
+	return parseInlineQueryResult(object);
 }
 
 
-InlineQueryResultCachedVoice::Ptr TgTypeParser::parseJsonAndGetInlineQueryResultCachedVoice(const boost::property_tree::ptree& data) const {
+InlineQueryResultCachedVoice::Ptr TgTypeParser::parseJsonAndGetInlineQueryResultCachedVoice(const JsonValue& data) const {
 	// NOTE: This function will be called by parseJsonAndGgetInlineQueryResult().
 	auto result(std::make_shared<InlineQueryResultCachedVoice>());
 	result->voiceFileId = data.get<std::string>("voice_file_id");
 	return result;
 }
 
-std::string TgTypeParser::parseInlineQueryResultCachedVoice(const InlineQueryResultCachedVoice::Ptr& object) const {
-	if (!object){
-		return " ";
+void TgTypeParser::writeInlineQueryResultCachedVoice(JsonWriter& writer, const InlineQueryResultCachedVoice::Ptr& object) const {
+	if (!object) {
+		return;
 	}
-	// This function will be called by parseInlineQueryResult(), so I don't add
-	// curly brackets to the result std::string.
-	std::string result;
-	appendToJson(result, "voice_file_id", object->voiceFileId);
-	// The last comma will be erased by parseInlineQueryResult().
-	return result;
+	// This function is called by writeInlineQueryResult(), which opens and closes the object.
+	appendToJson(writer, "voice_file_id", object->voiceFileId);
+}
+
+std::string TgTypeParser::parseInlineQueryResultCachedVoice(const InlineQueryResultCachedVoice::Ptr& object) const {
+	return parseInlineQueryResult(object);
 }
 
-InlineQueryResultArticle::Ptr TgTypeParser::parseJsonAndGetInlineQueryResultArticle(const boost::property_tree::ptree& data) const {
+InlineQueryResultArticle::Ptr TgTypeParser::parseJsonAndGetInlineQueryResultArticle(const JsonValue& data) const {
 	// NOTE: This function will be called by parseJsonAndGgetInlineQueryResult().
 	auto result(std::make_shared<InlineQueryResultArticle>());
 	result->url = data.get<std::string>("url", "");
@@ -976,24 +1141,24 @@ InlineQueryResultArticle::Ptr TgTypeParser::parseJsonAndGetInlineQueryResultArti
 	return result;
 }
 
-std::string TgTypeParser::parseInlineQueryResultArticle(const InlineQueryResultArticle::Ptr& object) const {
-	if (!object){
-		return " ";
+void TgTypeParser::writeInlineQueryResultArticle(JsonWriter& writer, const InlineQueryResultArticle::Ptr& object) const {
+	if (!object) {
+		return;
 	}
-	// This function will be called by parseInlineQueryResult(), so I don't add
-	// curly brackets to the result std::string.
-	std::string result;
-	appendToJson(result, "url", object->url);
-	appendToJson(result, "hide_url", object->hideUrl);
-	appendToJson(result, "description", object->description);
-	appendToJson(result, "thumb_url", object->thumbUrl);
-	appendToJson(result, "thumb_width", object->thumbWidth);
-	appendToJson(result, "thumb_height", object->thumbHeight);
-	// The last comma will be erased by parseInlineQueryResult().
-	return result;
+	// This function is called by writeInlineQueryResult(), which opens and closes the object.
+	appendToJson(writer, "url", object->url);
+	appendToJson(writer, "hide_url", object->hideUrl);
+	appendToJson(writer, "description", object->description);
+	appendToJson(writer, "thumb_url", object->thumbUrl);
+	appendToJson(writer, "thumb_width", object->thumbWidth);
+	appendToJson(writer, "thumb_height", object->thumbHeight);
+}
+
+std::string TgTypeParser::parseInlineQueryResultArticle(const InlineQueryResultArticle::Ptr& object) const {
+	return parseInlineQueryResult(object);
 }
 
-InlineQueryResultAudio::Ptr TgTypeParser::parseJsonAndGetInlineQueryResultAudio(const boost::property_tree::ptree& data) const {
+InlineQueryResultAudio::Ptr TgTypeParser::parseJsonAndGetInlineQueryResultAudio(const JsonValue& data) const {
 	// NOTE: This function will be called by parseJsonAndGgetInlineQueryResult().
 	auto result(std::make_shared<InlineQueryResultAudio>());
 	result->audioUrl = data.get<std::string>("audio_url");
@@ -1002,22 +1167,22 @@ InlineQueryResultAudio::Ptr TgTypeParser::parseJsonAndGetInlineQueryResultAudio(
 	return result;
 }
 
-std::string TgTypeParser::parseInlineQueryResultAudio(const InlineQueryResultAudio::Ptr& object) const {
-	if (!object){
-		return " ";
+void TgTypeParser::writeInlineQueryResultAudio(JsonWriter& writer, const InlineQueryResultAudio::Ptr& object) const {
+	if (!object) {
+		return;
 	}
-	// This function will be called by parseInlineQueryResult(), so I don't add
-	// curly brackets to the result std::string.
-	std::string result;
-	appendToJson(result, "audio_url", object->audioUrl);
-	appendToJson(result, "performer", object->performer);
-	appendToJson(result, "audio_duration", object->audioDuration);
-	// The last comma will be erased by parseInlineQueryResult().
-	return result;
+	// This function is called by writeInlineQueryResult(), which opens and closes the object.
+	appendToJson(writer, "audio_url", object->audioUrl);
+	appendToJson(writer, "performer", object->performer);
+	appendToJson(writer, "audio_duration", object->audioDuration);
+}
+
+std::string TgTypeParser::parseInlineQueryResultAudio(const InlineQueryResultAudio::Ptr& object) const {
+	return parseInlineQueryResult(object);
 }
 
 
-InlineQueryResultContact::Ptr TgTypeParser::parseJsonAndGetInlineQueryResultContact(const boost::property_tree::ptree& data) const {
+InlineQueryResultContact::Ptr TgTypeParser::parseJsonAndGetInlineQueryResultContact(const JsonValue& data) const {
 	// NOTE: This function will be called by parseJsonAndGgetInlineQueryResult().
 	auto result(std::make_shared<InlineQueryResultContact>());
 	result->phoneNumber = data.get<std::string>("phone_number");
@@ -1029,44 +1194,44 @@ InlineQueryResultContact::Ptr TgTypeParser::parseJsonAndGetInlineQueryResultCont
 	return result;
 }
 
-std::string TgTypeParser::parseInlineQueryResultContact(const InlineQueryResultContact::Ptr& object) const {
-	if (!object){
-		return " ";
+void TgTypeParser::writeInlineQueryResultContact(JsonWriter& writer, const InlineQueryResultContact::Ptr& object) const {
+	if (!object) {
+		return;
 	}
-	// This function will be called by parseInlineQueryResult(), so I don't add
-	// curly brackets to the result std::string.
-	std::string result;
-	appendToJson(result, "phone_number", object->phoneNumber);
-	appendToJson(result, "first_name", object->firstName);
-	appendToJson(result, "last_name", object->lastName);
-	appendToJson(result, "thumb_url", object->thumbUrl);
-	appendToJson(result, "thumb_width", object->thumbWidth);
-	appendToJson(result, "thumb_height", object->thumbHeight);
-	// The last comma will be erased by parseInlineQueryResult().
-	return result;
+	// This function is called by writeInlineQueryResult(), which opens and closes the object.
+	appendToJson(writer, "phone_number", object->phoneNumber);
+	appendToJson(writer, "first_name", object->firstName);
+	appendToJson(writer, "last_name", object->lastName);
+	appendToJson(writer, "thumb_url", object->thumbUrl);
+	appendToJson(writer, "thumb_width", object->thumbWidth);
+	appendToJson(writer, "thumb_height", object->thumbHeight);
+}
+
+std::string TgTypeParser::parseInlineQueryResultContact(const InlineQueryResultContact::Ptr& object) const {
+	return parseInlineQueryResult(object);
 }
 
 
-InlineQueryResultGame::Ptr TgTypeParser::parseJsonAndGetInlineQueryResultGame(const boost::property_tree::ptree& data) const {
+InlineQueryResultGame::Ptr TgTypeParser::parseJsonAndGetInlineQueryResultGame(const JsonValue& data) const {
 	// NOTE: This function will be called by parseJsonAndGgetInlineQueryResult().
 	auto result(std::make_shared<InlineQueryResultGame>());
 	result->gameShortName = data.get<std::string>("game_short_name");
 	return result;
 }
 
-std::string TgTypeParser::parseInlineQueryResultGame(const InlineQueryResultGame::Ptr& object) const {
-	if (!object){
-		return " ";
+void TgTypeParser::writeInlineQueryResultGame(JsonWriter& writer, const InlineQueryResultGame::Ptr& object) const {
+	if (!object) {
+		return;
 	}
-	// This function will be called by parseInlineQueryResult(), so I don't add
-	// curly brackets to the result std::string.
-	std::string result;
-	appendToJson(result, "game_short_name", object->gameShortName);
-	// The last comma will be erased by parseInlineQueryResult().
-	return result;
+	// This function is called by writeInlineQueryResult(), which opens and closes the object.
+	appendToJson(writer, "game_short_name", object->gameShortName);
+}
+
+std::string TgTypeParser::parseInlineQueryResultGame(const InlineQueryResultGame::Ptr& object) const {
+	return parseInlineQueryResult(object);
 }
 
-InlineQueryResultDocument::Ptr TgTypeParser::parseJsonAndGetInlineQueryResultDocument(const boost::property_tree::ptree& data) const {
+InlineQueryResultDocument::Ptr TgTypeParser::parseJsonAndGetInlineQueryResultDocument(const JsonValue& data) const {
 	// NOTE: This function will be called by parseJsonAndGgetInlineQueryResult().
 	auto result(std::make_shared<InlineQueryResultDocument>());
 	result->documentUrl = data.get<std::string>("document_url");
@@ -1078,24 +1243,24 @@ InlineQueryResultDocument::Ptr TgTypeParser::parseJsonAndGetInlineQueryResultDoc
 	return result;
 }
 
-std::string TgTypeParser::parseInlineQueryResultDocument(const InlineQueryResultDocument::Ptr& object) const {
-	if (!object){
-		return " ";
+void TgTypeParser::writeInlineQueryResultDocument(JsonWriter& writer, const InlineQueryResultDocument::Ptr& object) const {
+	if (!object) {
+		return;
 	}
-	// This function will be called by parseInlineQueryResult(), so I don't add
-	// curly brackets to the result std::string.
-	std::string result;
-	appendToJson(result, "document_url", object->documentUrl);
-	appendToJson(result, "mime_type", object->mimeType);
-	appendToJson(result, "description", object->description);
-	appendToJson(result, "thumb_url", object->thumbUrl);
-	appendToJson(result, "thumb_width", object->thumbWidth);
-	appendToJson(result, "thumb_height", object->thumbHeight);
-	// The last comma will be erased by parseInlineQueryResult().
-	return result;
+	// This function is called by writeInlineQueryResult(), which opens and closes the object.
+	appendToJson(writer, "document_url", object->documentUrl);
+	appendToJson(writer, "mime_type", object->mimeType);
+	appendToJson(writer, "description", object->description);
+	appendToJson(writer, "thumb_url", object->thumbUrl);
+	appendToJson(writer, "thumb_width", object->thumbWidth);
+	appendToJson(writer, "thumb_height", object->thumbHeight);
 }
 
-InlineQueryResultLocation::Ptr TgTypeParser::parseJsonAndGetInlineQueryResultLocation(const boost::property_tree::ptree& data) const {
+std::string TgTypeParser::parseInlineQueryResultDocument(const InlineQueryResultDocument::Ptr& object) const {
+	return parseInlineQueryResult(object);
+}
+
+InlineQueryResultLocation::Ptr TgTypeParser::parseJsonAndGetInlineQueryResultLocation(const JsonValue& data) const {
 	// NOTE: This function will be called by parseJsonAndGgetInlineQueryResult().
 	auto result(std::make_shared<InlineQueryResultLocation>());
 	result->latitude = data.get<float>("latitude");
@@ -1106,24 +1271,24 @@ InlineQueryResultLocation::Ptr TgTypeParser::parseJsonAndGetInlineQueryResultLoc
 	return result;
 }
 
-std::string TgTypeParser::parseInlineQueryResultLocation(const InlineQueryResultLocation::Ptr& object) const {
-	if (!object){
-		return " ";
+void TgTypeParser::writeInlineQueryResultLocation(JsonWriter& writer, const InlineQueryResultLocation::Ptr& object) const {
+	if (!object) {
+		return;
 	}
-	// This function will be called by parseInlineQueryResult(), so I don't add
-	// curly brackets to the result std::string.
-	std::string result;
-	appendToJson(result, "latitude", object->latitude);
-	appendToJson(result, "longitude", object->longitude);
-	appendToJson(result, "thumb_url", object->thumbUrl);
-	appendToJson(result, "thumb_width", object->thumbWidth);
-	appendToJson(result, "thumb_height", object->thumbHeight);
-	// The last comma will be erased by parseInlineQueryResult().
-	return result;
+	// This function is called by writeInlineQueryResult(), which opens and closes the object.
+	appendToJson(writer, "latitude", object->latitude);
+	appendToJson(writer, "longitude", object->longitude);
+	appendToJson(writer, "thumb_url", object->thumbUrl);
+	appendToJson(writer, "thumb_width", object->thumbWidth);
+	appendToJson(writer, "thumb_height", object->thumbHeight);
+}
+
+std::string TgTypeParser::parseInlineQueryResultLocation(const InlineQueryResultLocation::Ptr& object) const {
+	return parseInlineQueryResult(object);
 }
 
 
-InlineQueryResultVenue::Ptr TgTypeParser::parseJsonAndGetInlineQueryResultVenue(const boost::property_tree::ptree& data) const {
+InlineQueryResultVenue::Ptr TgTypeParser::parseJsonAndGetInlineQueryResultVenue(const JsonValue& data) const {
 	// NOTE: This function will be called by parseJsonAndGgetInlineQueryResult().
 	auto result(std::make_shared<InlineQueryResultVenue>());
 	result->latitude = data.get<float>("latitude");
@@ -1136,25 +1301,25 @@ InlineQueryResultVenue::Ptr TgTypeParser::parseJsonAndGetInlineQueryResultVenue(
 	return result;
 }
 
-std::string TgTypeParser::parseInlineQueryResultVenue(const InlineQueryResultVenue::Ptr& object) const {
-	if (!object){
-		return " ";
+void TgTypeParser::writeInlineQueryResultVenue(JsonWriter& writer, const InlineQueryResultVenue::Ptr& object) const {
+	if (!object) {
+		return;
 	}
-	// This function will be called by parseInlineQueryResult(), so I don't add
-	// curly brackets to the result std::string.
-	std::string result;
-	appendToJson(result, "latitude", object->latitude);
-	appendToJson(result, "longitude", object->longitude);
-	appendToJson(result, "address", object->address);
-	appendToJson(result, "foursquare_id", object->foursquareId);
-	appendToJson(result, "thumb_url", object->thumbUrl);
-	appendToJson(result, "thumb_width", object->thumbWidth);
-	appendToJson(result, "thumb_height", object->thumbHeight);
-	// The last comma will be erased by parseInlineQueryResult().
-	return result;
+	// This function is called by writeInlineQueryResult(), which opens and closes the object.
+	appendToJson(writer, "latitude", object->latitude);
+	appendToJson(writer, "longitude", object->longitude);
+	appendToJson(writer, "address", object->address);
+	appendToJson(writer, "foursquare_id", object->foursquareId);
+	appendToJson(writer, "thumb_url", object->thumbUrl);
+	appendToJson(writer, "thumb_width", object->thumbWidth);
+	appendToJson(writer, "thumb_height", object->thumbHeight);
 }
 
-InlineQueryResultVoice::Ptr TgTypeParser::parseJsonAndGetInlineQueryResultVoice(const boost::property_tree::ptree& data) const {
+std::string TgTypeParser::parseInlineQueryResultVenue(const InlineQueryResultVenue::Ptr& object) const {
+	return parseInlineQueryResult(object);
+}
+
+InlineQueryResultVoice::Ptr TgTypeParser::parseJsonAndGetInlineQueryResultVoice(const JsonValue& data) const {
 	// NOTE: This function will be called by parseJsonAndGgetInlineQueryResult().
 	auto result(std::make_shared<InlineQueryResultVoice>());
 	result->voiceUrl = data.get<std::string>("voice_url");
@@ -1162,20 +1327,20 @@ InlineQueryResultVoice::Ptr TgTypeParser::parseJsonAndGetInlineQueryResultVoice(
 	return result;
 }
 
-std::string TgTypeParser::parseInlineQueryResultVoice(const InlineQueryResultVoice::Ptr& object) const {
-	if (!object){
-		return " ";
+void TgTypeParser::writeInlineQueryResultVoice(JsonWriter& writer, const InlineQueryResultVoice::Ptr& object) const {
+	if (!object) {
+		return;
 	}
-	// This function will be called by parseInlineQueryResult(), so I don't add
-	// curly brackets to the result std::string.
-	std::string result;
-	appendToJson(result, "voice_url", object->voiceUrl);
-	appendToJson(result, "voice_duration", object->voiceDuration);
-	// The last comma will be erased by parseInlineQueryResult().
-	return result;
+	// This function is called by writeInlineQueryResult(), which opens and closes the object.
+	appendToJson(writer, "voice_url", object->voiceUrl);
+	appendToJson(writer, "voice_duration", object->voiceDuration);
 }
 
-InlineQueryResultPhoto::Ptr TgTypeParser::parseJsonAndGetInlineQueryResultPhoto(const boost::property_tree::ptree& data) const {
+std::string TgTypeParser::parseInlineQueryResultVoice(const InlineQueryResultVoice::Ptr& object) const {
+	return parseInlineQueryResult(object);
+}
+
+InlineQueryResultPhoto::Ptr TgTypeParser::parseJsonAndGetInlineQueryResultPhoto(const JsonValue& data) const {
 	// NOTE: This function will be called by parseJsonAndGgetInlineQueryResult().
 	auto result(std::make_shared<InlineQueryResultPhoto>());
 	result->photoUrl = data.get<std::string>("photo_url", "");
@@ -1186,23 +1351,23 @@ InlineQueryResultPhoto::Ptr TgTypeParser::parseJsonAndGetInlineQueryResultPhoto(
 	return result;
 }
 
-std::string TgTypeParser::parseInlineQueryResultPhoto(const InlineQueryResultPhoto::Ptr& object) const{
-	if (!object){
-		return " ";
+void TgTypeParser::writeInlineQueryResultPhoto(JsonWriter& writer, const InlineQueryResultPhoto::Ptr& object) const {
+	if (!object) {
+		return;
 	}
-	// This function will be called by parseInlineQueryResult(), so I don't add
-	// curly brackets to the result std::string.
-	std::string result;
-	appendToJson(result, "photo_url", object->photoUrl);
-	appendToJson(result, "thumb_url", object->thumbUrl);
-	appendToJson(result, "photo_width", object->photoWidth);
-	appendToJson(result, "photo_height", object->photoHeight);
-	appendToJson(result, "description", object->description);
-	// The last comma will be erased by parseInlineQueryResult().
-	return result;
+	// This function is called by writeInlineQueryResult(), which opens and closes the object.
+	appendToJson(writer, "photo_url", object->photoUrl);
+	appendToJson(writer, "thumb_url", object->thumbUrl);
+	appendToJson(writer, "photo_width", object->photoWidth);
+	appendToJson(writer, "photo_height", object->photoHeight);
+	appendToJson(writer, "description", object->description);
 }
 
-InlineQueryResultGif::Ptr TgTypeParser::parseJsonAndGetInlineQueryResultGif(const boost::property_tree::ptree& data) const {
+std::string TgTypeParser::parseInlineQueryResultPhoto(const InlineQueryResultPhoto::Ptr& object) const {
+	return parseInlineQueryResult(object);
+}
+
+InlineQueryResultGif::Ptr TgTypeParser::parseJsonAndGetInlineQueryResultGif(const JsonValue& data) const {
 	// NOTE: This function will be called by parseJsonAndGgetInlineQueryResult().
 	auto result(std::make_shared<InlineQueryResultGif>());
 	result->gifUrl = data.get<std::string>("gif_url", "");
@@ -1212,23 +1377,23 @@ InlineQueryResultGif::Ptr TgTypeParser::parseJsonAndGetInlineQueryResultGif(cons
 	result->thumbUrl = data.get<std::string>("thumb_url");
 	return result;
 }
-std::string TgTypeParser::parseInlineQueryResultGif(const InlineQueryResultGif::Ptr& object) const {
-	if (!object){
-		return " ";
+void TgTypeParser::writeInlineQueryResultGif(JsonWriter& writer, const InlineQueryResultGif::Ptr& object) const {
+	if (!object) {
+		return;
 	}
-	// This function will be called by parseInlineQueryResult(), so I don't add
-	// curly brackets to the result std::string.
-	std::string result;
-	appendToJson(result, "gif_url", object->gifUrl);
-	appendToJson(result, "gif_width", object->gifWidth);
-	appendToJson(result, "gif_height", object->gifHeight);
-	appendToJson(result, "gif_duration", object->gifDuration);
-	appendToJson(result, "thumb_url", object->thumbUrl);
-	// The last comma will be erased by parseInlineQueryResult().
-	return result;
+	// This function is called by writeInlineQueryResult(), which opens and closes the object.
+	appendToJson(writer, "gif_url", object->gifUrl);
+	appendToJson(writer, "gif_width", object->gifWidth);
+	appendToJson(writer, "gif_height", object->gifHeight);
+	appendToJson(writer, "gif_duration", object->gifDuration);
+	appendToJson(writer, "thumb_url", object->thumbUrl);
 }
 
-InlineQueryResultMpeg4Gif::Ptr TgTypeParser::parseJsonAndGetInlineQueryResultMpeg4Gif(const boost::property_tree::ptree& data) const {
+std::string TgTypeParser::parseInlineQueryResultGif(const InlineQueryResultGif::Ptr& object) const {
+	return parseInlineQueryResult(object);
+}
+
+InlineQueryResultMpeg4Gif::Ptr TgTypeParser::parseJsonAndGetInlineQueryResultMpeg4Gif(const JsonValue& data) const {
 	// NOTE: This function will be called by parseJsonAndGgetInlineQueryResult().
 	auto result(std::make_shared<InlineQueryResultMpeg4Gif>());
 	result->mpeg4Url = data.get<std::string>("mpeg4_url");
@@ -1239,23 +1404,23 @@ InlineQueryResultMpeg4Gif::Ptr TgTypeParser::parseJsonAndGetInlineQueryResultMpe
 	return result;
 }
 
-std::string TgTypeParser::parseInlineQueryResultMpeg4Gif(const InlineQueryResultMpeg4Gif::Ptr& object) const {
-	if (!object){
-		return " ";
+void TgTypeParser::writeInlineQueryResultMpeg4Gif(JsonWriter& writer, const InlineQueryResultMpeg4Gif::Ptr& object) const {
+	if (!object) {
+		return;
 	}
-	// This function will be called by parseInlineQueryResult(), so I don't add
-	// curly brackets to the result std::string.
-	std::string result;
-	appendToJson(result, "mpeg4_url", object->mpeg4Url);
-	appendToJson(result, "mpeg4_width", object->mpeg4Width);
-	appendToJson(result, "mpeg4_height", object->mpeg4Height);
-	appendToJson(result, "mpeg4_duration", object->mpeg4Duration);
-	appendToJson(result, "thumb_url", object->thumbUrl);
-	// The last comma will be erased by parseInlineQueryResult().
-	return result;
+	// This function is called by writeInlineQueryResult(), which opens and closes the object.
+	appendToJson(writer, "mpeg4_url", object->mpeg4Url);
+	appendToJson(writer, "mpeg4_width", object->mpeg4Width);
+	appendToJson(writer, "mpeg4_height", object->mpeg4Height);
+	appendToJson(writer, "mpeg4_duration", object->mpeg4Duration);
+	appendToJson(writer, "thumb_url", object->thumbUrl);
+}
+
+std::string TgTypeParser::parseInlineQueryResultMpeg4Gif(const InlineQueryResultMpeg4Gif::Ptr& object) const {
+	return parseInlineQueryResult(object);
 }
 
-InlineQueryResultVideo::Ptr TgTypeParser::parseJsonAndGetInlineQueryResultVideo(const boost::property_tree::ptree& data) const {
+InlineQueryResultVideo::Ptr TgTypeParser::parseJsonAndGetInlineQueryResultVideo(const JsonValue& data) const {
 	// NOTE: This function will be called by parseJsonAndGgetInlineQueryResult().
 	auto result(std::make_shared<InlineQueryResultVideo>());
 	result->videoUrl = data.get<std::string>("video_url");
@@ -1268,25 +1433,25 @@ InlineQueryResultVideo::Ptr TgTypeParser::parseJsonAndGetInlineQueryResultVideo(
 	return result;
 }
 
-std::string TgTypeParser::parseInlineQueryResultVideo(const InlineQueryResultVideo::Ptr& object) const {
-	if (!object){
-		return " ";
+void TgTypeParser::writeInlineQueryResultVideo(JsonWriter& writer, const InlineQueryResultVideo::Ptr& object) const {
+	if (!object) {
+		return;
 	}
-	// This function will be called by parseInlineQueryResult(), so I don't add
-	// curly brackets to the result std::string.
-	std::string result;
-	appendToJson(result, "video_url", object->videoUrl);
-	appendToJson(result, "mime_type", object->mimeType);
-	appendToJson(result, "thumb_url", object->thumbUrl);
-	appendToJson(result, "video_width", object->videoWidth);
-	appendToJson(result, "video_height", object->videoHeight);
-	appendToJson(result, "video_duration", object->videoDuration);
-	appendToJson(result, "description", object->description);
-	// The last comma will be erased by parseInlineQueryResult().
-	return result;
+	// This function is called by writeInlineQueryResult(), which opens and closes the object.
+	appendToJson(writer, "video_url", object->videoUrl);
+	appendToJson(writer, "mime_type", object->mimeType);
+	appendToJson(writer, "thumb_url", object->thumbUrl);
+	appendToJson(writer, "video_width", object->videoWidth);
+	appendToJson(writer, "video_height", object->videoHeight);
+	appendToJson(writer, "video_duration", object->videoDuration);
+	appendToJson(writer, "description", object->description);
+}
+
+std::string TgTypeParser::parseInlineQueryResultVideo(const InlineQueryResultVideo::Ptr& object) const {
+	return parseInlineQueryResult(object);
 }
 
-ChosenInlineResult::Ptr TgTypeParser::parseJsonAndGetChosenInlineResult(const boost::property_tree::ptree& data) const {
+ChosenInlineResult::Ptr TgTypeParser::parseJsonAndGetChosenInlineResult(const JsonValue& data) const {
 	auto result(std::make_shared<ChosenInlineResult>());
 	result->resultId = data.get<std::string>("result_id");
 	result->from = tryParseJson<User>(&TgTypeParser::parseJsonAndGetUser, data, "from");
@@ -1296,22 +1461,23 @@ ChosenInlineResult::Ptr TgTypeParser::parseJsonAndGetChosenInlineResult(const bo
 	return result;
 }
 
-std::string TgTypeParser::parseChosenInlineResult(const ChosenInlineResult::Ptr& object) const {
-	if (!object){
-		return "";
+void TgTypeParser::writeChosenInlineResult(JsonWriter& writer, const ChosenInlineResult::Ptr& object) const {
+	if (!object) {
+		writer.nullValue();
+		return;
 	}
+	writer.startObject();
+	appendToJson(writer, "result_id", object->resultId);
+	appendToJson(writer, "from", &TgTypeParser::writeUser, object->from);
+	appendToJson(writer, "query", object->query);
+	writer.endObject();
+}
 
-	std::string result;
-	result += '{';
-	appendToJson(result, "result_id", object->resultId);
-	appendToJson(result, "from", parseUser(object->from));
-	appendToJson(result, "query", object->query);
-	result.erase(result.length() - 1);
-	result += '}';
-	return result;
+std::string TgTypeParser::parseChosenInlineResult(const ChosenInlineResult::Ptr& object) const {
+	return toJson(&TgTypeParser::writeChosenInlineResult, object);
 }
 
-CallbackQuery::Ptr TgTypeParser::parseJsonAndGetCallbackQuery(const boost::property_tree::ptree& data) const {
+CallbackQuery::Ptr TgTypeParser::parseJsonAndGetCallbackQuery(const JsonValue& data) const {
 	auto result(std::make_shared<CallbackQuery>());
 	result->id = data.get<std::string>("id");
 	result->from = tryParseJson<User>(&TgTypeParser::parseJsonAndGetUser, data, "from");
@@ -1323,56 +1489,50 @@ CallbackQuery::Ptr TgTypeParser::parseJsonAndGetCallbackQuery(const boost::prope
 	return result;
 }
 
-std::string TgTypeParser::parseCallbackQuery(const CallbackQuery::Ptr& object) const {
-	if (!object){
-		return "";
+void TgTypeParser::writeCallbackQuery(JsonWriter& writer, const CallbackQuery::Ptr& object) const {
+	if (!object) {
+		writer.nullValue();
+		return;
 	}
+	writer.startObject();
+	appendToJson(writer, "id", object->id);
+	appendToJson(writer, "from", &TgTypeParser::writeUser, object->from);
+	appendToJson(writer, "message", &TgTypeParser::writeMessage, object->message);
+	appendToJson(writer, "inline_message_id", object->inlineMessageId);
+	appendToJson(writer, "chat_instance", object->chatInstance);
+	appendToJson(writer, "game_short_name", object->gameShortName);
+	appendToJson(writer, "data", object->data);
+	writer.endObject();
+}
 
-	std::string result;
-	result += '{';
-	appendToJson(result, "id", object->id);
-	appendToJson(result, "from", parseUser(object->from));
-	appendToJson(result, "message", parseMessage(object->message));
-	appendToJson(result, "inline_message_id", object->inlineMessageId);
-	appendToJson(result, "chat_instance", object->chatInstance);
-	appendToJson(result, "game_short_name", object->gameShortName);
-	appendToJson(result, "data", object->data);
-	result.erase(result.length() - 1);
-	result += '}';
-	return result;
+std::string TgTypeParser::parseCallbackQuery(const CallbackQuery::Ptr& object) const {
+	return toJson(&TgTypeParser::writeCallbackQuery, object);
 }
 
-InlineKeyboardMarkup::Ptr TgTypeParser::parseJsonAndGetInlineKeyboardMarkup(const boost::property_tree::ptree& data) const {
+InlineKeyboardMarkup::Ptr TgTypeParser::parseJsonAndGetInlineKeyboardMarkup(const JsonValue& data) const {
 	auto result(std::make_shared<InlineKeyboardMarkup>());
-	for (const boost::property_tree::ptree::value_type& item : data.find("inline_keyboard")->second){
-		result->inlineKeyboard.push_back(parseJsonAndGetArray<InlineKeyboardButton>(&TgTypeParser::parseJsonAndGetInlineKeyboardButton, item.second));
+	for (const JsonValue& item : data["inline_keyboard"]) {
+		result->inlineKeyboard.push_back(parseJsonAndGetArray<InlineKeyboardButton>(&TgTypeParser::parseJsonAndGetInlineKeyboardButton, item));
 	}
 	return result;
 }
 
-std::string TgTypeParser::parseInlineKeyboardMarkup(const InlineKeyboardMarkup::Ptr& object) const {
-	if (!object){
-		return "";
-	}
-	std::string result;
-	result += '{';
-	result += "\"inline_keyboard\":[";
-	for (std::vector<InlineKeyboardButton::Ptr>& item : object->inlineKeyboard){
-		result += '[';
-		for (InlineKeyboardButton::Ptr& innerItem : item){
-			result += parseInlineKeyboardButton(innerItem);
-			result += ',';
-		}
-		result.erase(result.length() - 1);
-		result += "],";
+void TgTypeParser::writeInlineKeyboardMarkup(JsonWriter& writer, const InlineKeyboardMarkup::Ptr& object) const {
+	if (!object) {
+		writer.nullValue();
+		return;
 	}
-	if (!object->inlineKeyboard.empty())
-		result.erase(result.length() - 1);
-	result += "]}";
-	return result;
+	writer.startObject();
+	writer.key("inline_keyboard");
+	write2DArray(writer, &TgTypeParser::writeInlineKeyboardButton, object->inlineKeyboard);
+	writer.endObject();
 }
 
-InlineKeyboardButton::Ptr TgTypeParser::parseJsonAndGetInlineKeyboardButton(const boost::property_tree::ptree& data) const {
+std::string TgTypeParser::parseInlineKeyboardMarkup(const InlineKeyboardMarkup::Ptr& object) const {
+	return toJson(&TgTypeParser::writeInlineKeyboardMarkup, object);
+}
+
+InlineKeyboardButton::Ptr TgTypeParser::parseJsonAndGetInlineKeyboardButton(const JsonValue& data) const {
 	auto result(std::make_shared<InlineKeyboardButton>());
 	result->text = data.get<std::string>("text");
 	result->url = data.get<std::string>("url", "");
@@ -1381,23 +1541,25 @@ InlineKeyboardButton::Ptr TgTypeParser::parseJsonAndGetInlineKeyboardButton(cons
 	result->switchInlineQueryCurrentChat = data.get<std::string>("switch_inline_query_current_chat", "");
 	return result;
 }
-std::string TgTypeParser::parseInlineKeyboardButton(const InlineKeyboardButton::Ptr& object) const {
-	if (!object){
-		return "";
+void TgTypeParser::writeInlineKeyboardButton(JsonWriter& writer, const InlineKeyboardButton::Ptr& object) const {
+	if (!object) {
+		writer.nullValue();
+		return;
 	}
-	std::string result;
-	result += '{';
-	appendToJson(result, "text", object->text);
-	appendToJson(result, "url", object->url);
-	appendToJson(result, "callback_data", object->callbackData);
-	appendToJson(result, "switch_inline_query", object->switchInlineQuery);
-	appendToJson(result, "switch_inline_query_current_chat", object->switchInlineQueryCurrentChat);
-	result.erase(result.length() - 1);
-	result += '}';
-	return result;
+	writer.startObject();
+	appendToJson(writer, "text", object->text);
+	appendToJson(writer, "url", object->url);
+	appendToJson(writer, "callback_data", object->callbackData);
+	appendToJson(writer, "switch_inline_query", object->switchInlineQuery);
+	appendToJson(writer, "switch_inline_query_current_chat", object->switchInlineQueryCurrentChat);
+	writer.endObject();
+}
+
+std::string TgTypeParser::parseInlineKeyboardButton(const InlineKeyboardButton::Ptr& object) const {
+	return toJson(&TgTypeParser::writeInlineKeyboardButton, object);
 }
 
-WebhookInfo::Ptr TgTypeParser::parseJsonAndGetWebhookInfo(const boost::property_tree::ptree& data) const {
+WebhookInfo::Ptr TgTypeParser::parseJsonAndGetWebhookInfo(const JsonValue& data) const {
 	auto result(std::make_shared<WebhookInfo>());
 	result->url = data.get<std::string>("url");
 	result->hasCustomCertificate = data.get<bool>("has_custom_certificate");
@@ -1406,36 +1568,37 @@ WebhookInfo::Ptr TgTypeParser::parseJsonAndGetWebhookInfo(const boost::property_
 	result->lastErrorMessage = data.get<std::string>("last_error_message", "");
 	result->maxConnections = data.get<int32_t>("max_connections", 0);
 	result->allowedUpdates = parseJsonAndGetArray<std::string>(
-		[](const boost::property_tree::ptree& innerData)->std::string {
-			return innerData.get<std::string>("");
+		[](const JsonValue& innerData)->std::string {
+			return innerData.as<std::string>();
 		}
 		, data, "allowed_updates");
 	return result;
 }
 
-std::string TgTypeParser::parseWebhookInfo(const WebhookInfo::Ptr& object) const {
+void TgTypeParser::writeWebhookInfo(JsonWriter& writer, const WebhookInfo::Ptr& object) const {
 	if (!object) {
-		return "";
-	}
-	std::string result;
-	result += '{';
-	appendToJson(result, "url", object->url);
-	appendToJson(result, "has_custom_certificate", object->hasCustomCertificate);
-	appendToJson(result, "pending_update_count", object->pendingUpdateCount);
-	appendToJson(result, "last_error_date", object->lastErrorDate);
-	appendToJson(result, "last_error_message", object->lastErrorMessage);
-	appendToJson(result, "max_connections", object->maxConnections);
-	appendToJson(result, "allowed_updates", 
-		parseArray<std::string>([](const std::string &s)->std::string {
-			return s;
-		}
-		, object->allowedUpdates));
-	result.erase(result.length() - 1);
-	result += '}';
-	return result;
+		writer.nullValue();
+		return;
+	}
+	writer.startObject();
+	appendToJson(writer, "url", object->url);
+	appendToJson(writer, "has_custom_certificate", object->hasCustomCertificate);
+	appendToJson(writer, "pending_update_count", object->pendingUpdateCount);
+	appendToJson(writer, "last_error_date", object->lastErrorDate);
+	appendToJson(writer, "last_error_message", object->lastErrorMessage);
+	appendToJson(writer, "max_connections", object->maxConnections);
+	if (!object->allowedUpdates.empty()) {
+		writer.key("allowed_updates");
+		writeArray(writer, object->allowedUpdates);
+	}
+	writer.endObject();
+}
+
+std::string TgTypeParser::parseWebhookInfo(const WebhookInfo::Ptr& object) const {
+	return toJson(&TgTypeParser::writeWebhookInfo, object);
 }
 
-InputMessageContent::Ptr TgTypeParser::parseJsonAndGetInputMessageContent(const boost::property_tree::ptree& data) const {
+InputMessageContent::Ptr TgTypeParser::parseJsonAndGetInputMessageContent(const JsonValue& data) const {
 	InputMessageContent::Ptr result;
 	// define InputMessageContent type
 
@@ -1457,33 +1620,32 @@ InputMessageContent::Ptr TgTypeParser::parseJsonAndGetInputMessageContent(const
 	return result;
 }
 
-std::string TgTypeParser::parseInputMessageContent(const InputMessageContent::Ptr& object) const {
-	if (!object){
-		return "";
+void TgTypeParser::writeInputMessageContent(JsonWriter& writer, const InputMessageContent::Ptr& object) const {
+	if (!object) {
+		writer.nullValue();
+		return;
 	}
-
-	std::string result;
-	result += '{';
-	
+	writer.startObject();
 	if (object->type == std::string("InputTextMessageContent")) {
-		result += parseInputTextMessageContent(std::static_pointer_cast<InputTextMessageContent>(object));
+		writeInputTextMessageContent(writer, std::static_pointer_cast<InputTextMessageContent>(object));
 	}
 	else if (object->type == std::string("InputLocationMessageContent")) {
-		result += parseInputLocationMessageContent(std::static_pointer_cast<InputLocationMessageContent>(object));
+		writeInputLocationMessageContent(writer, std::static_pointer_cast<InputLocationMessageContent>(object));
 	}
 	else if (object->type == std::string("InputVenueMessageContent")) {
-		result += parseInputVenueMessageContent(std::static_pointer_cast<InputVenueMessageContent>(object));
+		writeInputVenueMessageContent(writer, std::static_pointer_cast<InputVenueMessageContent>(object));
 	}
 	else if (object->type == std::string("InputContactMessageContent")) {
-		result += parseInputContactMessageContent(std::static_pointer_cast<InputContactMessageContent>(object));
+		writeInputContactMessageContent(writer, std::static_pointer_cast<InputContactMessageContent>(object));
 	}
+	writer.endObject();
+}
 
-	result.erase(result.length() - 1);
-	result += '}';
-	return result;
+std::string TgTypeParser::parseInputMessageContent(const InputMessageContent::Ptr& object) const {
+	return toJson(&TgTypeParser::writeInputMessageContent, object);
 }
 
-InputTextMessageContent::Ptr TgTypeParser::parseJsonAndGetInputTextMessageContent(const boost::property_tree::ptree& data) const {
+InputTextMessageContent::Ptr TgTypeParser::parseJsonAndGetInputTextMessageContent(const JsonValue& data) const {
 	// NOTE: This function will be called by parseJsonAndGetInputMessageContent().
 	auto result(std::make_shared<InputTextMessageContent>());
 	result->messageText = data.get<std::string>("message_text");
@@ -1492,20 +1654,21 @@ InputTextMessageContent::Ptr TgTypeParser::parseJsonAndGetInputTextMessageConten
 	return result;
 }
 
-std::string TgTypeParser::parseInputTextMessageContent(const InputTextMessageContent::Ptr& object) const {
-	if (!object){
-		return " ";
+void TgTypeParser::writeInputTextMessageContent(JsonWriter& writer, const InputTextMessageContent::Ptr& object) const {
+	if (!object) {
+		return;
 	}
-	// This function will be called by parseInputMessageContent()
-	std::string result;
-	appendToJson(result, "message_text", object->messageText);
-	appendToJson(result, "parse_mode", object->parseMode);
-	appendToJson(result, "disable_web_page_preview", object->disableWebPagePreview);
-	// The last comma will be erased by parseInputMessageContent().
-	return result;
+	// This function is called by writeInputMessageContent(), which opens and closes the object.
+	appendToJson(writer, "message_text", object->messageText);
+	appendToJson(writer, "parse_mode", object->parseMode);
+	appendToJson(writer, "disable_web_page_preview", object->disableWebPagePreview);
 }
 
-InputLocationMessageContent::Ptr TgTypeParser::parseJsonAndGetInputLocationMessageContent(const boost::property_tree::ptree& data) const {
+std::string TgTypeParser::parseInputTextMessageContent(const InputTextMessageContent::Ptr& object) const {
+	return parseInputMessageContent(object);
+}
+
+InputLocationMessageContent::Ptr TgTypeParser::parseJsonAndGetInputLocationMessageContent(const JsonValue& data) const {
 	// NOTE: This function will be called by parseJsonAndGetInputMessageContent().
 	auto result(std::make_shared<InputLocationMessageContent>());
 	result->latitude = data.get<float>("latitude");
@@ -1513,19 +1676,20 @@ InputLocationMessageContent::Ptr TgTypeParser::parseJsonAndGetInputLocationMessa
 	return result;
 }
 
-std::string TgTypeParser::parseInputLocationMessageContent(const InputLocationMessageContent::Ptr& object) const {
-	if (!object){
-		return " ";
+void TgTypeParser::writeInputLocationMessageContent(JsonWriter& writer, const InputLocationMessageContent::Ptr& object) const {
+	if (!object) {
+		return;
 	}
-	// This function will be called by parseInputMessageContent()
-	std::string result;
-	appendToJson(result, "latitude", object->latitude);
-	appendToJson(result, "longitude", object->longitude);
-	// The last comma will be erased by parseInputMessageContent().
-	return result;
+	// This function is called by writeInputMessageContent(), which opens and closes the object.
+	appendToJson(writer, "latitude", object->latitude);
+	appendToJson(writer, "longitude", object->longitude);
 }
 
-InputVenueMessageContent::Ptr TgTypeParser::parseJsonAndGetInputVenueMessageContent(const boost::property_tree::ptree& data) const {
+std::string TgTypeParser::parseInputLocationMessageContent(const InputLocationMessageContent::Ptr& object) const {
+	return parseInputMessageContent(object);
+}
+
+InputVenueMessageContent::Ptr TgTypeParser::parseJsonAndGetInputVenueMessageContent(const JsonValue& data) const {
 	// NOTE: This function will be called by parseJsonAndGetInputMessageContent().
 	auto result(std::make_shared<InputVenueMessageContent>());
 	result->latitude = data.get<float>("latitude");
@@ -1536,22 +1700,23 @@ InputVenueMessageContent::Ptr TgTypeParser::parseJsonAndGetInputVenueMessageCont
 	return result;
 }
 
-std::string TgTypeParser::parseInputVenueMessageContent(const InputVenueMessageContent::Ptr& object) const {
-	if (!object){
-		return " ";
+void TgTypeParser::writeInputVenueMessageContent(JsonWriter& writer, const InputVenueMessageContent::Ptr& object) const {
+	if (!object) {
+		return;
 	}
-	// This function will be called by parseInputMessageContent()
-	std::string result;
-	appendToJson(result, "latitude", object->latitude);
-	appendToJson(result, "longitude", object->longitude);
-	appendToJson(result, "title", object->title);
-	appendToJson(result, "address", object->address);
-	appendToJson(result, "foursquare_id", object->foursquareId);
-	// The last comma will be erased by parseInputMessageContent().
-	return result;
+	// This function is called by writeInputMessageContent(), which opens and closes the object.
+	appendToJson(writer, "latitude", object->latitude);
+	appendToJson(writer, "longitude", object->longitude);
+	appendToJson(writer, "title", object->title);
+	appendToJson(writer, "address", object->address);
+	appendToJson(writer, "foursquare_id", object->foursquareId);
 }
 
-InputContactMessageContent::Ptr TgTypeParser::parseJsonAndGetInputContactMessageContent(const boost::property_tree::ptree& data) const {
+std::string TgTypeParser::parseInputVenueMessageContent(const InputVenueMessageContent::Ptr& object) const {
+	return parseInputMessageContent(object);
+}
+
+InputContactMessageContent::Ptr TgTypeParser::parseJsonAndGetInputContactMessageContent(const JsonValue& data) const {
 	// NOTE: This function will be called by parseJsonAndGetInputMessageContent().
 	auto result(std::make_shared<InputContactMessageContent>());
 	result->phoneNumber = data.get<std::string>("phone_number");
@@ -1560,20 +1725,21 @@ InputContactMessageContent::Ptr TgTypeParser::parseJsonAndGetInputContactMessage
 	return result;
 }
 
-std::string TgTypeParser::parseInputContactMessageContent(const InputContactMessageContent::Ptr& object) const {
-	if (!object){
-		return " ";
+void TgTypeParser::writeInputContactMessageContent(JsonWriter& writer, const InputContactMessageContent::Ptr& object) const {
+	if (!object) {
+		return;
 	}
-	// This function will be called by parseInputMessageContent()
-	std::string result;
-	appendToJson(result, "phone_number", object->phoneNumber);
-	appendToJson(result, "first_name", object->firstName);
-	appendToJson(result, "last_name", object->lastName);
-	// The last comma will be erased by parseInputMessageContent().
-	return result;
+	// This function is called by writeInputMessageContent(), which opens and closes the object.
+	appendToJson(writer, "phone_number", object->phoneNumber);
+	appendToJson(writer, "first_name", object->firstName);
+	appendToJson(writer, "last_name", object->lastName);
+}
+
+std::string TgTypeParser::parseInputContactMessageContent(const InputContactMessageContent::Ptr& object) const {
+	return parseInputMessageContent(object);
 }
 
-Invoice::Ptr TgTypeParser::parseJsonAndGetInvoice(const boost::property_tree::ptree& data) const {
+Invoice::Ptr TgTypeParser::parseJsonAndGetInvoice(const JsonValue& data) const {
 	auto result(std::make_shared<Invoice>());
 	result->title = data.get<std::string>("title");
 	result->description = data.get<std::string>("description");
@@ -1583,40 +1749,47 @@ Invoice::Ptr TgTypeParser::parseJsonAndGetInvoice(const boost::property_tree::pt
 	return result;
 }
 
-std::string TgTypeParser::parseInvoice(const Invoice::Ptr& object) const {
+void TgTypeParser::writeInvoice(JsonWriter& writer, const Invoice::Ptr& object) const {
 	if (!object) {
-		return " ";
+		writer.nullValue();
+		return;
 	}
-	std::string result;
-	result += '{';
-	appendToJson(result, "title", object->title);
-	appendToJson(result, "description", object->description);
-	appendToJson(result, "start_parameter", object->startParameter);
-	appendToJson(result, "currency", object->currency);
-	appendToJson(result, "total_amount", object->totalAmount);
-	result.erase(result.length() - 1);
-	result += '}';
-	return result;
+	writer.startObject();
+	appendToJson(writer, "title", object->title);
+	appendToJson(writer, "description", object->description);
+	appendToJson(writer, "start_parameter", object->startParameter);
+	appendToJson(writer, "currency", object->currency);
+	appendToJson(writer, "total_amount", object->totalAmount);
+	writer.endObject();
 }
 
-LabeledPrice::Ptr TgTypeParser::parseJsonAndGetLabeledPrice(const boost::property_tree::ptree& data) const {
+std::string TgTypeParser::parseInvoice(const Invoice::Ptr& object) const {
+	return toJson(&TgTypeParser::writeInvoice, object);
+}
+
+LabeledPrice::Ptr TgTypeParser::parseJsonAndGetLabeledPrice(const JsonValue& data) const {
 	auto result(std::make_shared<LabeledPrice>());
 	result->label  = data.get<std::string>("label");
 	result->amount = data.get<int32_t>("amount");
 	return result;
 }
 
+void TgTypeParser::writeLabeledPrice(JsonWriter& writer, const LabeledPrice::Ptr& object) const {
+	if (!object) {
+		writer.nullValue();
+		return;
+	}
+	writer.startObject();
+	appendToJson(writer, "label", object->label);
+	appendToJson(writer, "amount", object->amount);
+	writer.endObject();
+}
+
 std::string TgTypeParser::parseLabeledPrice(const LabeledPrice::Ptr& object) const {
-	std::string result;
-	result += '{';
-	appendToJson(result, "label", object->label);
-	appendToJson(result, "amount", object->amount);
-	result.erase(result.length() - 1);
-	result += '}';
-	return result;
+	return toJson(&TgTypeParser::writeLabeledPrice, object);
 }
 
-OrderInfo::Ptr TgTypeParser::parseJsonAndGetOrderInfo(const boost::property_tree::ptree& data) const {
+OrderInfo::Ptr TgTypeParser::parseJsonAndGetOrderInfo(const JsonValue& data) const {
 	auto result(std::make_shared<OrderInfo>());
 	result->name = data.get<std::string>("name", "");
 	result->phoneNumber = data.get<std::string>("phone_number", "");
@@ -1625,32 +1798,24 @@ OrderInfo::Ptr TgTypeParser::parseJsonAndGetOrderInfo(const boost::property_tree
 	return result;
 }
 
-std::string TgTypeParser::parseOrderInfo(const OrderInfo::Ptr& object) const {
+void TgTypeParser::writeOrderInfo(JsonWriter& writer, const OrderInfo::Ptr& object) const {
 	if (!object) {
-		return " ";
-	}
-	std::string result;
-	result += '{';
-	if (!object->name.empty()) {
-		appendToJson(result, "name", object->name);
-	}
-	if (!object->phoneNumber.empty()) {
-		appendToJson(result, "phone_number", object->phoneNumber);
-	}
-	if (!object->email.empty()) {
-		appendToJson(result, "email", object->email);
-	}
-	if (!object->shippingAddress) {
-		result += R"("shipping_address":)";
-		result += parseShippingAddress(object->shippingAddress);
-		result += ",";
+		writer.nullValue();
+		return;
 	}
-	result.erase(result.length() - 1);
-	result += '}';
-	return result;
+	writer.startObject();
+	appendToJson(writer, "name", object->name);
+	appendToJson(writer, "phone_number", object->phoneNumber);
+	appendToJson(writer, "email", object->email);
+	appendToJson(writer, "shipping_address", &TgTypeParser::writeShippingAddress, object->shippingAddress);
+	writer.endObject();
+}
+
+std::string TgTypeParser::parseOrderInfo(const OrderInfo::Ptr& object) const {
+	return toJson(&TgTypeParser::writeOrderInfo, object);
 }
 
-PreCheckoutQuery::Ptr TgTypeParser::parseJsonAndGetPreCheckoutQuery(const boost::property_tree::ptree& data) const {
+PreCheckoutQuery::Ptr TgTypeParser::parseJsonAndGetPreCheckoutQuery(const JsonValue& data) const {
 	auto result(std::make_shared<PreCheckoutQuery>());
 	result->id = data.get<std::string>("id");
 	result->from = tryParseJson(&TgTypeParser::parseJsonAndGetUser, data, "user");
@@ -1659,21 +1824,24 @@ PreCheckoutQuery::Ptr TgTypeParser::parseJsonAndGetPreCheckoutQuery(const boost:
 	return result;
 }
 
+void TgTypeParser::writePreCheckoutQuery(JsonWriter& writer, const PreCheckoutQuery::Ptr& object) const {
+	if (!object) {
+		writer.nullValue();
+		return;
+	}
+	writer.startObject();
+	appendToJson(writer, "id", object->id);
+	appendToJson(writer, "from", &TgTypeParser::writeUser, object->from);
+	appendToJson(writer, "currency", object->currency);
+	appendToJson(writer, "total_amount", object->totalAmount);
+	writer.endObject();
+}
+
 std::string TgTypeParser::parsePreCheckoutQuery(const PreCheckoutQuery::Ptr& object) const {
-	std::string result;
-	result += '{';
-	appendToJson(result, "id", object->id);
-	result += R"("user":)";
-	result += parseUser(object->from);
-	result += ",";
-	appendToJson(result, "currency", object->currency);
-	appendToJson(result, "total_amount", object->totalAmount);
-	result.erase(result.length() - 1);
-	result += '}';
-	return result;
+	return toJson(&TgTypeParser::writePreCheckoutQuery, object);
 }
 
-ShippingAddress::Ptr TgTypeParser::parseJsonAndGetShippingAddress(const boost::property_tree::ptree& data) const {
+ShippingAddress::Ptr TgTypeParser::parseJsonAndGetShippingAddress(const JsonValue& data) const {
 	ShippingAddress::Ptr result;
 	result->countryCode = data.get<std::string>("country_code");
 	result->state = data.get<std::string>("state", "");
@@ -1684,23 +1852,26 @@ ShippingAddress::Ptr TgTypeParser::parseJsonAndGetShippingAddress(const boost::p
 	return result;
 }
 
-std::string TgTypeParser::parseShippingAddress(const ShippingAddress::Ptr& object) const {
-	std::string result;
-	result += '{';
-	appendToJson(result, "country_code", object->countryCode);
-	if (!object->state.empty()) {
-		appendToJson(result, "state", object->state);
+void TgTypeParser::writeShippingAddress(JsonWriter& writer, const ShippingAddress::Ptr& object) const {
+	if (!object) {
+		writer.nullValue();
+		return;
 	}
-	appendToJson(result, "city", object->city);
-	appendToJson(result, "street_line1", object->streetLine1);
-	appendToJson(result, "street_line2", object->streetLine2);
-	appendToJson(result, "post_code", object->postCode);
-	result.erase(result.length() - 1);
-	result += '}';
-	return result;
+	writer.startObject();
+	appendToJson(writer, "country_code", object->countryCode);
+	appendToJson(writer, "state", object->state);
+	appendToJson(writer, "city", object->city);
+	appendToJson(writer, "street_line1", object->streetLine1);
+	appendToJson(writer, "street_line2", object->streetLine2);
+	appendToJson(writer, "post_code", object->postCode);
+	writer.endObject();
+}
+
+std::string TgTypeParser::parseShippingAddress(const ShippingAddress::Ptr& object) const {
+	return toJson(&TgTypeParser::writeShippingAddress, object);
 }
 
-ShippingOption::Ptr TgTypeParser::parseJsonAndGetShippingOption(const boost::property_tree::ptree& data) const {
+ShippingOption::Ptr TgTypeParser::parseJsonAndGetShippingOption(const JsonValue& data) const {
 	auto result(std::make_shared<ShippingOption>());
 	result->id = data.get<std::string>("id");
 	result->title = data.get<std::string>("title");
@@ -1708,19 +1879,23 @@ ShippingOption::Ptr TgTypeParser::parseJsonAndGetShippingOption(const boost::pro
 	return result;
 }
 
+void TgTypeParser::writeShippingOption(JsonWriter& writer, const ShippingOption::Ptr& object) const {
+	if (!object) {
+		writer.nullValue();
+		return;
+	}
+	writer.startObject();
+	appendToJson(writer, "id", object->id);
+	appendToJson(writer, "title", object->title);
+	appendToJson(writer, "prices", &TgTypeParser::writeLabeledPrice, object->prices);
+	writer.endObject();
+}
+
 std::string TgTypeParser::parseShippingOption(const ShippingOption::Ptr& object) const {
-	std::string result;
-	result += '{';
-	appendToJson(result, "id", object->id);
-	appendToJson(result, "title", object->title);
-	result.erase(result.length() - 1);
-	result += R"("prices":)";
-	result += parseArray(&TgTypeParser::parseLabeledPrice, object->prices);
-	result += '}';
-	return result;
+	return toJson(&TgTypeParser::writeShippingOption, object);
 }
 
-ShippingQuery::Ptr TgTypeParser::parseJsonAndGetShippingQuery(const boost::property_tree::ptree& data) const {
+ShippingQuery::Ptr TgTypeParser::parseJsonAndGetShippingQuery(const JsonValue& data) const {
 	auto result(std::make_shared<ShippingQuery>());
 	result->id = data.get<std::string>("id");
 	result->from = tryParseJson(&TgTypeParser::parseJsonAndGetUser, data, "from");
@@ -1729,23 +1904,24 @@ ShippingQuery::Ptr TgTypeParser::parseJsonAndGetShippingQuery(const boost::prope
 	return result;
 }
 
+void TgTypeParser::writeShippingQuery(JsonWriter& writer, const ShippingQuery::Ptr& object) const {
+	if (!object) {
+		writer.nullValue();
+		return;
+	}
+	writer.startObject();
+	appendToJson(writer, "id", object->id);
+	appendToJson(writer, "from", &TgTypeParser::writeUser, object->from);
+	appendToJson(writer, "invoice_payload", object->invoicePayload);
+	appendToJson(writer, "shipping_address", &TgTypeParser::writeShippingAddress, object->shippingAddress);
+	writer.endObject();
+}
+
 std::string TgTypeParser::parseShippingQuery(const ShippingQuery::Ptr& object) const {
-	std::string result;
-	result += '{';
-	appendToJson(result, "id", object->id);
-	result += R"("from":)";
-	result += parseUser(object->from);
-	result += ",";
-	appendToJson(result, "invoice_payload", object->invoicePayload);
-	result += R"("shipping_address":)";
-	result += parseShippingAddress(object->shippingAddress);
-	result += ",";
-	result.erase(result.length() - 1);
-	result += '}';
-	return result;
-}
-
-SuccessfulPayment::Ptr TgTypeParser::parseJsonAndGetSucessfulPayment(const boost::property_tree::ptree& data) const {
+	return toJson(&TgTypeParser::writeShippingQuery, object);
+}
+
+SuccessfulPayment::Ptr TgTypeParser::parseJsonAndGetSucessfulPayment(const JsonValue& data) const {
 	auto result(std::make_shared<SuccessfulPayment>());
 	result->currency = data.get<std::string>("currency");
 	result->totalAmount = data.get<int32_t>("total_amount");
@@ -1755,36 +1931,22 @@ SuccessfulPayment::Ptr TgTypeParser::parseJsonAndGetSucessfulPayment(const boost
 	return result;
 }
 
-std::string TgTypeParser::parseSucessfulPayment(const SuccessfulPayment::Ptr& object) const {
-	std::string result;
-	result += '{';
-	appendToJson(result, "currency", object->currency);
-	appendToJson(result, "total_amount", object->totalAmount);
-	appendToJson(result, "invoice_payload", object->invoicePayload);
-	appendToJson(result, "shipping_option_id", object->shippingOptionId);
-	result += R"("order_info":)";
-	result += parseOrderInfo(object->orderInfo);
-	result += ",";
-	result.erase(result.length() - 1);
-	result += '}';
-	return result;
-}
-
-void TgTypeParser::appendToJson(std::string& json, const std::string& varName, const std::string& value) const {
-	if (value.empty()) {
+void TgTypeParser::writeSucessfulPayment(JsonWriter& writer, const SuccessfulPayment::Ptr& object) const {
+	if (!object) {
+		writer.nullValue();
 		return;
 	}
-	json += '"';
-	json += varName;
-	json += "\":";
-	if (value.front() != '{') {
-		json += '"';
-	}
-	json += value;
-	if (value.back() != '}') {
-		json += '"';
-	}
-	json += ',';
+	writer.startObject();
+	appendToJson(writer, "currency", object->currency);
+	appendToJson(writer, "total_amount", object->totalAmount);
+	appendToJson(writer, "invoice_payload", object->invoicePayload);
+	appendToJson(writer, "shipping_option_id", object->shippingOptionId);
+	appendToJson(writer, "order_info", &TgTypeParser::writeOrderInfo, object->orderInfo);
+	writer.endObject();
+}
+
+std::string TgTypeParser::parseSucessfulPayment(const SuccessfulPayment::Ptr& object) const {
+	return toJson(&TgTypeParser::writeSucessfulPayment, object);
 }
 
 }
@@ -23,44 +23,566 @@
 
 #include "tgbot/net/HttpClient.h"
 
-#include <boost/asio/ssl.hpp>
+#include <algorithm>
+#include <fstream>
 
 using namespace boost::asio;
 using namespace boost::asio::ip;
 
 namespace TgBot {
 
+static const size_t STREAMED_FILE_CHUNK_SIZE = 64 * 1024;
+static const std::chrono::seconds IDLE_CHECK_INTERVAL(1);
+
+/**
+ * Returns true if repeating the request is harmless: GET requests and Bot API methods which only read, like getUpdates.
+ */
+static bool isIdempotentRequest(const std::string& requestText) {
+	if (!requestText.compare(0, 4, "GET ")) {
+		return true;
+	}
+	size_t pathStart = requestText.find(' ');
+	size_t pathEnd = requestText.find_first_of(" ?", pathStart + 1);
+	if (pathStart == std::string::npos || pathEnd == std::string::npos) {
+		return false;
+	}
+	size_t methodStart = requestText.rfind('/', pathEnd) + 1;
+	return methodStart > pathStart && !requestText.compare(methodStart, 3, "get");
+}
+
+/**
+ * State of one request which goes through resolving, connecting, handshaking, writing and reading.
+ */
+class HttpClient::Request : public std::enable_shared_from_this<HttpClient::Request> {
+
+public:
+	Request(HttpClient& client, const Url& url, std::string&& requestText, std::vector<HttpParser::FilePart>&& fileParts, const HttpResponseParser::HeadersHandler& headersHandler, const HttpResponseParser::BodyHandler& bodyHandler, const ResponseHandler& handler) :
+		client(client), url(url), poolKey(url.protocol + "://" + url.host), requestText(std::move(requestText)), fileParts(std::move(fileParts)), handler(handler), resolver(client._ioService),
+		strand(client._ioService), timer(client._ioService), isIdempotent(isIdempotentRequest(this->requestText))
+	{
+		parser.setHeadersHandler(headersHandler);
+		parser.setBodyHandler(bodyHandler);
+
+		// File contents are sent from their own buffers in between pieces of the request text, so they're never copied.
+		// Streamed files split the request into several writes.
+		requestBuffers.resize(1);
+		size_t position = 0;
+		for (const HttpParser::FilePart& item : this->fileParts) {
+			requestBuffers.back().push_back(buffer(this->requestText.data() + position, item.offset - position));
+			if (item.path.empty()) {
+				requestBuffers.back().push_back(buffer(item.data.data(), item.data.size()));
+			} else {
+				requestBuffers.resize(requestBuffers.size() + 1);
+			}
+			position = item.offset;
+		}
+		requestBuffers.back().push_back(buffer(this->requestText.data() + position, this->requestText.size() - position));
+	}
+
+	void openConnection() {
+		auto self(shared_from_this());
+		connection = std::make_shared<Connection>(client._ioService, client._sslContext, url.host);
+		isReused = false;
+		// The host part may have an explicit port, e.g. for a local Bot API server.
+		std::string hostName = url.host;
+		std::string service = url.protocol;
+		size_t portPosition = hostName.rfind(':');
+		if (portPosition != std::string::npos) {
+			service = hostName.substr(portPosition + 1);
+			hostName.erase(portPosition);
+		}
+		startTimer();
+		resolver.async_resolve(tcp::resolver::query(hostName, service), strand.wrap([self, hostName](const boost::system::error_code& error, tcp::resolver::iterator endpoints) {
+			self->runSafely([&]() {
+				if (error) {
+					self->fail(error);
+					return;
+				}
+				self->startTimer();
+				async_connect(self->connection->socket.lowest_layer(), endpoints, self->strand.wrap([self, hostName](const boost::system::error_code& error, tcp::resolver::iterator) {
+					self->runSafely([&]() {
+						if (error) {
+							self->fail(error);
+							return;
+						}
+						self->handshake(hostName);
+					});
+				}));
+			});
+		}));
+	}
+
+	void sendRequest(const std::shared_ptr<Connection>& connection, bool isReused) {
+		auto self(shared_from_this());
+		this->connection = connection;
+		this->isReused = isReused;
+		isRequestWritten = false;
+		isResponseStarted = false;
+		parser.reset();
+		writeRequest(0);
+	}
+
+	/**
+	 * Calls the function and aborts the request if it throws. Exceptions thrown by the parser or by handlers of the caller
+	 * must not escape into io_service::run, where the request would be dropped without calling its handler.
+	 */
+	template<typename Function>
+	void runSafely(const Function& function) {
+		try {
+			function();
+		} catch (...) {
+			abort(boost::system::errc::make_error_code(boost::system::errc::operation_canceled));
+		}
+	}
+
+	HttpClient& client;
+	const Url url;
+	const std::string poolKey;
+
+private:
+	void handshake(const std::string& hostName) {
+		auto self(shared_from_this());
+		SSL* ssl = connection->socket.native_handle();
+		connection->socket.set_verify_mode(ssl::verify_none);
+		connection->socket.set_verify_callback(ssl::rfc2818_verification(hostName));
+		SSL_set_tlsext_host_name(ssl, hostName.c_str());
+		SSL_set_ex_data(ssl, getSslDataIndex(), connection.get());
+		client.resumeSslSession(*connection);
+		startTimer();
+		connection->socket.async_handshake(ssl::stream_base::client, strand.wrap([self, ssl](const boost::system::error_code& error) {
+			self->runSafely([&]() {
+				if (error) {
+					self->fail(error);
+					return;
+				}
+				if (SSL_session_reused(ssl)) {
+					++self->client._resumedHandshakeCount;
+				} else {
+					++self->client._fullHandshakeCount;
+				}
+				self->sendRequest(self->connection, false);
+			});
+		}));
+	}
+
+	void writeRequest(size_t index) {
+		auto self(shared_from_this());
+		startTimer();
+		async_write(connection->socket, requestBuffers[index], strand.wrap([self, index](const boost::system::error_code& error, size_t) {
+			self->runSafely([&]() {
+				if (error) {
+					self->fail(error);
+					return;
+				}
+				if (index + 1 == self->requestBuffers.size()) {
+					self->isRequestWritten = true;
+					self->readResponse();
+					return;
+				}
+				self->writeStreamedFile(index);
+			});
+		}));
+	}
+
+	// The streamed file after the group of buffers with the given index is sent in chunks, so only one chunk is held in memory.
+	void writeStreamedFile(size_t index) {
+		const HttpParser::FilePart* part = nullptr;
+		size_t streamedIndex = 0;
+		for (const HttpParser::FilePart& item : fileParts) {
+			if (!item.path.empty() && streamedIndex++ == index) {
+				part = &item;
+				break;
+			}
+		}
+		fileStream.close();
+		fileStream.clear();
+		fileStream.open(part->path, std::ios::in | std::ios::binary);
+		if (!fileStream) {
+			fail(boost::system::errc::make_error_code(boost::system::errc::no_such_file_or_directory));
+			return;
+		}
+		chunk.resize(STREAMED_FILE_CHUNK_SIZE);
+		writeChunk(index, part->size);
+	}
+
+	void writeChunk(size_t index, size_t remainingSize) {
+		auto self(shared_from_this());
+		size_t size = std::min(remainingSize, chunk.size());
+		fileStream.read(chunk.data(), size);
+		if (static_cast<size_t>(fileStream.gcount()) != size) {
+			// The file was truncated after its size was taken, so the promised Content-Length can't be sent.
+			fail(boost::system::errc::make_error_code(boost::system::errc::io_error));
+			return;
+		}
+		startTimer();
+		async_write(connection->socket, buffer(chunk.data(), size), strand.wrap([self, index, remainingSize, size](const boost::system::error_code& error, size_t) {
+			self->runSafely([&]() {
+				if (error) {
+					self->fail(error);
+					return;
+				}
+				if (remainingSize > size) {
+					self->writeChunk(index, remainingSize - size);
+					return;
+				}
+				self->fileStream.close();
+				self->writeRequest(index + 1);
+			});
+		}));
+	}
+
+	void readResponse() {
+		auto self(shared_from_this());
+		startTimer();
+		connection->socket.async_read_some(buffer(connection->readBuffer), strand.wrap([self](const boost::system::error_code& error, size_t bytes) {
+			self->runSafely([&]() {
+				if (bytes) {
+					self->isResponseStarted = true;
+					self->parser.feed(self->connection->readBuffer, bytes);
+				}
+				if (error) {
+					if (error != error::eof && error != ssl::error::stream_truncated) {
+						self->fail(error);
+						return;
+					}
+					self->parser.finish();
+				}
+				if (self->parser.hasError()) {
+					self->fail(boost::system::errc::make_error_code(boost::system::errc::bad_message));
+				} else if (self->parser.isComplete()) {
+					self->timer.cancel();
+					self->client.releaseConnection(self->poolKey, std::move(self->connection), self->parser.isKeepAlive());
+					self->complete(boost::system::error_code());
+				} else {
+					self->readResponse();
+				}
+			});
+		}));
+	}
+
+	/**
+	 * Limits the time of the next network operation. When it's over, the connection is closed, so a peer which stopped
+	 * responding fails the request instead of blocking it forever.
+	 */
+	void startTimer() {
+		auto self(shared_from_this());
+		timer.expires_from_now(std::chrono::seconds(client._requestTimeout.load()));
+		timer.async_wait(strand.wrap([self](const boost::system::error_code& error) {
+			if (error || self->isCompleted) {
+				return;
+			}
+			self->isTimedOut = true;
+			boost::system::error_code ignoredError;
+			self->resolver.cancel();
+			if (self->connection) {
+				self->connection->socket.lowest_layer().close(ignoredError);
+			}
+		}));
+	}
+
+	void fail(boost::system::error_code error) {
+		timer.cancel();
+		client.releaseConnection(poolKey, nullptr, false);
+		connection.reset();
+		if (isTimedOut) {
+			complete(boost::system::errc::make_error_code(boost::system::errc::timed_out));
+			return;
+		}
+		// The server may have closed an idle connection while it was in the pool, so the request is repeated on another one.
+		// A request which was written completely may have been processed already, so it's repeated only if that's harmless.
+		if (isReused && !isResponseStarted && (!isRequestWritten || isIdempotent)) {
+			client.acquireConnection(shared_from_this());
+			return;
+		}
+		complete(error);
+	}
+
+	void abort(const boost::system::error_code& error) {
+		if (isCompleted) {
+			return;
+		}
+		timer.cancel();
+		client.releaseConnection(poolKey, nullptr, false);
+		connection.reset();
+		complete(error);
+	}
+
+	void complete(const boost::system::error_code& error) {
+		isCompleted = true;
+		try {
+			handler(error, std::move(parser.getBody()));
+		} catch (...) {
+		}
+	}
+
+	static int getSslDataIndex();
+
+	std::string requestText;
+	std::vector<HttpParser::FilePart> fileParts;
+	std::vector<std::vector<const_buffer>> requestBuffers;
+	std::ifstream fileStream;
+	std::vector<char> chunk;
+	ResponseHandler handler;
+	tcp::resolver resolver;
+	// Handlers of the request and of its timer run one at a time, so the timer can close the socket safely.
+	io_service::strand strand;
+	steady_timer timer;
+	const bool isIdempotent;
+	std::shared_ptr<Connection> connection;
+	bool isReused = false;
+	bool isRequestWritten = false;
+	bool isResponseStarted = false;
+	bool isTimedOut = false;
+	bool isCompleted = false;
+	HttpResponseParser parser;
+
+	friend class HttpClient;
+};
+
+static int getSslContextDataIndex() {
+	static int result = SSL_CTX_get_ex_new_index(0, nullptr, nullptr, nullptr, nullptr);
+	return result;
+}
+
+int HttpClient::Request::getSslDataIndex() {
+	static int result = SSL_get_ex_new_index(0, nullptr, nullptr, nullptr, nullptr);
+	return result;
+}
+
 HttpClient& HttpClient::getInstance() {
 	static HttpClient result;
 	return result;
 }
 
-std::string HttpClient::makeRequest(const Url& url, const std::vector<HttpReqArg>& args) {
-	ssl::context context(ssl::context::sslv23);
-	context.set_default_verify_paths();
+HttpClient::HttpClient() : _ioServiceWork(new io_service::work(_ioService)), _sslContext(ssl::context::sslv23), _requestTimeout(150), _idleTimer(_ioService), _fullHandshakeCount(0), _resumedHandshakeCount(0) {
+	_sslContext.set_default_verify_paths();
 
-	ssl::stream<tcp::socket> socket(_ioService, context);
-	tcp::resolver resolver(_ioService);
-	tcp::resolver::query query(url.host, url.protocol);
+	// Sessions are stored by onNewSslSession. With TLS 1.3 they arrive after the handshake, so they can't be simply taken when it ends.
+	SSL_CTX* context = _sslContext.native_handle();
+	SSL_CTX_set_ex_data(context, getSslContextDataIndex(), this);
+	SSL_CTX_set_session_cache_mode(context, SSL_SESS_CACHE_CLIENT | SSL_SESS_CACHE_NO_INTERNAL_STORE);
+	SSL_CTX_sess_set_new_cb(context, &HttpClient::onNewSslSession);
 
-	connect(socket.lowest_layer(), resolver.resolve(query));
+	setWorkerThreadCount(1);
+	scheduleIdleCheck();
+}
 
-	socket.set_verify_mode(ssl::verify_none);
-	socket.set_verify_callback(ssl::rfc2818_verification(url.host));
-	socket.handshake(ssl::stream<tcp::socket>::client);
+HttpClient::~HttpClient() {
+	_ioServiceWork.reset();
+	_ioService.stop();
+	for (std::thread& worker : _workers) {
+		worker.join();
+	}
+	_pools.clear();
+	for (auto& item : _sslSessions) {
+		SSL_SESSION_free(item.second);
+	}
+}
 
-	std::string requestText = HttpParser::getInstance().generateRequest(url, args, false);
-	write(socket, buffer(requestText.c_str(), requestText.length()));
+std::string HttpClient::makeRequest(const Url& url, const std::vector<HttpReqArg>& args, HttpParser::BodyEncoding bodyEncoding) {
+	return makeRequestAsync(url, args, bodyEncoding).get();
+}
+
+void HttpClient::makeRequestAsync(const Url& url, const std::vector<HttpReqArg>& args, const ResponseHandler& handler, HttpParser::BodyEncoding bodyEncoding) {
+	std::vector<HttpParser::FilePart> fileParts;
+	std::string requestText = HttpParser::getInstance().generateRequest(url, args, fileParts, true, bodyEncoding);
+	acquireConnection(std::make_shared<Request>(*this, url, std::move(requestText), std::move(fileParts), nullptr, nullptr, handler));
+}
+
+void HttpClient::makeRequestAsync(const Url& url, const std::vector<HttpReqArg>& args, const HttpResponseParser::BodyHandler& bodyHandler, const ResponseHandler& handler, HttpParser::BodyEncoding bodyEncoding) {
+	makeRequestAsync(url, args, nullptr, bodyHandler, handler, bodyEncoding);
+}
+
+void HttpClient::makeRequestAsync(const Url& url, const std::vector<HttpReqArg>& args, const HttpResponseParser::HeadersHandler& headersHandler, const HttpResponseParser::BodyHandler& bodyHandler, const ResponseHandler& handler, HttpParser::BodyEncoding bodyEncoding) {
+	std::vector<HttpParser::FilePart> fileParts;
+	std::string requestText = HttpParser::getInstance().generateRequest(url, args, fileParts, true, bodyEncoding);
+	acquireConnection(std::make_shared<Request>(*this, url, std::move(requestText), std::move(fileParts), headersHandler, bodyHandler, handler));
+}
+
+std::future<std::string> HttpClient::makeRequestAsync(const Url& url, const std::vector<HttpReqArg>& args, HttpParser::BodyEncoding bodyEncoding) {
+	auto promise(std::make_shared<std::promise<std::string>>());
+	makeRequestAsync(url, args, [promise](const boost::system::error_code& error, std::string&& response) {
+		if (error) {
+			promise->set_exception(std::make_exception_ptr(boost::system::system_error(error)));
+		} else {
+			promise->set_value(std::move(response));
+		}
+	}, bodyEncoding);
+	return promise->get_future();
+}
+
+std::string HttpClient::makeRequest(const Url& url, std::string&& requestText) {
+	std::promise<std::string> promise;
+	makeRequestAsync(url, std::move(requestText), [&promise](const boost::system::error_code& error, std::string&& response) {
+		if (error) {
+			promise.set_exception(std::make_exception_ptr(boost::system::system_error(error)));
+		} else {
+			promise.set_value(std::move(response));
+		}
+	});
+	return promise.get_future().get();
+}
+
+void HttpClient::makeRequestAsync(const Url& url, std::string&& requestText, const ResponseHandler& handler) {
+	acquireConnection(std::make_shared<Request>(*this, url, std::move(requestText), std::vector<HttpParser::FilePart>(), nullptr, nullptr, handler));
+}
+
+void HttpClient::makeRequestAsync(const Url& url, std::string&& requestText, const HttpResponseParser::HeadersHandler& headersHandler, const HttpResponseParser::BodyHandler& bodyHandler, const ResponseHandler& handler) {
+	acquireConnection(std::make_shared<Request>(*this, url, std::move(requestText), std::vector<HttpParser::FilePart>(), headersHandler, bodyHandler, handler));
+}
+
+void HttpClient::setWorkerThreadCount(size_t count) {
+	std::lock_guard<std::mutex> lock(_workersMutex);
+	while (_workers.size() < count) {
+		_workers.emplace_back([this]() {
+			// Requests catch their own exceptions, so this only keeps the worker alive if something else throws.
+			while (true) {
+				try {
+					_ioService.run();
+					break;
+				} catch (...) {
+				}
+			}
+		});
+	}
+}
+
+void HttpClient::setMaxConnectionsPerHost(size_t count) {
+	std::lock_guard<std::mutex> lock(_poolMutex);
+	_maxConnectionsPerHost = std::max<size_t>(1, count);
+	for (auto& item : _pools) {
+		startWaitingRequests(item.second);
+	}
+}
+
+void HttpClient::setIdleTimeout(int32_t seconds) {
+	std::lock_guard<std::mutex> lock(_poolMutex);
+	_idleTimeout = std::chrono::seconds(seconds);
+}
+
+void HttpClient::setRequestTimeout(int32_t seconds) {
+	_requestTimeout = seconds;
+}
+
+void HttpClient::scheduleIdleCheck() {
+	_idleTimer.expires_from_now(IDLE_CHECK_INTERVAL);
+	_idleTimer.async_wait([this](const boost::system::error_code& error) {
+		if (error) {
+			return;
+		}
+		closeIdleConnections();
+		scheduleIdleCheck();
+	});
+}
+
+void HttpClient::closeIdleConnections() {
+	// Connections are destroyed after the lock is released, since closing them may take a while.
+	std::vector<std::shared_ptr<Connection>> expiredConnections;
+	std::lock_guard<std::mutex> lock(_poolMutex);
+	auto now = std::chrono::steady_clock::now();
+	for (auto pool = _pools.begin(); pool != _pools.end();) {
+		auto& idleConnections = pool->second.idleConnections;
+		for (auto connection = idleConnections.begin(); connection != idleConnections.end();) {
+			if (now - (*connection)->lastUsed >= _idleTimeout) {
+				expiredConnections.push_back(std::move(*connection));
+				connection = idleConnections.erase(connection);
+				--pool->second.openedCount;
+			} else {
+				++connection;
+			}
+		}
+		if (pool->second.openedCount == 0 && pool->second.waitingRequests.empty()) {
+			pool = _pools.erase(pool);
+		} else {
+			++pool;
+		}
+	}
+}
+
+void HttpClient::acquireConnection(const std::shared_ptr<Request>& request) {
+	std::lock_guard<std::mutex> lock(_poolMutex);
+	HostPool& pool = _pools[request->poolKey];
+
+	auto now = std::chrono::steady_clock::now();
+	while (!pool.idleConnections.empty()) {
+		std::shared_ptr<Connection> connection = std::move(pool.idleConnections.back());
+		pool.idleConnections.pop_back();
+		if (now - connection->lastUsed < _idleTimeout) {
+			request->strand.post([request, connection]() {
+				request->runSafely([&]() {
+					request->sendRequest(connection, true);
+				});
+			});
+			return;
+		}
+		--pool.openedCount;
+	}
+
+	pool.waitingRequests.push_back(request);
+	startWaitingRequests(pool);
+}
+
+void HttpClient::releaseConnection(const std::string& poolKey, std::shared_ptr<Connection> connection, bool isReusable) {
+	std::lock_guard<std::mutex> lock(_poolMutex);
+	HostPool& pool = _pools[poolKey];
+	if (!connection || !isReusable) {
+		--pool.openedCount;
+		startWaitingRequests(pool);
+		return;
+	}
+
+	if (pool.waitingRequests.empty()) {
+		connection->lastUsed = std::chrono::steady_clock::now();
+		pool.idleConnections.push_back(std::move(connection));
+	} else {
+		std::shared_ptr<Request> request = std::move(pool.waitingRequests.front());
+		pool.waitingRequests.pop_front();
+		request->strand.post([request, connection]() {
+			request->runSafely([&]() {
+				request->sendRequest(connection, true);
+			});
+		});
+	}
+}
+
+void HttpClient::startWaitingRequests(HostPool& pool) {
+	while (!pool.waitingRequests.empty() && pool.openedCount < _maxConnectionsPerHost) {
+		std::shared_ptr<Request> request = std::move(pool.waitingRequests.front());
+		pool.waitingRequests.pop_front();
+		++pool.openedCount;
+		request->strand.post([request]() {
+			request->runSafely([&]() {
+				request->openConnection();
+			});
+		});
+	}
+}
+
+int HttpClient::onNewSslSession(SSL* ssl, SSL_SESSION* session) {
+	auto client = static_cast<HttpClient*>(SSL_CTX_get_ex_data(SSL_get_SSL_CTX(ssl), getSslContextDataIndex()));
+	auto connection = static_cast<Connection*>(SSL_get_ex_data(ssl, Request::getSslDataIndex()));
+	if (!client || !connection) {
+		return 0;
+	}
+	client->storeSslSession(connection->sessionKey, session);
+	return 1;
+}
 
-	std::string response;
-	char buff[2048];
-	boost::system::error_code error;
-	while (!error) {
-		size_t bytes = read(socket, buffer(buff), error);
-		response += std::string(buff, bytes);
+void HttpClient::storeSslSession(const std::string& sessionKey, SSL_SESSION* session) {
+	std::lock_guard<std::mutex> lock(_sslSessionsMutex);
+	SSL_SESSION*& item = _sslSessions[sessionKey];
+	if (item) {
+		SSL_SESSION_free(item);
 	}
+	item = session;
+}
 
-	return HttpParser::getInstance().parseResponse(response);
+void HttpClient::resumeSslSession(Connection& connection) {
+	std::lock_guard<std::mutex> lock(_sslSessionsMutex);
+	auto item = _sslSessions.find(connection.sessionKey);
+	if (item != _sslSessions.end()) {
+		SSL_set_session(connection.socket.native_handle(), item->second);
+	}
 }
 
 }
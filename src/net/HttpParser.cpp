@@ -23,8 +23,13 @@
 
 #include "tgbot/net/HttpParser.h"
 
+#include <stdexcept>
+
 #include <boost/algorithm/string.hpp>
+#include <openssl/rand.h>
 
+#include "tgbot/tools/FileTools.h"
+#include "tgbot/tools/JsonWriter.h"
 #include "tgbot/tools/StringTools.h"
 
 using namespace boost;
@@ -36,15 +41,52 @@ HttpParser& HttpParser::getInstance() {
 	return result;
 }
 
-std::string HttpParser::generateRequest(const Url& url, const std::vector<HttpReqArg>& args, bool isKeepAlive) {
+std::string HttpParser::generateRequest(const Url& url, const std::vector<HttpReqArg>& args, bool isKeepAlive, BodyEncoding bodyEncoding) {
+	std::vector<FilePart> fileParts;
+	std::string result = generateRequest(url, args, fileParts, isKeepAlive, bodyEncoding);
+	return insertFileParts(result, fileParts);
+}
+
+std::string HttpParser::generateRequest(const Url& url, const std::vector<HttpReqArg>& args, std::vector<FilePart>& fileParts, bool isKeepAlive, BodyEncoding bodyEncoding) {
+	std::string requestData;
+	std::string contentType;
+	if (!args.empty()) {
+		std::string bondary = generateMultipartBoundary(args);
+		if (bondary.empty() && bodyEncoding == BodyEncoding::Json) {
+			// The body is written right after the head, so values of args are copied into the request only once.
+			std::string result;
+			size_t bodyOffset = generateRequestHead(result, url, boost::string_ref(), "application/json", isKeepAlive, getJsonSize(args));
+			writeJson(result, args);
+			completeRequest(result, bodyOffset);
+			return result;
+		}
+		if (!bondary.empty()) {
+			contentType = "multipart/form-data; boundary=" + bondary;
+			requestData = generateMultipartFormData(args, bondary, fileParts);
+		} else {
+			contentType = "application/x-www-form-urlencoded";
+			requestData = generateWwwFormUrlencoded(args);
+		}
+	}
+
+	size_t contentLength = requestData.size();
+	for (const FilePart& item : fileParts) {
+		contentLength += item.size;
+	}
+
 	std::string result;
+	// The body is copied only once, so the whole request fits into the buffer.
+	result.reserve(256 + url.path.size() + url.query.size() + url.host.size() + requestData.size());
 	if (args.empty()) {
 		result += "GET ";
 	} else {
 		result += "POST ";
 	}
 	result += url.path;
-	result += url.query.empty() ? "" : "?" + url.query;
+	if (!url.query.empty()) {
+		result += '?';
+		result += url.query;
+	}
 	result += " HTTP/1.1\r\n";
 	result += "Host: ";
 	result += url.host;
@@ -58,28 +100,80 @@ std::string HttpParser::generateRequest(const Url& url, const std::vector<HttpRe
 	if (args.empty()) {
 		result += "\r\n";
 	} else {
-		std::string requestData;
-
-		std::string bondary = generateMultipartBoundary(args);
-		if (bondary.empty()) {
-			result += "Content-Type: application/x-www-form-urlencoded\r\n";
-			requestData = generateWwwFormUrlencoded(args);
-		} else {
-			result += "Content-Type: multipart/form-data; boundary=";
-			result += bondary;
-			result += "\r\n";
-			requestData = generateMultipartFormData(args, bondary);
-		}
-
-		result += "Content-Length: ";
-		result += lexical_cast<std::string>(requestData.length());
+		result += "Content-Type: ";
+		result += contentType;
+		result += "\r\nContent-Length: ";
+		result += lexical_cast<std::string>(contentLength);
 		result += "\r\n\r\n";
+		for (FilePart& item : fileParts) {
+			item.offset += result.size();
+		}
 		result += requestData;
 	}
 	return result;
 }
 
+// Content-Length is written as a fixed width field padded with spaces, which are allowed before a header value.
+static const size_t CONTENT_LENGTH_WIDTH = 20;
+
+size_t HttpParser::generateRequestHead(std::string& output, const Url& url, boost::string_ref relativePath, const std::string& contentType, bool isKeepAlive, size_t bodySize) {
+	output.reserve(output.size() + 128 + url.path.size() + relativePath.size() + url.query.size() + url.host.size() + contentType.size() + bodySize);
+	output += "POST ";
+	output += url.path;
+	output.append(relativePath.data(), relativePath.size());
+	if (!url.query.empty()) {
+		output += '?';
+		output += url.query;
+	}
+	output += " HTTP/1.1\r\nHost: ";
+	output += url.host;
+	output += "\r\nConnection: ";
+	output += isKeepAlive ? "keep-alive" : "close";
+	output += "\r\nContent-Type: ";
+	output += contentType;
+	output += "\r\nContent-Length: ";
+	output.append(CONTENT_LENGTH_WIDTH, ' ');
+	output += "\r\n\r\n";
+	return output.size();
+}
+
+void HttpParser::completeRequest(std::string& output, size_t bodyOffset) {
+	size_t length = output.size() - bodyOffset;
+	size_t position = bodyOffset - 4;
+	do {
+		output[--position] = static_cast<char>('0' + length % 10);
+		length /= 10;
+	} while (length != 0);
+}
+
+std::string HttpParser::generateRangeRequest(const Url& url, uint64_t firstByte, uint64_t lastByte, bool isKeepAlive) {
+	std::string result;
+	result.reserve(160 + url.path.size() + url.query.size() + url.host.size());
+	result += "GET ";
+	result += url.path;
+	if (!url.query.empty()) {
+		result += '?';
+		result += url.query;
+	}
+	result += " HTTP/1.1\r\nHost: ";
+	result += url.host;
+	result += "\r\nConnection: ";
+	result += isKeepAlive ? "keep-alive" : "close";
+	result += "\r\nRange: bytes=";
+	result += std::to_string(firstByte);
+	result += '-';
+	result += std::to_string(lastByte);
+	result += "\r\n\r\n";
+	return result;
+}
+
 std::string HttpParser::generateMultipartFormData(const std::vector<HttpReqArg>& args, const std::string& bondary) {
+	std::vector<FilePart> fileParts;
+	std::string result = generateMultipartFormData(args, bondary, fileParts);
+	return insertFileParts(result, fileParts);
+}
+
+std::string HttpParser::generateMultipartFormData(const std::vector<HttpReqArg>& args, const std::string& bondary, std::vector<FilePart>& fileParts) {
 	std::string result;
 	for (const HttpReqArg& item : args) {
 		result += "--";
@@ -96,22 +190,73 @@ std::string HttpParser::generateMultipartFormData(const std::vector<HttpReqArg>&
 			result += "\r\n";
 		}
 		result += "\r\n";
-		result += item.value;
+		if (!item.filePath.empty()) {
+			fileParts.push_back(FilePart{ result.size(), item.fileSize, boost::string_ref(), nullptr, item.filePath });
+		} else if (item.isFileReferenced()) {
+			fileParts.push_back(FilePart{ result.size(), item.fileData.size(), item.fileData, item.fileOwner, std::string() });
+		} else {
+			result += item.value;
+		}
 		result += "\r\n";
 	}
 	result += "--" + bondary + "--\r\n";
 	return result;
 }
 
-std::string HttpParser::generateMultipartBoundary(const std::vector<HttpReqArg>& args) {
+std::string HttpParser::insertFileParts(const std::string& text, const std::vector<FilePart>& fileParts) {
+	size_t size = text.size();
+	for (const FilePart& item : fileParts) {
+		size += item.size;
+	}
 	std::string result;
-	srand((unsigned int) time(nullptr));
+	result.reserve(size);
+	size_t position = 0;
+	for (const FilePart& item : fileParts) {
+		result.append(text, position, item.offset - position);
+		if (item.path.empty()) {
+			result.append(item.data.data(), item.data.size());
+		} else {
+			result += FileTools::read(item.path);
+		}
+		position = item.offset;
+	}
+	result.append(text, position, std::string::npos);
+	return result;
+}
+
+// 32 characters of a 64 character alphabet carry 192 random bits, so a boundary practically can't occur in file contents and they aren't scanned.
+static const size_t MULTIPART_BOUNDARY_SIZE = 32;
+
+std::string HttpParser::generateMultipartBoundary(const std::vector<HttpReqArg>& args) {
+	bool hasFiles = false;
 	for (const HttpReqArg& item : args) {
 		if (item.isFile) {
-			while (result.empty() || item.value.find(result) != item.value.npos) {
-				result += StringTools::generateRandomString(4);
-			}
+			hasFiles = true;
+			break;
+		}
+	}
+	if (!hasFiles) {
+		return "";
+	}
+
+	// Random bytes are taken from OpenSSL's CSPRNG in batches, which are kept per thread, so no locking is needed between requests.
+	struct RandomPool {
+		unsigned char bytes[256];
+		size_t position = sizeof(bytes);
+	};
+	static thread_local RandomPool pool;
+	if (pool.position + MULTIPART_BOUNDARY_SIZE > sizeof(pool.bytes)) {
+		if (RAND_bytes(pool.bytes, sizeof(pool.bytes)) != 1) {
+			throw std::runtime_error("tgbot-cpp library can't generate random bytes for a multipart boundary.");
 		}
+		pool.position = 0;
+	}
+
+	// Only characters which are allowed in a boundary without quoting. 64 of them map each random byte without bias.
+	static const char chars[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+	std::string result(MULTIPART_BOUNDARY_SIZE, '\0');
+	for (char& item : result) {
+		item = chars[pool.bytes[pool.position++] & 63];
 	}
 	return result;
 }
@@ -134,6 +279,35 @@ std::string HttpParser::generateWwwFormUrlencoded(const std::vector<HttpReqArg>&
 	return result;
 }
 
+std::string HttpParser::generateJson(const std::vector<HttpReqArg>& args) {
+	std::string result;
+	result.reserve(getJsonSize(args));
+	writeJson(result, args);
+	return result;
+}
+
+size_t HttpParser::getJsonSize(const std::vector<HttpReqArg>& args) {
+	size_t result = 2;
+	for (const HttpReqArg& item : args) {
+		result += item.name.size() + item.value.size() + 6;
+	}
+	return result;
+}
+
+void HttpParser::writeJson(std::string& output, const std::vector<HttpReqArg>& args) {
+	JsonWriter writer(output, 0);
+	writer.startObject();
+	for (const HttpReqArg& item : args) {
+		writer.key(item.name);
+		if (item.isJson) {
+			writer.rawValue(item.value);
+		} else {
+			writer.value(item.value);
+		}
+	}
+	writer.endObject();
+}
+
 std::string HttpParser::generateResponse(const std::string& data, const std::string& mimeType, unsigned short statusCode, const std::string& statusStr, bool isKeepAlive) {
 	std::string result;
 	result += "HTTP/1.1 ";
@@ -0,0 +1,263 @@
+/*
+ * Copyright (c) 2015 Oleg Morozenkov
+ * Copyright (c) 2017 Maks Mazurov (fox.cpp)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "tgbot/net/HttpResponseParser.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstring>
+#include <cstdlib>
+#include <limits>
+
+#include <boost/algorithm/string.hpp>
+
+using namespace boost;
+
+namespace TgBot {
+
+static const size_t MAX_LINE_LENGTH = 65536;
+// Content-Length comes from the peer, so only this much is reserved in advance and a longer body grows as it arrives.
+static const size_t MAX_RESERVED_BODY_SIZE = 1024 * 1024;
+
+/**
+ * Parses a decimal or hexadecimal length. Returns false if it isn't a plain number or doesn't fit into size_t.
+ */
+static bool parseLength(const std::string& text, int base, size_t& length) {
+	if (text.empty() || !isxdigit(static_cast<unsigned char>(text[0]))) {
+		return false;
+	}
+	char* end = nullptr;
+	errno = 0;
+	unsigned long long value = strtoull(text.c_str(), &end, base);
+	if (errno == ERANGE || value > std::numeric_limits<size_t>::max()) {
+		return false;
+	}
+	length = static_cast<size_t>(value);
+	return end != text.c_str();
+}
+
+void HttpResponseParser::reset() {
+	_state = State::StatusLine;
+	_line.clear();
+	_remainingLength = 0;
+	_contentLength = 0;
+	_isKeepAlive = false;
+	_isHttp11 = false;
+	_statusCode = 0;
+	_headers.clear();
+	_body.clear();
+}
+
+size_t HttpResponseParser::feed(const char* data, size_t length) {
+	size_t position = 0;
+	while (position < length && _state != State::Complete && _state != State::Error) {
+		switch (_state) {
+			case State::Body:
+			case State::ChunkData: {
+				size_t count = std::min(_remainingLength, length - position);
+				appendBody(data + position, count);
+				position += count;
+				_remainingLength -= count;
+				if (_remainingLength == 0) {
+					_state = _state == State::Body ? State::Complete : State::ChunkDataEnd;
+				}
+				break;
+			}
+
+			case State::BodyUntilClose:
+				appendBody(data + position, length - position);
+				position = length;
+				break;
+
+			default:
+				if (readLine(data, length, position)) {
+					processLine();
+				}
+				break;
+		}
+	}
+	return position;
+}
+
+void HttpResponseParser::finish() {
+	if (_state == State::BodyUntilClose) {
+		_state = State::Complete;
+	} else if (_state != State::Complete) {
+		_state = State::Error;
+	}
+}
+
+bool HttpResponseParser::readLine(const char* data, size_t length, size_t& position) {
+	const char* lineEnd = static_cast<const char*>(memchr(data + position, '\n', length - position));
+	size_t count = lineEnd ? lineEnd - (data + position) : length - position;
+	if (_line.length() + count > MAX_LINE_LENGTH) {
+		_state = State::Error;
+		position = length;
+		return false;
+	}
+	_line.append(data + position, count);
+	if (!lineEnd) {
+		position = length;
+		return false;
+	}
+	position += count + 1;
+	if (!_line.empty() && _line.back() == '\r') {
+		_line.erase(_line.length() - 1);
+	}
+	return true;
+}
+
+void HttpResponseParser::processLine() {
+	switch (_state) {
+		case State::StatusLine:
+			processStatusLine();
+			break;
+
+		case State::Headers:
+			if (_line.empty()) {
+				processHeadersEnd();
+			} else {
+				processHeaderLine();
+			}
+			break;
+
+		case State::ChunkSize:
+			processChunkSizeLine();
+			break;
+
+		case State::ChunkDataEnd:
+			_state = _line.empty() ? State::ChunkSize : State::Error;
+			break;
+
+		case State::Trailers:
+			if (_line.empty()) {
+				_state = State::Complete;
+			}
+			break;
+
+		default:
+			break;
+	}
+	_line.clear();
+}
+
+void HttpResponseParser::processStatusLine() {
+	if (!starts_with(_line, "HTTP/")) {
+		_state = State::Error;
+		return;
+	}
+	size_t versionEnd = _line.find(' ');
+	if (versionEnd == _line.npos) {
+		_state = State::Error;
+		return;
+	}
+	_isHttp11 = _line.compare(0, versionEnd, "HTTP/1.0") != 0;
+	_statusCode = (unsigned short) strtoul(_line.c_str() + versionEnd + 1, nullptr, 10);
+	if (_statusCode < 100 || _statusCode > 999) {
+		_state = State::Error;
+		return;
+	}
+	_state = State::Headers;
+}
+
+void HttpResponseParser::processHeaderLine() {
+	size_t separatorPosition = _line.find(':');
+	if (separatorPosition == _line.npos) {
+		_state = State::Error;
+		return;
+	}
+	std::string name = to_lower_copy(_line.substr(0, separatorPosition));
+	std::string value = trim_copy(_line.substr(separatorPosition + 1));
+	auto header = _headers.find(name);
+	if (header == _headers.end()) {
+		_headers.emplace(std::move(name), std::move(value));
+	} else {
+		header->second += ", ";
+		header->second += value;
+	}
+}
+
+void HttpResponseParser::processHeadersEnd() {
+	if (_statusCode < 200) {
+		// Interim responses like 100 Continue are followed by the real one.
+		_headers.clear();
+		_state = State::StatusLine;
+		return;
+	}
+
+	auto connection = _headers.find("connection");
+	if (connection == _headers.end()) {
+		_isKeepAlive = _isHttp11;
+	} else {
+		std::string value = to_lower_copy(connection->second);
+		_isKeepAlive = _isHttp11 ? value.find("close") == value.npos : value.find("keep-alive") != value.npos;
+	}
+
+	auto transferEncoding = _headers.find("transfer-encoding");
+	auto contentLength = _headers.find("content-length");
+	if (transferEncoding != _headers.end() && ifind_first(transferEncoding->second, "chunked")) {
+		_state = State::ChunkSize;
+	} else if (contentLength != _headers.end()) {
+		if (!parseLength(contentLength->second, 10, _remainingLength) || (!_bodyHandler && _remainingLength > _body.max_size())) {
+			_state = State::Error;
+			return;
+		}
+		_contentLength = _remainingLength;
+		if (!_bodyHandler) {
+			_body.reserve(std::min(_remainingLength, MAX_RESERVED_BODY_SIZE));
+		}
+		_state = _remainingLength == 0 ? State::Complete : State::Body;
+	} else if (_statusCode == 204 || _statusCode == 304) {
+		_state = State::Complete;
+	} else {
+		_isKeepAlive = false;
+		_state = State::BodyUntilClose;
+	}
+
+	if (_headersHandler) {
+		_headersHandler(*this);
+	}
+}
+
+void HttpResponseParser::processChunkSizeLine() {
+	if (!parseLength(_line, 16, _remainingLength)) {
+		_state = State::Error;
+		return;
+	}
+	if (_remainingLength == 0) {
+		_state = State::Trailers;
+	} else {
+		_state = State::ChunkData;
+	}
+}
+
+void HttpResponseParser::appendBody(const char* data, size_t length) {
+	if (_bodyHandler) {
+		_bodyHandler(data, length);
+	} else {
+		_body.append(data, length);
+	}
+}
+
+}
@@ -0,0 +1,293 @@
+/*
+ * Copyright (c) 2015 Oleg Morozenkov
+ * Copyright (c) 2017 Maks Mazurov (fox.cpp)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "tgbot/net/ParallelDownloader.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <system_error>
+
+#include <boost/interprocess/file_mapping.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include "tgbot/net/HttpClient.h"
+#include "tgbot/net/HttpParser.h"
+
+namespace TgBot {
+
+static const uint64_t UNKNOWN_SIZE = std::numeric_limits<uint64_t>::max();
+
+/**
+ * State of one download. The first request asks for the first part; if the server responds with a part, the output file is
+ * allocated and the rest of the parts are requested, otherwise the whole file from the first response is written sequentially.
+ */
+class ParallelDownloader::Download : public std::enable_shared_from_this<ParallelDownloader::Download> {
+
+public:
+	Download(const ParallelDownloader& downloader, const Url& url, const std::string& destinationPath, const ProgressHandler& progress) :
+		_concurrency(std::max<size_t>(1, downloader._concurrency)), _partSize(std::max<uint64_t>(1, downloader._partSize)), _url(url), _destinationPath(destinationPath), _progress(progress)
+	{
+	}
+
+	void run() {
+		std::unique_lock<std::mutex> lock(_mutex);
+		startPart(0);
+		_finishedCondition.wait(lock, [this]() {
+			return _activeCount == 0;
+		});
+		_region.reset();
+		if (_stream.is_open()) {
+			_stream.close();
+			if (!_stream && !_error) {
+				throw std::system_error(errno, std::system_category());
+			}
+		}
+		if (_error) {
+			std::rethrow_exception(_error);
+		}
+	}
+
+private:
+	struct Part {
+		uint64_t offset;
+		uint64_t size;
+		uint64_t receivedSize = 0;
+		bool isBodyIgnored = false;
+	};
+
+	// Must be called with the mutex locked.
+	void startPart(uint64_t offset) {
+		auto self(shared_from_this());
+		auto part(std::make_shared<Part>());
+		part->offset = offset;
+		part->size = offset == 0 ? _partSize : std::min(_partSize, _fileSize - offset);
+		_nextOffset = offset + part->size;
+		++_activeCount;
+
+		std::string requestText = HttpParser::getInstance().generateRangeRequest(_url, offset, offset + part->size - 1, true);
+		HttpClient::getInstance().makeRequestAsync(_url, std::move(requestText), [self, part](const HttpResponseParser& parser) {
+			self->processHeaders(*part, parser);
+		}, [self, part](const char* data, size_t length) {
+			self->processBody(*part, data, length);
+		}, [self, part](const boost::system::error_code& error, std::string&&) {
+			self->completePart(*part, error);
+		});
+	}
+
+	void processHeaders(Part& part, const HttpResponseParser& parser) {
+		try {
+			unsigned short statusCode = parser.getStatusCode();
+			if (part.offset == 0 && statusCode == 200) {
+				// The server ignores ranges, so the whole file comes in this response. Its size may be unknown if the body is chunked.
+				_fileSize = parser.getContentLength();
+				part.size = _fileSize != 0 ? _fileSize : UNKNOWN_SIZE;
+				_stream.open(_destinationPath, std::ios::out | std::ios::binary | std::ios::trunc);
+				if (!_stream) {
+					throw std::system_error(errno, std::system_category());
+				}
+				return;
+			}
+			if (part.offset == 0 && statusCode == 416) {
+				// Even the first byte is out of range, so the file is empty.
+				part.size = 0;
+				part.isBodyIgnored = true;
+				createOutput(0);
+				return;
+			}
+			if (statusCode != 206) {
+				throw std::runtime_error("tgbot-cpp library can't download file, server responded with status " + std::to_string(statusCode) + ".");
+			}
+
+			uint64_t firstByte = 0;
+			uint64_t fileSize = 0;
+			auto contentRange = parser.getHeaders().find("content-range");
+			if (contentRange == parser.getHeaders().end() || !parseContentRange(contentRange->second, firstByte, fileSize) || firstByte != part.offset) {
+				throw std::runtime_error("tgbot-cpp library can't download file, server responded with a wrong range.");
+			}
+			if (part.offset != 0) {
+				if (fileSize != _fileSize) {
+					throw std::runtime_error("tgbot-cpp library can't download file, it was changed during the download.");
+				}
+				return;
+			}
+
+			part.size = std::min(part.size, fileSize);
+			createOutput(fileSize);
+			std::lock_guard<std::mutex> lock(_mutex);
+			_isRanged = true;
+			_fileSize = fileSize;
+			_nextOffset = part.size;
+			startParts();
+		} catch (...) {
+			fail(std::current_exception());
+		}
+	}
+
+	void processBody(Part& part, const char* data, size_t length) {
+		if (_isFailed || part.isBodyIgnored) {
+			return;
+		}
+		if (part.size - part.receivedSize < length) {
+			fail(std::make_exception_ptr(std::runtime_error("tgbot-cpp library can't download file, server sent more data than requested.")));
+			return;
+		}
+		if (_region) {
+			memcpy(static_cast<char*>(_region->get_address()) + part.offset + part.receivedSize, data, length);
+		} else if (!_stream.write(data, length)) {
+			fail(std::make_exception_ptr(std::system_error(errno, std::system_category())));
+			return;
+		}
+		part.receivedSize += length;
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			_downloadedSize += length;
+		}
+		reportProgress();
+	}
+
+	// The handler is called without the main mutex held, so a slow or throwing handler doesn't block other parts.
+	void reportProgress() {
+		if (!_progress) {
+			return;
+		}
+		std::lock_guard<std::mutex> progressLock(_progressMutex);
+		if (_isFailed) {
+			return;
+		}
+		uint64_t downloadedSize;
+		uint64_t fileSize;
+		{
+			// Sizes are read under the progress mutex, so reported values never decrease.
+			std::lock_guard<std::mutex> lock(_mutex);
+			downloadedSize = _downloadedSize;
+			fileSize = _fileSize;
+		}
+		try {
+			_progress(downloadedSize, fileSize);
+		} catch (...) {
+			fail(std::current_exception());
+		}
+	}
+
+	void completePart(const Part& part, const boost::system::error_code& error) {
+		if (error) {
+			fail(std::make_exception_ptr(boost::system::system_error(error)));
+		} else if (part.receivedSize != part.size && !part.isBodyIgnored && part.size != UNKNOWN_SIZE) {
+			fail(std::make_exception_ptr(std::runtime_error("tgbot-cpp library can't download file, server sent less data than requested.")));
+		}
+
+		std::lock_guard<std::mutex> lock(_mutex);
+		--_activeCount;
+		if (_isRanged && !_error) {
+			startParts();
+		}
+		if (_activeCount == 0) {
+			_finishedCondition.notify_all();
+		}
+	}
+
+	// Must be called with the mutex locked.
+	void startParts() {
+		while (_activeCount < _concurrency && _nextOffset < _fileSize) {
+			startPart(_nextOffset);
+		}
+	}
+
+	void createOutput(uint64_t fileSize) {
+		std::ofstream output(_destinationPath, std::ios::out | std::ios::binary | std::ios::trunc);
+		if (!output) {
+			throw std::system_error(errno, std::system_category());
+		}
+		if (fileSize == 0) {
+			return;
+		}
+		// The file is extended to its full size at once, so parts can be written into its mapping in any order.
+		output.seekp(static_cast<std::streamoff>(fileSize - 1));
+		output.put('\0');
+		output.close();
+		if (!output) {
+			throw std::system_error(errno, std::system_category());
+		}
+		boost::interprocess::file_mapping mapping(_destinationPath.c_str(), boost::interprocess::read_write);
+		_region.reset(new boost::interprocess::mapped_region(mapping, boost::interprocess::read_write));
+	}
+
+	void fail(const std::exception_ptr& error) {
+		std::lock_guard<std::mutex> lock(_mutex);
+		if (!_error) {
+			_error = error;
+			_isFailed = true;
+		}
+	}
+
+	static bool parseContentRange(const std::string& value, uint64_t& firstByte, uint64_t& fileSize) {
+		// The value looks like "bytes 0-1023/4096".
+		size_t position = value.find_first_of("0123456789");
+		size_t slashPosition = value.find('/');
+		if (position == std::string::npos || slashPosition == std::string::npos || position > slashPosition) {
+			return false;
+		}
+		char* end = nullptr;
+		firstByte = strtoull(value.c_str() + position, &end, 10);
+		fileSize = strtoull(value.c_str() + slashPosition + 1, &end, 10);
+		return end != value.c_str() + slashPosition + 1;
+	}
+
+	const size_t _concurrency;
+	const uint64_t _partSize;
+	const Url _url;
+	const std::string _destinationPath;
+	const ProgressHandler _progress;
+
+	std::mutex _mutex;
+	std::mutex _progressMutex;
+	std::condition_variable _finishedCondition;
+	size_t _activeCount = 0;
+	uint64_t _nextOffset = 0;
+	uint64_t _fileSize = 0;
+	uint64_t _downloadedSize = 0;
+	bool _isRanged = false;
+	std::exception_ptr _error;
+	std::atomic<bool> _isFailed{false};
+
+	std::unique_ptr<boost::interprocess::mapped_region> _region;
+	std::ofstream _stream;
+};
+
+ParallelDownloader::ParallelDownloader(size_t concurrency, uint64_t partSize) : _concurrency(concurrency), _partSize(partSize) {
+}
+
+void ParallelDownloader::download(const Url& url, const std::string& destinationPath, const ProgressHandler& progress) const {
+	std::make_shared<Download>(*this, url, destinationPath, progress)->run();
+}
+
+}
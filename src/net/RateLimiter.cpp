@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2015 Oleg Morozenkov
+ * Copyright (c) 2017 Maks Mazurov (fox.cpp)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "tgbot/net/RateLimiter.h"
+
+#include <algorithm>
+
+using namespace std;
+
+namespace TgBot {
+
+static const size_t MIN_CLEANUP_THRESHOLD = 1024;
+
+RateLimiter::RateLimiter() : RateLimiter(Limits()) {
+}
+
+RateLimiter::RateLimiter(const Limits& limits) : _limits(limits), _cleanupThreshold(MIN_CLEANUP_THRESHOLD) {
+}
+
+void RateLimiter::acquire(const string& chatId) {
+	unique_lock<mutex> lock(_mutex);
+	Clock::time_point start = Clock::now();
+	bool isGroup = isGroupChat(chatId);
+	// References to elements of unordered_map stay valid on rehashing, and buckets with waiting messages aren't removed.
+	Bucket* chatBucket = chatId.empty() ? nullptr : &_chatBuckets[chatId];
+	uint64_t ticket = chatBucket ? chatBucket->nextTicket++ : 0;
+	++_metrics.waitingCount;
+
+	Clock::time_point now = start;
+	while (true) {
+		if (chatBucket && chatBucket->servingTicket != ticket) {
+			_condition.wait(lock);
+		} else {
+			Clock::time_point allowedTime = getAllowedTime(_globalBucket, _limits.globalRate, _limits.globalBurst);
+			if (chatBucket) {
+				allowedTime = max(allowedTime, isGroup
+					? getAllowedTime(*chatBucket, _limits.groupChatRate, _limits.groupChatBurst)
+					: getAllowedTime(*chatBucket, _limits.privateChatRate, _limits.privateChatBurst));
+			}
+			if (allowedTime <= now) {
+				break;
+			}
+			_condition.wait_until(lock, allowedTime);
+		}
+		now = Clock::now();
+	}
+
+	take(_globalBucket, _limits.globalRate, now);
+	if (chatBucket) {
+		take(*chatBucket, isGroup ? _limits.groupChatRate : _limits.privateChatRate, now);
+		++chatBucket->servingTicket;
+	}
+
+	Clock::duration delay = now - start;
+	--_metrics.waitingCount;
+	++_metrics.releasedCount;
+	if (delay > Clock::duration::zero()) {
+		++_metrics.delayedCount;
+		_metrics.totalDelay += delay;
+		_metrics.maxDelay = max(_metrics.maxDelay, delay);
+	}
+	if (_chatBuckets.size() >= _cleanupThreshold) {
+		removeIdleChats(now);
+	}
+	_condition.notify_all();
+}
+
+void RateLimiter::setLimits(const Limits& limits) {
+	lock_guard<mutex> lock(_mutex);
+	_limits = limits;
+	// Buckets are shortened to the new rates, so raising a limit takes effect at once instead of after the messages taken at the old rate.
+	Clock::time_point now = Clock::now();
+	limitWaitingTime(_globalBucket, _limits.globalRate, now);
+	for (auto& chatBucket : _chatBuckets) {
+		limitWaitingTime(chatBucket.second, isGroupChat(chatBucket.first) ? _limits.groupChatRate : _limits.privateChatRate, now);
+	}
+	_condition.notify_all();
+}
+
+RateLimiter::Limits RateLimiter::getLimits() const {
+	lock_guard<mutex> lock(_mutex);
+	return _limits;
+}
+
+RateLimiter::Metrics RateLimiter::getMetrics() const {
+	lock_guard<mutex> lock(_mutex);
+	Metrics metrics = _metrics;
+	metrics.chatCount = _chatBuckets.size();
+	return metrics;
+}
+
+bool RateLimiter::isGroupChat(const string& chatId) {
+	return !chatId.empty() && (chatId[0] == '-' || chatId[0] == '@');
+}
+
+RateLimiter::Clock::time_point RateLimiter::getAllowedTime(const Bucket& bucket, double rate, size_t burst) {
+	if (rate <= 0) {
+		return Clock::time_point::min();
+	}
+	// The bucket is kept as the time when it becomes full, so a message is allowed while it's less than a burst ahead of now.
+	chrono::duration<double> burstDuration((burst ? burst - 1 : 0) / rate);
+	return bucket.theoreticalArrivalTime - chrono::duration_cast<Clock::duration>(burstDuration);
+}
+
+void RateLimiter::take(Bucket& bucket, double rate, Clock::time_point now) {
+	if (rate <= 0) {
+		return;
+	}
+	bucket.theoreticalArrivalTime = max(bucket.theoreticalArrivalTime, now) + chrono::duration_cast<Clock::duration>(chrono::duration<double>(1 / rate));
+}
+
+void RateLimiter::limitWaitingTime(Bucket& bucket, double rate, Clock::time_point now) {
+	Clock::time_point maxTime = now;
+	if (rate > 0) {
+		maxTime += chrono::duration_cast<Clock::duration>(chrono::duration<double>(1 / rate));
+	}
+	bucket.theoreticalArrivalTime = min(bucket.theoreticalArrivalTime, maxTime);
+}
+
+void RateLimiter::removeIdleChats(Clock::time_point now) {
+	for (auto it = _chatBuckets.begin(); it != _chatBuckets.end();) {
+		if (it->second.servingTicket == it->second.nextTicket && it->second.theoreticalArrivalTime <= now) {
+			it = _chatBuckets.erase(it);
+		} else {
+			++it;
+		}
+	}
+	_cleanupThreshold = max(MIN_CLEANUP_THRESHOLD, _chatBuckets.size() * 2);
+}
+
+}
@@ -0,0 +1,203 @@
+/*
+ * Copyright (c) 2015 Oleg Morozenkov
+ * Copyright (c) 2017 Maks Mazurov (fox.cpp)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "tgbot/net/RetryEngine.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include <boost/system/system_error.hpp>
+
+#include "tgbot/TgException.h"
+
+using namespace std;
+
+namespace TgBot {
+
+RetryEngine::RetryEngine() : RetryEngine(Options()) {
+}
+
+RetryEngine::RetryEngine(const Options& options) : _options(options), _ioServiceWork(new boost::asio::io_service::work(_ioService)),
+	_random(random_device()()), _pendingCount(0), _retryCount(0)
+{
+	for (size_t i = 0; i < max<size_t>(_options.threadCount, 1); ++i) {
+		_workers.emplace_back([this]() {
+			_ioService.run();
+		});
+	}
+}
+
+RetryEngine::~RetryEngine() {
+	{
+		lock_guard<mutex> lock(_mutex);
+		_isStopped = true;
+		for (const auto& timer : _timers) {
+			timer->cancel();
+		}
+	}
+	// The threads exit when the queued calls are dropped and the cancelled timers are handled.
+	_ioServiceWork.reset();
+	for (thread& worker : _workers) {
+		worker.join();
+	}
+}
+
+void RetryEngine::submit(int64_t chatId, const Call& call, const CompletionHandler& handler) {
+	auto task(make_shared<Task>());
+	task->chatId = chatId;
+	task->call = call;
+	task->handler = handler;
+	post(task);
+}
+
+void RetryEngine::submitResult(int64_t chatId, const ResultCall& call, const ResultHandler& handler) {
+	auto task(make_shared<Task>());
+	task->chatId = chatId;
+	task->resultCall = call;
+	task->resultHandler = handler;
+	post(task);
+}
+
+void RetryEngine::post(const shared_ptr<Task>& task) {
+	++_pendingCount;
+	_ioService.post([this, task]() {
+		run(task);
+	});
+}
+
+void RetryEngine::run(const shared_ptr<Task>& task) {
+	{
+		lock_guard<mutex> lock(_mutex);
+		if (_isStopped) {
+			--_pendingCount;
+			return;
+		}
+	}
+
+	++task->attemptCount;
+	chrono::steady_clock::duration delay;
+	exception_ptr error;
+	Result<void> result;
+	try {
+		if (task->resultCall) {
+			result = task->resultCall(task->chatId);
+			if (result || !getRetryDelay(result.getError().errorCode, result.getError().parameters, *task, delay)) {
+				complete(task, nullptr, result);
+				return;
+			}
+		} else {
+			task->call(task->chatId);
+			complete(task, nullptr, result);
+			return;
+		}
+	} catch (TgException& e) {
+		error = current_exception();
+		result = ApiError(e.errorCode, e.what(), e.parameters);
+		if (!getRetryDelay(e.errorCode, e.parameters, *task, delay)) {
+			complete(task, error, result);
+			return;
+		}
+	} catch (boost::system::system_error& e) {
+		error = current_exception();
+		result = ApiError(0, e.what());
+		delay = getBackoff(task->attemptCount);
+	} catch (exception& e) {
+		complete(task, current_exception(), ApiError(0, e.what()));
+		return;
+	} catch (...) {
+		complete(task, current_exception(), ApiError());
+		return;
+	}
+
+	if (task->attemptCount >= _options.maxAttempts) {
+		complete(task, error, result);
+		return;
+	}
+	++_retryCount;
+	schedule(task, delay);
+}
+
+bool RetryEngine::getRetryDelay(int32_t errorCode, const ResponseParameters::Ptr& parameters, Task& task, chrono::steady_clock::duration& delay) {
+	if (parameters && parameters->migrateToChatId) {
+		task.chatId = parameters->migrateToChatId;
+		delay = chrono::steady_clock::duration::zero();
+	} else if (parameters && parameters->retryAfter > 0) {
+		delay = chrono::seconds(parameters->retryAfter);
+	} else if (errorCode >= 500 || errorCode == 0) {
+		// Errors without a code weren't reported by Telegram, e.g. an html page of a failed gateway, so they're transient like network errors.
+		delay = getBackoff(task.attemptCount);
+	} else {
+		return false;
+	}
+	return true;
+}
+
+void RetryEngine::schedule(const shared_ptr<Task>& task, chrono::steady_clock::duration delay) {
+	if (delay == chrono::steady_clock::duration::zero()) {
+		_ioService.post([this, task]() {
+			run(task);
+		});
+		return;
+	}
+	auto timer(make_shared<boost::asio::steady_timer>(_ioService, delay));
+	{
+		lock_guard<mutex> lock(_mutex);
+		if (_isStopped) {
+			--_pendingCount;
+			return;
+		}
+		_timers.insert(timer);
+	}
+	timer->async_wait([this, task, timer](const boost::system::error_code&) {
+		{
+			lock_guard<mutex> lock(_mutex);
+			_timers.erase(timer);
+		}
+		run(task);
+	});
+}
+
+void RetryEngine::complete(const shared_ptr<Task>& task, exception_ptr error, const Result<void>& result) {
+	// The call is done before its handler runs, so the handler already sees it as completed.
+	--_pendingCount;
+	try {
+		if (task->handler) {
+			task->handler(error);
+		}
+		if (task->resultHandler) {
+			task->resultHandler(result);
+		}
+	} catch (...) {
+	}
+}
+
+chrono::steady_clock::duration RetryEngine::getBackoff(size_t attemptCount) {
+	double maxBackoff = min<double>(_options.maxBackoff.count(),
+		_options.initialBackoff.count() * pow(_options.backoffMultiplier, static_cast<double>(attemptCount - 1)));
+	lock_guard<mutex> lock(_mutex);
+	// Full jitter spreads repeated calls of many clients over the whole interval, so they don't hit the server at once again.
+	uniform_real_distribution<double> distribution(0, max(maxBackoff, 0.0));
+	return chrono::duration_cast<chrono::steady_clock::duration>(chrono::duration<double, milli>(distribution(_random)));
+}
+
+}
@@ -31,13 +31,41 @@ TgLongPoll::TgLongPoll(const Api* api, const EventHandler* eventHandler) : _api(
 TgLongPoll::TgLongPoll(const Bot& bot) : TgLongPoll(&bot.getApi(), &bot.getEventHandler()) {
 }
 
+TgLongPoll::~TgLongPoll() {
+	stop();
+}
+
 void TgLongPoll::start() {
+	if (!_dispatchQueue) {
+		_api->streamUpdates([this](const Update::Ptr& item) {
+			if (item->updateId >= _lastUpdateId) {
+				_lastUpdateId = item->updateId + 1;
+			}
+			_eventHandler->handleUpdate(item);
+		}, _lastUpdateId, 100, timeout);
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(_dispatchErrorMutex);
+		if (_dispatchError) {
+			std::exception_ptr error = _dispatchError;
+			_dispatchError = nullptr;
+			std::rethrow_exception(error);
+		}
+	}
+	if (!_dispatchThread.joinable()) {
+		_dispatchThread = std::thread(&TgLongPoll::dispatchUpdates, this);
+	}
+
 	auto updates(_api->getUpdates(_lastUpdateId, 100, timeout));
 	for (Update::Ptr& item : updates) {
 		if (item->updateId >= _lastUpdateId) {
 			_lastUpdateId = item->updateId + 1;
 		}
-		_eventHandler->handleUpdate(item);
+	}
+	if (!updates.empty()) {
+		_dispatchQueue->push(std::move(updates));
 	}
 }
 
@@ -45,4 +73,39 @@ void TgLongPoll::setMaxTime(int seconds){
 	timeout = seconds;
 }
 
+void TgLongPoll::setPipelined(bool pipelined, size_t maxQueuedBatches) {
+	stop();
+	if (pipelined) {
+		_dispatchQueue.reset(new BlockingQueue<std::vector<Update::Ptr>>(maxQueuedBatches));
+	}
+}
+
+void TgLongPoll::stop() {
+	if (!_dispatchQueue) {
+		return;
+	}
+	_dispatchQueue->close();
+	if (_dispatchThread.joinable()) {
+		_dispatchThread.join();
+	}
+	_dispatchQueue.reset();
+}
+
+void TgLongPoll::dispatchUpdates() {
+	std::vector<Update::Ptr> updates;
+	while (_dispatchQueue->pop(updates)) {
+		// The offset is already advanced past the batch, so a throwing listener mustn't stop the rest of it from being dispatched.
+		for (Update::Ptr& item : updates) {
+			try {
+				_eventHandler->handleUpdate(item);
+			} catch (...) {
+				std::lock_guard<std::mutex> lock(_dispatchErrorMutex);
+				if (!_dispatchError) {
+					_dispatchError = std::current_exception();
+				}
+			}
+		}
+	}
+}
+
 }
@@ -0,0 +1,264 @@
+/*
+ * Copyright (c) 2015 Oleg Morozenkov
+ * Copyright (c) 2017 Maks Mazurov (fox.cpp)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "tgbot/tools/FileIdCache.h"
+
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+
+#include <sys/stat.h>
+
+#include <openssl/evp.h>
+
+#include "tgbot/tools/FileTools.h"
+
+using namespace std;
+
+namespace TgBot {
+
+static const size_t MAX_STREAMED_FILE_KEY_COUNT = 4096;
+
+namespace {
+
+class DigestContext {
+
+public:
+	DigestContext() : _context(EVP_MD_CTX_new()) {
+		if (!_context || !EVP_DigestInit_ex(_context, EVP_sha256(), nullptr)) {
+			EVP_MD_CTX_free(_context);
+			throw runtime_error("tgbot-cpp library can't initialize SHA-256");
+		}
+	}
+
+	~DigestContext() {
+		EVP_MD_CTX_free(_context);
+	}
+
+	void update(const void* data, size_t size) {
+		EVP_DigestUpdate(_context, data, size);
+	}
+
+	string finishHex() {
+		static const char HEX_DIGITS[] = "0123456789abcdef";
+		unsigned char digest[EVP_MAX_MD_SIZE];
+		unsigned int digestSize = 0;
+		EVP_DigestFinal_ex(_context, digest, &digestSize);
+		string result;
+		result.reserve(digestSize * 2);
+		for (unsigned int i = 0; i < digestSize; ++i) {
+			result += HEX_DIGITS[digest[i] >> 4];
+			result += HEX_DIGITS[digest[i] & 0x0f];
+		}
+		return result;
+	}
+
+private:
+	DigestContext(const DigestContext&) = delete;
+	DigestContext& operator=(const DigestContext&) = delete;
+
+	EVP_MD_CTX* _context;
+};
+
+string finishKey(DigestContext& digest, const string& mimeType) {
+	// The zero byte separates contents from the mime type, so different splits of the same bytes give different keys.
+	digest.update("", 1);
+	digest.update(mimeType.data(), mimeType.size());
+	return digest.finishHex();
+}
+
+}
+
+FileIdCache::FileIdCache(size_t capacity, const string& persistencePath) : _capacity(capacity ? capacity : 1), _persistencePath(persistencePath) {
+	if (!_persistencePath.empty()) {
+		load();
+		compact();
+	}
+}
+
+string FileIdCache::getKey(const InputFile& file) {
+	if (!file.mappedRegion && !file.filePath.empty()) {
+		return getStreamedFileKey(file);
+	}
+	DigestContext digest;
+	if (file.mappedRegion) {
+		digest.update(file.mappedRegion->get_address(), file.mappedRegion->get_size());
+	} else {
+		digest.update(file.data.data(), file.data.size());
+	}
+	return finishKey(digest, file.mimeType);
+}
+
+string FileIdCache::getStreamedFileKey(const InputFile& file) {
+	struct StreamedFileKey {
+		int64_t size;
+		int64_t modificationTime;
+		string key;
+	};
+	static mutex keysMutex;
+	static unordered_map<string, StreamedFileKey> keys;
+
+	struct stat fileStatus;
+	if (stat(file.filePath.c_str(), &fileStatus) != 0) {
+		throw runtime_error("tgbot-cpp library can't open file " + file.filePath);
+	}
+	// Hashing a big file takes a while, so the key is reused until the size or the modification time of the file changes.
+	string memoKey = file.filePath;
+	memoKey += '\0';
+	memoKey += file.mimeType;
+	{
+		lock_guard<mutex> lock(keysMutex);
+		auto found = keys.find(memoKey);
+		if (found != keys.end() && found->second.size == fileStatus.st_size && found->second.modificationTime == fileStatus.st_mtime) {
+			return found->second.key;
+		}
+	}
+
+	DigestContext digest;
+	ifstream in(file.filePath, ios::in | ios::binary);
+	if (!in) {
+		throw runtime_error("tgbot-cpp library can't open file " + file.filePath);
+	}
+	char buffer[64 * 1024];
+	while (in.read(buffer, sizeof(buffer)) || in.gcount() > 0) {
+		digest.update(buffer, static_cast<size_t>(in.gcount()));
+	}
+	string key = finishKey(digest, file.mimeType);
+
+	lock_guard<mutex> lock(keysMutex);
+	if (keys.size() >= MAX_STREAMED_FILE_KEY_COUNT) {
+		keys.clear();
+	}
+	keys[memoKey] = StreamedFileKey{static_cast<int64_t>(fileStatus.st_size), static_cast<int64_t>(fileStatus.st_mtime), key};
+	return key;
+}
+
+string FileIdCache::find(const string& key) {
+	lock_guard<mutex> lock(_mutex);
+	auto found = _index.find(key);
+	if (found == _index.end()) {
+		return "";
+	}
+	_entries.splice(_entries.end(), _entries, found->second);
+	return found->second->second;
+}
+
+void FileIdCache::insert(const string& key, const string& fileId) {
+	if (key.empty() || fileId.empty()) {
+		return;
+	}
+	lock_guard<mutex> lock(_mutex);
+	auto found = _index.find(key);
+	if (found != _index.end()) {
+		if (found->second->second == fileId) {
+			_entries.splice(_entries.end(), _entries, found->second);
+			return;
+		}
+		_entries.erase(found->second);
+		_index.erase(found);
+	}
+	_entries.emplace_back(key, fileId);
+	_index[key] = prev(_entries.end());
+	while (_entries.size() > _capacity) {
+		_index.erase(_entries.front().first);
+		_entries.pop_front();
+	}
+	persist(key, fileId);
+}
+
+void FileIdCache::erase(const string& key) {
+	lock_guard<mutex> lock(_mutex);
+	auto found = _index.find(key);
+	if (found == _index.end()) {
+		return;
+	}
+	_entries.erase(found->second);
+	_index.erase(found);
+	persist(key, "");
+}
+
+size_t FileIdCache::size() const {
+	lock_guard<mutex> lock(_mutex);
+	return _entries.size();
+}
+
+void FileIdCache::load() {
+	ifstream in(_persistencePath);
+	string line;
+	// Every line is either "key fileId" or "key" for a removed entry. Later lines override earlier ones.
+	while (getline(in, line)) {
+		size_t separator = line.find(' ');
+		string key = line.substr(0, separator);
+		if (key.empty()) {
+			continue;
+		}
+		auto found = _index.find(key);
+		if (found != _index.end()) {
+			_entries.erase(found->second);
+			_index.erase(found);
+		}
+		if (separator == string::npos || separator + 1 == line.size()) {
+			continue;
+		}
+		_entries.emplace_back(key, line.substr(separator + 1));
+		_index[key] = prev(_entries.end());
+		if (_entries.size() > _capacity) {
+			_index.erase(_entries.front().first);
+			_entries.pop_front();
+		}
+	}
+}
+
+void FileIdCache::persist(const string& key, const string& fileId) {
+	if (_persistencePath.empty()) {
+		return;
+	}
+	// Changes are appended, and the file is rewritten only when it has grown well past the number of entries.
+	if (_persistedLineCount >= _capacity * 2) {
+		compact();
+		return;
+	}
+	_persistenceStream << key;
+	if (!fileId.empty()) {
+		_persistenceStream << ' ' << fileId;
+	}
+	_persistenceStream << '\n';
+	_persistenceStream.flush();
+	++_persistedLineCount;
+}
+
+void FileIdCache::compact() {
+	if (_persistenceStream.is_open()) {
+		_persistenceStream.close();
+	}
+	ostringstream content;
+	// Entries are written from the least recently used one, so loading them restores the same order.
+	for (const auto& entry : _entries) {
+		content << entry.first << ' ' << entry.second << '\n';
+	}
+	FileTools::replace(content.str(), _persistencePath);
+	_persistedLineCount = _entries.size();
+	_persistenceStream.open(_persistencePath, ios::out | ios::app);
+}
+
+}
@@ -23,8 +23,16 @@
 
 #include "tgbot/tools/FileTools.h"
 
+#include <cstdio>
 #include <fstream>
 #include <sstream>
+#include <stdexcept>
+
+#include <sys/stat.h>
+
+#ifndef S_ISREG
+#define S_ISREG(mode) (((mode) & S_IFMT) == S_IFREG)
+#endif
 
 namespace FileTools {
 
@@ -33,10 +41,34 @@ std::string read(const std::string& filePath) {
 	if (!in) {
 		throw std::system_error(errno, std::system_category());
 	}
-	std::ostringstream contents;
-	contents << in.rdbuf();
-	in.close();
-	return contents.str();
+	in.seekg(0, std::ios::end);
+	std::streamoff size = in.tellg();
+	if (size <= 0) {
+		// Pipes can't seek and files like the ones in /proc report no size, so they are read until their end.
+		in.clear();
+		in.seekg(0, std::ios::beg);
+		in.clear();
+		std::ostringstream contents;
+		contents << in.rdbuf();
+		return contents.str();
+	}
+	// The contents of a regular file are read straight into the result, instead of being copied from a stream buffer.
+	std::string contents(static_cast<size_t>(size), '\0');
+	in.seekg(0, std::ios::beg);
+	in.read(&contents[0], contents.size());
+	contents.resize(static_cast<size_t>(in.gcount()));
+	return contents;
+}
+
+size_t getSize(const std::string& filePath) {
+	struct stat fileStatus;
+	if (stat(filePath.c_str(), &fileStatus) != 0) {
+		throw std::system_error(errno, std::system_category());
+	}
+	if (!S_ISREG(fileStatus.st_mode)) {
+		throw std::runtime_error("tgbot-cpp library can't get size of " + filePath + ", it isn't a regular file");
+	}
+	return static_cast<size_t>(fileStatus.st_size);
 }
 
 bool write(const std::string& content, const std::string& filePath) {
@@ -49,4 +81,23 @@ bool write(const std::string& content, const std::string& filePath) {
 	return false;
 }
 
+void replace(const std::string& content, const std::string& filePath) {
+	std::string temporaryPath = filePath + ".tmp";
+	{
+		std::ofstream out(temporaryPath, std::ios::out | std::ios::binary | std::ios::trunc);
+		out.write(content.data(), content.size());
+		out.close();
+		if (!out) {
+			throw std::runtime_error("tgbot-cpp library can't write file " + temporaryPath);
+		}
+	}
+	if (std::rename(temporaryPath.c_str(), filePath.c_str()) != 0) {
+		// Windows doesn't replace existing files on rename.
+		std::remove(filePath.c_str());
+		if (std::rename(temporaryPath.c_str(), filePath.c_str()) != 0) {
+			throw std::runtime_error("tgbot-cpp library can't write file " + filePath);
+		}
+	}
+}
+
 };
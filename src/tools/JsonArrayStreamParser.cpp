@@ -0,0 +1,157 @@
+/*
+ * Copyright (c) 2015 Oleg Morozenkov
+ * Copyright (c) 2017 Maks Mazurov (fox.cpp)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "tgbot/tools/JsonArrayStreamParser.h"
+
+using namespace std;
+
+namespace TgBot {
+
+JsonArrayStreamParser::JsonArrayStreamParser(const string& arrayName, const ElementHandler& handler) : _arrayName(arrayName), _handler(handler) {
+}
+
+void JsonArrayStreamParser::feed(const char* data, size_t length) {
+	const char* it = data;
+	const char* end = data + length;
+	while (it != end) {
+		switch (_state) {
+			case State::Root:
+				it = feedRoot(it, end);
+				break;
+
+			case State::Array:
+				it = feedArray(it, end);
+				break;
+
+			case State::Element:
+				it = feedElement(it, end);
+				break;
+		}
+	}
+}
+
+JsonValue::Ptr JsonArrayStreamParser::finish() {
+	if (_state != State::Root || _depth != 0) {
+		throw JsonException("json text is incomplete");
+	}
+	return JsonDocument::parse(move(_root));
+}
+
+const char* JsonArrayStreamParser::feedRoot(const char* it, const char* end) {
+	// Everything except elements of the array goes to the root document, which is parsed at the end.
+	const char* begin = it;
+	for (; it != end; ++it) {
+		char c = *it;
+		if (_isInString) {
+			if (_isEscaped) {
+				_isEscaped = false;
+			} else if (c == '\\') {
+				_isEscaped = true;
+			} else if (c == '"') {
+				_isInString = false;
+			} else if (_depth == 1 && _lastRootString.size() <= _arrayName.size()) {
+				_lastRootString += c;
+			}
+			continue;
+		}
+		if (c == '"') {
+			_isInString = true;
+			_lastRootString.clear();
+		} else if (c == '{' || c == '[') {
+			// In valid json the last string before an array which is a member of the root object is its name.
+			bool isArray = c == '[' && _depth == 1 && _lastRootString == _arrayName;
+			++_depth;
+			if (isArray) {
+				_root.append(begin, it + 1);
+				_arrayDepth = _depth;
+				_state = State::Array;
+				return it + 1;
+			}
+		} else if ((c == '}' || c == ']') && _depth > 0) {
+			--_depth;
+		}
+	}
+	_root.append(begin, end);
+	return end;
+}
+
+const char* JsonArrayStreamParser::feedArray(const char* it, const char* end) {
+	for (; it != end; ++it) {
+		char c = *it;
+		if (c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == ',') {
+			continue;
+		}
+		if (c == ']') {
+			--_depth;
+			_root += c;
+			_state = State::Root;
+			return it + 1;
+		}
+		if (c != '{' && c != '[') {
+			throw JsonException(string("unexpected character '") + c + "' in streamed json array");
+		}
+		_element.clear();
+		_state = State::Element;
+		return it;
+	}
+	return end;
+}
+
+const char* JsonArrayStreamParser::feedElement(const char* it, const char* end) {
+	const char* begin = it;
+	if (_element.empty()) {
+		// The opening bracket of the element.
+		++_depth;
+		++it;
+	}
+	for (; it != end; ++it) {
+		char c = *it;
+		if (_isInString) {
+			if (_isEscaped) {
+				_isEscaped = false;
+			} else if (c == '\\') {
+				_isEscaped = true;
+			} else if (c == '"') {
+				_isInString = false;
+			}
+			continue;
+		}
+		if (c == '"') {
+			_isInString = true;
+		} else if (c == '{' || c == '[') {
+			++_depth;
+		} else if (c == '}' || c == ']') {
+			if (--_depth == _arrayDepth) {
+				_element.append(begin, it + 1);
+				_state = State::Array;
+				_handler(JsonDocument::parse(move(_element)));
+				_element.clear();
+				return it + 1;
+			}
+		}
+	}
+	_element.append(begin, end);
+	return end;
+}
+
+}
@@ -0,0 +1,366 @@
+/*
+ * Copyright (c) 2015 Oleg Morozenkov
+ * Copyright (c) 2017 Maks Mazurov (fox.cpp)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "tgbot/tools/JsonDocument.h"
+
+using namespace std;
+
+namespace TgBot {
+
+class JsonDocument::Parser {
+
+public:
+	Parser(const JsonDocument* document, char* begin, char* end, vector<JsonValue>& values) : _document(document), _begin(begin), _it(begin), _end(end), _values(values) {
+	}
+
+	void parseDocument() {
+		skipWhitespace();
+		parseValue(0);
+		skipWhitespace();
+		if (_it != _end) {
+			fail("unexpected data after the root value");
+		}
+	}
+
+private:
+	static const size_t MAX_DEPTH = 512;
+
+	const JsonDocument* const _document;
+	char* const _begin;
+	char* _it;
+	char* const _end;
+	vector<JsonValue>& _values;
+
+	[[noreturn]] void fail(const string& message) const {
+		throw JsonException("can't parse json at offset " + to_string(_it - _begin) + ": " + message);
+	}
+
+	inline void skipWhitespace() {
+		while (_it != _end && (*_it == ' ' || *_it == '\n' || *_it == '\r' || *_it == '\t')) {
+			++_it;
+		}
+	}
+
+	inline void expect(char c) {
+		if (_it == _end || *_it != c) {
+			fail(string("expected '") + c + "'");
+		}
+		++_it;
+	}
+
+	void parseValue(size_t depth) {
+		if (_it == _end) {
+			fail("unexpected end of data");
+		}
+		size_t index = _values.size();
+		_values.emplace_back();
+		_values.back()._document = _document;
+		switch (*_it) {
+			case '{':
+				parseObject(index, depth + 1);
+				break;
+			case '[':
+				parseArray(index, depth + 1);
+				break;
+			case '"':
+				_values[index]._type = JsonValue::Type::String;
+				parseString(_values[index]._data, _values[index]._dataLength);
+				break;
+			case 't':
+				parseLiteral("true");
+				_values[index]._type = JsonValue::Type::Bool;
+				_values[index]._boolValue = true;
+				break;
+			case 'f':
+				parseLiteral("false");
+				_values[index]._type = JsonValue::Type::Bool;
+				break;
+			case 'n':
+				parseLiteral("null");
+				break;
+			default:
+				parseNumber(_values[index]);
+				break;
+		}
+	}
+
+	void parseObject(size_t index, size_t depth) {
+		if (depth > MAX_DEPTH) {
+			fail("too deep nesting");
+		}
+		++_it;
+		uint32_t childCount = 0;
+		skipWhitespace();
+		if (_it != _end && *_it == '}') {
+			++_it;
+		} else {
+			while (true) {
+				const char* key;
+				uint32_t keyLength;
+				if (_it == _end || *_it != '"') {
+					fail("expected member name");
+				}
+				parseString(key, keyLength);
+				skipWhitespace();
+				expect(':');
+				skipWhitespace();
+				size_t childIndex = _values.size();
+				parseValue(depth);
+				_values[childIndex]._key = key;
+				_values[childIndex]._keyLength = keyLength;
+				++childCount;
+				skipWhitespace();
+				if (_it != _end && *_it == ',') {
+					++_it;
+					skipWhitespace();
+					continue;
+				}
+				expect('}');
+				break;
+			}
+		}
+		JsonValue& value = _values[index];
+		value._type = JsonValue::Type::Object;
+		value._childCount = childCount;
+		value._subtreeSize = static_cast<uint32_t>(_values.size() - index);
+	}
+
+	void parseArray(size_t index, size_t depth) {
+		if (depth > MAX_DEPTH) {
+			fail("too deep nesting");
+		}
+		++_it;
+		uint32_t childCount = 0;
+		skipWhitespace();
+		if (_it != _end && *_it == ']') {
+			++_it;
+		} else {
+			while (true) {
+				parseValue(depth);
+				++childCount;
+				skipWhitespace();
+				if (_it != _end && *_it == ',') {
+					++_it;
+					skipWhitespace();
+					continue;
+				}
+				expect(']');
+				break;
+			}
+		}
+		JsonValue& value = _values[index];
+		value._type = JsonValue::Type::Array;
+		value._childCount = childCount;
+		value._subtreeSize = static_cast<uint32_t>(_values.size() - index);
+	}
+
+	void parseLiteral(const char* literal) {
+		for (const char* it = literal; *it; ++it, ++_it) {
+			if (_it == _end || *_it != *it) {
+				fail("invalid literal");
+			}
+		}
+	}
+
+	static inline bool isDigit(char c) {
+		return c >= '0' && c <= '9';
+	}
+
+	void parseNumber(JsonValue& value) {
+		char* begin = _it;
+		if (_it != _end && *_it == '-') {
+			++_it;
+		}
+		if (_it == _end || !isDigit(*_it)) {
+			fail("invalid value");
+		}
+		if (*_it == '0') {
+			++_it;
+		} else {
+			while (_it != _end && isDigit(*_it)) {
+				++_it;
+			}
+		}
+		if (_it != _end && *_it == '.') {
+			++_it;
+			if (_it == _end || !isDigit(*_it)) {
+				fail("invalid number");
+			}
+			while (_it != _end && isDigit(*_it)) {
+				++_it;
+			}
+		}
+		if (_it != _end && (*_it == 'e' || *_it == 'E')) {
+			++_it;
+			if (_it != _end && (*_it == '+' || *_it == '-')) {
+				++_it;
+			}
+			if (_it == _end || !isDigit(*_it)) {
+				fail("invalid number");
+			}
+			while (_it != _end && isDigit(*_it)) {
+				++_it;
+			}
+		}
+		value._type = JsonValue::Type::Number;
+		value._data = begin;
+		value._dataLength = static_cast<uint32_t>(_it - begin);
+	}
+
+	int parseHexDigit() {
+		if (_it == _end) {
+			fail("unexpected end of data");
+		}
+		char c = *_it++;
+		if (c >= '0' && c <= '9') {
+			return c - '0';
+		}
+		if (c >= 'a' && c <= 'f') {
+			return c - 'a' + 10;
+		}
+		if (c >= 'A' && c <= 'F') {
+			return c - 'A' + 10;
+		}
+		fail("invalid unicode escape");
+	}
+
+	uint32_t parseUnicodeEscape() {
+		uint32_t result = 0;
+		for (int i = 0; i < 4; ++i) {
+			result = (result << 4) | parseHexDigit();
+		}
+		return result;
+	}
+
+	static char* writeUtf8(char* output, uint32_t codePoint) {
+		if (codePoint < 0x80) {
+			*output++ = static_cast<char>(codePoint);
+		} else if (codePoint < 0x800) {
+			*output++ = static_cast<char>(0xC0 | (codePoint >> 6));
+			*output++ = static_cast<char>(0x80 | (codePoint & 0x3F));
+		} else if (codePoint < 0x10000) {
+			*output++ = static_cast<char>(0xE0 | (codePoint >> 12));
+			*output++ = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+			*output++ = static_cast<char>(0x80 | (codePoint & 0x3F));
+		} else {
+			*output++ = static_cast<char>(0xF0 | (codePoint >> 18));
+			*output++ = static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F));
+			*output++ = static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F));
+			*output++ = static_cast<char>(0x80 | (codePoint & 0x3F));
+		}
+		return output;
+	}
+
+	/**
+	 * Parses a string starting at the opening quote. Escape sequences are decoded in place, decoded text is never longer than the source one.
+	 */
+	void parseString(const char*& data, uint32_t& dataLength) {
+		++_it;
+		char* begin = _it;
+		while (_it != _end && *_it != '"' && *_it != '\\') {
+			if (static_cast<unsigned char>(*_it) < 0x20) {
+				fail("control character in string");
+			}
+			++_it;
+		}
+		char* output = _it;
+		while (_it != _end && *_it != '"') {
+			char c = *_it++;
+			if (static_cast<unsigned char>(c) < 0x20) {
+				fail("control character in string");
+			}
+			if (c != '\\') {
+				*output++ = c;
+				continue;
+			}
+			if (_it == _end) {
+				break;
+			}
+			c = *_it++;
+			switch (c) {
+				case '"':
+				case '\\':
+				case '/':
+					*output++ = c;
+					break;
+				case 'b':
+					*output++ = '\b';
+					break;
+				case 'f':
+					*output++ = '\f';
+					break;
+				case 'n':
+					*output++ = '\n';
+					break;
+				case 'r':
+					*output++ = '\r';
+					break;
+				case 't':
+					*output++ = '\t';
+					break;
+				case 'u': {
+					uint32_t codePoint = parseUnicodeEscape();
+					if (codePoint >= 0xD800 && codePoint < 0xDC00 && _end - _it >= 6 && _it[0] == '\\' && _it[1] == 'u') {
+						char* lowSurrogateBegin = _it;
+						_it += 2;
+						uint32_t lowSurrogate = parseUnicodeEscape();
+						if (lowSurrogate >= 0xDC00 && lowSurrogate < 0xE000) {
+							codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (lowSurrogate - 0xDC00);
+						} else {
+							_it = lowSurrogateBegin;
+						}
+					}
+					output = writeUtf8(output, codePoint);
+					break;
+				}
+				default:
+					--_it;
+					fail("invalid escape sequence");
+			}
+		}
+		if (_it == _end) {
+			fail("unterminated string");
+		}
+		++_it;
+		data = begin;
+		dataLength = static_cast<uint32_t>(output - begin);
+	}
+};
+
+JsonDocument::JsonDocument(string json) : _buffer(move(json)) {
+	if (_buffer.size() > numeric_limits<uint32_t>::max()) {
+		throw JsonException("json text is too large");
+	}
+	// A member of a typical api object takes about 16 bytes of text, so usually this prevents most of reallocations.
+	_values.reserve(_buffer.size() / 16 + 1);
+	char* begin = &_buffer[0];
+	Parser(this, begin, begin + _buffer.size(), _values).parseDocument();
+}
+
+JsonValue::Ptr JsonDocument::parse(string json) {
+	auto document(make_shared<JsonDocument>(move(json)));
+	document->_self = document;
+	return JsonValue::Ptr(document, &document->getRoot());
+}
+
+}
@@ -0,0 +1,257 @@
+/*
+ * Copyright (c) 2015 Oleg Morozenkov
+ * Copyright (c) 2017 Maks Mazurov (fox.cpp)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "tgbot/tools/JsonValue.h"
+#include "tgbot/tools/JsonDocument.h"
+
+#include <cstring>
+#include <locale>
+#include <sstream>
+
+using namespace std;
+
+namespace TgBot {
+
+namespace {
+
+// Powers of ten which are exactly representable as double.
+const double EXACT_POWERS_OF_TEN[] = {
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+bool parseInteger(const char* it, const char* end, int64_t& result) {
+	if (it == end) {
+		return false;
+	}
+	bool isNegative = false;
+	if (*it == '-') {
+		isNegative = true;
+		++it;
+		if (it == end) {
+			return false;
+		}
+	}
+	uint64_t limit = isNegative ? static_cast<uint64_t>(numeric_limits<int64_t>::max()) + 1 : static_cast<uint64_t>(numeric_limits<int64_t>::max());
+	uint64_t value = 0;
+	for (; it != end; ++it) {
+		unsigned digit = static_cast<unsigned char>(*it) - '0';
+		if (digit > 9 || value > (limit - digit) / 10) {
+			return false;
+		}
+		value = value * 10 + digit;
+	}
+	result = isNegative ? static_cast<int64_t>(0 - value) : static_cast<int64_t>(value);
+	return true;
+}
+
+bool parseDoubleSlow(const char* begin, const char* end, double& result) {
+	istringstream input(string(begin, end));
+	input.imbue(locale::classic());
+	input >> result;
+	return !input.fail() && input.eof();
+}
+
+bool parseDouble(const char* begin, const char* end, double& result) {
+	const char* it = begin;
+	bool isNegative = false;
+	if (it != end && *it == '-') {
+		isNegative = true;
+		++it;
+	}
+	uint64_t mantissa = 0;
+	int digitCount = 0;
+	int exponent = 0;
+	bool hasDigits = false;
+	for (; it != end && *it >= '0' && *it <= '9'; ++it) {
+		hasDigits = true;
+		if (mantissa == 0 && *it == '0') {
+			continue;
+		}
+		if (++digitCount > 19) {
+			return parseDoubleSlow(begin, end, result);
+		}
+		mantissa = mantissa * 10 + (*it - '0');
+	}
+	if (it != end && *it == '.') {
+		++it;
+		for (; it != end && *it >= '0' && *it <= '9'; ++it) {
+			hasDigits = true;
+			if (mantissa == 0 && *it == '0') {
+				--exponent;
+				continue;
+			}
+			if (++digitCount > 19) {
+				return parseDoubleSlow(begin, end, result);
+			}
+			mantissa = mantissa * 10 + (*it - '0');
+			--exponent;
+		}
+	}
+	if (!hasDigits) {
+		return false;
+	}
+	if (it != end && (*it == 'e' || *it == 'E')) {
+		++it;
+		bool isExponentNegative = false;
+		if (it != end && (*it == '+' || *it == '-')) {
+			isExponentNegative = *it == '-';
+			++it;
+		}
+		if (it == end) {
+			return false;
+		}
+		int explicitExponent = 0;
+		for (; it != end && *it >= '0' && *it <= '9'; ++it) {
+			if (explicitExponent > 10000) {
+				return parseDoubleSlow(begin, end, result);
+			}
+			explicitExponent = explicitExponent * 10 + (*it - '0');
+		}
+		exponent += isExponentNegative ? -explicitExponent : explicitExponent;
+	}
+	if (it != end) {
+		return false;
+	}
+
+	// The value is exact if both the mantissa and the power of ten fit into double without rounding.
+	if (mantissa > (static_cast<uint64_t>(1) << 53) || exponent < -22 || exponent > 22) {
+		return parseDoubleSlow(begin, end, result);
+	}
+	double value = static_cast<double>(mantissa);
+	if (exponent < 0) {
+		value /= EXACT_POWERS_OF_TEN[-exponent];
+	} else {
+		value *= EXACT_POWERS_OF_TEN[exponent];
+	}
+	result = isNegative ? -value : value;
+	return true;
+}
+
+}
+
+JsonValue::Ptr JsonValue::getSharedPtr() const {
+	if (_document == nullptr) {
+		return nullptr;
+	}
+	std::shared_ptr<const JsonDocument> document = _document->_self.lock();
+	if (!document) {
+		return nullptr;
+	}
+	return Ptr(document, this);
+}
+
+const JsonValue* JsonValue::find(boost::string_ref key) const {
+	if (_type != Type::Object) {
+		return nullptr;
+	}
+	for (const JsonValue& item : *this) {
+		if (item._keyLength == key.size() && memcmp(item._key, key.data(), key.size()) == 0) {
+			return &item;
+		}
+	}
+	return nullptr;
+}
+
+const JsonValue& JsonValue::operator[](boost::string_ref key) const {
+	const JsonValue* result = find(key);
+	if (result == nullptr) {
+		throw JsonException("json object has no member \"" + key.to_string() + "\"");
+	}
+	return *result;
+}
+
+string JsonValue::getTypeName() const {
+	switch (_type) {
+		case Type::Null:
+			return "null";
+		case Type::Bool:
+			return "bool";
+		case Type::Number:
+			return "number";
+		case Type::String:
+			return "string";
+		case Type::Array:
+			return "array";
+		case Type::Object:
+			return "object";
+	}
+	return "";
+}
+
+bool JsonValue::convert(bool& result) const {
+	if (_type == Type::Bool) {
+		result = _boolValue;
+		return true;
+	}
+	if (_type != Type::String && _type != Type::Number) {
+		return false;
+	}
+	boost::string_ref text = getStringRef();
+	if (text == "true" || text == "1") {
+		result = true;
+		return true;
+	}
+	if (text == "false" || text == "0") {
+		result = false;
+		return true;
+	}
+	return false;
+}
+
+bool JsonValue::convert(string& result) const {
+	if (_type == Type::String || _type == Type::Number) {
+		result.assign(_data, _dataLength);
+		return true;
+	}
+	if (_type == Type::Bool) {
+		result = _boolValue ? "true" : "false";
+		return true;
+	}
+	return false;
+}
+
+bool JsonValue::convert(double& result) const {
+	if (_type != Type::String && _type != Type::Number) {
+		return false;
+	}
+	return parseDouble(_data, _data + _dataLength, result);
+}
+
+bool JsonValue::convert(float& result) const {
+	double value;
+	if (!convert(value)) {
+		return false;
+	}
+	result = static_cast<float>(value);
+	return true;
+}
+
+bool JsonValue::convertToInteger(int64_t& result) const {
+	if (_type != Type::String && _type != Type::Number) {
+		return false;
+	}
+	return parseInteger(_data, _data + _dataLength, result);
+}
+
+}
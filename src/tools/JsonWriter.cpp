@@ -0,0 +1,269 @@
+/*
+ * Copyright (c) 2015 Oleg Morozenkov
+ * Copyright (c) 2017 Maks Mazurov (fox.cpp)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include "tgbot/tools/JsonWriter.h"
+
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+
+using namespace std;
+
+namespace TgBot {
+
+static const char DIGIT_PAIRS[] =
+	"00010203040506070809"
+	"10111213141516171819"
+	"20212223242526272829"
+	"30313233343536373839"
+	"40414243444546474849"
+	"50515253545556575859"
+	"60616263646566676869"
+	"70717273747576777879"
+	"80818283848586878889"
+	"90919293949596979899";
+
+static const char HEX_DIGITS[] = "0123456789abcdef";
+
+const size_t JsonWriter::DEFAULT_RESERVED_SIZE;
+
+JsonWriter::JsonWriter(string& output, size_t reservedSize) : _output(output) {
+	_output.reserve(_output.size() + reservedSize);
+}
+
+JsonWriter& JsonWriter::startObject() {
+	beforeValue();
+	_output += '{';
+	_needsComma = false;
+	return *this;
+}
+
+JsonWriter& JsonWriter::endObject() {
+	_output += '}';
+	_needsComma = true;
+	return *this;
+}
+
+JsonWriter& JsonWriter::startArray() {
+	beforeValue();
+	_output += '[';
+	_needsComma = false;
+	return *this;
+}
+
+JsonWriter& JsonWriter::endArray() {
+	_output += ']';
+	_needsComma = true;
+	return *this;
+}
+
+JsonWriter& JsonWriter::key(boost::string_ref name) {
+	beforeValue();
+	_output += '"';
+	_output.append(name.data(), name.size());
+	_output += "\":";
+	_needsComma = false;
+	return *this;
+}
+
+JsonWriter& JsonWriter::value(boost::string_ref value) {
+	beforeValue();
+	appendString(_output, value);
+	return *this;
+}
+
+JsonWriter& JsonWriter::value(const char* value) {
+	return this->value(boost::string_ref(value));
+}
+
+JsonWriter& JsonWriter::value(const string& value) {
+	return this->value(boost::string_ref(value));
+}
+
+JsonWriter& JsonWriter::value(bool value) {
+	beforeValue();
+	_output += value ? "true" : "false";
+	return *this;
+}
+
+JsonWriter& JsonWriter::value(int32_t value) {
+	beforeValue();
+	appendInteger(_output, static_cast<int64_t>(value));
+	return *this;
+}
+
+JsonWriter& JsonWriter::value(int64_t value) {
+	beforeValue();
+	appendInteger(_output, value);
+	return *this;
+}
+
+JsonWriter& JsonWriter::value(uint32_t value) {
+	beforeValue();
+	appendInteger(_output, static_cast<uint64_t>(value));
+	return *this;
+}
+
+JsonWriter& JsonWriter::value(uint64_t value) {
+	beforeValue();
+	appendInteger(_output, value);
+	return *this;
+}
+
+template<typename T>
+static void appendFloatingPoint(string& output, T value, int minPrecision, int maxPrecision) {
+	if (!isfinite(value)) {
+		output += "null";
+		return;
+	}
+	// Shortest representation which is read back to the same value, so 55.75f isn't written as 55.75000000001.
+	char buffer[32];
+	int length = 0;
+	for (int precision = minPrecision; precision <= maxPrecision; ++precision) {
+		length = snprintf(buffer, sizeof(buffer), "%.*g", precision, static_cast<double>(value));
+		if (static_cast<T>(strtod(buffer, nullptr)) == value) {
+			break;
+		}
+	}
+	for (int i = 0; i < length; ++i) {
+		// Decimal separator depends on the current locale.
+		if (buffer[i] == ',') {
+			buffer[i] = '.';
+		}
+	}
+	output.append(buffer, length);
+}
+
+JsonWriter& JsonWriter::value(float value) {
+	beforeValue();
+	appendFloatingPoint(_output, value, 6, 9);
+	return *this;
+}
+
+JsonWriter& JsonWriter::value(double value) {
+	beforeValue();
+	appendFloatingPoint(_output, value, 15, 17);
+	return *this;
+}
+
+JsonWriter& JsonWriter::nullValue() {
+	beforeValue();
+	_output += "null";
+	return *this;
+}
+
+JsonWriter& JsonWriter::rawValue(boost::string_ref json) {
+	beforeValue();
+	_output.append(json.data(), json.size());
+	return *this;
+}
+
+JsonWriter& JsonWriter::rawMembers(boost::string_ref json) {
+	if (!json.empty()) {
+		beforeValue();
+		_output.append(json.data(), json.size());
+	}
+	return *this;
+}
+
+void JsonWriter::appendString(string& output, boost::string_ref value) {
+	output += '"';
+	const char* runBegin = value.data();
+	const char* end = value.data() + value.size();
+	for (const char* it = runBegin; it != end; ++it) {
+		unsigned char c = static_cast<unsigned char>(*it);
+		if (c >= 0x20 && c != '"' && c != '\\') {
+			continue;
+		}
+		output.append(runBegin, it);
+		runBegin = it + 1;
+		switch (c) {
+			case '"':
+				output += "\\\"";
+				break;
+
+			case '\\':
+				output += "\\\\";
+				break;
+
+			case '\n':
+				output += "\\n";
+				break;
+
+			case '\r':
+				output += "\\r";
+				break;
+
+			case '\t':
+				output += "\\t";
+				break;
+
+			case '\b':
+				output += "\\b";
+				break;
+
+			case '\f':
+				output += "\\f";
+				break;
+
+			default: {
+				char escaped[] = { '\\', 'u', '0', '0', HEX_DIGITS[c >> 4], HEX_DIGITS[c & 0xf] };
+				output.append(escaped, sizeof(escaped));
+				break;
+			}
+		}
+	}
+	output.append(runBegin, end);
+	output += '"';
+}
+
+void JsonWriter::appendInteger(string& output, int64_t value) {
+	if (value < 0) {
+		output += '-';
+		// Negation is done in unsigned arithmetic, so the minimal value doesn't overflow.
+		appendInteger(output, 0 - static_cast<uint64_t>(value));
+	} else {
+		appendInteger(output, static_cast<uint64_t>(value));
+	}
+}
+
+void JsonWriter::appendInteger(string& output, uint64_t value) {
+	char buffer[20];
+	char* it = buffer + sizeof(buffer);
+	while (value >= 100) {
+		size_t pair = static_cast<size_t>(value % 100) * 2;
+		value /= 100;
+		*--it = DIGIT_PAIRS[pair + 1];
+		*--it = DIGIT_PAIRS[pair];
+	}
+	if (value >= 10) {
+		size_t pair = static_cast<size_t>(value) * 2;
+		*--it = DIGIT_PAIRS[pair + 1];
+		*--it = DIGIT_PAIRS[pair];
+	} else {
+		*--it = static_cast<char>('0' + value);
+	}
+	output.append(it, buffer + sizeof(buffer));
+}
+
+}
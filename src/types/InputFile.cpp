@@ -25,6 +25,8 @@
 
 #include <fstream>
 
+#include <boost/interprocess/file_mapping.hpp>
+
 #include "tgbot/tools/StringTools.h"
 #include "tgbot/tools/FileTools.h"
 
@@ -38,4 +40,27 @@ InputFile::Ptr InputFile::fromFile(const std::string& filePath, const std::strin
 	return result;
 }
 
+InputFile::Ptr InputFile::fromMappedFile(const std::string& filePath, const std::string& mimeType) {
+	auto result(std::make_shared<InputFile>());
+	// An empty file can't be mapped, but then there is nothing to map anyway.
+	if (FileTools::getSize(filePath)) {
+		boost::interprocess::file_mapping mapping(filePath.c_str(), boost::interprocess::read_only);
+		auto region(std::make_shared<boost::interprocess::mapped_region>(mapping, boost::interprocess::read_only));
+		region->advise(boost::interprocess::mapped_region::advice_sequential);
+		result->mappedRegion = region;
+	}
+	result->mimeType = mimeType;
+	result->fileName = StringTools::split(filePath, '/').back();
+	return result;
+}
+
+InputFile::Ptr InputFile::fromStreamedFile(const std::string& filePath, const std::string& mimeType) {
+	auto result(std::make_shared<InputFile>());
+	result->filePath = filePath;
+	result->fileSize = FileTools::getSize(filePath);
+	result->mimeType = mimeType;
+	result->fileName = StringTools::split(filePath, '/').back();
+	return result;
+}
+
 };
@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) 2015 Oleg Morozenkov
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#ifndef TGBOT_TESTSERVER_H
+#define TGBOT_TESTSERVER_H
+
+#include <atomic>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/asio.hpp>
+#include <boost/asio/ssl.hpp>
+#include <openssl/evp.h>
+#include <openssl/rsa.h>
+#include <openssl/x509.h>
+
+/**
+ * Local https server for tests of network code. Every connection is served on its own thread, requests are answered by a responder.
+ */
+class TestServer {
+
+public:
+	/**
+	 * Returns the whole response text for a request. An empty text closes the connection without a response.
+	 */
+	typedef std::function<std::string (const std::string& head, const std::string& body)> Responder;
+
+	explicit TestServer(const Responder& responder) : _responder(responder), _context(boost::asio::ssl::context::sslv23),
+		_acceptor(_ioService, boost::asio::ip::tcp::endpoint(boost::asio::ip::address_v4::loopback(), 0)), _requestCount(0)
+	{
+		useSelfSignedCertificate(_context);
+		_acceptThread = std::thread(&TestServer::accept, this);
+	}
+
+	~TestServer() {
+		_isStopped = true;
+		// Blocking calls don't return when their sockets are closed, so they're woken by a connection and shut down sockets.
+		boost::system::error_code error;
+		boost::asio::ip::tcp::socket wakeUpSocket(_ioService);
+		wakeUpSocket.connect(_acceptor.local_endpoint(), error);
+		_acceptThread.join();
+		{
+			std::lock_guard<std::mutex> lock(_mutex);
+			for (auto& stream : _streams) {
+				stream->lowest_layer().shutdown(boost::asio::socket_base::shutdown_both, error);
+			}
+		}
+		for (std::thread& thread : _connectionThreads) {
+			thread.join();
+		}
+	}
+
+	inline std::string getUrl() const {
+		return "https://127.0.0.1:" + std::to_string(_acceptor.local_endpoint().port());
+	}
+
+	inline size_t getRequestCount() const {
+		return _requestCount;
+	}
+
+	/**
+	 * @return Number of connections which the client hasn't closed yet.
+	 */
+	inline size_t getOpenConnectionCount() const {
+		return _openConnectionCount;
+	}
+
+	static std::string makeResponse(unsigned short statusCode, const std::string& body, const std::string& headers = "") {
+		return "HTTP/1.1 " + std::to_string(statusCode) + " Status\r\nContent-Length: " + std::to_string(body.size()) + "\r\n" + headers + "\r\n" + body;
+	}
+
+private:
+	typedef boost::asio::ssl::stream<boost::asio::ip::tcp::socket> Stream;
+
+	static void useSelfSignedCertificate(boost::asio::ssl::context& context) {
+		static std::once_flag keyFlag;
+		static EVP_PKEY* key = nullptr;
+		static X509* certificate = nullptr;
+		std::call_once(keyFlag, []() {
+			EVP_PKEY_CTX* keyContext = EVP_PKEY_CTX_new_id(EVP_PKEY_RSA, nullptr);
+			EVP_PKEY_keygen_init(keyContext);
+			EVP_PKEY_CTX_set_rsa_keygen_bits(keyContext, 2048);
+			EVP_PKEY_keygen(keyContext, &key);
+			EVP_PKEY_CTX_free(keyContext);
+
+			certificate = X509_new();
+			X509_set_version(certificate, 2);
+			ASN1_INTEGER_set(X509_get_serialNumber(certificate), 1);
+			X509_gmtime_adj(X509_get_notBefore(certificate), 0);
+			X509_gmtime_adj(X509_get_notAfter(certificate), 24 * 60 * 60);
+			X509_set_pubkey(certificate, key);
+			X509_NAME* name = X509_get_subject_name(certificate);
+			X509_NAME_add_entry_by_txt(name, "CN", MBSTRING_ASC, reinterpret_cast<const unsigned char*>("127.0.0.1"), -1, -1, 0);
+			X509_set_issuer_name(certificate, name);
+			X509_sign(certificate, key, EVP_sha256());
+		});
+		SSL_CTX_use_certificate(context.native_handle(), certificate);
+		SSL_CTX_use_PrivateKey(context.native_handle(), key);
+	}
+
+	void accept() {
+		while (true) {
+			auto stream(std::make_shared<Stream>(_ioService, _context));
+			boost::system::error_code error;
+			_acceptor.accept(stream->lowest_layer(), error);
+			if (_isStopped) {
+				break;
+			}
+			if (error) {
+				continue;
+			}
+			std::lock_guard<std::mutex> lock(_mutex);
+			_streams.push_back(stream);
+			_connectionThreads.emplace_back(&TestServer::serve, this, stream);
+		}
+	}
+
+	void serve(const std::shared_ptr<Stream>& stream) {
+		++_openConnectionCount;
+		boost::system::error_code error;
+		stream->handshake(boost::asio::ssl::stream_base::server, error);
+		boost::asio::streambuf buffer;
+		while (!error && !_isStopped) {
+			size_t headSize = boost::asio::read_until(*stream, buffer, "\r\n\r\n", error);
+			if (error) {
+				break;
+			}
+			std::string head(boost::asio::buffers_begin(buffer.data()), boost::asio::buffers_begin(buffer.data()) + headSize);
+			buffer.consume(headSize);
+
+			size_t bodySize = 0;
+			size_t position = head.find("Content-Length:");
+			if (position != std::string::npos) {
+				bodySize = strtoul(head.c_str() + position + 15, nullptr, 10);
+			}
+			if (buffer.size() < bodySize) {
+				boost::asio::read(*stream, buffer, boost::asio::transfer_exactly(bodySize - buffer.size()), error);
+			}
+			std::string body(boost::asio::buffers_begin(buffer.data()), boost::asio::buffers_begin(buffer.data()) + bodySize);
+			buffer.consume(bodySize);
+
+			++_requestCount;
+			std::string response = _responder(head, body);
+			if (response.empty()) {
+				break;
+			}
+			boost::asio::write(*stream, boost::asio::buffer(response), error);
+		}
+		stream->lowest_layer().shutdown(boost::asio::socket_base::shutdown_both, error);
+		--_openConnectionCount;
+	}
+
+	const Responder _responder;
+	boost::asio::io_service _ioService;
+	boost::asio::ssl::context _context;
+	boost::asio::ip::tcp::acceptor _acceptor;
+	std::thread _acceptThread;
+	std::mutex _mutex;
+	std::vector<std::shared_ptr<Stream>> _streams;
+	std::vector<std::thread> _connectionThreads;
+	std::atomic<bool> _isStopped{false};
+	std::atomic<size_t> _requestCount;
+	std::atomic<size_t> _openConnectionCount{0};
+};
+
+#endif //TGBOT_TESTSERVER_H
@@ -0,0 +1,133 @@
+/*
+ * Copyright (c) 2015 Oleg Morozenkov
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <chrono>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <tgbot/Api.h>
+
+#include "TestServer.h"
+
+using namespace std;
+using namespace TgBot;
+
+/**
+ * Answers every request with a sent message and remembers request bodies.
+ */
+class RecordingServer {
+
+public:
+	RecordingServer() : server([this](const string& head, const string& body) {
+		lock_guard<mutex> lock(requestMutex);
+		size_t methodStart = head.find("/botTOKEN/") + 10;
+		methods.push_back(head.substr(methodStart, head.find(' ', methodStart) - methodStart));
+		bodies.push_back(body);
+		return TestServer::makeResponse(200, "{\"ok\":true,\"result\":{\"message_id\":5,\"date\":0,\"chat\":{\"id\":1,\"type\":\"private\"}}}");
+	}), api("TOKEN", server.getUrl()) {
+	}
+
+	mutex requestMutex;
+	vector<string> methods;
+	vector<string> bodies;
+	TestServer server;
+	Api api;
+};
+
+BOOST_AUTO_TEST_SUITE(tApi)
+
+BOOST_AUTO_TEST_CASE(sendWithOptions) {
+	RecordingServer recorder;
+	SendOptions options;
+	options.caption = "c";
+	options.disableNotification = true;
+	BOOST_CHECK_EQUAL(recorder.api.sendAudio(1, "a", options)->messageId, 5);
+	BOOST_CHECK_EQUAL(recorder.api.sendAudioAndForget(1, "a", options), 5);
+	BOOST_CHECK_EQUAL(recorder.api.trySendVenueAndForget(1, 2, 3, "t", "a").getValue(), 5);
+	BOOST_CHECK_EQUAL(recorder.api.sendContactAndForget(1, "+1", "f"), 5);
+	BOOST_CHECK_EQUAL(recorder.api.forwardMessageAndForget(1, 2, 3, options), 5);
+
+	vector<string> expectedMethods = {"sendAudio", "sendAudio", "sendVenue", "sendContact", "forwardMessage"};
+	BOOST_CHECK_EQUAL_COLLECTIONS(recorder.methods.begin(), recorder.methods.end(), expectedMethods.begin(), expectedMethods.end());
+	BOOST_REQUIRE_EQUAL(recorder.bodies.size(), 5);
+	BOOST_CHECK_EQUAL(recorder.bodies[0], "{\"chat_id\":1,\"audio\":\"a\",\"disable_notification\":true,\"caption\":\"c\"}");
+	BOOST_CHECK_EQUAL(recorder.bodies[1], recorder.bodies[0]);
+	BOOST_CHECK_EQUAL(recorder.bodies[2], "{\"chat_id\":1,\"latitude\":2,\"longitude\":3,\"title\":\"t\",\"address\":\"a\"}");
+	BOOST_CHECK_EQUAL(recorder.bodies[3], "{\"chat_id\":1,\"phone_number\":\"+1\",\"first_name\":\"f\"}");
+	BOOST_CHECK_EQUAL(recorder.bodies[4], "{\"chat_id\":1,\"from_chat_id\":2,\"message_id\":3,\"disable_notification\":true}");
+}
+
+BOOST_AUTO_TEST_CASE(editWithOptions) {
+	RecordingServer recorder;
+	EditOptions options;
+	options.parseMode = "HTML";
+	BOOST_CHECK_EQUAL(recorder.api.editMessageText(1, 2, "t", options)->messageId, 5);
+	recorder.api.editMessageTextAndForget(1, 2, "t", options);
+	BOOST_CHECK(recorder.api.tryEditMessageReplyMarkupAndForget("i", options));
+	BOOST_CHECK(recorder.api.tryEditMessageReplyMarkupAndForget(1, 2));
+
+	BOOST_REQUIRE_EQUAL(recorder.bodies.size(), 4);
+	BOOST_CHECK_EQUAL(recorder.bodies[0], "{\"chat_id\":1,\"message_id\":2,\"text\":\"t\",\"parse_mode\":\"HTML\"}");
+	BOOST_CHECK_EQUAL(recorder.bodies[1], recorder.bodies[0]);
+	BOOST_CHECK_EQUAL(recorder.bodies[2], "{\"inline_message_id\":\"i\"}");
+	BOOST_CHECK_EQUAL(recorder.bodies[3], "{\"chat_id\":1,\"message_id\":2}");
+}
+
+BOOST_AUTO_TEST_CASE(throwingDownloadSink) {
+	TestServer server([](const string&, const string&) {
+		return TestServer::makeResponse(200, string(8 * 1024 * 1024, 'a'));
+	});
+	Api api("TOKEN", server.getUrl());
+	size_t pieceCount = 0;
+	BOOST_CHECK_THROW(api.downloadFile("file", [&pieceCount](const char*, size_t) {
+		++pieceCount;
+		throw runtime_error("sink");
+	}), runtime_error);
+	BOOST_CHECK_EQUAL(pieceCount, 1);
+	// The aborted connection is closed instead of being read to the end and kept for reuse.
+	for (int i = 0; i < 100 && server.getOpenConnectionCount() != 0; ++i) {
+		this_thread::sleep_for(chrono::milliseconds(10));
+	}
+	BOOST_CHECK_EQUAL(server.getOpenConnectionCount(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(downloadToWrongPath) {
+	TestServer server([](const string&, const string&) {
+		return TestServer::makeResponse(200, "a");
+	});
+	Api api("TOKEN", server.getUrl());
+	const string path = "tgbot_test_missing_directory/file";
+	try {
+		api.downloadFileToPath("file", path);
+		BOOST_ERROR("downloadFileToPath doesn't throw");
+	} catch (runtime_error& e) {
+		BOOST_CHECK(string(e.what()).find(path) != string::npos);
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2015 Oleg Morozenkov
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <mutex>
+#include <set>
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <tgbot/Broadcaster.h>
+
+using namespace std;
+using namespace TgBot;
+
+static vector<int64_t> readAll(const Broadcaster::ChatIdSource& source) {
+	vector<int64_t> result;
+	int64_t chatId;
+	while (source(chatId)) {
+		result.push_back(chatId);
+	}
+	return result;
+}
+
+BOOST_AUTO_TEST_SUITE(tBroadcaster)
+
+BOOST_AUTO_TEST_CASE(fromRange) {
+	vector<int64_t> chatIds = {1, -2, 3000000000};
+	vector<int64_t> result = readAll(Broadcaster::fromRange(chatIds.begin(), chatIds.end()));
+	BOOST_CHECK_EQUAL_COLLECTIONS(result.begin(), result.end(), chatIds.begin(), chatIds.end());
+}
+
+BOOST_AUTO_TEST_CASE(fromFile) {
+	const string path = "tgbot_test_broadcaster_chats.tmp";
+	{
+		ofstream out(path);
+		out << "1\n-1001234567890\n\n42\n";
+	}
+	vector<int64_t> result = readAll(Broadcaster::fromFile(path));
+	vector<int64_t> expected = {1, -1001234567890, 42};
+	BOOST_CHECK_EQUAL_COLLECTIONS(result.begin(), result.end(), expected.begin(), expected.end());
+	remove(path.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(classifyFailure) {
+	BOOST_CHECK(Broadcaster::classifyFailure(ApiError(403, "Forbidden: bot was blocked by the user")) == Broadcaster::FailureKind::Blocked);
+	BOOST_CHECK(Broadcaster::classifyFailure(ApiError(403, "Forbidden: user is deactivated")) == Broadcaster::FailureKind::Deactivated);
+	BOOST_CHECK(Broadcaster::classifyFailure(ApiError(400, "Bad Request: chat not found")) == Broadcaster::FailureKind::ChatNotFound);
+	BOOST_CHECK(Broadcaster::classifyFailure(ApiError(400, "Bad Request: message text is empty")) == Broadcaster::FailureKind::Other);
+}
+
+BOOST_AUTO_TEST_CASE(stopAndResume) {
+	const string checkpointPath = "tgbot_test_broadcaster_checkpoint.tmp";
+	const string failuresPath = "tgbot_test_broadcaster_failures.tmp";
+	remove(checkpointPath.c_str());
+	remove(failuresPath.c_str());
+	vector<int64_t> chatIds;
+	for (int64_t i = 1; i <= 200; ++i) {
+		chatIds.push_back(i);
+	}
+
+	mutex sentMutex;
+	map<int64_t, int> doneCounts;
+	atomic<int> callCount(0);
+	Broadcaster* stoppedBroadcaster = nullptr;
+	// Every 10th chat is blocked and every 10th is migrated to a supergroup with the negated id.
+	Broadcaster::Sender sender = [&](int64_t chatId) -> Result<void> {
+		if (++callCount == 60 && stoppedBroadcaster) {
+			stoppedBroadcaster->stop();
+		}
+		if (chatId % 10 == 7) {
+			auto parameters(make_shared<ResponseParameters>());
+			parameters->migrateToChatId = -chatId;
+			return ApiError(400, "Bad Request: group chat was upgraded to a supergroup chat", parameters);
+		}
+		{
+			lock_guard<mutex> lock(sentMutex);
+			++doneCounts[chatId < 0 ? -chatId : chatId];
+		}
+		if (chatId % 10 == 3) {
+			return ApiError(403, "Forbidden: bot was blocked by the user");
+		}
+		return Result<void>();
+	};
+	Broadcaster::Options options;
+	options.concurrency = 4;
+	options.rate = 0;
+	options.checkpointPath = checkpointPath;
+	options.failuresPath = failuresPath;
+	options.progressInterval = chrono::milliseconds(5);
+
+	Broadcaster firstBroadcaster(sender, options);
+	stoppedBroadcaster = &firstBroadcaster;
+	Broadcaster::Progress firstProgress = firstBroadcaster.run(Broadcaster::fromRange(chatIds.begin(), chatIds.end()));
+	BOOST_CHECK_GT(firstProgress.processedCount, 0);
+	BOOST_CHECK_LT(firstProgress.processedCount, chatIds.size());
+
+	stoppedBroadcaster = nullptr;
+	Broadcaster secondBroadcaster(sender, options);
+	Broadcaster::Progress progress = secondBroadcaster.run(Broadcaster::fromRange(chatIds.begin(), chatIds.end()));
+	BOOST_CHECK_EQUAL(progress.processedCount, 200);
+	BOOST_CHECK_EQUAL(progress.sentCount, 180);
+	BOOST_CHECK_EQUAL(progress.migratedCount, 20);
+	BOOST_CHECK_EQUAL(progress.blockedCount, 20);
+	BOOST_CHECK_EQUAL(progress.otherFailureCount, 0);
+
+	BOOST_REQUIRE_EQUAL(doneCounts.size(), chatIds.size());
+	for (const auto& item : doneCounts) {
+		BOOST_CHECK_MESSAGE(item.second == 1, "chat " << item.first << " is processed " << item.second << " times");
+	}
+
+	ifstream failures(failuresPath);
+	vector<string> lines;
+	for (string line; getline(failures, line);) {
+		lines.push_back(line);
+	}
+	failures.close();
+	set<string> uniqueLines(lines.begin(), lines.end());
+	BOOST_CHECK_EQUAL(lines.size(), 40);
+	BOOST_CHECK_EQUAL(uniqueLines.size(), lines.size());
+	BOOST_CHECK(uniqueLines.count("17 migrated -17"));
+	BOOST_CHECK(uniqueLines.count("13 blocked Forbidden: bot was blocked by the user"));
+	remove(checkpointPath.c_str());
+	remove(failuresPath.c_str());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
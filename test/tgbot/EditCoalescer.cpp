@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2015 Oleg Morozenkov
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <tgbot/EditCoalescer.h>
+
+using namespace std;
+using namespace TgBot;
+
+namespace {
+
+struct SentEdits {
+	mutex sentMutex;
+	vector<string> texts;
+	vector<EditCoalescer::Clock::time_point> times;
+	ApiError nextError;
+
+	EditCoalescer::Sender getSender() {
+		return [this](int64_t, int32_t, const string& text, const EditOptions&) -> Result<void> {
+			lock_guard<mutex> lock(sentMutex);
+			texts.push_back(text);
+			times.push_back(EditCoalescer::Clock::now());
+			if (nextError.errorCode) {
+				ApiError error = nextError;
+				nextError = ApiError();
+				return error;
+			}
+			return Result<void>();
+		};
+	}
+};
+
+EditCoalescer::Options makeOptions(int minIntervalMs) {
+	EditCoalescer::Options options;
+	options.minInterval = chrono::milliseconds(minIntervalMs);
+	return options;
+}
+
+}
+
+BOOST_AUTO_TEST_SUITE(tEditCoalescer)
+
+BOOST_AUTO_TEST_CASE(latestWins) {
+	SentEdits sent;
+	EditCoalescer coalescer(sent.getSender(), makeOptions(100));
+	coalescer.edit(1, 2, "0%");
+	coalescer.flush();
+	for (int i = 1; i <= 100; ++i) {
+		coalescer.edit(1, 2, to_string(i) + "%");
+	}
+	coalescer.flush();
+
+	vector<string> expected = {"0%", "100%"};
+	BOOST_CHECK_EQUAL_COLLECTIONS(sent.texts.begin(), sent.texts.end(), expected.begin(), expected.end());
+	BOOST_CHECK_GE(chrono::duration_cast<chrono::milliseconds>(sent.times[1] - sent.times[0]).count(), 100);
+	EditCoalescer::Metrics metrics = coalescer.getMetrics();
+	BOOST_CHECK_EQUAL(metrics.requestedCount, 101);
+	BOOST_CHECK_EQUAL(metrics.sentCount, 2);
+	BOOST_CHECK_EQUAL(metrics.supersededCount, 99);
+	BOOST_CHECK_EQUAL(metrics.pendingCount, 0);
+}
+
+BOOST_AUTO_TEST_CASE(unchanged) {
+	SentEdits sent;
+	EditCoalescer coalescer(sent.getSender(), makeOptions(0));
+	coalescer.edit(1, 2, "text");
+	coalescer.flush();
+	coalescer.edit(1, 2, "text");
+	EditOptions options;
+	auto markup(make_shared<InlineKeyboardMarkup>());
+	markup->inlineKeyboard.push_back({make_shared<InlineKeyboardButton>()});
+	markup->inlineKeyboard[0][0]->text = "Stop";
+	markup->inlineKeyboard[0][0]->callbackData = "stop";
+	options.replyMarkup = markup;
+	coalescer.edit(1, 2, "text", options);
+	coalescer.flush();
+	coalescer.edit(1, 2, "text", options);
+	coalescer.flush();
+
+	BOOST_CHECK_EQUAL(sent.texts.size(), 2);
+	BOOST_CHECK_EQUAL(coalescer.getMetrics().unchangedCount, 2);
+}
+
+BOOST_AUTO_TEST_CASE(separateMessages) {
+	SentEdits sent;
+	EditCoalescer coalescer(sent.getSender(), makeOptions(1000));
+	coalescer.edit(1, 2, "a");
+	coalescer.edit(1, 3, "b");
+	coalescer.edit(4, 2, "c");
+	coalescer.flush();
+	BOOST_CHECK_EQUAL(sent.texts.size(), 3);
+}
+
+BOOST_AUTO_TEST_CASE(failures) {
+	SentEdits sent;
+	EditCoalescer::Options options = makeOptions(0);
+	vector<int32_t> errorCodes;
+	options.errorHandler = [&errorCodes](int64_t, int32_t, const ApiError& error) {
+		errorCodes.push_back(error.errorCode);
+	};
+	EditCoalescer coalescer(sent.getSender(), options);
+
+	sent.nextError = ApiError(400, "Bad Request: message is not modified");
+	coalescer.edit(1, 2, "text");
+	coalescer.flush();
+	coalescer.edit(1, 2, "text");
+
+	sent.nextError = ApiError(400, "Bad Request: message to edit not found");
+	coalescer.edit(1, 2, "new text");
+	coalescer.flush();
+
+	auto parameters(make_shared<ResponseParameters>());
+	parameters->retryAfter = 1;
+	sent.nextError = ApiError(429, "Too Many Requests: retry after 1", parameters);
+	coalescer.edit(1, 3, "text");
+	coalescer.flush();
+
+	vector<string> expected = {"text", "new text", "text", "text"};
+	BOOST_CHECK_EQUAL_COLLECTIONS(sent.texts.begin(), sent.texts.end(), expected.begin(), expected.end());
+	BOOST_CHECK_GE(chrono::duration<double>(sent.times[3] - sent.times[2]).count(), 0.99);
+	BOOST_REQUIRE_EQUAL(errorCodes.size(), 1);
+	BOOST_CHECK_EQUAL(errorCodes[0], 400);
+	EditCoalescer::Metrics metrics = coalescer.getMetrics();
+	BOOST_CHECK_EQUAL(metrics.sentCount, 1);
+	BOOST_CHECK_EQUAL(metrics.unchangedCount, 2);
+	BOOST_CHECK_EQUAL(metrics.failedCount, 1);
+}
+
+BOOST_AUTO_TEST_CASE(forget) {
+	SentEdits sent;
+	EditCoalescer coalescer(sent.getSender(), makeOptions(60000));
+	coalescer.edit(1, 2, "a");
+	coalescer.flush();
+	coalescer.edit(1, 2, "b");
+	BOOST_CHECK_EQUAL(coalescer.getMetrics().pendingCount, 1);
+	coalescer.forget(1, 2);
+	coalescer.flush();
+	BOOST_CHECK_EQUAL(sent.texts.size(), 1);
+	BOOST_CHECK_EQUAL(coalescer.getMetrics().pendingCount, 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
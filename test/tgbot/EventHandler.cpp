@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2015 Oleg Morozenkov
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <tgbot/EventHandler.h>
+
+using namespace std;
+using namespace TgBot;
+
+static Update::Ptr createMessageUpdate(int32_t updateId, int64_t chatId) {
+	Update::Ptr update(new Update);
+	update->updateId = updateId;
+	update->message.reset(new Message);
+	update->message->chat.reset(new Chat);
+	update->message->chat->id = chatId;
+	update->message->messageId = updateId;
+	return update;
+}
+
+BOOST_AUTO_TEST_SUITE(tEventHandler)
+
+BOOST_AUTO_TEST_CASE(laneKey) {
+	BOOST_CHECK_EQUAL(EventHandler::getLaneKey(createMessageUpdate(1, -100500)), -100500);
+
+	Update::Ptr update(new Update);
+	BOOST_CHECK_EQUAL(EventHandler::getLaneKey(update), 0);
+	update->callbackQuery.reset(new CallbackQuery);
+	update->callbackQuery->from.reset(new User);
+	update->callbackQuery->from->id = 42;
+	BOOST_CHECK_EQUAL(EventHandler::getLaneKey(update), 42);
+}
+
+BOOST_AUTO_TEST_CASE(parallelDispatchKeepsChatOrder) {
+	EventBroadcaster broadcaster;
+	mutex handledMutex;
+	map<int64_t, vector<int32_t>> handled;
+	broadcaster.onAnyMessage([&](const Message::Ptr message) {
+		lock_guard<mutex> lock(handledMutex);
+		handled[message->chat->id].push_back(message->messageId);
+	});
+
+	EventHandler eventHandler(&broadcaster);
+	eventHandler.enableParallelDispatch(4, 8);
+	for (int32_t i = 0; i < 1000; ++i) {
+		eventHandler.handleUpdate(createMessageUpdate(i, i % 7));
+	}
+	eventHandler.drain();
+	BOOST_CHECK_EQUAL(eventHandler.getQueuedUpdateCount(), 0);
+
+	BOOST_REQUIRE_EQUAL(handled.size(), 7);
+	for (auto& item : handled) {
+		const vector<int32_t>& ids = item.second;
+		for (size_t i = 1; i < ids.size(); ++i) {
+			BOOST_CHECK_LT(ids[i - 1], ids[i]);
+		}
+	}
+}
+
+BOOST_AUTO_TEST_CASE(parallelDispatchRethrows) {
+	EventBroadcaster broadcaster;
+	broadcaster.onAnyMessage([](const Message::Ptr) {
+		throw runtime_error("listener failed");
+	});
+
+	EventHandler eventHandler(&broadcaster);
+	eventHandler.enableParallelDispatch(1, 1);
+	eventHandler.handleUpdate(createMessageUpdate(1, 1));
+	BOOST_CHECK_THROW(eventHandler.drain(), runtime_error);
+	eventHandler.drain();
+}
+
+BOOST_AUTO_TEST_CASE(parallelDispatchKeepsFirstError) {
+	EventBroadcaster broadcaster;
+	broadcaster.onAnyMessage([](const Message::Ptr message) {
+		throw runtime_error(to_string(message->messageId));
+	});
+
+	EventHandler eventHandler(&broadcaster);
+	eventHandler.enableParallelDispatch(1, 2);
+	eventHandler.handleUpdate(createMessageUpdate(1, 1));
+	eventHandler.handleUpdate(createMessageUpdate(2, 1));
+	BOOST_CHECK_EXCEPTION(eventHandler.drain(), runtime_error, [](const runtime_error& e) {
+		return string(e.what()) == "1";
+	});
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,71 @@
+/*
+ * Copyright (c) 2015 Oleg Morozenkov
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <memory>
+#include <string>
+
+#include <boost/test/unit_test.hpp>
+
+#include <tgbot/Result.h>
+
+using namespace std;
+using namespace TgBot;
+
+BOOST_AUTO_TEST_SUITE(tResult)
+
+BOOST_AUTO_TEST_CASE(value) {
+	Result<string> result(string("text"));
+	BOOST_CHECK(result);
+	BOOST_CHECK(result.isOk());
+	BOOST_CHECK_EQUAL(result.getValue(), "text");
+	BOOST_CHECK_EQUAL(result.getValueOrThrow(), "text");
+	BOOST_CHECK_EQUAL(result.getError().errorCode, 0);
+}
+
+BOOST_AUTO_TEST_CASE(error) {
+	auto parameters(make_shared<ResponseParameters>());
+	parameters->retryAfter = 5;
+	Result<int32_t> result(ApiError(429, "Too Many Requests: retry after 5", parameters));
+	BOOST_CHECK(!result);
+	BOOST_CHECK_EQUAL(result.getValue(), 0);
+	BOOST_CHECK_EQUAL(result.getError().errorCode, 429);
+	try {
+		result.getValueOrThrow();
+		BOOST_ERROR("getValueOrThrow didn't throw");
+	} catch (TgException& e) {
+		BOOST_CHECK_EQUAL(e.what(), "Too Many Requests: retry after 5");
+		BOOST_CHECK_EQUAL(e.errorCode, 429);
+		BOOST_CHECK_EQUAL(e.parameters->retryAfter, 5);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(voidResult) {
+	Result<void> result;
+	BOOST_CHECK(result);
+	BOOST_CHECK_NO_THROW(result.throwIfFailed());
+	result = ApiError(403, "Forbidden: bot was blocked by the user");
+	BOOST_CHECK(!result.isOk());
+	BOOST_CHECK_THROW(result.throwIfFailed(), TgException);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2015 Oleg Morozenkov
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include <boost/test/unit_test.hpp>
+
+#include <tgbot/net/HttpClient.h>
+
+#include "TestServer.h"
+
+using namespace std;
+using namespace TgBot;
+
+static boost::system::error_code waitForError(future<boost::system::error_code> result) {
+	// A request which is never completed would hang the test instead of failing it.
+	BOOST_REQUIRE(result.wait_for(chrono::seconds(10)) == future_status::ready);
+	return result.get();
+}
+
+BOOST_AUTO_TEST_SUITE(tHttpClient)
+
+BOOST_AUTO_TEST_CASE(makeRequest) {
+	TestServer server([](const string&, const string& body) {
+		return TestServer::makeResponse(200, "got " + body);
+	});
+	HttpClient client;
+	vector<HttpReqArg> args = {HttpReqArg("text", "Hi")};
+	BOOST_CHECK_EQUAL(client.makeRequest(Url(server.getUrl() + "/sendMessage"), args), "got text=Hi");
+	BOOST_CHECK_EQUAL(client.makeRequest(Url(server.getUrl() + "/sendMessage"), args), "got text=Hi");
+	BOOST_CHECK_EQUAL(client.getFullHandshakeCount(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(throwingHandlers) {
+	TestServer server([](const string&, const string&) {
+		return TestServer::makeResponse(200, string(100000, 'x'));
+	});
+	HttpClient client;
+	Url url(server.getUrl() + "/file");
+
+	auto bodyResult(make_shared<promise<boost::system::error_code>>());
+	client.makeRequestAsync(url, vector<HttpReqArg>(), [](const char*, size_t) {
+		throw runtime_error("sink is full");
+	}, [bodyResult](const boost::system::error_code& error, string&&) {
+		bodyResult->set_value(error);
+	});
+	BOOST_CHECK(waitForError(bodyResult->get_future()) == boost::system::errc::operation_canceled);
+
+	auto headersResult(make_shared<promise<boost::system::error_code>>());
+	client.makeRequestAsync(url, vector<HttpReqArg>(), [](const HttpResponseParser&) {
+		throw runtime_error("unexpected status");
+	}, nullptr, [headersResult](const boost::system::error_code& error, string&&) {
+		headersResult->set_value(error);
+	});
+	BOOST_CHECK(waitForError(headersResult->get_future()) == boost::system::errc::operation_canceled);
+
+	// The client keeps working after aborted requests.
+	BOOST_CHECK_EQUAL(client.makeRequest(url, vector<HttpReqArg>()).size(), 100000);
+}
+
+BOOST_AUTO_TEST_CASE(noReplayAfterWrite) {
+	TestServer server([](const string& head, const string&) {
+		static atomic<int> requestCount(0);
+		int requestIndex = ++requestCount;
+		// The connection is closed without a response, as if it was closed by the server while it was idle.
+		return requestIndex == 2 || requestIndex == 4 ? string() : TestServer::makeResponse(200, head.substr(0, head.find(' ', 5)));
+	});
+	HttpClient client;
+	vector<HttpReqArg> args = {HttpReqArg("chat_id", 1)};
+
+	BOOST_CHECK_EQUAL(client.makeRequest(Url(server.getUrl() + "/sendMessage"), args), "POST /sendMessage");
+	// The message may have been sent already, so it isn't sent again.
+	BOOST_CHECK_THROW(client.makeRequest(Url(server.getUrl() + "/sendMessage"), args), boost::system::system_error);
+	BOOST_CHECK_EQUAL(server.getRequestCount(), 2);
+
+	BOOST_CHECK_EQUAL(client.makeRequest(Url(server.getUrl() + "/getUpdates"), args), "POST /getUpdates");
+	// Reading updates is harmless, so it's repeated on a new connection.
+	BOOST_CHECK_EQUAL(client.makeRequest(Url(server.getUrl() + "/getUpdates"), args), "POST /getUpdates");
+	BOOST_CHECK_EQUAL(server.getRequestCount(), 5);
+}
+
+BOOST_AUTO_TEST_CASE(requestTimeout) {
+	TestServer server([](const string&, const string&) {
+		this_thread::sleep_for(chrono::seconds(3));
+		return TestServer::makeResponse(200, "late");
+	});
+	HttpClient client;
+	client.setRequestTimeout(1);
+	auto start = chrono::steady_clock::now();
+	try {
+		client.makeRequest(Url(server.getUrl() + "/getMe"), vector<HttpReqArg>());
+		BOOST_ERROR("makeRequest didn't time out");
+	} catch (boost::system::system_error& e) {
+		BOOST_CHECK(e.code() == boost::system::errc::timed_out);
+	}
+	BOOST_CHECK_LT(chrono::duration<double>(chrono::steady_clock::now() - start).count(), 2.5);
+}
+
+BOOST_AUTO_TEST_CASE(idleTimeout) {
+	TestServer server([](const string&, const string&) {
+		return TestServer::makeResponse(200, "ok");
+	});
+	HttpClient client;
+	client.setIdleTimeout(1);
+	client.makeRequest(Url(server.getUrl() + "/getMe"), vector<HttpReqArg>());
+	BOOST_CHECK_EQUAL(server.getOpenConnectionCount(), 1);
+	auto deadline = chrono::steady_clock::now() + chrono::seconds(5);
+	while (server.getOpenConnectionCount() != 0 && chrono::steady_clock::now() < deadline) {
+		this_thread::sleep_for(chrono::milliseconds(50));
+	}
+	BOOST_CHECK_EQUAL(server.getOpenConnectionCount(), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -20,9 +20,12 @@
  * SOFTWARE.
  */
 
+#include <cstdio>
+
 #include <boost/test/unit_test.hpp>
 
 #include <tgbot/net/HttpParser.h>
+#include <tgbot/tools/FileTools.h>
 
 #include "utils.h"
 
@@ -62,6 +65,71 @@ BOOST_AUTO_TEST_CASE(generateMultipartFormData) {
 	BOOST_CHECK_MESSAGE(t == e, diffS(t, e));
 }
 
+BOOST_AUTO_TEST_CASE(generateMultipartBoundary) {
+	std::vector<HttpReqArg> args = { HttpReqArg("email", "test@example.com") };
+	BOOST_CHECK_EQUAL(HttpParser::getInstance().generateMultipartBoundary(args), "");
+
+	args.push_back(HttpReqArg("text", "Hello, world!", true));
+	std::string first = HttpParser::getInstance().generateMultipartBoundary(args);
+	std::string second = HttpParser::getInstance().generateMultipartBoundary(args);
+	BOOST_CHECK_EQUAL(first.size(), 32);
+	BOOST_CHECK_EQUAL(first.find_first_not_of("ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_"), std::string::npos);
+	BOOST_CHECK_NE(first, second);
+}
+
+BOOST_AUTO_TEST_CASE(generateRequestFileParts) {
+	auto file(std::make_shared<InputFile>());
+	file->data = "Hello, world!";
+	file->mimeType = "text/plain";
+	file->fileName = "a.txt";
+	std::vector<HttpReqArg> args = { HttpReqArg("email", "test@example.com"), HttpReqArg("document", file) };
+	std::vector<HttpParser::FilePart> fileParts;
+	std::string t = HttpParser::getInstance().generateRequest(Url("http://example.com/index.html"), args, fileParts, true);
+	BOOST_REQUIRE_EQUAL(fileParts.size(), 1);
+	BOOST_CHECK(fileParts[0].data.data() == file->data.data());
+	BOOST_CHECK_EQUAL(t.find("Hello, world!"), std::string::npos);
+
+	std::string joined = t.substr(0, fileParts[0].offset) + file->data + t.substr(fileParts[0].offset);
+	size_t bodyOffset = joined.find("\r\n\r\n") + 4;
+	std::string boundary = joined.substr(bodyOffset + 2, joined.find("\r\n", bodyOffset) - bodyOffset - 2);
+	std::string e = ""
+		"--" + boundary + "\r\n"
+		"Content-Disposition: form-data; name=\"email\"\r\n"
+		"\r\n"
+		"test@example.com\r\n"
+		"--" + boundary + "\r\n"
+		"Content-Disposition: form-data; name=\"document\"; filename=\"a.txt\"\r\n"
+		"Content-Type: text/plain\r\n"
+		"\r\n"
+		"Hello, world!\r\n"
+		"--" + boundary + "--\r\n";
+	BOOST_CHECK_MESSAGE(joined.substr(bodyOffset) == e, diffS(joined.substr(bodyOffset), e));
+	BOOST_CHECK(joined.find("Content-Length: " + std::to_string(e.size()) + "\r\n") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(generateRequestStreamedFile) {
+	std::string filePath = "generateRequestStreamedFile.txt";
+	FileTools::write("Hello, world!", filePath);
+	std::vector<HttpReqArg> args = { HttpReqArg("document", InputFile::fromStreamedFile(filePath, "text/plain")) };
+	std::vector<HttpParser::FilePart> fileParts;
+	std::string t = HttpParser::getInstance().generateRequest(Url("http://example.com/index.html"), args, fileParts, true);
+	BOOST_REQUIRE_EQUAL(fileParts.size(), 1);
+	BOOST_CHECK_EQUAL(fileParts[0].path, filePath);
+	BOOST_CHECK_EQUAL(fileParts[0].size, 13);
+	BOOST_CHECK_EQUAL(t.find("Hello, world!"), std::string::npos);
+
+	t = HttpParser::getInstance().generateRequest(Url("http://example.com/index.html"), args, true);
+	BOOST_CHECK(t.find("\r\n\r\nHello, world!\r\n") != std::string::npos);
+
+	args = { HttpReqArg("document", InputFile::fromMappedFile(filePath, "text/plain")) };
+	fileParts.clear();
+	HttpParser::getInstance().generateRequest(Url("http://example.com/index.html"), args, fileParts, true);
+	BOOST_REQUIRE_EQUAL(fileParts.size(), 1);
+	BOOST_CHECK(fileParts[0].path.empty());
+	BOOST_CHECK_EQUAL(fileParts[0].data, "Hello, world!");
+	std::remove(filePath.c_str());
+}
+
 BOOST_AUTO_TEST_CASE(generateWwwFormUrlencoded) {
 	std::vector<HttpReqArg> args = { HttpReqArg("email", "test@example.com"), HttpReqArg("text", "Hello, world!") };
 	std::string t = HttpParser::getInstance().generateWwwFormUrlencoded(args);
@@ -69,6 +137,56 @@ BOOST_AUTO_TEST_CASE(generateWwwFormUrlencoded) {
 	BOOST_CHECK_MESSAGE(t == e, diffS(t, e));
 }
 
+BOOST_AUTO_TEST_CASE(generateJson) {
+	std::vector<HttpReqArg> args = { HttpReqArg("chat_id", -100123), HttpReqArg("text", "Hello, \"world\"!\n"), HttpReqArg("disable_notification", true), HttpReqArg("reply_markup", "{\"force_reply\":true}") };
+	args.back().isJson = true;
+	std::string t = HttpParser::getInstance().generateJson(args);
+	std::string e = "{\"chat_id\":-100123,\"text\":\"Hello, \\\"world\\\"!\\n\",\"disable_notification\":true,\"reply_markup\":{\"force_reply\":true}}";
+	BOOST_CHECK_MESSAGE(t == e, diffS(t, e));
+}
+
+BOOST_AUTO_TEST_CASE(generateRequestJson) {
+	std::vector<HttpReqArg> args = { HttpReqArg("chat_id", 1), HttpReqArg("text", "Hi") };
+	std::string t = HttpParser::getInstance().generateRequest(Url("http://example.com/sendMessage"), args, true, HttpParser::BodyEncoding::Json);
+	std::string e = ""
+		"POST /sendMessage HTTP/1.1\r\n"
+		"Host: example.com\r\n"
+		"Connection: keep-alive\r\n"
+		"Content-Type: application/json\r\n"
+		"Content-Length:                   25\r\n"
+		"\r\n"
+		"{\"chat_id\":1,\"text\":\"Hi\"}";
+	BOOST_CHECK_MESSAGE(t == e, diffS(t, e));
+}
+
+BOOST_AUTO_TEST_CASE(generateRequestHead) {
+	std::string t;
+	size_t bodyOffset = HttpParser::getInstance().generateRequestHead(t, Url("http://example.com/"), "sendMessage", "application/json", true);
+	t += "{\"chat_id\":1,\"text\":\"Hi\"}";
+	HttpParser::getInstance().completeRequest(t, bodyOffset);
+	std::string e = ""
+		"POST /sendMessage HTTP/1.1\r\n"
+		"Host: example.com\r\n"
+		"Connection: keep-alive\r\n"
+		"Content-Type: application/json\r\n"
+		"Content-Length:                   25\r\n"
+		"\r\n"
+		"{\"chat_id\":1,\"text\":\"Hi\"}";
+	BOOST_CHECK_MESSAGE(t == e, diffS(t, e));
+	BOOST_CHECK_EQUAL(bodyOffset, t.find('{'));
+}
+
+BOOST_AUTO_TEST_CASE(generateRangeRequest) {
+	std::string t = HttpParser::getInstance().generateRangeRequest(Url("http://example.com/file/a.bin"), 1024, 2047, true);
+	std::string e = ""
+		"GET /file/a.bin HTTP/1.1\r\n"
+		"Host: example.com\r\n"
+		"Connection: keep-alive\r\n"
+		"Range: bytes=1024-2047\r\n"
+		"\r\n";
+	BOOST_CHECK_MESSAGE(t == e, diffS(t, e));
+}
+
 BOOST_AUTO_TEST_CASE(generateResponse) {
 	std::string t = HttpParser::getInstance().generateResponse("testdata");
 	std::string e = ""
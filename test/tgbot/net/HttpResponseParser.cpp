@@ -0,0 +1,207 @@
+/*
+ * Copyright (c) 2015 Oleg Morozenkov
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <boost/test/unit_test.hpp>
+
+#include <tgbot/net/HttpResponseParser.h>
+
+#include "utils.h"
+
+using namespace TgBot;
+
+BOOST_AUTO_TEST_SUITE(tHttpResponseParser)
+
+BOOST_AUTO_TEST_CASE(contentLength) {
+	std::string data = ""
+		"HTTP/1.1 200 OK\r\n"
+		"Content-Type: text/plain\r\n"
+		"Content-Length: 8\r\n"
+		"\r\n"
+		"testdata";
+
+	HttpResponseParser parser;
+	BOOST_CHECK_EQUAL(parser.feed(data.c_str(), data.length()), data.length());
+	BOOST_CHECK(parser.isComplete());
+	BOOST_CHECK(parser.isKeepAlive());
+	BOOST_CHECK_EQUAL(parser.getStatusCode(), 200);
+	BOOST_CHECK_EQUAL(parser.getHeaders().at("content-type"), "text/plain");
+	BOOST_CHECK_EQUAL(parser.getBody(), "testdata");
+}
+
+BOOST_AUTO_TEST_CASE(byteByByte) {
+	std::string data = ""
+		"HTTP/1.1 404 Not Found\r\n"
+		"Content-Length: 8\r\n"
+		"Connection: close\r\n"
+		"\r\n"
+		"testdata";
+
+	HttpResponseParser parser;
+	for (size_t i = 0; i < data.length(); ++i) {
+		BOOST_CHECK(!parser.isComplete());
+		parser.feed(data.c_str() + i, 1);
+	}
+	BOOST_CHECK(parser.isComplete());
+	BOOST_CHECK(!parser.isKeepAlive());
+	BOOST_CHECK_EQUAL(parser.getStatusCode(), 404);
+	BOOST_CHECK_EQUAL(parser.getBody(), "testdata");
+}
+
+BOOST_AUTO_TEST_CASE(chunked) {
+	std::string data = ""
+		"HTTP/1.1 200 OK\r\n"
+		"Transfer-Encoding: chunked\r\n"
+		"\r\n"
+		"4\r\n"
+		"test\r\n"
+		"4;name=value\r\n"
+		"data\r\n"
+		"0\r\n"
+		"\r\n";
+
+	HttpResponseParser parser;
+	parser.feed(data.c_str(), 20);
+	BOOST_CHECK(!parser.isComplete());
+	parser.feed(data.c_str() + 20, data.length() - 20);
+	BOOST_CHECK(parser.isComplete());
+	BOOST_CHECK(parser.isKeepAlive());
+	BOOST_CHECK_EQUAL(parser.getBody(), "testdata");
+}
+
+BOOST_AUTO_TEST_CASE(bodyHandler) {
+	std::string data = ""
+		"HTTP/1.1 200 OK\r\n"
+		"Transfer-Encoding: chunked\r\n"
+		"\r\n"
+		"4\r\n"
+		"test\r\n"
+		"4\r\n"
+		"data\r\n"
+		"0\r\n"
+		"\r\n";
+
+	std::vector<std::string> pieces;
+	HttpResponseParser parser;
+	parser.setBodyHandler([&pieces](const char* data, size_t length) {
+		pieces.push_back(std::string(data, length));
+	});
+	parser.feed(data.c_str(), data.length());
+	BOOST_CHECK(parser.isComplete());
+	BOOST_CHECK_EQUAL(parser.getBody(), "");
+	BOOST_REQUIRE_EQUAL(pieces.size(), 2);
+	BOOST_CHECK_EQUAL(pieces[0], "test");
+	BOOST_CHECK_EQUAL(pieces[1], "data");
+}
+
+BOOST_AUTO_TEST_CASE(headersHandler) {
+	std::string data = ""
+		"HTTP/1.1 100 Continue\r\n"
+		"\r\n"
+		"HTTP/1.1 200 OK\r\n"
+		"Content-Length: 8\r\n"
+		"\r\n"
+		"testdata";
+
+	std::vector<std::string> events;
+	HttpResponseParser parser;
+	parser.setHeadersHandler([&events](const HttpResponseParser& parser) {
+		events.push_back("headers " + std::to_string(parser.getStatusCode()) + " " + std::to_string(parser.getContentLength()));
+	});
+	parser.setBodyHandler([&events](const char* data, size_t length) {
+		events.push_back(std::string(data, length));
+	});
+	parser.feed(data.c_str(), data.length());
+	BOOST_CHECK(parser.isComplete());
+	BOOST_REQUIRE_EQUAL(events.size(), 2);
+	BOOST_CHECK_EQUAL(events[0], "headers 200 8");
+	BOOST_CHECK_EQUAL(events[1], "testdata");
+}
+
+BOOST_AUTO_TEST_CASE(untilClose) {
+	std::string data = ""
+		"HTTP/1.0 200 OK\r\n"
+		"\r\n"
+		"testdata";
+
+	HttpResponseParser parser;
+	parser.feed(data.c_str(), data.length());
+	BOOST_CHECK(!parser.isComplete());
+	parser.finish();
+	BOOST_CHECK(parser.isComplete());
+	BOOST_CHECK(!parser.isKeepAlive());
+	BOOST_CHECK_EQUAL(parser.getBody(), "testdata");
+}
+
+BOOST_AUTO_TEST_CASE(interimResponse) {
+	std::string data = ""
+		"HTTP/1.1 100 Continue\r\n"
+		"\r\n"
+		"HTTP/1.1 200 OK\r\n"
+		"Content-Length: 0\r\n"
+		"\r\n";
+
+	HttpResponseParser parser;
+	parser.feed(data.c_str(), data.length());
+	BOOST_CHECK(parser.isComplete());
+	BOOST_CHECK_EQUAL(parser.getStatusCode(), 200);
+	BOOST_CHECK(parser.getBody().empty());
+}
+
+BOOST_AUTO_TEST_CASE(malformed) {
+	std::string data = "<html>\r\n";
+
+	HttpResponseParser parser;
+	parser.feed(data.c_str(), data.length());
+	BOOST_CHECK(parser.hasError());
+
+	parser.reset();
+	parser.finish();
+	BOOST_CHECK(parser.hasError());
+}
+
+BOOST_AUTO_TEST_CASE(hugeContentLength) {
+	std::string data = ""
+		"HTTP/1.1 200 OK\r\n"
+		"Content-Length: 1000000000000\r\n"
+		"\r\n"
+		"test";
+
+	HttpResponseParser parser;
+	BOOST_CHECK_EQUAL(parser.feed(data.c_str(), data.length()), data.length());
+	BOOST_CHECK(parser.getState() == HttpResponseParser::State::Body);
+	BOOST_CHECK_LE(parser.getBody().capacity(), 1024 * 1024);
+	BOOST_CHECK_EQUAL(parser.getBody(), "test");
+
+	for (const char* length : {"99999999999999999999999", "-1", "abc"}) {
+		data = std::string("HTTP/1.1 200 OK\r\nContent-Length: ") + length + "\r\n\r\n";
+		parser.reset();
+		parser.feed(data.c_str(), data.length());
+		BOOST_CHECK_MESSAGE(parser.hasError(), length);
+	}
+
+	data = "HTTP/1.1 200 OK\r\nTransfer-Encoding: chunked\r\n\r\nfffffffffffffffffffff\r\n";
+	parser.reset();
+	parser.feed(data.c_str(), data.length());
+	BOOST_CHECK(parser.hasError());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2015 Oleg Morozenkov
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+
+#include <boost/test/unit_test.hpp>
+
+#include <tgbot/net/ParallelDownloader.h>
+
+#include "TestServer.h"
+
+using namespace std;
+using namespace TgBot;
+
+static const char* DESTINATION_PATH = "tgbot_test_download.bin";
+
+static string makeContent(size_t size) {
+	string result;
+	for (size_t i = 0; i < size; ++i) {
+		result += static_cast<char>('a' + i % 26);
+	}
+	return result;
+}
+
+static TestServer::Responder makeFileResponder(const string& content, bool isRanged) {
+	return [content, isRanged](const string& head, const string&) {
+		size_t position = head.find("Range: bytes=");
+		if (!isRanged || position == string::npos) {
+			return TestServer::makeResponse(200, content);
+		}
+		char* end = nullptr;
+		size_t firstByte = strtoul(head.c_str() + position + 13, &end, 10);
+		size_t lastByte = strtoul(end + 1, nullptr, 10);
+		if (firstByte >= content.size()) {
+			return TestServer::makeResponse(416, "", "Content-Range: bytes */" + to_string(content.size()) + "\r\n");
+		}
+		lastByte = min(lastByte, content.size() - 1);
+		return TestServer::makeResponse(206, content.substr(firstByte, lastByte - firstByte + 1),
+			"Content-Range: bytes " + to_string(firstByte) + "-" + to_string(lastByte) + "/" + to_string(content.size()) + "\r\n");
+	};
+}
+
+static string readDestination() {
+	ifstream input(DESTINATION_PATH, ios::binary);
+	string result((istreambuf_iterator<char>(input)), istreambuf_iterator<char>());
+	remove(DESTINATION_PATH);
+	return result;
+}
+
+static void checkDownload(const string& content, bool isRanged) {
+	TestServer server(makeFileResponder(content, isRanged));
+	mutex progressMutex;
+	uint64_t downloadedSize = 0;
+	bool isProgressMonotonic = true;
+	ParallelDownloader(3, 1000).download(Url(server.getUrl() + "/file"), DESTINATION_PATH, [&](uint64_t size, uint64_t) {
+		lock_guard<mutex> lock(progressMutex);
+		isProgressMonotonic = isProgressMonotonic && size >= downloadedSize;
+		downloadedSize = size;
+	});
+	BOOST_CHECK(readDestination() == content);
+	BOOST_CHECK_EQUAL(downloadedSize, content.size());
+	BOOST_CHECK(isProgressMonotonic);
+}
+
+BOOST_AUTO_TEST_SUITE(tParallelDownloader)
+
+BOOST_AUTO_TEST_CASE(ranged) {
+	checkDownload(makeContent(10500), true);
+}
+
+BOOST_AUTO_TEST_CASE(rangesIgnored) {
+	checkDownload(makeContent(10500), false);
+}
+
+BOOST_AUTO_TEST_CASE(emptyFile) {
+	TestServer server(makeFileResponder("", true));
+	ParallelDownloader().download(Url(server.getUrl() + "/file"), DESTINATION_PATH);
+	ifstream input(DESTINATION_PATH);
+	BOOST_CHECK(input.is_open());
+	input.close();
+	BOOST_CHECK(readDestination().empty());
+}
+
+BOOST_AUTO_TEST_CASE(throwingProgress) {
+	TestServer server(makeFileResponder(makeContent(10500), true));
+	BOOST_CHECK_THROW(ParallelDownloader(3, 1000).download(Url(server.getUrl() + "/file"), DESTINATION_PATH, [](uint64_t, uint64_t) {
+		throw runtime_error("progress");
+	}), runtime_error);
+	readDestination();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,125 @@
+/*
+ * Copyright (c) 2015 Oleg Morozenkov
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <tgbot/net/RateLimiter.h>
+
+using namespace std;
+using namespace TgBot;
+
+static RateLimiter::Limits makeLimits(double globalRate, double chatRate) {
+	RateLimiter::Limits limits;
+	limits.globalRate = globalRate;
+	limits.privateChatRate = chatRate;
+	limits.groupChatRate = chatRate;
+	return limits;
+}
+
+static double measureSeconds(RateLimiter& rateLimiter, const vector<string>& chatIds) {
+	auto start = chrono::steady_clock::now();
+	for (const string& chatId : chatIds) {
+		rateLimiter.acquire(chatId);
+	}
+	return chrono::duration<double>(chrono::steady_clock::now() - start).count();
+}
+
+BOOST_AUTO_TEST_SUITE(tRateLimiter)
+
+BOOST_AUTO_TEST_CASE(isGroupChat) {
+	BOOST_CHECK(!RateLimiter::isGroupChat("12345"));
+	BOOST_CHECK(RateLimiter::isGroupChat("-10012345"));
+	BOOST_CHECK(RateLimiter::isGroupChat("@channel"));
+	BOOST_CHECK(!RateLimiter::isGroupChat(""));
+}
+
+BOOST_AUTO_TEST_CASE(globalRate) {
+	RateLimiter rateLimiter(makeLimits(100, 0));
+	double seconds = measureSeconds(rateLimiter, {"1", "2", "3", "4", "5", "6"});
+	BOOST_CHECK_GE(seconds, 0.045);
+	BOOST_CHECK_EQUAL(rateLimiter.getMetrics().releasedCount, 6);
+	BOOST_CHECK_EQUAL(rateLimiter.getMetrics().delayedCount, 5);
+}
+
+BOOST_AUTO_TEST_CASE(chatRate) {
+	RateLimiter rateLimiter(makeLimits(0, 50));
+	BOOST_CHECK_LT(measureSeconds(rateLimiter, {"1", "2", "3", "-4", "@5"}), 0.015);
+	BOOST_CHECK_GE(measureSeconds(rateLimiter, {"1", "1", "1"}), 0.035);
+	BOOST_CHECK_EQUAL(rateLimiter.getMetrics().chatCount, 5);
+}
+
+BOOST_AUTO_TEST_CASE(burst) {
+	RateLimiter::Limits limits = makeLimits(20, 0);
+	limits.globalBurst = 4;
+	RateLimiter rateLimiter(limits);
+	BOOST_CHECK_LT(measureSeconds(rateLimiter, {"1", "2", "3", "4"}), 0.015);
+	BOOST_CHECK_GE(measureSeconds(rateLimiter, {"5"}), 0.04);
+}
+
+BOOST_AUTO_TEST_CASE(chatOrder) {
+	RateLimiter rateLimiter(makeLimits(0, 0.01));
+	rateLimiter.acquire("1");
+	mutex orderMutex;
+	vector<size_t> order;
+	vector<thread> threads;
+	for (size_t i = 0; i < 8; ++i) {
+		threads.emplace_back([&rateLimiter, &orderMutex, &order, i]() {
+			rateLimiter.acquire("1");
+			lock_guard<mutex> lock(orderMutex);
+			order.push_back(i);
+		});
+		while (rateLimiter.getMetrics().waitingCount != i + 1) {
+			this_thread::yield();
+		}
+	}
+	rateLimiter.setLimits(makeLimits(0, 200));
+	for (thread& t : threads) {
+		t.join();
+	}
+	vector<size_t> expected = {0, 1, 2, 3, 4, 5, 6, 7};
+	BOOST_CHECK_EQUAL_COLLECTIONS(order.begin(), order.end(), expected.begin(), expected.end());
+	BOOST_CHECK_EQUAL(rateLimiter.getMetrics().waitingCount, 0);
+}
+
+BOOST_AUTO_TEST_CASE(setLimits) {
+	RateLimiter rateLimiter(makeLimits(1, 0));
+	rateLimiter.acquire("");
+	thread waiting([&rateLimiter]() {
+		rateLimiter.acquire("");
+	});
+	while (rateLimiter.getMetrics().waitingCount != 1) {
+		this_thread::yield();
+	}
+	auto start = chrono::steady_clock::now();
+	rateLimiter.setLimits(makeLimits(0, 0));
+	waiting.join();
+	BOOST_CHECK_LT(chrono::duration<double>(chrono::steady_clock::now() - start).count(), 0.5);
+	BOOST_CHECK_EQUAL(rateLimiter.getLimits().globalRate, 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
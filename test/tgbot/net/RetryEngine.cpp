@@ -0,0 +1,174 @@
+/*
+ * Copyright (c) 2015 Oleg Morozenkov
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+
+#include <boost/system/system_error.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <tgbot/TgException.h>
+#include <tgbot/net/RetryEngine.h>
+
+using namespace std;
+using namespace TgBot;
+
+static RetryEngine::Options makeOptions() {
+	RetryEngine::Options options;
+	options.maxAttempts = 4;
+	options.initialBackoff = chrono::milliseconds(2);
+	options.maxBackoff = chrono::milliseconds(5);
+	return options;
+}
+
+static TgException makeException(int32_t errorCode, int64_t migrateToChatId, int32_t retryAfter) {
+	auto parameters(make_shared<ResponseParameters>());
+	parameters->migrateToChatId = migrateToChatId;
+	parameters->retryAfter = retryAfter;
+	return TgException("error", errorCode, parameters);
+}
+
+static exception_ptr submitAndWait(RetryEngine& engine, int64_t chatId, const RetryEngine::Call& call) {
+	promise<exception_ptr> result;
+	engine.submit(chatId, call, [&result](exception_ptr error) {
+		result.set_value(error);
+	});
+	return result.get_future().get();
+}
+
+BOOST_AUTO_TEST_SUITE(tRetryEngine)
+
+BOOST_AUTO_TEST_CASE(success) {
+	RetryEngine engine(makeOptions());
+	int64_t calledChatId = 0;
+	BOOST_CHECK(submitAndWait(engine, 42, [&calledChatId](int64_t chatId) {
+		calledChatId = chatId;
+	}) == nullptr);
+	BOOST_CHECK_EQUAL(calledChatId, 42);
+	BOOST_CHECK_EQUAL(engine.getRetryCount(), 0);
+	BOOST_CHECK_EQUAL(engine.getPendingCount(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(migrateToChatId) {
+	RetryEngine engine(makeOptions());
+	int64_t calledChatId = 0;
+	BOOST_CHECK(submitAndWait(engine, -42, [&calledChatId](int64_t chatId) {
+		calledChatId = chatId;
+		if (chatId == -42) {
+			throw makeException(400, -1000000000042, 0);
+		}
+	}) == nullptr);
+	BOOST_CHECK_EQUAL(calledChatId, -1000000000042);
+	BOOST_CHECK_EQUAL(engine.getRetryCount(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(retryAfter) {
+	RetryEngine engine(makeOptions());
+	int attemptCount = 0;
+	auto start = chrono::steady_clock::now();
+	BOOST_CHECK(submitAndWait(engine, 1, [&attemptCount](int64_t) {
+		if (++attemptCount == 1) {
+			throw makeException(429, 0, 1);
+		}
+	}) == nullptr);
+	BOOST_CHECK_EQUAL(attemptCount, 2);
+	BOOST_CHECK_GE(chrono::duration<double>(chrono::steady_clock::now() - start).count(), 0.99);
+}
+
+BOOST_AUTO_TEST_CASE(backoff) {
+	RetryEngine engine(makeOptions());
+	int attemptCount = 0;
+	BOOST_CHECK(submitAndWait(engine, 1, [&attemptCount](int64_t) {
+		if (++attemptCount == 1) {
+			throw boost::system::system_error(boost::asio::error::connection_reset);
+		}
+		if (attemptCount == 2) {
+			throw makeException(502, 0, 0);
+		}
+		if (attemptCount == 3) {
+			throw TgException("tgbot-cpp library have got html page instead of json response.");
+		}
+	}) == nullptr);
+	BOOST_CHECK_EQUAL(attemptCount, 4);
+}
+
+BOOST_AUTO_TEST_CASE(failures) {
+	RetryEngine engine(makeOptions());
+	int attemptCount = 0;
+	exception_ptr error = submitAndWait(engine, 1, [&attemptCount](int64_t) {
+		++attemptCount;
+		throw boost::system::system_error(boost::asio::error::connection_reset);
+	});
+	BOOST_CHECK(error != nullptr);
+	BOOST_CHECK_EQUAL(attemptCount, 4);
+
+	attemptCount = 0;
+	error = submitAndWait(engine, 1, [&attemptCount](int64_t) {
+		++attemptCount;
+		throw makeException(403, 0, 0);
+	});
+	BOOST_CHECK_EQUAL(attemptCount, 1);
+	try {
+		rethrow_exception(error);
+	} catch (TgException& e) {
+		BOOST_CHECK_EQUAL(e.errorCode, 403);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(resultCall) {
+	RetryEngine engine(makeOptions());
+	int attemptCount = 0;
+	promise<Result<void>> result;
+	engine.submitResult(-42, [&attemptCount](int64_t chatId) -> Result<void> {
+		++attemptCount;
+		if (chatId == -42) {
+			return ApiError(400, "migrated", makeException(400, -1000000000042, 0).parameters);
+		}
+		return ApiError(403, "Forbidden: bot was blocked by the user");
+	}, [&result](const Result<void>& value) {
+		result.set_value(value);
+	});
+	Result<void> value = result.get_future().get();
+	BOOST_CHECK(!value);
+	BOOST_CHECK_EQUAL(value.getError().errorCode, 403);
+	BOOST_CHECK_EQUAL(attemptCount, 2);
+}
+
+BOOST_AUTO_TEST_CASE(destruction) {
+	atomic<int> attemptCount(0);
+	{
+		RetryEngine engine(makeOptions());
+		engine.submit(1, [&attemptCount](int64_t) {
+			++attemptCount;
+			throw makeException(429, 0, 60);
+		});
+		while (engine.getRetryCount() == 0) {
+			this_thread::yield();
+		}
+	}
+	BOOST_CHECK_EQUAL(attemptCount, 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,119 @@
+/*
+ * Copyright (c) 2015 Oleg Morozenkov
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <atomic>
+#include <future>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <tgbot/net/TgLongPoll.h>
+
+#include "TestServer.h"
+
+using namespace std;
+using namespace TgBot;
+
+static string makeUpdate(int32_t id) {
+	string result = to_string(id);
+	return "{\"update_id\":" + result + ",\"message\":{\"message_id\":" + result + ",\"date\":0,\"chat\":{\"id\":1,\"type\":\"private\"},\"text\":\"Hi\"}}";
+}
+
+BOOST_AUTO_TEST_SUITE(tTgLongPoll)
+
+BOOST_AUTO_TEST_CASE(pipelinedListenerErrors) {
+	TestServer server([](const string&, const string& body) {
+		bool isFirstPoll = body.find("\"offset\":0") != string::npos || body.find("offset") == string::npos;
+		string result = isFirstPoll ? makeUpdate(1) + "," + makeUpdate(2) + "," + makeUpdate(3) : "";
+		return TestServer::makeResponse(200, "{\"ok\":true,\"result\":[" + result + "]}");
+	});
+	Api api("TOKEN", server.getUrl());
+	EventBroadcaster broadcaster;
+	mutex handledMutex;
+	vector<int32_t> handled;
+	broadcaster.onAnyMessage([&](const Message::Ptr message) {
+		{
+			lock_guard<mutex> lock(handledMutex);
+			handled.push_back(message->messageId);
+		}
+		if (message->messageId < 3) {
+			throw runtime_error("update " + to_string(message->messageId));
+		}
+	});
+	EventHandler eventHandler(&broadcaster);
+	TgLongPoll longPoll(&api, &eventHandler);
+	longPoll.setMaxTime(0);
+	longPoll.setPipelined(true);
+
+	string error;
+	for (int i = 0; i < 1000 && error.empty(); ++i) {
+		try {
+			longPoll.start();
+		} catch (runtime_error& e) {
+			error = e.what();
+		}
+	}
+	longPoll.stop();
+	BOOST_CHECK_EQUAL(error, "update 1");
+	vector<int32_t> expected = {1, 2, 3};
+	BOOST_CHECK_EQUAL_COLLECTIONS(handled.begin(), handled.end(), expected.begin(), expected.end());
+}
+
+BOOST_AUTO_TEST_CASE(pipelinedPollsWhileListenerBlocks) {
+	atomic<bool> isAdvancedPollReceived(false);
+	TestServer server([&](const string&, const string& body) {
+		string result;
+		if (body.find("offset") == string::npos) {
+			result = makeUpdate(1);
+		} else if (body.find("\"offset\":2") != string::npos) {
+			isAdvancedPollReceived = true;
+		}
+		return TestServer::makeResponse(200, "{\"ok\":true,\"result\":[" + result + "]}");
+	});
+	Api api("TOKEN", server.getUrl());
+	EventBroadcaster broadcaster;
+	promise<void> latch;
+	shared_future<void> latchFuture(latch.get_future());
+	atomic<bool> isHandled(false);
+	broadcaster.onAnyMessage([&](const Message::Ptr) {
+		latchFuture.wait();
+		isHandled = true;
+	});
+	EventHandler eventHandler(&broadcaster);
+	TgLongPoll longPoll(&api, &eventHandler);
+	longPoll.setMaxTime(0);
+	longPoll.setPipelined(true);
+
+	longPoll.start();
+	longPoll.start();
+	bool isReceivedBeforeRelease = isAdvancedPollReceived && !isHandled;
+	latch.set_value();
+	longPoll.stop();
+	BOOST_CHECK(isReceivedBeforeRelease);
+	BOOST_CHECK(isHandled);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
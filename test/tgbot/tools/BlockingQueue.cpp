@@ -0,0 +1,77 @@
+/*
+ * Copyright (c) 2015 Oleg Morozenkov
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <thread>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <tgbot/tools/BlockingQueue.h>
+
+using namespace TgBot;
+
+BOOST_AUTO_TEST_SUITE(tBlockingQueue)
+
+BOOST_AUTO_TEST_CASE(capacity) {
+	BlockingQueue<int> queue(2);
+	BOOST_CHECK(queue.tryPush(1));
+	BOOST_CHECK(queue.tryPush(2));
+	BOOST_CHECK(!queue.tryPush(3));
+	BOOST_CHECK_EQUAL(queue.size(), 2);
+	int item = 0;
+	BOOST_CHECK(queue.pop(item));
+	BOOST_CHECK_EQUAL(item, 1);
+	BOOST_CHECK(queue.tryPush(3));
+}
+
+BOOST_AUTO_TEST_CASE(close) {
+	BlockingQueue<int> queue(4);
+	queue.push(1);
+	queue.close();
+	BOOST_CHECK(!queue.push(2));
+	int item = 0;
+	BOOST_CHECK(queue.pop(item));
+	BOOST_CHECK_EQUAL(item, 1);
+	BOOST_CHECK(!queue.pop(item));
+}
+
+BOOST_AUTO_TEST_CASE(producerConsumer) {
+	BlockingQueue<int> queue(1);
+	std::thread producer([&queue]() {
+		for (int i = 0; i < 1000; ++i) {
+			queue.push(i);
+		}
+		queue.close();
+	});
+	std::vector<int> items;
+	int item;
+	while (queue.pop(item)) {
+		items.push_back(item);
+	}
+	producer.join();
+	BOOST_REQUIRE_EQUAL(items.size(), 1000);
+	for (int i = 0; i < 1000; ++i) {
+		BOOST_CHECK_EQUAL(items[i], i);
+	}
+}
+
+BOOST_AUTO_TEST_SUITE_END()
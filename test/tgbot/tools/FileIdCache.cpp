@@ -0,0 +1,118 @@
+/*
+ * Copyright (c) 2015 Oleg Morozenkov
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include <boost/test/unit_test.hpp>
+
+#include <tgbot/tools/FileIdCache.h>
+
+using namespace std;
+using namespace TgBot;
+
+static InputFile makeFile(const string& data, const string& mimeType) {
+	InputFile file;
+	file.data = data;
+	file.mimeType = mimeType;
+	return file;
+}
+
+BOOST_AUTO_TEST_SUITE(tFileIdCache)
+
+BOOST_AUTO_TEST_CASE(getKey) {
+	string key = FileIdCache::getKey(makeFile("abc", "image/png"));
+	BOOST_CHECK_EQUAL(key.size(), 64);
+	BOOST_CHECK_EQUAL(key, FileIdCache::getKey(makeFile("abc", "image/png")));
+	BOOST_CHECK_NE(key, FileIdCache::getKey(makeFile("abd", "image/png")));
+	BOOST_CHECK_NE(key, FileIdCache::getKey(makeFile("abc", "image/jpeg")));
+	BOOST_CHECK_NE(FileIdCache::getKey(makeFile("ab", "cimage/png")), FileIdCache::getKey(makeFile("abc", "image/png")));
+}
+
+BOOST_AUTO_TEST_CASE(getKeyOfStreamedFile) {
+	const string path = "tgbot_test_file_id_cache_stream.tmp";
+	{
+		ofstream out(path, ios::out | ios::binary);
+		out << "abc";
+	}
+	InputFile file;
+	file.filePath = path;
+	file.fileSize = 3;
+	file.mimeType = "image/png";
+	BOOST_CHECK_EQUAL(FileIdCache::getKey(file), FileIdCache::getKey(makeFile("abc", "image/png")));
+	BOOST_CHECK_EQUAL(FileIdCache::getKey(file), FileIdCache::getKey(makeFile("abc", "image/png")));
+	{
+		ofstream out(path, ios::out | ios::binary | ios::trunc);
+		out << "abcd";
+	}
+	file.fileSize = 4;
+	BOOST_CHECK_EQUAL(FileIdCache::getKey(file), FileIdCache::getKey(makeFile("abcd", "image/png")));
+	remove(path.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(leastRecentlyUsed) {
+	FileIdCache cache(2);
+	cache.insert("a", "1");
+	cache.insert("b", "2");
+	BOOST_CHECK_EQUAL(cache.find("a"), "1");
+	cache.insert("c", "3");
+	BOOST_CHECK_EQUAL(cache.size(), 2);
+	BOOST_CHECK_EQUAL(cache.find("b"), "");
+	BOOST_CHECK_EQUAL(cache.find("a"), "1");
+	BOOST_CHECK_EQUAL(cache.find("c"), "3");
+	cache.erase("a");
+	BOOST_CHECK_EQUAL(cache.find("a"), "");
+	BOOST_CHECK_EQUAL(cache.size(), 1);
+}
+
+BOOST_AUTO_TEST_CASE(persistence) {
+	const string path = "tgbot_test_file_id_cache.tmp";
+	remove(path.c_str());
+	{
+		FileIdCache cache(3, path);
+		cache.insert("a", "1");
+		cache.insert("b", "2");
+		cache.insert("a", "4");
+		cache.insert("c", "3");
+		cache.erase("b");
+		for (int i = 0; i < 10; ++i) {
+			cache.insert("d", to_string(i));
+		}
+	}
+	{
+		FileIdCache cache(3, path);
+		BOOST_CHECK_EQUAL(cache.size(), 3);
+		BOOST_CHECK_EQUAL(cache.find("a"), "4");
+		BOOST_CHECK_EQUAL(cache.find("b"), "");
+		BOOST_CHECK_EQUAL(cache.find("c"), "3");
+		BOOST_CHECK_EQUAL(cache.find("d"), "9");
+	}
+	{
+		FileIdCache cache(1, path);
+		BOOST_CHECK_EQUAL(cache.size(), 1);
+		BOOST_CHECK_EQUAL(cache.find("d"), "9");
+	}
+	remove(path.c_str());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
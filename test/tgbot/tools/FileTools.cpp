@@ -0,0 +1,65 @@
+/*
+ * Copyright (c) 2015 Oleg Morozenkov
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+
+#include <cstdio>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+#include <boost/test/unit_test.hpp>
+
+#include <tgbot/tools/FileTools.h>
+
+using namespace std;
+
+BOOST_AUTO_TEST_SUITE(tFileTools)
+
+BOOST_AUTO_TEST_CASE(readAndGetSize) {
+	const string path = "tgbot_test_file_tools.tmp";
+	{
+		ofstream out(path, ios::out | ios::binary);
+		out << "abc";
+	}
+	BOOST_CHECK_EQUAL(FileTools::read(path), "abc");
+	BOOST_CHECK_EQUAL(FileTools::getSize(path), 3);
+	remove(path.c_str());
+}
+
+BOOST_AUTO_TEST_CASE(replace) {
+	const string path = "tgbot_test_file_tools_replace.tmp";
+	FileTools::replace("old", path);
+	FileTools::replace("new", path);
+	BOOST_CHECK_EQUAL(FileTools::read(path), "new");
+	BOOST_CHECK(!ifstream(path + ".tmp"));
+	remove(path.c_str());
+}
+
+#ifdef __linux__
+BOOST_AUTO_TEST_CASE(readFileWithoutSize) {
+	// Files in /proc report a size of 0, but they have contents.
+	BOOST_CHECK_NE(FileTools::read("/proc/self/status").find("Name:"), string::npos);
+	BOOST_CHECK_THROW(FileTools::getSize("/proc/self/fd"), runtime_error);
+}
+#endif
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2015 Oleg Morozenkov
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <tgbot/tools/JsonArrayStreamParser.h>
+
+#include "utils.h"
+
+using namespace std;
+using namespace TgBot;
+
+BOOST_AUTO_TEST_SUITE(tJsonArrayStreamParser)
+
+BOOST_AUTO_TEST_CASE(byteByByte) {
+	string json = "{\"ok\":true, \"description\":\"result\", \"result\" : [ {\"update_id\":1,\"text\":\"]}\\\"[{\"} ,\n{\"update_id\":2,\"a\":[[],{}]} ]}";
+	vector<int32_t> ids;
+	vector<string> texts;
+	JsonArrayStreamParser parser("result", [&ids, &texts](JsonValue::Ptr element) {
+		ids.push_back(element->get<int32_t>("update_id"));
+		texts.push_back(element->get("text", ""));
+	});
+	for (size_t i = 0; i < json.size(); ++i) {
+		parser.feed(json.data() + i, 1);
+		if (i < json.find("update_id\":2")) {
+			BOOST_CHECK(ids.size() <= 1);
+		}
+	}
+	JsonValue::Ptr root = parser.finish();
+	BOOST_REQUIRE_EQUAL(ids.size(), 2);
+	BOOST_CHECK_EQUAL(ids[0], 1);
+	BOOST_CHECK_EQUAL(ids[1], 2);
+	BOOST_CHECK_EQUAL(texts[0], "]}\"[{");
+	BOOST_CHECK_EQUAL(root->get<bool>("ok"), true);
+	BOOST_CHECK_EQUAL(root->get<string>("description"), "result");
+	BOOST_CHECK_EQUAL((*root)["result"].size(), 0);
+}
+
+BOOST_AUTO_TEST_CASE(elementBeforeEnd) {
+	string json = "{\"ok\":true,\"result\":[{\"update_id\":7},{\"update_id\":8";
+	size_t count = 0;
+	JsonArrayStreamParser parser("result", [&count](JsonValue::Ptr) {
+		++count;
+	});
+	parser.feed(json.data(), json.size());
+	BOOST_CHECK_EQUAL(count, 1);
+	BOOST_CHECK_THROW(parser.finish(), JsonException);
+}
+
+BOOST_AUTO_TEST_CASE(errorResponse) {
+	string json = "{\"ok\":false,\"error_code\":401,\"description\":\"Unauthorized\"}";
+	JsonArrayStreamParser parser("result", [](JsonValue::Ptr) {
+		BOOST_FAIL("unexpected element");
+	});
+	parser.feed(json.data(), json.size());
+	JsonValue::Ptr root = parser.finish();
+	BOOST_CHECK_EQUAL(root->get<int32_t>("error_code"), 401);
+	BOOST_CHECK(root->find("result") == nullptr);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
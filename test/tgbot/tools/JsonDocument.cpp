@@ -0,0 +1,131 @@
+/*
+ * Copyright (c) 2015 Oleg Morozenkov
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include <tgbot/tools/JsonDocument.h>
+#include <tgbot/TgTypeParser.h>
+
+#include "utils.h"
+
+using namespace std;
+using namespace TgBot;
+
+BOOST_AUTO_TEST_SUITE(tJsonDocument)
+
+BOOST_AUTO_TEST_CASE(scalars) {
+	JsonValue::Ptr root = JsonDocument::parse("{\"i\":-42,\"big\":-1001234567890,\"f\":55.75,\"e\":1.5e3,\"t\":true,\"n\":null,\"s\":\"text\"}");
+	BOOST_CHECK(root->isObject());
+	BOOST_CHECK_EQUAL(root->size(), 7);
+	BOOST_CHECK_EQUAL(root->get<int32_t>("i"), -42);
+	BOOST_CHECK_EQUAL(root->get<int64_t>("big"), -1001234567890LL);
+	BOOST_CHECK_EQUAL(root->get<float>("f"), 55.75f);
+	BOOST_CHECK_EQUAL(root->get<double>("e"), 1500.0);
+	BOOST_CHECK_EQUAL(root->get<bool>("t"), true);
+	BOOST_CHECK((*root)["n"].isNull());
+	BOOST_CHECK_EQUAL(root->get<string>("s"), "text");
+	BOOST_CHECK_EQUAL(root->get<string>("i"), "-42");
+	BOOST_CHECK_EQUAL(root->get("missing", "default"), "default");
+	BOOST_CHECK_EQUAL(root->get<int32_t>("big", 7), 7);
+	BOOST_CHECK_THROW(root->get<int32_t>("missing"), JsonException);
+	BOOST_CHECK_THROW(root->get<int32_t>("s"), JsonException);
+}
+
+BOOST_AUTO_TEST_CASE(escapes) {
+	JsonValue::Ptr root = JsonDocument::parse("[\"a\\\"b\\\\c\\/d\\n\", \"\\u0041\\u00e9\\u20ac\\ud83d\\ude00\", \"\"]");
+	vector<string> items;
+	for (const JsonValue& item : *root) {
+		items.push_back(item.as<string>());
+	}
+	BOOST_REQUIRE_EQUAL(items.size(), 3);
+	BOOST_CHECK_EQUAL(items[0], "a\"b\\c/d\n");
+	BOOST_CHECK_EQUAL(items[1], "A\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80");
+	BOOST_CHECK_EQUAL(items[2], "");
+}
+
+BOOST_AUTO_TEST_CASE(nested) {
+	JsonValue::Ptr root = JsonDocument::parse(" { \"a\" : [ [1, 2], {}, [] ], \"b\" : { \"c\" : [3] } } ");
+	const JsonValue& a = (*root)["a"];
+	BOOST_CHECK_EQUAL(a.size(), 3);
+	JsonValue::ConstIterator it = a.begin();
+	BOOST_CHECK_EQUAL(it->size(), 2);
+	BOOST_CHECK_EQUAL(it->begin()->as<int32_t>(), 1);
+	++it;
+	BOOST_CHECK(it->isObject());
+	++it;
+	BOOST_CHECK(it->isArray());
+	++it;
+	BOOST_CHECK(it == a.end());
+	BOOST_CHECK_EQUAL((*root)["b"]["c"].begin()->as<int32_t>(), 3);
+	BOOST_CHECK_EQUAL((*root)["b"].begin()->getKey(), "c");
+}
+
+BOOST_AUTO_TEST_CASE(malformed) {
+	BOOST_CHECK_THROW(JsonDocument::parse(""), JsonException);
+	BOOST_CHECK_THROW(JsonDocument::parse("{\"a\":1"), JsonException);
+	BOOST_CHECK_THROW(JsonDocument::parse("{\"a\" 1}"), JsonException);
+	BOOST_CHECK_THROW(JsonDocument::parse("[1,]"), JsonException);
+	BOOST_CHECK_THROW(JsonDocument::parse("[01]"), JsonException);
+	BOOST_CHECK_THROW(JsonDocument::parse("\"abc"), JsonException);
+	BOOST_CHECK_THROW(JsonDocument::parse("\"\\x\""), JsonException);
+	BOOST_CHECK_THROW(JsonDocument::parse("tru"), JsonException);
+	BOOST_CHECK_THROW(JsonDocument::parse("{} {}"), JsonException);
+	BOOST_CHECK_THROW(JsonDocument::parse(string(1000, '[') + string(1000, ']')), JsonException);
+}
+
+BOOST_AUTO_TEST_CASE(update) {
+	JsonValue::Ptr root = JsonDocument::parse("{\"update_id\":100,\"message\":{\"message_id\":5,\"from\":{\"id\":12,\"first_name\":\"A\"},"
+		"\"chat\":{\"id\":-100500,\"type\":\"group\",\"title\":\"T\"},\"date\":1500000000,\"text\":\"/start@bot x\","
+		"\"entities\":[{\"type\":\"bot_command\",\"offset\":0,\"length\":10}],\"location\":{\"longitude\":30.5,\"latitude\":-50.25}}}");
+	Update::Ptr update = TgTypeParser::getInstance().parseJsonAndGetUpdate(*root);
+	BOOST_CHECK_EQUAL(update->updateId, 100);
+	BOOST_REQUIRE(update->message);
+	BOOST_CHECK_EQUAL(update->message->messageId, 5);
+	BOOST_CHECK_EQUAL(update->message->from->id, 12);
+	BOOST_CHECK_EQUAL(update->message->chat->id, -100500);
+	BOOST_CHECK(update->message->chat->type == Chat::Type::Group);
+	BOOST_CHECK_EQUAL(update->message->text, "/start@bot x");
+	BOOST_CHECK_EQUAL(update->message->caption, "");
+	BOOST_REQUIRE_EQUAL(update->message->entities.size(), 1);
+	BOOST_CHECK_EQUAL(update->message->entities[0]->length, 10);
+	BOOST_CHECK_EQUAL(update->message->location->latitude, -50.25f);
+	BOOST_CHECK(!update->message->replyToMessage);
+}
+
+BOOST_AUTO_TEST_CASE(scanResponse) {
+	const TgTypeParser& parser = TgTypeParser::getInstance();
+	int32_t messageId = -1;
+	BOOST_CHECK(parser.scanResponse("{\"ok\":true,\"result\":{\"message_id\":123,\"from\":{\"id\":1}}}", messageId));
+	BOOST_CHECK_EQUAL(messageId, 123);
+	BOOST_CHECK(parser.scanResponse("{ \"result\" : { \"reply_to_message\": {\"message_id\": 5}, \"text\": \"\\\"message_id\\\":7\", \"message_id\" : 42 }, \"ok\" : true }", messageId));
+	BOOST_CHECK_EQUAL(messageId, 42);
+	BOOST_CHECK(parser.scanResponse("{\"ok\":true,\"result\":true}", messageId));
+	BOOST_CHECK_EQUAL(messageId, 0);
+	BOOST_CHECK(!parser.scanResponse("{\"ok\":false,\"error_code\":400,\"description\":\"Bad Request\"}", messageId));
+	BOOST_CHECK(!parser.scanResponse("<html>", messageId));
+	BOOST_CHECK(!parser.scanResponse("{\"result\":{\"message_id\":1}}", messageId));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
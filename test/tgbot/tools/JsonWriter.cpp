@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2015 Oleg Morozenkov
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <cstdint>
+#include <limits>
+#include <string>
+
+#include <boost/test/unit_test.hpp>
+
+#include <tgbot/TgTypeParser.h>
+#include <tgbot/tools/JsonWriter.h>
+
+using namespace std;
+using namespace TgBot;
+
+BOOST_AUTO_TEST_SUITE(tJsonWriter)
+
+BOOST_AUTO_TEST_CASE(structure) {
+	string json;
+	JsonWriter writer(json);
+	writer.startObject();
+	writer.key("a").startArray().value(1).value("x").startObject().endObject().startArray().endArray().endArray();
+	writer.key("b").nullValue();
+	writer.key("c").rawValue("{\"d\":true}");
+	writer.key("e").value(false);
+	writer.endObject();
+	BOOST_CHECK_EQUAL(json, "{\"a\":[1,\"x\",{},[]],\"b\":null,\"c\":{\"d\":true},\"e\":false}");
+}
+
+BOOST_AUTO_TEST_CASE(rawMembers) {
+	string json;
+	JsonWriter writer(json);
+	writer.startObject().key("chat_id").value(1).rawMembers("\"text\":\"x\",\"silent\":true").rawMembers("").endObject();
+	BOOST_CHECK_EQUAL(json, "{\"chat_id\":1,\"text\":\"x\",\"silent\":true}");
+}
+
+BOOST_AUTO_TEST_CASE(escaping) {
+	string json;
+	JsonWriter writer(json);
+	writer.value(string("q\"b\\s/n\nr\rt\tb\bf\f\x01\x1f\xd0\xbf", 20));
+	BOOST_CHECK_EQUAL(json, "\"q\\\"b\\\\s/n\\nr\\rt\\tb\\bf\\f\\u0001\\u001f\xd0\xbf\"");
+
+	JsonValue::Ptr parsed = JsonDocument::parse("{\"s\":" + json + "}");
+	BOOST_CHECK_EQUAL(parsed->get<string>("s"), string("q\"b\\s/n\nr\rt\tb\bf\f\x01\x1f\xd0\xbf", 20));
+}
+
+BOOST_AUTO_TEST_CASE(numbers) {
+	string json;
+	JsonWriter writer(json);
+	writer.startArray();
+	writer.value(0).value(7).value(10).value(99).value(100).value(-12345);
+	writer.value(numeric_limits<int32_t>::min()).value(numeric_limits<int64_t>::min()).value(numeric_limits<int64_t>::max());
+	writer.value(numeric_limits<uint64_t>::max());
+	writer.value(55.75f).value(37.6173f).value(0.1).value(-2.5).value(numeric_limits<double>::infinity());
+	writer.endArray();
+	BOOST_CHECK_EQUAL(json, "[0,7,10,99,100,-12345,-2147483648,-9223372036854775808,9223372036854775807,18446744073709551615,"
+		"55.75,37.6173,0.1,-2.5,null]");
+}
+
+BOOST_AUTO_TEST_CASE(replyKeyboardMarkup) {
+	ReplyKeyboardMarkup::Ptr markup(new ReplyKeyboardMarkup);
+	markup->keyboard.resize(2);
+	for (const char* text : { "Yes", "No \"way\"" }) {
+		KeyboardButton::Ptr button(new KeyboardButton);
+		button->text = text;
+		markup->keyboard[0].push_back(button);
+	}
+	markup->oneTimeKeyboard = true;
+
+	string json = TgTypeParser::getInstance().parseGenericReply(markup);
+	BOOST_CHECK_EQUAL(json, "{\"keyboard\":[[{\"text\":\"Yes\",\"request_contact\":false,\"request_location\":false},"
+		"{\"text\":\"No \\\"way\\\"\",\"request_contact\":false,\"request_location\":false}],[]],"
+		"\"resize_keyboard\":false,\"one_time_keyboard\":true,\"selective\":false}");
+}
+
+BOOST_AUTO_TEST_CASE(inlineQueryResult) {
+	InlineQueryResultPhoto::Ptr photo(new InlineQueryResultPhoto);
+	photo->id = "1";
+	photo->photoUrl = "http://example.com/p.jpg";
+	photo->photoWidth = 640;
+	photo->photoHeight = 480;
+	photo->replyMarkup.reset(new InlineKeyboardMarkup);
+	photo->replyMarkup->inlineKeyboard.resize(1);
+	photo->replyMarkup->inlineKeyboard[0].push_back(InlineKeyboardButton::Ptr(new InlineKeyboardButton));
+	photo->replyMarkup->inlineKeyboard[0][0]->text = "Open";
+	photo->replyMarkup->inlineKeyboard[0][0]->callbackData = "open";
+
+	string json = TgTypeParser::getInstance().parseInlineQueryResult(photo);
+	BOOST_CHECK_EQUAL(json, "{\"id\":\"1\",\"type\":\"photo\",\"reply_markup\":{\"inline_keyboard\":[[{\"text\":\"Open\",\"callback_data\":\"open\"}]]},"
+		"\"photo_url\":\"http://example.com/p.jpg\",\"photo_width\":640,\"photo_height\":480}");
+	BOOST_CHECK_EQUAL(TgTypeParser::getInstance().parseInlineQueryResultPhoto(photo), json);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
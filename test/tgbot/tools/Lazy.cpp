@@ -0,0 +1,109 @@
+/*
+ * Copyright (c) 2015 Oleg Morozenkov
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+
+#include <string>
+
+#include <boost/test/unit_test.hpp>
+
+#include <tgbot/TgTypeParser.h>
+
+using namespace std;
+using namespace TgBot;
+
+BOOST_AUTO_TEST_SUITE(tLazy)
+
+BOOST_AUTO_TEST_CASE(lazyMessage) {
+	TgTypeParser& parser = TgTypeParser::getInstance();
+	parser.setLazyDecoding(true);
+
+	Message::Ptr message;
+	{
+		JsonValue::Ptr root = parser.parseJson("{\"message_id\":2,\"date\":0,\"chat\":{\"id\":1,\"type\":\"private\"},"
+			"\"reply_to_message\":{\"message_id\":1,\"date\":0,\"chat\":{\"id\":1,\"type\":\"private\"},\"text\":\"original\"},"
+			"\"photo\":[{\"file_id\":\"a\",\"width\":1,\"height\":1},{\"file_id\":\"b\",\"width\":2,\"height\":2}]}");
+		message = parser.parseJsonAndGetMessage(*root);
+	}
+	parser.setLazyDecoding(false);
+
+	BOOST_CHECK_EQUAL(message->chat->id, 1);
+	BOOST_CHECK(!message->replyToMessage.isDecoded());
+	BOOST_CHECK(message->replyToMessage != nullptr);
+	BOOST_CHECK(!message->replyToMessage.isDecoded());
+	BOOST_CHECK(message->pinnedMessage == nullptr);
+
+	Message copy(*message);
+	BOOST_CHECK_EQUAL(message->replyToMessage->text, "original");
+	BOOST_CHECK(message->replyToMessage.isDecoded());
+	BOOST_CHECK(!message->replyToMessage->replyToMessage);
+	BOOST_CHECK_EQUAL(copy.replyToMessage->messageId, 1);
+
+	BOOST_CHECK(!message->photo.isDecoded());
+	BOOST_REQUIRE_EQUAL(message->photo.size(), 2);
+	BOOST_CHECK_EQUAL(message->photo[1]->fileId, "b");
+	BOOST_CHECK(message->entities.empty());
+}
+
+BOOST_AUTO_TEST_CASE(eagerWithoutSharedDocument) {
+	TgTypeParser& parser = TgTypeParser::getInstance();
+	parser.setLazyDecoding(true);
+	JsonDocument document("{\"message_id\":2,\"date\":0,\"chat\":{\"id\":1,\"type\":\"private\"},\"reply_to_message\":{\"message_id\":1,\"date\":0,\"chat\":{\"id\":1,\"type\":\"private\"}}}");
+	Message::Ptr message = parser.parseJsonAndGetMessage(document.getRoot());
+	parser.setLazyDecoding(false);
+	BOOST_CHECK(message->replyToMessage.isDecoded());
+	BOOST_CHECK_EQUAL(message->replyToMessage->messageId, 1);
+}
+
+BOOST_AUTO_TEST_CASE(pointerAndVectorInterface) {
+	TgTypeParser& parser = TgTypeParser::getInstance();
+	parser.setLazyDecoding(true);
+	Message::Ptr message;
+	{
+		JsonValue::Ptr root = parser.parseJson("{\"message_id\":2,\"date\":0,\"chat\":{\"id\":1,\"type\":\"private\"},"
+			"\"voice\":{\"file_id\":\"v\",\"duration\":3},\"venue\":{\"location\":{\"longitude\":1,\"latitude\":2},\"title\":\"t\",\"address\":\"a\"},"
+			"\"photo\":[{\"file_id\":\"a\",\"width\":1,\"height\":1}]}");
+		message = parser.parseJsonAndGetMessage(*root);
+	}
+	parser.setLazyDecoding(false);
+
+	BOOST_CHECK(!message->voice.isDecoded());
+	BOOST_CHECK_EQUAL(message->voice->duration, 3);
+	BOOST_CHECK_EQUAL(message->venue->location->latitude, 2);
+	Voice* voice = message->voice.get();
+	BOOST_CHECK_EQUAL(voice->file_id, "v");
+	Voice::Ptr voicePtr = message->voice;
+	BOOST_CHECK(message->voice == voicePtr);
+	message->voice.reset();
+	BOOST_CHECK(message->voice == nullptr);
+	BOOST_CHECK(message->voice != voicePtr);
+
+	message->photo.push_back(make_shared<PhotoSize>());
+	message->photo[1]->fileId = "b";
+	BOOST_CHECK_EQUAL(message->photo.size(), 2);
+	const vector<PhotoSize::Ptr>& photo = message->photo;
+	BOOST_CHECK_EQUAL(photo.back()->fileId, "b");
+	message->entities.push_back(make_shared<MessageEntity>());
+	BOOST_CHECK_EQUAL(message->entities.size(), 1);
+	message->entities.clear();
+	BOOST_CHECK(message->entities.empty());
+}
+
+BOOST_AUTO_TEST_SUITE_END()